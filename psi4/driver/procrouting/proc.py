@@ -1191,7 +1191,7 @@ def scf_wavefunction_factory(name, ref_wfn, reference, **kwargs):
         wfn._disp_functor = _disp_functor
 
     # Set the DF basis sets
-    if (("DF" in core.get_global_option("SCF_TYPE")) or
+    if (("DF" in core.get_global_option("SCF_TYPE")) or (core.get_global_option("SCF_TYPE") == "COSX") or
             (core.get_option("SCF", "DF_SCF_GUESS") and (core.get_global_option("SCF_TYPE") == "DIRECT"))):
         aux_basis = core.BasisSet.build(wfn.molecule(), "DF_BASIS_SCF",
                                         core.get_option("SCF", "DF_BASIS_SCF"),
@@ -65,8 +65,10 @@ def scf_compute_energy(self):
         #   each iter) by first converging via fast DF iterations, then
         #   fully converging in fewer slow DIRECT iterations. aka Andy trick 2.0
         core.print_out("  Starting with a DF guess...\n\n")
-        with p4util.OptionsStateCM(['SCF_TYPE']):
+        with p4util.OptionsStateCM(['SCF_TYPE']), p4util.OptionsStateCM(['SCF', 'CFMM']):
             core.set_global_option('SCF_TYPE', 'DF')
+            # CFMM only applies to the DIRECT iterations, the DF guess builds the fitted J
+            core.set_local_option('SCF', 'CFMM', False)
             self.initialize()
             try:
                 self.iterations()
@@ -261,6 +263,9 @@ def scf_iterate(self, e_conv=None, d_conv=None):
         core.print_out("%s                        Total Energy        Delta E     %s |[F,P]|\n\n" %
                        ("   " if is_dfjk else "", "RMS" if diis_rms else "MAX"))
 
+    # mixed precision DF-JK: single precision until the orbital gradient is small enough
+    single_precision = hasattr(self.jk(), "get_single_precision") and self.jk().get_single_precision()
+
     # SCF iterations!
     SCFE_old = 0.0
     Dnorm = 0.0
@@ -443,6 +448,16 @@ def scf_iterate(self, e_conv=None, d_conv=None):
             self.Da().print_out()
             self.Db().print_out()
 
+        # Switch to double precision integrals, and never converge on a single precision Fock matrix
+        promoted = False
+        if single_precision and not ((self.iteration_ == 0) and self.sad_):
+            if Dnorm < core.get_option('SCF', 'DF_MIXED_PRECISION_CONVERGENCE') or _converged(
+                    Ediff, Dnorm, e_conv=e_conv, d_conv=d_conv):
+                self.jk().set_single_precision(False)
+                single_precision = False
+                promoted = True
+                status.append("FP64")
+
         # Print out the iteration
         core.print_out(
             "   @%s%s iter %3s: %20.14f   %12.5e   %-11.5e %s\n" %
@@ -458,7 +473,8 @@ def scf_iterate(self, e_conv=None, d_conv=None):
             continue
 
         # Call any postiteration callbacks
-        if not ((self.iteration_ == 0) and self.sad_) and _converged(Ediff, Dnorm, e_conv=e_conv, d_conv=d_conv):
+        if not ((self.iteration_ == 0) and self.sad_) and not promoted and _converged(
+                Ediff, Dnorm, e_conv=e_conv, d_conv=d_conv):
             break
         if self.iteration_ >= core.get_option('SCF', 'MAXITER'):
             raise SCFConvergenceError("""SCF iterations""", self.iteration_, self, Ediff, Dnorm)
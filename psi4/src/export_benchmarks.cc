@@ -26,9 +26,15 @@
  * @END LICENSE
  */
 
+#include "psi4/libfock/benchmark.h"
+#include "psi4/libmints/basisset.h"
 #include "psi4/libmints/benchmark.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libfunctional/superfunctional.h"
 #include "psi4/pybind11.h"
 
+#include <pybind11/stl.h>
+
 namespace py = pybind11;
 
 void export_benchmarks(py::module& m) {
@@ -36,6 +42,11 @@ void export_benchmarks(py::module& m) {
     m.def("benchmark_blas2", &psi::benchmark_blas2, "docstring");
     m.def("benchmark_blas3", &psi::benchmark_blas3, "docstring");
     m.def("benchmark_disk", &psi::benchmark_disk, "docstring");
+    m.def("benchmark_dfhelper_io", &psi::benchmark_dfhelper_io, "docstring");
+    m.def("benchmark_vv10", &psi::benchmark_vv10, "docstring");
+    m.def("benchmark_dft_grid", &psi::benchmark_dft_grid, "docstring");
     m.def("benchmark_math", &psi::benchmark_math, "docstring");
     m.def("benchmark_integrals", &psi::benchmark_integrals, "docstring");
+    m.def("benchmark_boys", &psi::benchmark_boys, "docstring");
+    m.def("benchmark_directjk", &psi::benchmark_directjk, "docstring");
 }
@@ -95,7 +95,10 @@ void export_fock(py::module &m) {
         .def("print_header", &JK::print_header, "docstring");
 
     py::class_<MemDFJK, std::shared_ptr<MemDFJK>, JK>(m, "MemDFJK", "docstring")
-        .def("dfh", &MemDFJK::dfh, "Return the DFHelper object.");
+        .def("dfh", &MemDFJK::dfh, "Return the DFHelper object.")
+        .def("set_single_precision", &MemDFJK::set_single_precision,
+             "Store the AOs and build J/K in single precision, turning it off rebuilds the AOs in double precision.")
+        .def("get_single_precision", &MemDFJK::get_single_precision, "Is single precision requested for the AOs?");
 
     py::class_<LaplaceDenominator, std::shared_ptr<LaplaceDenominator>>(m, "LaplaceDenominator", "docstring")
         .def(py::init<std::shared_ptr<Vector>, std::shared_ptr<Vector>, double>())
@@ -171,6 +174,15 @@ void export_fock(py::module &m) {
         .def("get_AO_core", &DFHelper::get_AO_core)
         .def("set_MO_core", &DFHelper::set_MO_core)
         .def("get_MO_core", &DFHelper::get_MO_core)
+        .def("set_mmap_io", &DFHelper::set_mmap_io)
+        .def("get_mmap_io", &DFHelper::get_mmap_io)
+        .def("set_pipeline_transform", &DFHelper::set_pipeline_transform)
+        .def("get_pipeline_transform", &DFHelper::get_pipeline_transform)
+        .def("set_pipeline_int_threads", &DFHelper::set_pipeline_int_threads)
+        .def("get_pipeline_int_threads", &DFHelper::get_pipeline_int_threads)
+        .def("set_block_sparse_K", &DFHelper::set_block_sparse_K)
+        .def("get_block_sparse_K", &DFHelper::get_block_sparse_K)
+        .def("K_tile_sparsity", &DFHelper::K_tile_sparsity, "Fraction of K tile pairs skipped in the last K build.")
         .def("add_space", &DFHelper::add_space)
         .def("initialize", &DFHelper::initialize)
         .def("print_header", &DFHelper::print_header)
@@ -263,7 +263,8 @@ void export_functional(py::module &m) {
         .def("max_points", &MolecularGrid::max_points, "Returns the maximum number of points in a block.")
         .def("max_functions", &MolecularGrid::max_functions, "Returns the maximum number of functions in a block.")
         .def("collocation_size", &MolecularGrid::collocation_size, "Returns the total collocation size of all blocks.")
-        .def("blocks", &MolecularGrid::blocks, "Returns a list of blocks.");
+        .def("blocks", &MolecularGrid::blocks, "Returns a list of blocks.")
+        .def("from_cache", &MolecularGrid::from_cache, "Was the grid read from the DFT grid cache?");
 
     py::class_<DFTGrid, std::shared_ptr<DFTGrid>, MolecularGrid>(m, "DFTGrid", "docstring")
         .def_static("build",
@@ -273,7 +274,9 @@ void export_functional(py::module &m) {
         .def_static("build", [](std::shared_ptr<Molecule> &mol, std::shared_ptr<BasisSet> &basis,
                                 std::map<std::string, int> int_opts, std::map<std::string, std::string> string_opts) {
             return std::make_shared<DFTGrid>(mol, basis, int_opts, string_opts, Process::environment.options);
-        });
+        })
+        .def_static("clear_cache", []() { return DFTGrid::clear_cache(Process::environment.options); },
+                    "Removes all DFT grid cache files from the cache directory, returns the number removed.");
 
     py::class_<Dispersion, std::shared_ptr<Dispersion>>(m, "Dispersion", "docstring")
         .def_static("build", &Dispersion::build, "type"_a, "s6"_a = 0.0, "alpha6"_a = 0.0, "sr6"_a = 0.0,
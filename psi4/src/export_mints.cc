@@ -57,6 +57,7 @@
 #include "psi4/libmints/nabla.h"
 #include "psi4/libmints/electrostatic.h"
 #include "psi4/libmints/potential.h"
+#include "psi4/libmints/fjt.h"
 #include "psi4/libmints/kinetic.h"
 #include "psi4/libmints/factory.h"
 #include "psi4/libmints/writer.h"
@@ -880,7 +881,8 @@ void export_mints(py::module& m) {
         .def("so_kinetic", &IntegralFactory::so_kinetic, "Returns a OneBodyInt that computes the SO kinetic integrals",
              "deriv"_a = 0)
         .def("ao_potential", &IntegralFactory::ao_potential,
-             "Returns a OneBodyInt that computes the AO nuclear attraction integral", "deriv"_a = 0)
+             "Returns a OneBodyInt that computes the AO nuclear attraction integral", "deriv"_a = 0,
+             "use_shell_pairs"_a = true)
         .def("so_potential", &IntegralFactory::so_potential,
              "Returns a OneBodyInt that computes the SO nuclear attraction integral", "deriv"_a = 0)
         .def("ao_pseudospectral", &IntegralFactory::ao_pseudospectral,
@@ -900,7 +902,7 @@ void export_mints(py::module& m) {
         .def("so_quadrupole", &IntegralFactory::so_quadrupole,
              "Returns a OneBodyInt that computes SO the quadrupole integral")
         .def("ao_multipoles", &IntegralFactory::ao_multipoles,
-             "Returns a OneBodyInt that computes arbitrary-order AO multipole integrals", "order"_a)
+             "Returns a OneBodyInt that computes arbitrary-order AO multipole integrals", "order"_a, "deriv"_a = 0)
         .def("so_multipoles", &IntegralFactory::so_multipoles,
              "Returns a OneBodyInt that computes arbitrary-order SO multipole integrals", "order"_a)
         .def("ao_traceless_quadrupole", &IntegralFactory::ao_traceless_quadrupole,
@@ -943,6 +945,8 @@ void export_mints(py::module& m) {
         // Options and attributes
         .def("nbf", &MintsHelper::nbf, "Returns the number of basis functions")
         .def("set_print", &MintsHelper::set_print, "Sets the print level")
+        .def("set_use_shell_pairs", &MintsHelper::set_use_shell_pairs,
+             "Sets whether ERI and potential integrals use the cached, screened primitive pairs", "use_shell_pairs"_a)
         .def("basisset", &MintsHelper::basisset, "Returns the basis set being used")
         .def("sobasisset", &MintsHelper::sobasisset, "Returns the SO basis set being used")
         .def("factory", &MintsHelper::factory, "Returns the Matrix factory being used")
@@ -1590,4 +1594,26 @@ void export_mints(py::module& m) {
     py::class_<ERISieve, std::shared_ptr<ERISieve>>(m, "ERISieve", "docstring")
         .def(py::init<std::shared_ptr<BasisSet>, double, bool>())
         .def("shell_significant", &ERISieve::shell_significant);
+
+    py::class_<Taylor_Fjt, std::shared_ptr<Taylor_Fjt>>(m, "TaylorFjt",
+                                                        "Boys function F_j(T) by Taylor interpolation of a table")
+        .def(py::init<size_t, double>(), "mmax"_a, "accuracy"_a = 1.0e-15)
+        .def(
+            "values",
+            [](Taylor_Fjt& fjt, int J, double T) {
+                const double* F = fjt.values(J, T);
+                return std::vector<double>(F, F + J + 1);
+            },
+            "Returns F_j(T) for 0 <= j <= J, one T at a time", "J"_a, "T"_a)
+        .def(
+            "batch_values",
+            [](Taylor_Fjt& fjt, int J, const std::vector<double>& T) {
+                std::vector<double> out((J + 1) * T.size());
+                fjt.values(J, T.data(), T.size(), out.data());
+                return out;
+            },
+            "Returns F_j(T_i) for 0 <= j <= J and every T_i from the batched evaluation, as out[j * len(T) + i]",
+            "J"_a, "T"_a)
+        .def("T_crit", &Taylor_Fjt::T_crit, "Largest T at which F_m(T) is interpolated rather than asymptotic",
+             "m"_a);
 }
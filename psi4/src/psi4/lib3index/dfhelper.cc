@@ -30,11 +30,16 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include <cstring>
+#include <future>
 #ifdef _MSC_VER
 #include <process.h>
 #define SYSTEM_GETPID ::_getpid
 #else
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #define SYSTEM_GETPID ::getpid
 #endif
 #ifdef _OPENMP
@@ -184,6 +189,7 @@ void DFHelper::initialize() {
     }
 
     // prepare AOs for STORE method
+    Ppq_sp_.reset();
     if (AO_core_) {
         if (do_wK_) {
             prepare_AO_wK_core();
@@ -220,6 +226,11 @@ void DFHelper::AO_core() {
         // total size of sparse AOs.
         // yes, a nested ternary operator
         required_core_size_ = (do_wK_ ? ( wcombine_ ? 2 * big_skips_[nbf_] : 3 * big_skips_[nbf_] ) : big_skips_[nbf_]);
+
+        // single precision AOs take half the space, plus the metric contraction buffers
+        if (single_precision_ && !direct_ && !do_wK_) {
+            required_core_size_ = (big_skips_[nbf_] + 1) / 2 + nthreads_ * naux_ * nbf_;
+        }
     }
 
     // Auxiliary metric
@@ -249,6 +260,14 @@ void DFHelper::print_header() {
     outfile->Printf("    Algorithm:               %11s\n", method_.c_str());
     outfile->Printf("    AO Core:                 %11s\n", (AO_core_ ? "True" : "False"));
     outfile->Printf("    MO Core:                 %11s\n", (MO_core_ ? "True" : "False"));
+    outfile->Printf("    Disk Reads:              %11s\n", (mmap_io_ ? "mmap" : "fread"));
+    outfile->Printf("    Pipelined Transform:     %11s\n", (pipeline_transform_ ? "True" : "False"));
+    if (pipeline_transform_)
+        outfile->Printf("    Pipeline AO Threads:     %11zu\n",
+                        (nthreads_ > 1 ? (pipeline_int_threads_ ? std::min(pipeline_int_threads_, nthreads_ - 1)
+                                                                : nthreads_ / 2)
+                                       : (size_t)1));
+    outfile->Printf("    AO Precision:            %11s\n", (single_precision_ ? "Single" : "Double"));
     outfile->Printf("    Hold Metric:             %11s\n", (hold_met_ ? "True" : "False"));
     outfile->Printf("    Metric Power:            %11.3f\n", mpower_);
     outfile->Printf("    Fitting Condition:       %11.0E\n", condition_);
@@ -378,9 +397,37 @@ void DFHelper::prepare_sparsity() {
         symm_big_skips_[i] = symm_big_skips_[i - 1] + symm_small_skips_[i - 1] * naux_;
     }
 
+    prepare_K_tiles();
+    schwarz_fun_index_.clear();
+    atom_funs_.clear();
+    atom_pairs_.clear();
+
     sparsity_prepared_ = true;
     timer_off("DFH: sparsity prep");
 }
+void DFHelper::prepare_K_tiles() {
+    // functions are ordered by shell and shells by atom, so atoms are contiguous
+    // ranges. tiny atoms (hydrogens) are merged with their neighbors to keep the
+    // tile GEMMs reasonably sized.
+    const size_t min_tile = 16;
+
+    K_tiles_.clear();
+    K_tiles_.push_back(0);
+    size_t tile_size = 0;
+    for (size_t MU = 0; MU < pshells_; MU++) {
+        tile_size += primary_->shell(MU).nfunction();
+        bool atom_end = (MU + 1 == pshells_ || primary_->shell(MU + 1).ncenter() != primary_->shell(MU).ncenter());
+        if (atom_end && tile_size >= min_tile) {
+            K_tiles_.push_back(primary_->shell(MU).function_index() + primary_->shell(MU).nfunction());
+            tile_size = 0;
+        }
+    }
+    if (K_tiles_.back() != nbf_) {
+        // the remainder is too small for its own tile, fold it into the last one
+        if (K_tiles_.size() > 1) K_tiles_.pop_back();
+        K_tiles_.push_back(nbf_);
+    }
+}
 
 void DFHelper::prepare_AO() {
     // prepare eris
@@ -493,9 +540,14 @@ void DFHelper::prepare_AO_core() {
     std::vector<std::pair<size_t, size_t>> psteps;
     std::pair<size_t, size_t> plargest = pshell_blocks_for_AO_build(memory_, 1, psteps);
 
-    // allocate final AO vector
+    // allocate final AO vector, only the STORE method keeps single precision AOs
+    bool single = single_precision_ && !direct_ && !direct_iaQ_;
+    Ppq_.reset();
+    Ppq_sp_.reset();
     if (direct_iaQ_) {
         Ppq_ = std::unique_ptr<double[]>(new double[naux_ * nbf_ * nbf_]);
+    } else if (single) {
+        Ppq_sp_ = std::unique_ptr<float[]>(new float[big_skips_[nbf_]]);
     } else {
         Ppq_ = std::unique_ptr<double[]>(new double[big_skips_[nbf_]]);
     }
@@ -540,7 +592,11 @@ void DFHelper::prepare_AO_core() {
 
             // contract metric
             timer_on("DFH: AO-Met. Contraction");
-            contract_metric_AO_core_symm(Mp, ppq, metp, begin, end);
+            if (single) {
+                contract_metric_AO_core_symm_sp(Mp, Ppq_sp_.get(), metp, begin, end);
+            } else {
+                contract_metric_AO_core_symm(Mp, ppq, metp, begin, end);
+            }
             timer_off("DFH: AO-Met. Contraction");
         }
         // no more need for metrics
@@ -741,6 +797,9 @@ std::pair<size_t, size_t> DFHelper::Qshell_blocks_for_transform(const size_t mem
 
         size_t constraint = total + (wtmp * nbf_ + 2 * wfinal) * tmpbs + extra;
         // AOs + worst half transformed + worst final
+        // a pipelined transform double buffers the AOs and the final buffers being written
+        if (pipeline_transform_ && !AO_core_) constraint += total;
+        if (pipeline_transform_ && !MO_core_) constraint += 2 * wfinal * tmpbs;
         if (constraint > mem || i == Qshells_ - 1) {
             if (count == 1 && i != Qshells_ - 1) {
                 std::stringstream error;
@@ -824,6 +883,7 @@ std::tuple<size_t, size_t> DFHelper::Qshell_blocks_for_JK_build(std::vector<std:
 }
 
 FILE* DFHelper::stream_check(std::string filename, std::string op) {
+    std::lock_guard<std::mutex> lock(stream_lock_);
     if (file_streams_.count(filename) == 0) {
         file_streams_[filename] = std::make_shared<Stream>(filename, op);
     }
@@ -843,6 +903,7 @@ DFHelper::StreamStruct::StreamStruct(std::string filename, std::string op, bool
 DFHelper::StreamStruct::StreamStruct() {}
 
 DFHelper::StreamStruct::~StreamStruct() {
+    close_map();
     fflush(fp_);
     fclose(fp_);
     std::remove(filename_.c_str());
@@ -874,6 +935,95 @@ void DFHelper::StreamStruct::close_stream() {
     fclose(fp_);
 }
 
+const double* DFHelper::StreamStruct::get_map(size_t& size) {
+#ifdef _MSC_VER
+    throw PSIEXCEPTION("DFHelper:get_map: memory-mapped reads are not available on this platform");
+#else
+    // pending writes must reach the file before it is read through the map
+    if (open_) fflush(fp_);
+
+    struct stat st;
+    if (stat(filename_.c_str(), &st)) {
+        std::stringstream error;
+        error << "DFHelper:get_map: unable to stat " << filename_;
+        throw PSIEXCEPTION(error.str().c_str());
+    }
+    size_t bytes = static_cast<size_t>(st.st_size);
+
+    // the map covers the whole file, a grown file is mapped again
+    if (map_ && bytes != map_bytes_) close_map();
+    if (!map_ && bytes) {
+        int fd = open(filename_.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::stringstream error;
+            error << "DFHelper:get_map: unable to open " << filename_;
+            throw PSIEXCEPTION(error.str().c_str());
+        }
+        void* map = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (map == MAP_FAILED) {
+            std::stringstream error;
+            error << "DFHelper:get_map: unable to map " << filename_;
+            throw PSIEXCEPTION(error.str().c_str());
+        }
+        madvise(map, bytes, MADV_SEQUENTIAL);
+        map_ = map;
+        map_bytes_ = bytes;
+    }
+
+    size = map_bytes_ / sizeof(double);
+    return static_cast<const double*>(map_);
+#endif
+}
+
+void DFHelper::StreamStruct::close_map() {
+#ifndef _MSC_VER
+    if (map_) munmap(map_, map_bytes_);
+#endif
+    map_ = nullptr;
+    map_bytes_ = 0;
+}
+
+const double* DFHelper::map_check(std::string filename, size_t& size) {
+    std::lock_guard<std::mutex> lock(stream_lock_);
+    if (file_streams_.count(filename) == 0) {
+        file_streams_[filename] = std::make_shared<Stream>(filename, "rb");
+    }
+
+    return file_streams_[filename]->get_map(size);
+}
+
+void DFHelper::get_tensor_map(std::string file, double* b, size_t offset, size_t a0, size_t a1, size_t A1) {
+    size_t size;
+    const double* Mp = map_check(file, size);
+
+    size_t last = offset + (a0 - 1) * A1 + a1;
+    if (!a0 || !a1 || last > size) {
+        std::stringstream error;
+        error << "DFHelper:get_tensor: read error";
+        throw PSIEXCEPTION(error.str().c_str());
+    }
+
+    if (A1 == a1) {
+        std::memcpy(b, &Mp[offset], a0 * a1 * sizeof(double));
+    } else {
+        for (size_t i = 0; i < a0; i++) std::memcpy(&b[i * a1], &Mp[offset + i * A1], a1 * sizeof(double));
+    }
+
+#ifndef _MSC_VER
+    // blocks are read in order, ask for the next one (same rows, following columns
+    // for strided reads) while the caller works on this one
+    size_t next = (A1 == a1 ? last : offset + a1);
+    size_t stop = std::min(size, (A1 == a1 ? last + a0 * a1 : last + a1));
+    if (next < stop) {
+        size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        size_t begin = (next * sizeof(double) / page) * page;
+        size_t end = stop * sizeof(double);
+        madvise(const_cast<char*>(reinterpret_cast<const char*>(Mp)) + begin, end - begin, MADV_WILLNEED);
+    }
+#endif
+}
+
 void DFHelper::put_tensor(std::string file, double* b, std::pair<size_t, size_t> i0, std::pair<size_t, size_t> i1,
                           std::pair<size_t, size_t> i2, std::string op) {
     // collapse to 2D, assume file has form (i1 | i2 i3)
@@ -961,6 +1111,13 @@ void DFHelper::put_tensor_AO(std::string file, double* Mp, size_t size, size_t s
     }
 }
 void DFHelper::get_tensor_AO(std::string file, double* Mp, size_t size, size_t start) {
+#ifndef _MSC_VER
+    if (mmap_io_) {
+        get_tensor_map(file, Mp, start, 1, size, size);
+        return;
+    }
+#endif
+
     // begin stream
     FILE* fp = stream_check(file, "rb");
 
@@ -1020,6 +1177,13 @@ void DFHelper::get_tensor_(std::string file, double* b, const size_t start1, con
     size_t A1 = std::get<1>(sizes) * std::get<2>(sizes);
     size_t st = A1 - a1;
 
+#ifndef _MSC_VER
+    if (mmap_io_) {
+        get_tensor_map(file, b, start1 * A1 + start2, a0, a1, A1);
+        return;
+    }
+#endif
+
     // check stream
     FILE* fp = stream_check(file, "rb");
 
@@ -1087,7 +1251,7 @@ void DFHelper::compute_dense_Qpq_blocking_Q(const size_t start, const size_t sto
         buffer[rank] = eri[rank]->buffer();
     }
 
-#pragma omp parallel for schedule(guided) num_threads(nthreads_)
+#pragma omp parallel for schedule(guided) num_threads(nthread)
     for (size_t MU = 0; MU < pshells_; MU++) {
         int rank = 0;
 #ifdef _OPENMP
@@ -1142,7 +1306,7 @@ void DFHelper::compute_sparse_pQq_blocking_Q(const size_t start, const size_t st
         buffer[rank] = eri[rank]->buffer();
     }
 
-#pragma omp parallel for schedule(guided) num_threads(nthreads_)
+#pragma omp parallel for schedule(guided) num_threads(nthread)
     for (size_t MU = 0; MU < pshells_; MU++) {
         int rank = 0;
 #ifdef _OPENMP
@@ -1637,6 +1801,39 @@ void DFHelper::contract_metric_AO_core_symm(double* Qpq, double* Ppq, double* me
         }
     }
 }
+void DFHelper::contract_metric_AO_core_symm_sp(double* Qpq, float* Ppq, double* metp, size_t begin, size_t end) {
+    // contract in double precision, round on the way into the stored AOs
+    size_t startind = symm_big_skips_[begin];
+    std::vector<std::vector<double>> buffers(nthreads_);
+#pragma omp parallel for num_threads(nthreads_) schedule(guided)
+    for (size_t j = begin; j <= end; j++) {
+        int rank = 0;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        size_t mi = symm_small_skips_[j];
+        size_t si = small_skips_[j];
+        size_t jump = symm_ignored_columns_[j];
+        size_t skip1 = big_skips_[j];
+        size_t skip2 = symm_big_skips_[j] - startind;
+        std::vector<double>& buf = buffers[rank];
+        if (buf.size() < naux_ * mi) buf.resize(naux_ * mi);
+        C_DGEMM('N', 'N', naux_, mi, naux_, 1.0, metp, naux_, &Qpq[skip2], mi, 0.0, buf.data(), mi);
+
+        // upper columns m >= j of row j, mirrored into row m
+        for (size_t m = j, c = 0; m < nbf_; m++) {
+            if (!schwarz_fun_mask_[j * nbf_ + m]) continue;
+            size_t sm = small_skips_[m];
+            size_t col = schwarz_fun_mask_[m * nbf_ + j] - 1;
+            for (size_t Q = 0; Q < naux_; Q++) {
+                float val = static_cast<float>(buf[Q * mi + c]);
+                Ppq[skip1 + Q * si + jump + c] = val;
+                Ppq[big_skips_[m] + Q * sm + col] = val;
+            }
+            c++;
+        }
+    }
+}
 void DFHelper::copy_upper_lower_wAO_core_symm(double* Qpq, double* Ppq, size_t begin, size_t end) {
     // copy out of symm
     size_t startind = symm_big_skips_[begin];
@@ -1866,7 +2063,7 @@ void DFHelper::transform() {
         std::unique_ptr<double[]> N;
         double* Tp = T.get();
         double* Fp = F.get();
-        double* Np;
+        double* Np = nullptr;
         if (!MO_core_) {
             N = std::unique_ptr<double[]>(new double[max_block * wfinal]);
             Np = N.get();
@@ -1882,6 +2079,54 @@ void DFHelper::transform() {
             Mp = Ppq_.get();
         }
 
+        // pipelined transforms: the next AO block is produced into the second AO
+        // buffer, and MO blocks are written from alternating final buffers
+        bool pipeline_AO = pipeline_transform_ && !AO_core_;
+        bool pipeline_MO = pipeline_transform_ && !MO_core_;
+        std::unique_ptr<double[]> M2, F2, N2;
+        double* AO_buffers[2] = {Mp, nullptr};
+        double* F_buffers[2] = {Fp, nullptr};
+        double* N_buffers[2] = {Np, nullptr};
+        if (pipeline_AO) {
+            M2 = std::unique_ptr<double[]>(new double[std::get<0>(Qlargest)]);
+            AO_buffers[1] = M2.get();
+        }
+        if (pipeline_MO) {
+            F2 = std::unique_ptr<double[]>(new double[max_block * wfinal]);
+            N2 = std::unique_ptr<double[]>(new double[max_block * wfinal]);
+            F_buffers[1] = F2.get();
+            N_buffers[1] = N2.get();
+        }
+        std::future<void> next_AO, last_write;
+        size_t wbuf = 0;
+
+        // a pipelined transform splits the threads between the integral team on the helper
+        // thread and the BLAS team of the transformation, instead of running two full teams
+        size_t n_int = nthreads_;
+        size_t n_blas = nthreads_;
+        if (pipeline_AO && nthreads_ > 1) {
+            n_int = (pipeline_int_threads_ ? std::min(pipeline_int_threads_, nthreads_ - 1) : nthreads_ / 2);
+            n_blas = nthreads_ - n_int;
+        }
+        std::vector<std::shared_ptr<TwoBodyAOInt>> eri_int(eri.begin(), eri.begin() + n_int);
+#ifdef _OPENMP
+        int omp_nthread_old = omp_get_max_threads();
+        if (pipeline_AO) omp_set_num_threads(n_blas);
+#endif
+
+        // no timers in here, it runs on the helper thread when pipelined
+        auto fetch_AO = [&](size_t step, double* buf) {
+            size_t sta = std::get<0>(Qsteps[step]);
+            size_t sto = std::get<1>(Qsteps[step]);
+            if (direct_iaQ_) {
+                compute_dense_Qpq_blocking_Q(sta, sto, buf, eri_int);
+            } else if (direct_) {
+                compute_sparse_pQq_blocking_Q(sta, sto, buf, eri_int);
+            } else {
+                grab_AO(sta, sto, buf);
+            }
+        };
+
         // transform in steps, blocking over the auxiliary basis (Q blocks)
         for (size_t j = 0, bcount = 0, block_size; j < Qsteps.size(); j++, bcount += block_size) {
             // Qshell step info
@@ -1898,6 +2143,21 @@ void DFHelper::transform() {
             // get AO chunk according to directives
             if (AO_core_) {
                 ;  // pass
+            } else if (pipeline_AO) {
+                // wait for this block, then start on the next one
+                timer_on("DFH: Total Workflow");
+                timer_on("DFH: Pipeline AO Wait");
+                Mp = AO_buffers[j % 2];
+                if (j == 0) {
+                    fetch_AO(j, Mp);
+                } else {
+                    next_AO.get();
+                }
+                if (j + 1 < Qsteps.size()) {
+                    next_AO = std::async(std::launch::async, fetch_AO, j + 1, AO_buffers[(j + 1) % 2]);
+                }
+                timer_off("DFH: Pipeline AO Wait");
+                timer_off("DFH: Total Workflow");
             } else if (direct_iaQ_) {
                 timer_on("DFH: Total Workflow");
                 compute_dense_Qpq_blocking_Q(start, stop, Mp, eri);
@@ -1931,7 +2191,7 @@ void DFHelper::transform() {
                     C_DGEMM('N', 'N', block_size * nbf_, bsize, nbf_, 1.0, &Mp[bump], nbf_, Bp, bsize, 0.0, Tp, bsize);
                 } else {
                     // (bq)(p|Qq)->(p|Qb)
-                    first_transform_pQq(bsize, bcount, block_size, Mp, Tp, Bp, C_buffers);
+                    first_transform_pQq(bsize, bcount, block_size, Mp, Tp, Bp, C_buffers, n_blas);
                 }
                 timer_off("DFH: 1st Contraction");
                 timer_off("DFH: Total Transform");
@@ -1954,6 +2214,10 @@ void DFHelper::transform() {
                         Fp = transf_core_[order_[count + k]].get();
                     } else if (MO_core_) {
                         Np = transf_core_[order_[count + k]].get();
+                    } else if (pipeline_MO) {
+                        // the other pair of buffers may still be on its way to disk
+                        Fp = F_buffers[wbuf];
+                        Np = N_buffers[wbuf];
                     }
 
                     // perform final contraction
@@ -1965,14 +2229,14 @@ void DFHelper::transform() {
                         size_t bump = (MO_core_ ? begin * wsize * bsize : 0);
                         // (pw)(Q|pb)->(Q|bw)
                         if (bleft) {
-#pragma omp parallel for num_threads(nthreads_)
+#pragma omp parallel for num_threads(n_blas)
                             for (size_t i = 0; i < block_size; i++) {
                                 C_DGEMM('T', 'N', bsize, wsize, nbf_, 1.0, &Tp[i * nbf_ * bsize], bsize, Wp, wsize, 0.0,
                                         &Fp[bump + i * wsize * bsize], wsize);
                             }
                         } else {
 // (pw)(Q|pb)->(Q|wb)
-#pragma omp parallel for num_threads(nthreads_)
+#pragma omp parallel for num_threads(n_blas)
                             for (size_t i = 0; i < block_size; i++) {
                                 C_DGEMM('T', 'N', wsize, bsize, nbf_, 1.0, Wp, wsize, &Tp[i * nbf_ * bsize], bsize, 0.0,
                                         &Fp[bump + i * wsize * bsize], bsize);
@@ -1989,7 +2253,22 @@ void DFHelper::transform() {
 
                     // put the transformations away
                     timer_on("DFH: MO to disk");
-                    if (direct_iaQ_) {
+                    if (pipeline_MO) {
+                        // one write in flight at a time keeps the file order; the writer sorts
+                        // serially so it does not compete with the transformation's BLAS team
+                        if (last_write.valid()) last_write.get();
+                        size_t ind = count + k;
+                        size_t bsz = block_size;
+                        size_t bct = bcount;
+                        last_write = std::async(std::launch::async, [=]() {
+                            if (direct_iaQ_) {
+                                put_transformations_Qpq(begin, end, wsize, bsize, Fp, ind, bleft);
+                            } else {
+                                put_transformations_pQq(begin, end, bsz, bct, wsize, bsize, Np, Fp, ind, bleft, 1);
+                            }
+                        });
+                        wbuf = 1 - wbuf;
+                    } else if (direct_iaQ_) {
                         put_transformations_Qpq(begin, end, wsize, bsize, Fp, count + k, bleft);
                     } else {
                         put_transformations_pQq(begin, end, block_size, bcount, wsize, bsize, Np, Fp, count + k, bleft);
@@ -1998,6 +2277,16 @@ void DFHelper::transform() {
                 }
             }
         }
+
+        // drain the pipeline before the buffers go
+        if (last_write.valid()) {
+            timer_on("DFH: MO to disk");
+            last_write.get();
+            timer_off("DFH: MO to disk");
+        }
+#ifdef _OPENMP
+        if (pipeline_AO) omp_set_num_threads(omp_nthread_old);
+#endif
     }  // buffers destroyed with std housekeeping
 
     // outfile->Printf("\n     ==> DFHelper:--End Transformations (disk)<==\n\n");
@@ -2102,9 +2391,10 @@ void DFHelper::transform() {
 }
 
 void DFHelper::first_transform_pQq(size_t bsize, size_t bcount, size_t block_size, double* Mp, double* Tp, double* Bp,
-                                   std::vector<std::vector<double>>& C_buffers) {
+                                   std::vector<std::vector<double>>& C_buffers, size_t nthread) {
+    if (!nthread) nthread = nthreads_;
 // perform first contraction on pQq, thread over p.
-#pragma omp parallel for schedule(guided) num_threads(nthreads_)
+#pragma omp parallel for schedule(guided) num_threads(nthread)
     for (size_t k = 0; k < nbf_; k++) {
         // truncate transformation matrix according to fun_mask
         size_t sp_size = small_skips_[k];
@@ -2148,11 +2438,12 @@ void DFHelper::put_transformations_Qpq(int begin, int end, int wsize, int bsize,
 }
 
 void DFHelper::put_transformations_pQq(int begin, int end, int rblock_size, int bcount, int wsize, int bsize,
-                                       double* Np, double* Fp, int ind, bool bleft) {
+                                       double* Np, double* Fp, int ind, bool bleft, size_t nthread) {
     // incoming transformed integrals to this function are in a pQq format.
     // first, the integrals are tranposed to the desired format specified in add_transformation().
     // if MO_core is on, then the LHS buffers are final destinations.
     // else, the buffers are put to disk.
+    if (!nthread) nthread = nthreads_;
 
     // setup ~
     int lblock_size = rblock_size;
@@ -2169,7 +2460,7 @@ void DFHelper::put_transformations_pQq(int begin, int end, int rblock_size, int
         // result is in pqQ format
         if (std::get<2>(transf_[order_[ind]]) == 2) {
 // (w|Qb)->(bw|Q)
-#pragma omp parallel for num_threads(nthreads_)
+#pragma omp parallel for num_threads(nthread)
             for (size_t z = 0; z < wsize; z++) {
                 for (size_t y = 0; y < bsize; y++) {
                     for (size_t x = 0; x < rblock_size; x++) {
@@ -2186,7 +2477,7 @@ void DFHelper::put_transformations_pQq(int begin, int end, int rblock_size, int
             // result is in Qpq format
         } else if (std::get<2>(transf_[order_[ind]]) == 0) {
 // (w|Qb)->(Q|bw)
-#pragma omp parallel for num_threads(nthreads_)
+#pragma omp parallel for num_threads(nthread)
             for (size_t x = 0; x < rblock_size; x++) {
                 for (size_t z = 0; z < wsize; z++) {
                     for (size_t y = 0; y < bsize; y++) {
@@ -2202,7 +2493,7 @@ void DFHelper::put_transformations_pQq(int begin, int end, int rblock_size, int
             // result is in pQq format
         } else {
 // (w|Qb)->(bQw)
-#pragma omp parallel for num_threads(nthreads_)
+#pragma omp parallel for num_threads(nthread)
             for (size_t x = 0; x < rblock_size; x++) {
                 for (size_t y = 0; y < bsize; y++) {
                     for (size_t z = 0; z < wsize; z++) {
@@ -2221,7 +2512,7 @@ void DFHelper::put_transformations_pQq(int begin, int end, int rblock_size, int
         // result is in pqQ format
         if (std::get<2>(transf_[order_[ind]]) == 2) {
 // (w|Qb)->(wbQ)
-#pragma omp parallel for num_threads(nthreads_)
+#pragma omp parallel for num_threads(nthread)
             for (size_t z = 0; z < wsize; z++) {
                 for (size_t x = 0; x < rblock_size; x++) {
                     for (size_t y = 0; y < bsize; y++) {
@@ -2238,7 +2529,7 @@ void DFHelper::put_transformations_pQq(int begin, int end, int rblock_size, int
             // result is in Qpq format
         } else if (std::get<2>(transf_[order_[ind]]) == 0) {
 // (w|Qb)->(Q|wb)
-#pragma omp parallel for num_threads(nthreads_)
+#pragma omp parallel for num_threads(nthread)
             for (size_t x = 0; x < rblock_size; x++) {
                 for (size_t z = 0; z < wsize; z++) {
                     C_DCOPY(bsize, &Fp[z * rblock_size * bsize + x * bsize], 1,
@@ -2258,7 +2549,7 @@ void DFHelper::put_transformations_pQq(int begin, int end, int rblock_size, int
                            std::make_pair(0, bsize - 1), op);
             } else {
 // we have to copy over the buffer
-#pragma omp parallel for num_threads(nthreads_)
+#pragma omp parallel for num_threads(nthread)
                 for (size_t x = 0; x < wsize; x++) {
                     for (size_t y = 0; y < rblock_size; y++) {
                         C_DCOPY(bsize, &Fp[x * rblock_size * bsize + y * bsize], 1,
@@ -2992,6 +3283,12 @@ void DFHelper::compute_JK(std::vector<SharedMatrix> Cleft, std::vector<SharedMat
     // size checks for C matrices occur in jk.cc
     // computing D occurs inside of jk.cc
 
+    // single precision AOs have their own contractions
+    if (Ppq_sp_) {
+        compute_JK_sp(Cleft, Cright, D, J, K, max_nocc, do_J, do_K, lr_symmetric);
+        return;
+    }
+
     // determine buffer sizes and blocking scheme
     // would love to move this to initialize(), but
     // we would need to know max_nocc_ beforehand
@@ -3059,6 +3356,13 @@ void DFHelper::compute_JK(std::vector<SharedMatrix> Cleft, std::vector<SharedMat
         M1p = m1Ppq_.get();
     }
 
+    // the local K domains only depend on the orbitals, not on the Q block
+    if (do_K && local_K_ && lr_symmetric) {
+        timer_on("DFH: local K domains");
+        prepare_K_local(Cleft);
+        timer_off("DFH: local K domains");
+    }
+
     // transform in steps (blocks of Q)
     for (size_t j = 0, bcount = 0; j < Qsteps.size(); j++) {
         // Qshell step info
@@ -3098,6 +3402,140 @@ void DFHelper::compute_JK(std::vector<SharedMatrix> Cleft, std::vector<SharedMat
     }
     // outfile->Printf("\n     ==> DFHelper:--End J/K Builds (disk)<==\n\n");
 }
+void DFHelper::compute_JK_sp(std::vector<SharedMatrix> Cleft, std::vector<SharedMatrix> Cright,
+                             std::vector<SharedMatrix> D, std::vector<SharedMatrix> J, std::vector<SharedMatrix> K,
+                             size_t max_nocc, bool do_J, bool do_K, bool lr_symmetric) {
+    float* Mp = Ppq_sp_.get();
+
+    if (do_K && (block_sparse_K_ || (local_K_ && lr_symmetric)))
+        throw PSIEXCEPTION("DFHelper:compute_JK: block-sparse and local K are not available with single precision AOs");
+
+    // significant m for each p, in the column order of the sparse pQq blocks
+    std::vector<std::vector<size_t>> funs(nbf_);
+    for (size_t p = 0; p < nbf_; p++) {
+        funs[p].reserve(small_skips_[p]);
+        for (size_t m = 0; m < nbf_; m++) {
+            if (schwarz_fun_mask_[p * nbf_ + m]) funs[p].push_back(m);
+        }
+    }
+
+    // J is memory bound, accumulate it in double precision
+    if (do_J) {
+        timer_on("DFH: compute_J");
+        for (size_t N = 0; N < J.size(); N++) {
+            double* Dp = D[N]->pointer()[0];
+            double* Jp = J[N]->pointer()[0];
+
+            // V_Q = (Q|pm) D_pm
+            std::vector<std::vector<double>> V_buffers(nthreads_);
+#pragma omp parallel num_threads(nthreads_)
+            {
+                int rank = 0;
+#ifdef _OPENMP
+                rank = omp_get_thread_num();
+#endif
+                V_buffers[rank].assign(naux_, 0.0);
+                std::vector<double> Dsub(nbf_);
+#pragma omp for schedule(guided)
+                for (size_t p = 0; p < nbf_; p++) {
+                    size_t sp_size = small_skips_[p];
+                    float* Bp = &Mp[big_skips_[p]];
+                    for (size_t s = 0; s < sp_size; s++) Dsub[s] = Dp[p * nbf_ + funs[p][s]];
+                    for (size_t Q = 0; Q < naux_; Q++) {
+                        double val = 0.0;
+                        for (size_t s = 0; s < sp_size; s++) val += Bp[Q * sp_size + s] * Dsub[s];
+                        V_buffers[rank][Q] += val;
+                    }
+                }
+            }
+            std::vector<double> V(naux_, 0.0);
+            for (size_t t = 0; t < V_buffers.size(); t++) {
+                for (size_t Q = 0; Q < naux_; Q++) V[Q] += V_buffers[t][Q];
+            }
+
+            // J_pm = (Q|pm) V_Q
+#pragma omp parallel num_threads(nthreads_)
+            {
+                std::vector<double> Jsub(nbf_);
+#pragma omp for schedule(guided)
+                for (size_t p = 0; p < nbf_; p++) {
+                    size_t sp_size = small_skips_[p];
+                    float* Bp = &Mp[big_skips_[p]];
+                    std::fill(Jsub.begin(), Jsub.begin() + sp_size, 0.0);
+                    for (size_t Q = 0; Q < naux_; Q++) {
+                        for (size_t s = 0; s < sp_size; s++) Jsub[s] += Bp[Q * sp_size + s] * V[Q];
+                    }
+                    for (size_t s = 0; s < sp_size; s++) Jp[p * nbf_ + funs[p][s]] += Jsub[s];
+                }
+            }
+        }
+        timer_off("DFH: compute_J");
+    }
+
+    if (!do_K || !max_nocc) return;
+
+    // K in Q blocks with single precision GEMMs, accumulated into the double K
+    timer_on("DFH: compute_K");
+    std::vector<std::pair<size_t, size_t>> Qsteps;
+    std::tuple<size_t, size_t> info = Qshell_blocks_for_JK_build(Qsteps, max_nocc, lr_symmetric);
+    size_t totsb = std::get<1>(info);
+
+    std::vector<float> T1(nbf_ * max_nocc * totsb);
+    std::vector<float> T2((lr_symmetric ? 0 : nbf_ * max_nocc * totsb));
+    std::vector<float> Kf(nbf_ * nbf_);
+    std::vector<float> Cl(nbf_ * max_nocc), Cr(nbf_ * max_nocc);
+    std::vector<std::vector<float>> C_buffers(nthreads_, std::vector<float>(nbf_ * max_nocc));
+
+    // (Q|pm) C_mi -> (p|Qi) for the rows of the Q block
+    auto first_transform = [&](size_t nocc, size_t bcount, size_t block_size, float* Cp, float* Tp) {
+#pragma omp parallel for schedule(guided) num_threads(nthreads_)
+        for (size_t p = 0; p < nbf_; p++) {
+            int rank = 0;
+#ifdef _OPENMP
+            rank = omp_get_thread_num();
+#endif
+            size_t sp_size = small_skips_[p];
+            size_t jump = big_skips_[p] + bcount * sp_size;
+            float* Cb = C_buffers[rank].data();
+            for (size_t s = 0; s < sp_size; s++) {
+                std::copy(&Cp[funs[p][s] * nocc], &Cp[funs[p][s] * nocc] + nocc, &Cb[s * nocc]);
+            }
+            C_SGEMM('N', 'N', block_size, nocc, sp_size, 1.0f, &Mp[jump], sp_size, Cb, nocc, 0.0f,
+                    &Tp[p * block_size * nocc], nocc);
+        }
+    };
+
+    for (size_t j = 0, bcount = 0; j < Qsteps.size(); j++) {
+        size_t begin = Qshell_aggs_[std::get<0>(Qsteps[j])];
+        size_t end = Qshell_aggs_[std::get<1>(Qsteps[j]) + 1] - 1;
+        size_t block_size = end - begin + 1;
+
+        for (size_t N = 0; N < K.size(); N++) {
+            size_t nocc = Cleft[N]->colspi()[0];
+            if (!nocc) continue;
+
+            double* Clp = Cleft[N]->pointer()[0];
+            double* Crp = Cright[N]->pointer()[0];
+            for (size_t i = 0; i < nbf_ * nocc; i++) Cl[i] = static_cast<float>(Clp[i]);
+            first_transform(nocc, bcount, block_size, Cl.data(), T1.data());
+
+            float* T2p = T1.data();
+            if (!lr_symmetric) {
+                for (size_t i = 0; i < nbf_ * nocc; i++) Cr[i] = static_cast<float>(Crp[i]);
+                first_transform(nocc, bcount, block_size, Cr.data(), T2.data());
+                T2p = T2.data();
+            }
+
+            size_t width = nocc * block_size;
+            C_SGEMM('N', 'T', nbf_, nbf_, width, 1.0f, T1.data(), width, T2p, width, 0.0f, Kf.data(), nbf_);
+
+            double* Kp = K[N]->pointer()[0];
+            for (size_t i = 0; i < nbf_ * nbf_; i++) Kp[i] += Kf[i];
+        }
+        bcount += block_size;
+    }
+    timer_off("DFH: compute_K");
+}
 void DFHelper::compute_J_symm(std::vector<SharedMatrix> D, std::vector<SharedMatrix> J, double* Mp, double* T1p,
                               double* T2p, std::vector<std::vector<double>>& D_buffers, size_t bcount,
                               size_t block_size) {
@@ -3287,6 +3725,12 @@ void DFHelper::compute_J_combined(std::vector<SharedMatrix> D, std::vector<Share
 void DFHelper::compute_K(std::vector<SharedMatrix> Cleft, std::vector<SharedMatrix> Cright, std::vector<SharedMatrix> K,
                          double* T1p, double* T2p, double* Mp, size_t bcount, size_t block_size,
                          std::vector<std::vector<double>>& C_buffers, bool lr_symmetric) {
+    // localized orbitals are contracted domain by domain
+    if (local_K_ && lr_symmetric) {
+        compute_K_local(Cleft, K, T1p, Mp, bcount, block_size);
+        return;
+    }
+
     for (size_t i = 0; i < K.size(); i++) {
         size_t nocc = Cleft[i]->colspi()[0];
         if (!nocc) {
@@ -3308,8 +3752,246 @@ void DFHelper::compute_K(std::vector<SharedMatrix> Cleft, std::vector<SharedMatr
         }
 
         // compute K
-        C_DGEMM('N', 'T', nbf_, nbf_, nocc * block_size, 1.0, T1p, nocc * block_size, T2p, nocc * block_size, 1.0, Kp,
-                nbf_);
+        if (block_sparse_K_) {
+            compute_K_tiles(T1p, T2p, Kp, nocc, block_size, lr_symmetric);
+        } else {
+            C_DGEMM('N', 'T', nbf_, nbf_, nocc * block_size, 1.0, T1p, nocc * block_size, T2p, nocc * block_size, 1.0,
+                    Kp, nbf_);
+        }
+    }
+}
+void DFHelper::compute_K_tiles(double* T1p, double* T2p, double* Kp, size_t nocc, size_t block_size,
+                               bool lr_symmetric) {
+    size_t ntiles = K_tiles_.size() - 1;
+    size_t width = nocc * block_size;
+
+    // per (tile, orbital) norms over the aux index bound each K tile,
+    //   |K_AB| <= \sum_i |T1_{A,i}| |T2_{B,i}|
+    // which is far tighter than |T1_A| |T2_B| once the orbitals are spatially confined
+    std::vector<double> norm1(ntiles * nocc, 0.0);
+    std::vector<double> norm2(lr_symmetric ? 0 : ntiles * nocc, 0.0);
+#pragma omp parallel for schedule(guided) num_threads(nthreads_)
+    for (size_t A = 0; A < ntiles; A++) {
+        double* n1 = &norm1[A * nocc];
+        double* n2 = (lr_symmetric ? nullptr : &norm2[A * nocc]);
+        for (size_t p = K_tiles_[A]; p < K_tiles_[A + 1]; p++) {
+            for (size_t Q = 0; Q < block_size; Q++) {
+                const double* T1row = &T1p[p * width + Q * nocc];
+                for (size_t i = 0; i < nocc; i++) n1[i] += T1row[i] * T1row[i];
+                if (!lr_symmetric) {
+                    const double* T2row = &T2p[p * width + Q * nocc];
+                    for (size_t i = 0; i < nocc; i++) n2[i] += T2row[i] * T2row[i];
+                }
+            }
+        }
+        for (size_t i = 0; i < nocc; i++) {
+            n1[i] = std::sqrt(n1[i]);
+            if (!lr_symmetric) n2[i] = std::sqrt(n2[i]);
+        }
+    }
+    const std::vector<double>& norm2_ref = (lr_symmetric ? norm1 : norm2);
+
+    std::vector<std::pair<size_t, size_t>> tiles;
+    size_t ntotal = 0;
+    for (size_t A = 0; A < ntiles; A++) {
+        for (size_t B = (lr_symmetric ? A : 0); B < ntiles; B++) {
+            ntotal++;
+            double bound = C_DDOT(nocc, const_cast<double*>(&norm1[A * nocc]), 1,
+                                  const_cast<double*>(&norm2_ref[B * nocc]), 1);
+            if (bound >= cutoff_) tiles.push_back(std::make_pair(A, B));
+        }
+    }
+    K_tile_sparsity_ = (ntotal ? 1.0 - (double)tiles.size() / (double)ntotal : 0.0);
+
+    size_t max_tile = 0;
+    for (size_t A = 0; A < ntiles; A++) max_tile = std::max(max_tile, K_tiles_[A + 1] - K_tiles_[A]);
+    std::vector<std::vector<double>> tile_buffers(nthreads_, std::vector<double>(max_tile * max_tile));
+
+    // every tile pair writes to its own K blocks (AB, and BA if lr_symmetric)
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads_)
+    for (size_t ind = 0; ind < tiles.size(); ind++) {
+        int rank = 0;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        size_t A = tiles[ind].first;
+        size_t B = tiles[ind].second;
+        size_t oA = K_tiles_[A], nA = K_tiles_[A + 1] - oA;
+        size_t oB = K_tiles_[B], nB = K_tiles_[B + 1] - oB;
+
+        if (!lr_symmetric || A == B) {
+            C_DGEMM('N', 'T', nA, nB, width, 1.0, &T1p[oA * width], width, &T2p[oB * width], width, 1.0,
+                    &Kp[oA * nbf_ + oB], nbf_);
+        } else {
+            double* Tp = tile_buffers[rank].data();
+            C_DGEMM('N', 'T', nA, nB, width, 1.0, &T1p[oA * width], width, &T2p[oB * width], width, 0.0, Tp, nB);
+            for (size_t a = 0; a < nA; a++) {
+                for (size_t b = 0; b < nB; b++) {
+                    Kp[(oA + a) * nbf_ + oB + b] += Tp[a * nB + b];
+                    Kp[(oB + b) * nbf_ + oA + a] += Tp[a * nB + b];
+                }
+            }
+        }
+    }
+}
+void DFHelper::prepare_K_local(std::vector<SharedMatrix> Cleft) {
+    // significant m for each p, in the column order of the sparse pQq blocks
+    size_t natom = primary_->molecule()->natom();
+    if (schwarz_fun_index_.size() != nbf_) {
+        schwarz_fun_index_.assign(nbf_, std::vector<size_t>());
+        for (size_t p = 0; p < nbf_; p++) {
+            schwarz_fun_index_[p].reserve(small_skips_[p]);
+            for (size_t m = 0; m < nbf_; m++) {
+                if (schwarz_fun_mask_[p * nbf_ + m]) schwarz_fun_index_[p].push_back(m);
+            }
+        }
+
+        // atom blocks of basis functions (contiguous, shells are ordered by center),
+        // and which atom pairs carry significant pQq
+        atom_funs_.assign(natom, std::vector<size_t>());
+        for (size_t m = 0; m < nbf_; m++) atom_funs_[primary_->function_to_center(m)].push_back(m);
+        atom_pairs_.assign(natom * natom, 0);
+        for (size_t MU = 0; MU < pshells_; MU++) {
+            size_t A = primary_->shell_to_center(MU);
+            for (size_t NU = 0; NU < pshells_; NU++) {
+                if (schwarz_shell_mask_[MU * pshells_ + NU]) atom_pairs_[A * natom + primary_->shell_to_center(NU)] = 1;
+            }
+        }
+    }
+
+    double tol2 = local_K_tolerance_ * local_K_tolerance_;
+    size_t domain_total = 0, orbital_total = 0;
+
+    local_K_domains_.assign(Cleft.size(), LocalKDomains());
+    for (size_t N = 0; N < Cleft.size(); N++) {
+        size_t nocc = Cleft[N]->colspi()[0];
+        if (!nocc) continue;
+        double* Cp = Cleft[N]->pointer()[0];
+        LocalKDomains& dom = local_K_domains_[N];
+        dom.in_domain.assign(nocc, std::vector<char>(nbf_, 0));
+        dom.rows.assign(nocc, std::vector<size_t>());
+        std::vector<std::vector<size_t>> row_atoms(nocc);
+        std::vector<size_t> domain_sizes(nocc, 0);
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads_)
+        for (size_t i = 0; i < nocc; i++) {
+            // AO domain: atoms carrying a non-negligible share of the orbital
+            std::vector<char> atom_rows(natom, 0);
+            for (size_t A = 0; A < natom; A++) {
+                double val = 0.0;
+                for (size_t m : atom_funs_[A]) val += Cp[m * nocc + i] * Cp[m * nocc + i];
+                if (val < tol2) continue;
+                domain_sizes[i] += atom_funs_[A].size();
+                for (size_t m : atom_funs_[A]) dom.in_domain[i][m] = 1;
+                for (size_t B = 0; B < natom; B++) {
+                    if (atom_pairs_[A * natom + B]) atom_rows[B] = 1;
+                }
+            }
+
+            // extended domain: the rows p that pair significantly with the AO domain, atom by atom
+            for (size_t B = 0; B < natom; B++) {
+                if (!atom_rows[B]) continue;
+                row_atoms[i].push_back(B);
+                dom.rows[i].insert(dom.rows[i].end(), atom_funs_[B].begin(), atom_funs_[B].end());
+            }
+        }
+
+        // orbitals are stacked in T one after the other, and each atom knows where it sits in every orbital
+        dom.row_offsets.assign(nocc + 1, 0);
+        dom.atom_orbitals.assign(natom, std::vector<std::pair<size_t, size_t>>());
+        for (size_t i = 0; i < nocc; i++) {
+            dom.row_offsets[i + 1] = dom.row_offsets[i] + dom.rows[i].size();
+            size_t offset = 0;
+            for (size_t B : row_atoms[i]) {
+                dom.atom_orbitals[B].push_back(std::make_pair(i, offset));
+                offset += atom_funs_[B].size();
+            }
+            domain_total += domain_sizes[i];
+        }
+        orbital_total += nocc;
+    }
+
+    local_K_domain_fraction_ = (orbital_total ? (double)domain_total / (double)(orbital_total * nbf_) : 1.0);
+}
+void DFHelper::compute_K_local(std::vector<SharedMatrix> Cleft, std::vector<SharedMatrix> K, double* Tp, double* Mp,
+                               size_t bcount, size_t block_size) {
+    size_t natom = atom_funs_.size();
+
+    // upper atom pairs of K; each task owns the blocks AB and BA
+    std::vector<std::pair<size_t, size_t>> atom_blocks;
+    for (size_t A = 0; A < natom; A++) {
+        for (size_t B = A; B < natom; B++) atom_blocks.push_back(std::make_pair(A, B));
+    }
+    size_t max_atom = 0;
+    for (size_t A = 0; A < natom; A++) max_atom = std::max(max_atom, atom_funs_[A].size());
+    std::vector<std::vector<double>> tile_buffers(nthreads_, std::vector<double>(max_atom * max_atom));
+
+    for (size_t N = 0; N < K.size(); N++) {
+        size_t nocc = Cleft[N]->colspi()[0];
+        if (!nocc) continue;
+        double* Cp = Cleft[N]->pointer()[0];
+        double* Kp = K[N]->pointer()[0];
+        const LocalKDomains& dom = local_K_domains_[N];
+
+        // (Q|p i) = (Q|p m) C_{m i} over m in the domain, for the rows p of the extended domain
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads_)
+        for (size_t i = 0; i < nocc; i++) {
+            const std::vector<size_t>& rows = dom.rows[i];
+            const std::vector<char>& in_domain = dom.in_domain[i];
+            double* T = &Tp[dom.row_offsets[i] * block_size];
+            std::fill(T, T + rows.size() * block_size, 0.0);
+            for (size_t r = 0; r < rows.size(); r++) {
+                size_t p = rows[r];
+                size_t sp_size = small_skips_[p];
+                size_t jump = (AO_core_ ? big_skips_[p] + bcount * sp_size : (big_skips_[p] * block_size) / naux_);
+                for (size_t s = 0; s < sp_size; s++) {
+                    size_t m = schwarz_fun_index_[p][s];
+                    if (in_domain[m]) C_DAXPY(block_size, Cp[m * nocc + i], &Mp[jump + s], sp_size, &T[r * block_size], 1);
+                }
+            }
+        }
+
+        // K_AB += \sum_i (Q|A i)(Q|B i) over the orbitals whose extended domain holds both atoms
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads_)
+        for (size_t ind = 0; ind < atom_blocks.size(); ind++) {
+            int rank = 0;
+#ifdef _OPENMP
+            rank = omp_get_thread_num();
+#endif
+            size_t A = atom_blocks[ind].first;
+            size_t B = atom_blocks[ind].second;
+            const std::vector<std::pair<size_t, size_t>>& orbsA = dom.atom_orbitals[A];
+            const std::vector<std::pair<size_t, size_t>>& orbsB = dom.atom_orbitals[B];
+            if (orbsA.empty() || orbsB.empty()) continue;
+            size_t oA = atom_funs_[A].front(), nA = atom_funs_[A].size();
+            size_t oB = atom_funs_[B].front(), nB = atom_funs_[B].size();
+            double* Kt = tile_buffers[rank].data();
+
+            // both lists are ordered by orbital
+            bool touched = false;
+            for (size_t a = 0, b = 0; a < orbsA.size() && b < orbsB.size();) {
+                if (orbsA[a].first < orbsB[b].first) {
+                    a++;
+                } else if (orbsB[b].first < orbsA[a].first) {
+                    b++;
+                } else {
+                    size_t row0 = dom.row_offsets[orbsA[a].first];
+                    C_DGEMM('N', 'T', nA, nB, block_size, 1.0, &Tp[(row0 + orbsA[a].second) * block_size], block_size,
+                            &Tp[(row0 + orbsB[b].second) * block_size], block_size, (touched ? 1.0 : 0.0), Kt, nB);
+                    touched = true;
+                    a++;
+                    b++;
+                }
+            }
+            if (!touched) continue;
+
+            for (size_t a = 0; a < nA; a++) {
+                for (size_t b = 0; b < nB; b++) {
+                    Kp[(oA + a) * nbf_ + oB + b] += Kt[a * nB + b];
+                    if (A != B) Kp[(oB + b) * nbf_ + oA + a] += Kt[a * nB + b];
+                }
+            }
+        }
     }
 }
 void DFHelper::compute_wK(std::vector<SharedMatrix> Cleft, std::vector<SharedMatrix> Cright,
@@ -3367,8 +4049,12 @@ void DFHelper::compute_wK(std::vector<SharedMatrix> Cleft, std::vector<SharedMat
             first_transform_pQq(nocc, bcount, block_size, wMp, T2p, Crp, C_buffers);
 
             // compute wK
-            C_DGEMM('N', 'T', nbf_, nbf_, nocc * block_size, 1.0, T2p, nocc * block_size, T1p, nocc * block_size, 1.0,
-                    wKp, nbf_);
+            if (block_sparse_K_) {
+                compute_K_tiles(T2p, T1p, wKp, nocc, block_size, false);
+            } else {
+                C_DGEMM('N', 'T', nbf_, nbf_, nocc * block_size, 1.0, T2p, nocc * block_size, T1p, nocc * block_size,
+                        1.0, wKp, nbf_);
+            }
         }
         bcount += block_size;
     }
@@ -34,6 +34,7 @@
 
 #include <map>
 #include <list>
+#include <mutex>
 #include <vector>
 #include <tuple>
 #include <string>
@@ -110,10 +111,86 @@ class PSI_API DFHelper {
     void set_MO_core(bool core) { MO_core_ = core; }
     bool get_MO_core() { return MO_core_; }
 
+    ///
+    /// Read on-disk tensors through read-only memory maps instead of
+    /// fread. Each read also advises the kernel to prefetch the block that
+    /// follows it, so disk-mode transformations overlap I/O with compute.
+    /// Ignored where mmap is unavailable. (Defaults to FALSE)
+    /// @param mmap True to read disk tensors through memory maps
+    ///
+    void set_mmap_io(bool mmap) { mmap_io_ = mmap; }
+    bool get_mmap_io() { return mmap_io_; }
+
+    ///
+    /// Pipeline transform() when the AOs are not in core: a helper thread
+    /// fetches (STORE) or computes (DIRECT, DIRECT_iaQ) the AO block of the
+    /// next Q step while the current one is transformed, and the finished
+    /// MO blocks are written out by a second thread while the next
+    /// transformation runs. Costs a second AO buffer and, if not MO_core,
+    /// a second pair of MO buffers. (Defaults to FALSE)
+    /// @param pipeline True to overlap AO generation, transformation and writes
+    ///
+    void set_pipeline_transform(bool pipeline) { pipeline_transform_ = pipeline; }
+    bool get_pipeline_transform() { return pipeline_transform_; }
+
+    ///
+    /// Threads of the AO integral team in a pipelined transform, the
+    /// remaining nthreads - n run the transformation (BLAS) team, so the
+    /// two teams never oversubscribe the cores. (Defaults to 0, half of
+    /// the threads)
+    /// @param n threads for the AO integrals, at most nthreads - 1
+    ///
+    void set_pipeline_int_threads(size_t n) { pipeline_int_threads_ = n; }
+    size_t get_pipeline_int_threads() { return pipeline_int_threads_; }
+
+    ///
+    /// Store the in-core, metric-contracted AOs of the STORE method in single
+    /// precision and build J and K from them with single precision GEMMs.
+    /// Halves the AO memory. Takes effect at the next initialize(), so
+    /// switching back to double precision means calling initialize() again.
+    /// Not used with wK. (Defaults to FALSE)
+    /// @param single True to store the AOs in single precision
+    ///
+    void set_single_precision(bool single) { single_precision_ = single; }
+    bool get_single_precision() { return single_precision_; }
+
+    /// Are the stored AOs currently single precision?
+    bool AO_single_precision() { return (bool)Ppq_sp_; }
+
     /// schwarz screening cutoff (defaults to 1e-12)
     void set_schwarz_cutoff(double cutoff) { cutoff_ = cutoff; }
     double get_schwarz_cutoff() { return cutoff_; }
 
+    ///
+    /// Contract K tile by tile over (merged) atom blocks of basis functions,
+    /// skipping tile pairs whose per-orbital norm bound falls below the schwarz
+    /// cutoff, and only the upper tiles for lr_symmetric builds. Pays off only
+    /// when the orbitals are spatially confined. (Defaults to FALSE)
+    /// @param block_sparse_K True for tiled K contractions
+    ///
+    void set_block_sparse_K(bool block_sparse_K) { block_sparse_K_ = block_sparse_K; }
+    bool get_block_sparse_K() { return block_sparse_K_; }
+
+    /// Returns the fraction of K tile pairs skipped in the last K build
+    double K_tile_sparsity() { return K_tile_sparsity_; }
+
+    ///
+    /// Build lr_symmetric K from localized occupied orbitals, restricting each
+    /// orbital's half-transform to its atomic domain. The caller is responsible
+    /// for passing localized C matrices. (Defaults to FALSE)
+    /// @param local_K True for local K builds
+    ///
+    void set_local_K(bool local_K) { local_K_ = local_K; }
+    bool get_local_K() { return local_K_; }
+
+    /// atoms enter an orbital's domain if sum_{m on A} C_{m i}^2 exceeds the square
+    /// of this tolerance (defaults to 1e-5)
+    void set_local_K_tolerance(double tol) { local_K_tolerance_ = tol; }
+    double get_local_K_tolerance() { return local_K_tolerance_; }
+
+    /// Returns the average fraction of basis functions in the orbital domains of the last K build
+    double local_K_domain_fraction() { return local_K_domain_fraction_; }
+
     /// fitting metric power (defaults to -0.5) to use in
 	/// K_{m n} = C_{l a}(m l|Q)(Q|R)^{-1/2}(R|P)^{-1/2}(P|n s)C_{s a}
     void set_metric_pow(double m_pow) { mpower_ = m_pow; }
@@ -329,6 +406,10 @@ class PSI_API DFHelper {
     double mpower_ = -0.5;
     double wmpower_ = -1.0;
     bool hold_met_ = false;
+    bool mmap_io_ = false;
+    bool pipeline_transform_ = false;
+    size_t pipeline_int_threads_ = 0;
+    bool single_precision_ = false;
     bool built_ = false;
     bool transformed_ = false;
     std::pair<size_t, size_t> info_;
@@ -341,10 +422,16 @@ class PSI_API DFHelper {
     bool debug_ = false;
     bool sparsity_prepared_ = false;
     int print_lvl_ = 1;
+    bool block_sparse_K_ = false;
+    double K_tile_sparsity_ = 0.0;
+    bool local_K_ = false;
+    double local_K_tolerance_ = 1.0E-5;
+    double local_K_domain_fraction_ = 1.0;
 
     // => in-core machinery <=
     void AO_core();
     std::unique_ptr<double[]> Ppq_;
+    std::unique_ptr<float[]> Ppq_sp_;  // if single_precision_ holds the AOs in place of Ppq_
     std::map<double, SharedMatrix> metrics_;
 
     // => in-core wK machinery <=
@@ -369,6 +456,7 @@ class PSI_API DFHelper {
 
 
     void contract_metric_AO_core_symm(double* Qpq, double* Ppq, double* metp, size_t begin, size_t end);
+    void contract_metric_AO_core_symm_sp(double* Qpq, float* Ppq, double* metp, size_t begin, size_t end);
     void grab_AO(const size_t start, const size_t stop, double* Mp);
 
     // => wK AO building machinery <=
@@ -378,8 +466,38 @@ class PSI_API DFHelper {
     void copy_upper_lower_wAO_core_symm(double* Qpq, double* Ppq, size_t begin, size_t end);
 
     // first integral transforms
+    // nthread = 0 uses all nthreads_
     void first_transform_pQq(size_t bsize, size_t bcount, size_t block_size, double* Mp, double* Tp, double* Bp,
-                             std::vector<std::vector<double>>& C_buffers);
+                             std::vector<std::vector<double>>& C_buffers, size_t nthread = 0);
+
+    // => K tiles: contiguous atom blocks of basis functions, merged up to a minimum size <=
+    std::vector<size_t> K_tiles_;
+    void prepare_K_tiles();
+    // K += T1 T2^T over the significant tiles, T1 and T2 are (nbf, block_size, nocc)
+    void compute_K_tiles(double* T1p, double* T2p, double* Kp, size_t nocc, size_t block_size, bool lr_symmetric);
+
+    // => local K: per-orbital atomic domains of localized occupied orbitals <=
+    // significant functions m for each p, in pQq column order (built on first use)
+    std::vector<std::vector<size_t>> schwarz_fun_index_;
+    // basis functions of each atom, and the atom pairs with significant pQq (built on first use)
+    std::vector<std::vector<size_t>> atom_funs_;
+    std::vector<char> atom_pairs_;
+    struct LocalKDomains {
+        // AO domain mask of each orbital, [i][m]
+        std::vector<std::vector<char>> in_domain;
+        // extended-domain rows p of each orbital, atom by atom
+        std::vector<std::vector<size_t>> rows;
+        // first row of each orbital in the stacked (Q|p i), size nocc + 1
+        std::vector<size_t> row_offsets;
+        // orbitals holding each atom, with the atom's first row inside the orbital, [B] -> (i, row)
+        std::vector<std::vector<std::pair<size_t, size_t>>> atom_orbitals;
+    };
+    // one per density, rebuilt once per build_JK call
+    std::vector<LocalKDomains> local_K_domains_;
+    void prepare_K_local(std::vector<SharedMatrix> Cleft);
+    // K += (Q|p i)(Q|q i) by atom-pair blocks, Tp holds the stacked (Q|p i) of all orbitals
+    void compute_K_local(std::vector<SharedMatrix> Cleft, std::vector<SharedMatrix> K, double* Tp, double* Mp,
+                         size_t bcount, size_t block_size);
 
     // => index vectors for screened AOs <=
     std::vector<size_t> small_skips_;
@@ -436,8 +554,9 @@ class PSI_API DFHelper {
     std::pair<size_t, size_t> identify_order();
     void print_order();
     void put_transformations_Qpq(int begin, int end, int wsize, int bsize, double* Fp, int ind, bool bleft);
+    // nthread = 0 uses all nthreads_
     void put_transformations_pQq(int begin, int end, int block_size, int bcount, int wsize, int bsize, double* Np,
-                                 double* Fp, int ind, bool bleft);
+                                 double* Fp, int ind, bool bleft, size_t nthread = 0);
     std::vector<std::pair<std::string, size_t>> sorted_spaces_;
     std::vector<std::string> order_;
     std::vector<std::string> bspace_;
@@ -453,15 +572,27 @@ class PSI_API DFHelper {
         void change_stream(std::string op);
         void close_stream();
 
+        // read-only map of the whole file, remapped when the file grows
+        const double* get_map(size_t& size);
+        void close_map();
+
         FILE* fp_;
         std::string op_;
         bool open_ = false;
         std::string filename_;
+        void* map_ = nullptr;
+        size_t map_bytes_ = 0;
 
     } Stream;
 
     std::map<std::string, std::shared_ptr<Stream>> file_streams_;
+    // guards file_streams_ when a pipelined transform reads and writes from helper threads
+    std::mutex stream_lock_;
     FILE* stream_check(std::string filename, std::string op);
+    // returns the mapped file and its length in doubles
+    const double* map_check(std::string filename, size_t& size);
+    // copies a0 rows of a1 doubles, A1 apart, from the map and prefetches what follows
+    void get_tensor_map(std::string file, double* b, size_t offset, size_t a0, size_t a1, size_t A1);
 
     // => FILE IO machinery <=
     void put_tensor(std::string file, double* b, std::pair<size_t, size_t> a1, std::pair<size_t, size_t> a2,
@@ -500,6 +631,9 @@ class PSI_API DFHelper {
     void compute_JK(std::vector<SharedMatrix> Cleft, std::vector<SharedMatrix> Cright, std::vector<SharedMatrix> D,
                     std::vector<SharedMatrix> J, std::vector<SharedMatrix> K, size_t max_nocc, bool do_J, bool do_K,
                     bool do_wK, bool lr_symmetric);
+    void compute_JK_sp(std::vector<SharedMatrix> Cleft, std::vector<SharedMatrix> Cright, std::vector<SharedMatrix> D,
+                       std::vector<SharedMatrix> J, std::vector<SharedMatrix> K, size_t max_nocc, bool do_J, bool do_K,
+                       bool lr_symmetric);
     void compute_D(std::vector<SharedMatrix> D, std::vector<SharedMatrix> Cleft, std::vector<SharedMatrix> Cright);
     void compute_J(std::vector<SharedMatrix> D, std::vector<SharedMatrix> J, double* Mp, double* T1p, double* T2p,
                    std::vector<std::vector<double>>& D_buffers, size_t bcount, size_t block_size);
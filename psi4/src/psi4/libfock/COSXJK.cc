@@ -0,0 +1,433 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2019 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+
+#include "psi4/libqt/qt.h"
+#include "psi4/psi4-dec.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libmints/basisset.h"
+#include "psi4/libmints/integral.h"
+#include "psi4/libmints/onebody.h"
+#include "psi4/libmints/potential.h"
+#include "psi4/libmints/sieve.h"
+#include "psi4/lib3index/dfhelper.h"
+#include "psi4/liboptions/liboptions.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/exception.h"
+
+#include "jk.h"
+#include "cubature.h"
+#include "points.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <string>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace psi;
+
+namespace psi {
+
+COSXJK::COSXJK(std::shared_ptr<BasisSet> primary, std::shared_ptr<BasisSet> auxiliary, Options& options)
+    : JK(primary), options_(options), auxiliary_(auxiliary) {
+    common_init();
+}
+
+COSXJK::~COSXJK() {}
+
+void COSXJK::common_init() {
+    dfh_ = std::make_shared<DFHelper>(primary_, auxiliary_);
+    cosx_radial_points_ = 35;
+    cosx_spherical_points_ = 110;
+    overlap_fitted_ = true;
+}
+size_t COSXJK::memory_estimate() {
+    dfh_->set_nthreads(omp_nthread_);
+    dfh_->set_schwarz_cutoff(cutoff_);
+    return dfh_->get_core_size();
+}
+void COSXJK::preiterations() {
+    if (do_wK_) throw PSIEXCEPTION("COSXJK: wK is not implemented, use a different SCF_TYPE for LRC functionals.");
+
+    // => Coulomb: DFHelper in STORE mode, J only <= //
+    dfh_->set_nthreads(omp_nthread_);
+    dfh_->set_schwarz_cutoff(cutoff_);
+    dfh_->set_method("STORE");
+    dfh_->set_fitting_condition(condition_);
+    dfh_->set_memory(memory_ - memory_overhead());
+    dfh_->set_do_wK(false);
+    dfh_->set_wcombine(false);
+    dfh_->initialize();
+
+    if (!do_K_) return;
+
+    // => Exchange: grid, collocation and potential integral workers <= //
+    timer_on("COSXJK: Grid");
+    std::map<std::string, int> int_opts_map;
+    int_opts_map["DFT_RADIAL_POINTS"] = cosx_radial_points_;
+    int_opts_map["DFT_SPHERICAL_POINTS"] = cosx_spherical_points_;
+    std::map<std::string, std::string> opts_map;
+    grid_ = std::make_shared<DFTGrid>(primary_->molecule(), primary_, int_opts_map, opts_map, options_);
+    timer_off("COSXJK: Grid");
+
+    const int max_points = grid_->max_points();
+    const int max_functions = grid_->max_functions();
+
+    sieve_ = std::make_shared<ERISieve>(primary_, cutoff_);
+
+    basis_workers_.clear();
+    potential_ints_.clear();
+    auto factory = std::make_shared<IntegralFactory>(primary_);
+    for (int thread = 0; thread < omp_nthread_; thread++) {
+        auto worker = std::make_shared<BasisFunctions>(primary_, max_points, max_functions);
+        worker->set_deriv(0);
+        basis_workers_.push_back(worker);
+        potential_ints_.push_back(std::shared_ptr<PotentialInt>(static_cast<PotentialInt*>(factory->ao_potential())));
+    }
+
+    // => Overlap fitting: S (X^T W X)^-1, the numerical overlap is fixed for the grid <= //
+    overlap_fitting_.reset();
+    if (!overlap_fitted_) return;
+
+    timer_on("COSXJK: Overlap Fitting");
+    int nbf = primary_->nbf();
+    std::vector<SharedMatrix> Snum_thread;
+    std::vector<SharedMatrix> XW_thread;
+    std::vector<SharedMatrix> S_local;
+    for (int thread = 0; thread < omp_nthread_; thread++) {
+        Snum_thread.push_back(std::make_shared<Matrix>("S numerical", nbf, nbf));
+        XW_thread.push_back(std::make_shared<Matrix>("XW", max_points, max_functions));
+        S_local.push_back(std::make_shared<Matrix>("S local", max_functions, max_functions));
+    }
+
+    const auto& blocks = grid_->blocks();
+#pragma omp parallel for schedule(guided) num_threads(omp_nthread_)
+    for (size_t Q = 0; Q < blocks.size(); Q++) {
+        int rank = 0;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        std::shared_ptr<BlockOPoints> block = blocks[Q];
+        int npoints = block->npoints();
+        double* w = block->w();
+        const std::vector<int>& function_map = block->functions_local_to_global();
+        int nlocal = function_map.size();
+        if (nlocal == 0) continue;
+
+        basis_workers_[rank]->compute_functions(block);
+        SharedMatrix phi = basis_workers_[rank]->basis_value("PHI");
+        double** Xp = phi->pointer();
+        size_t coll_funcs = phi->ncol();
+        double** XWp = XW_thread[rank]->pointer();
+        double** Slp = S_local[rank]->pointer();
+        double** Sp = Snum_thread[rank]->pointer();
+
+        for (int P = 0; P < npoints; P++) {
+            for (int ml = 0; ml < nlocal; ml++) {
+                XWp[P][ml] = w[P] * Xp[P][ml];
+            }
+        }
+        C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, Xp[0], coll_funcs, XWp[0], max_functions, 0.0, Slp[0],
+                max_functions);
+        for (int ml = 0; ml < nlocal; ml++) {
+            int mg = function_map[ml];
+            for (int nl = 0; nl < nlocal; nl++) {
+                Sp[mg][function_map[nl]] += Slp[ml][nl];
+            }
+        }
+    }
+
+    auto Snum = std::make_shared<Matrix>("S numerical", nbf, nbf);
+    for (int thread = 0; thread < omp_nthread_; thread++) {
+        Snum->add(Snum_thread[thread]);
+    }
+    Snum->power(-1.0, condition_);
+
+    auto S = std::make_shared<Matrix>("S", nbf, nbf);
+    std::shared_ptr<OneBodyAOInt> overlap(factory->ao_overlap());
+    overlap->compute(S);
+
+    overlap_fitting_ = std::make_shared<Matrix>("COSX Overlap Fitting", nbf, nbf);
+    overlap_fitting_->gemm(false, false, 1.0, S, Snum, 0.0);
+    timer_off("COSXJK: Overlap Fitting");
+}
+void COSXJK::compute_JK() {
+    if (do_J_) {
+        timer_on("COSXJK: J");
+        dfh_->build_JK(C_left_ao_, C_right_ao_, D_ao_, J_ao_, K_ao_, wK_ao_, max_nocc(), true, false, false,
+                       lr_symmetric_);
+        timer_off("COSXJK: J");
+    }
+
+    if (do_K_) {
+        timer_on("COSXJK: K");
+        build_K_sn(D_ao_, K_ao_);
+        timer_off("COSXJK: K");
+
+        if (lr_symmetric_) {
+            for (size_t N = 0; N < K_ao_.size(); N++) {
+                K_ao_[N]->hermitivitize();
+            }
+        }
+    }
+}
+void COSXJK::build_K_sn(std::vector<SharedMatrix>& D, std::vector<SharedMatrix>& K) {
+    const int nbf = primary_->nbf();
+    const int nshell = primary_->nshell();
+    const std::vector<std::vector<int>>& shell_to_shell = sieve_->shell_to_shell();
+    const size_t nmat = D.size();
+    const int max_points = grid_->max_points();
+    const int max_functions = grid_->max_functions();
+
+    // => Per-thread buffers <= //
+
+    // K_thread[rank][N] collects the raw (unfitted) exchange of each thread
+    std::vector<std::vector<SharedMatrix>> K_thread(omp_nthread_);
+    std::vector<SharedMatrix> D_local(omp_nthread_);
+    std::vector<std::vector<SharedMatrix>> F_thread(omp_nthread_);
+    std::vector<SharedMatrix> Z_thread(omp_nthread_);
+    // Compressed scratch, sized by the significant functions of each block rather than nbf
+    std::vector<std::vector<double>> Fs_thread(omp_nthread_);
+    std::vector<std::vector<double>> Gs_thread(omp_nthread_);
+    std::vector<std::vector<double>> As_thread(omp_nthread_);
+    std::vector<std::vector<double>> Ks_thread(omp_nthread_);
+    // Shell maps into the compressed lambda (density side) and nu (potential side) index, or -1
+    std::vector<std::vector<int>> lam_offset(omp_nthread_, std::vector<int>(nshell, -1));
+    std::vector<std::vector<int>> nu_offset(omp_nthread_, std::vector<int>(nshell, -1));
+    for (int thread = 0; thread < omp_nthread_; thread++) {
+        D_local[thread] = std::make_shared<Matrix>("D local", max_functions, nbf);
+        // A unit point charge; PotentialInt contracts -Z/|r - C|, so Z = -1 yields +1/|r - C|
+        Z_thread[thread] = std::make_shared<Matrix>("Charge (Z,x,y,z)", 1, 4);
+        Z_thread[thread]->set(0, 0, -1.0);
+        potential_ints_[thread]->set_charge_field(Z_thread[thread]);
+        for (size_t N = 0; N < nmat; N++) {
+            K_thread[thread].push_back(std::make_shared<Matrix>("K thread", nbf, nbf));
+            F_thread[thread].push_back(std::make_shared<Matrix>("F", max_points, nbf));
+        }
+    }
+
+    // => Grid loop <= //
+
+    const auto& blocks = grid_->blocks();
+#pragma omp parallel for schedule(guided) num_threads(omp_nthread_)
+    for (size_t Q = 0; Q < blocks.size(); Q++) {
+        int rank = 0;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        std::shared_ptr<BlockOPoints> block = blocks[Q];
+        int npoints = block->npoints();
+        double* x = block->x();
+        double* y = block->y();
+        double* z = block->z();
+        double* w = block->w();
+        const std::vector<int>& function_map = block->functions_local_to_global();
+        int nlocal = function_map.size();
+        if (nlocal == 0) continue;
+
+        // X_gm for the local functions of this block
+        basis_workers_[rank]->compute_functions(block);
+        SharedMatrix phi = basis_workers_[rank]->basis_value("PHI");
+        double** Xp = phi->pointer();
+        size_t coll_funcs = phi->ncol();
+
+        // => Significant functions of this block <= //
+
+        // lambda shells: F_gl = \sum_m X_gm D_ml is significant somewhere on the block for some density
+        std::vector<int>& lam_off = lam_offset[rank];
+        std::vector<int>& nu_off = nu_offset[rank];
+        std::fill(lam_off.begin(), lam_off.end(), -1);
+        std::fill(nu_off.begin(), nu_off.end(), -1);
+        std::vector<double> F_max(nshell, 0.0);
+        double** Dlp = D_local[rank]->pointer();
+        for (size_t N = 0; N < nmat; N++) {
+            double** Dp = D[N]->pointer();
+            for (int ml = 0; ml < nlocal; ml++) {
+                ::memcpy(Dlp[ml], Dp[function_map[ml]], sizeof(double) * nbf);
+            }
+            double** Fp = F_thread[rank][N]->pointer();
+            C_DGEMM('N', 'N', npoints, nbf, nlocal, 1.0, Xp[0], coll_funcs, Dlp[0], nbf, 0.0, Fp[0], nbf);
+            for (int R = 0; R < nshell; R++) {
+                int oR = primary_->shell_to_basis_function(R);
+                int nR = primary_->shell(R).nfunction();
+                for (int P = 0; P < npoints; P++) {
+                    for (int r = oR; r < oR + nR; r++) {
+                        F_max[R] = std::max(F_max[R], std::fabs(Fp[P][r]));
+                    }
+                }
+            }
+        }
+        std::vector<int> lam_shells;
+        int nlam = 0;
+        for (int R = 0; R < nshell; R++) {
+            if (F_max[R] < cutoff_) continue;
+            lam_shells.push_back(R);
+            lam_off[R] = nlam;
+            nlam += primary_->shell(R).nfunction();
+        }
+        if (nlam == 0) continue;
+
+        // nu shells: Schwarz partners of the significant lambda shells
+        std::vector<int> nu_shells;
+        for (int R : lam_shells) {
+            for (int M : shell_to_shell[R]) {
+                if (nu_off[M] == -2) continue;
+                nu_off[M] = -2;
+                nu_shells.push_back(M);
+            }
+        }
+        std::sort(nu_shells.begin(), nu_shells.end());
+        int nnu = 0;
+        for (int M : nu_shells) {
+            nu_off[M] = nnu;
+            nnu += primary_->shell(M).nfunction();
+        }
+
+        // => Compressed F_gl for every density <= //
+
+        std::vector<double>& Fs = Fs_thread[rank];
+        std::vector<double>& Gs = Gs_thread[rank];
+        std::vector<double>& As = As_thread[rank];
+        std::vector<double>& Ks = Ks_thread[rank];
+        Fs.resize(nmat * npoints * nlam);
+        Gs.resize(nmat * npoints * nnu);
+        Ks.resize((size_t)nlocal * nnu);
+        // A(g) is not symmetric once compressed; pairs outside the sieve stay zero for the whole block
+        As.assign((size_t)nnu * nlam, 0.0);
+
+        for (size_t N = 0; N < nmat; N++) {
+            double** Fp = F_thread[rank][N]->pointer();
+            double* FsN = Fs.data() + N * npoints * nlam;
+            for (int P = 0; P < npoints; P++) {
+                for (int R : lam_shells) {
+                    int oR = primary_->shell_to_basis_function(R);
+                    int nR = primary_->shell(R).nfunction();
+                    ::memcpy(&FsN[P * nlam + lam_off[R]], &Fp[P][oR], sizeof(double) * nR);
+                }
+            }
+        }
+
+        // G_gn = w_g \sum_l A_nl(g) F_gl over the significant (nu, lambda) shell pairs
+        std::shared_ptr<PotentialInt> Vint = potential_ints_[rank];
+        double** Zp = Z_thread[rank]->pointer();
+        const double* buffer = Vint->buffer();
+        for (int P = 0; P < npoints; P++) {
+            Zp[0][1] = x[P];
+            Zp[0][2] = y[P];
+            Zp[0][3] = z[P];
+
+            for (int R : lam_shells) {
+                int nR = primary_->shell(R).nfunction();
+                int lR = lam_off[R];
+                for (int M : shell_to_shell[R]) {
+                    int nM = primary_->shell(M).nfunction();
+                    int nuM = nu_off[M];
+                    Vint->compute_shell(M, R);
+                    for (int m = 0, index = 0; m < nM; m++) {
+                        for (int r = 0; r < nR; r++, index++) {
+                            As[(size_t)(nuM + m) * nlam + lR + r] = buffer[index];
+                        }
+                    }
+                }
+            }
+
+            for (size_t N = 0; N < nmat; N++) {
+                double* FsN = Fs.data() + N * npoints * nlam;
+                double* GsN = Gs.data() + N * npoints * nnu;
+                C_DGEMV('N', nnu, nlam, w[P], As.data(), nlam, &FsN[P * nlam], 1, 0.0, &GsN[P * nnu], 1);
+            }
+        }
+
+        // K_mn += \sum_g X_gm G_gn, local m by significant n
+        for (size_t N = 0; N < nmat; N++) {
+            double* GsN = Gs.data() + N * npoints * nnu;
+            C_DGEMM('T', 'N', nlocal, nnu, npoints, 1.0, Xp[0], coll_funcs, GsN, nnu, 0.0, Ks.data(), nnu);
+            double** Ktp = K_thread[rank][N]->pointer();
+            for (int ml = 0; ml < nlocal; ml++) {
+                double* Krow = Ktp[function_map[ml]];
+                const double* Ksrow = Ks.data() + (size_t)ml * nnu;
+                for (int M : nu_shells) {
+                    int oM = primary_->shell_to_basis_function(M);
+                    int nM = primary_->shell(M).nfunction();
+                    C_DAXPY(nM, 1.0, const_cast<double*>(&Ksrow[nu_off[M]]), 1, &Krow[oM], 1);
+                }
+            }
+        }
+    }
+
+    // => Reduction and overlap fitting <= //
+
+    for (size_t N = 0; N < nmat; N++) {
+        for (int thread = 1; thread < omp_nthread_; thread++) {
+            K_thread[0][N]->add(K_thread[thread][N]);
+        }
+        if (overlap_fitting_) {
+            K[N]->gemm(false, false, 1.0, overlap_fitting_, K_thread[0][N], 0.0);
+        } else {
+            K[N]->copy(K_thread[0][N]);
+        }
+    }
+}
+void COSXJK::postiterations() {
+    grid_.reset();
+    sieve_.reset();
+    basis_workers_.clear();
+    potential_ints_.clear();
+    overlap_fitting_.reset();
+}
+void COSXJK::print_header() const {
+    if (print_) {
+        outfile->Printf("  ==> COSXJK: Density-Fitted J, Seminumerical K <==\n\n");
+
+        outfile->Printf("    J tasked:           %11s\n", (do_J_ ? "Yes" : "No"));
+        outfile->Printf("    K tasked:           %11s\n", (do_K_ ? "Yes" : "No"));
+        outfile->Printf("    wK tasked:          %11s\n", (do_wK_ ? "Yes" : "No"));
+        outfile->Printf("    OpenMP threads:     %11d\n", omp_nthread_);
+        outfile->Printf("    Memory [MiB]:       %11ld\n", (memory_ * 8L) / (1024L * 1024L));
+        outfile->Printf("    Schwarz Cutoff:     %11.0E\n", cutoff_);
+        outfile->Printf("    Fitting Condition:  %11.0E\n", condition_);
+        outfile->Printf("    Radial Points:      %11d\n", cosx_radial_points_);
+        outfile->Printf("    Spherical Points:   %11d\n", cosx_spherical_points_);
+        outfile->Printf("    Overlap Fitted:     %11s\n\n", (overlap_fitted_ ? "Yes" : "No"));
+
+        outfile->Printf("   => Auxiliary Basis Set <=\n\n");
+        auxiliary_->print_by_level("outfile", print_);
+    }
+}
+int COSXJK::max_nocc() const {
+    int max_nocc = 0;
+    for (size_t N = 0; N < C_left_ao_.size(); N++) {
+        max_nocc = (C_left_ao_[N]->colspi()[0] > max_nocc ? C_left_ao_[N]->colspi()[0] : max_nocc);
+    }
+    return max_nocc;
+}
+}  // namespace psi
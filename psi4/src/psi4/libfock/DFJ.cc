@@ -0,0 +1,330 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2019 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "psi4/libqt/qt.h"
+#include "psi4/psi4-dec.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libmints/vector.h"
+#include "psi4/libmints/basisset.h"
+#include "psi4/libmints/integral.h"
+#include "psi4/libmints/twobody.h"
+#include "psi4/libmints/sieve.h"
+#include "psi4/lib3index/dftensor.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/exception.h"
+
+#include "jk.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace psi;
+
+namespace psi {
+
+DFJ::DFJ(std::shared_ptr<BasisSet> primary, std::shared_ptr<BasisSet> auxiliary)
+    : JK(primary), auxiliary_(auxiliary) {
+    common_init();
+}
+
+DFJ::~DFJ() {}
+
+void DFJ::common_init() {
+    df_ints_num_threads_ = omp_nthread_;
+    incfock_ = true;
+    incfock_full_fock_every_ = 10;
+    incfock_count_ = 0;
+}
+size_t DFJ::sparse_size() {
+    if (!sieve_) sieve_ = std::make_shared<ERISieve>(primary_, cutoff_);
+    size_t npairs_funs = 0L;
+    for (const auto& MN : sieve_->shell_pairs()) {
+        npairs_funs += (size_t)primary_->shell(MN.first).nfunction() * primary_->shell(MN.second).nfunction();
+    }
+    return npairs_funs * auxiliary_->nbf();
+}
+size_t DFJ::memory_estimate() {
+    size_t naux = auxiliary_->nbf();
+    return sparse_size() + naux * naux;
+}
+void DFJ::preiterations() {
+    if (do_K_ || do_wK_) {
+        throw PSIEXCEPTION("DFJ: only J is available, use a different SCF_TYPE for functionals with exact exchange.");
+    }
+
+    sieve_ = std::make_shared<ERISieve>(primary_, cutoff_);
+    const std::vector<std::pair<int, int>>& shell_pairs = sieve_->shell_pairs();
+    const size_t npairs = shell_pairs.size();
+    const int naux = auxiliary_->nbf();
+
+    size_t required = memory_estimate();
+    size_t available = memory_ - memory_overhead();
+    if (required > available) {
+        std::stringstream error;
+        error << "DFJ: the sparse (P|mn) integrals need " << (required * 8L) / (1024L * 1024L) << " MiB, but only "
+              << (available * 8L) / (1024L * 1024L) << " MiB are available.\n"
+              << "Please supply more memory or use SCF_TYPE DF.";
+        throw PSIEXCEPTION(error.str().c_str());
+    }
+
+    // => Metric: (Q|P) = L L^T, factored once per SCF <= //
+
+    timer_on("DFJ: Metric");
+    auto metric = std::make_shared<FittingMetric>(auxiliary_, true);
+    metric->form_fitting_metric();
+    metric_chol_ = metric->get_metric();
+    metric_chol_->set_name("DFJ Metric Cholesky");
+    int info = C_DPOTRF('L', naux, metric_chol_->pointer()[0], naux);
+    timer_off("DFJ: Metric");
+    if (info != 0) {
+        throw PSIEXCEPTION("DFJ: the fitting metric is not positive definite, use SCF_TYPE DF.");
+    }
+
+    // => Sparse (mn|Q), one block per significant shell pair <= //
+
+    timer_on("DFJ: Integrals");
+    pair_offsets_.resize(npairs + 1);
+    pair_offsets_[0] = 0L;
+    for (size_t MN = 0; MN < npairs; MN++) {
+        size_t nM = primary_->shell(shell_pairs[MN].first).nfunction();
+        size_t nN = primary_->shell(shell_pairs[MN].second).nfunction();
+        pair_offsets_[MN + 1] = pair_offsets_[MN] + nM * nN * naux;
+    }
+    Qmn_.assign(pair_offsets_[npairs], 0.0);
+    pair_max_.assign(npairs, 0.0);
+
+    std::shared_ptr<BasisSet> zero = BasisSet::zero_ao_basis_set();
+    auto factory = std::make_shared<IntegralFactory>(auxiliary_, zero, primary_, primary_);
+    std::vector<std::shared_ptr<TwoBodyAOInt>> eri(df_ints_num_threads_);
+    for (int thread = 0; thread < df_ints_num_threads_; thread++) {
+        eri[thread] = std::shared_ptr<TwoBodyAOInt>(factory->eri());
+    }
+
+#pragma omp parallel for schedule(dynamic) num_threads(df_ints_num_threads_)
+    for (size_t MN = 0; MN < npairs; MN++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        int M = shell_pairs[MN].first;
+        int N = shell_pairs[MN].second;
+        int nM = primary_->shell(M).nfunction();
+        int nN = primary_->shell(N).nfunction();
+        double* Bp = Qmn_.data() + pair_offsets_[MN];
+        const double* buffer = eri[thread]->buffer();
+        double max_val = 0.0;
+        for (int P = 0; P < auxiliary_->nshell(); P++) {
+            int nP = auxiliary_->shell(P).nfunction();
+            int oP = auxiliary_->shell(P).function_index();
+            eri[thread]->compute_shell(P, 0, M, N);
+            for (int p = 0; p < nP; p++) {
+                for (int mn = 0; mn < nM * nN; mn++) {
+                    double val = buffer[p * nM * nN + mn];
+                    Bp[(size_t)mn * naux + oP + p] = val;
+                    max_val = std::max(max_val, std::fabs(val));
+                }
+            }
+        }
+        pair_max_[MN] = max_val;
+    }
+    timer_off("DFJ: Integrals");
+
+    D_prev_.clear();
+    d_prev_.clear();
+    incfock_count_ = 0;
+}
+void DFJ::compute_JK() {
+    if (!do_J_) return;
+
+    const std::vector<std::pair<int, int>>& shell_pairs = sieve_->shell_pairs();
+    const size_t npairs = shell_pairs.size();
+    const size_t njk = D_ao_.size();
+    const int naux = auxiliary_->nbf();
+    const int max_nbf = primary_->max_function_per_shell();
+
+    // => Full or incremental build <= //
+
+    bool full = !incfock_ || (D_prev_.size() != njk) || (incfock_count_ >= incfock_full_fock_every_);
+    if (D_prev_.size() != njk) {
+        D_prev_.clear();
+        d_prev_.clear();
+        for (size_t N = 0; N < njk; N++) {
+            D_prev_.push_back(std::make_shared<Matrix>("D Prev", primary_->nbf(), primary_->nbf()));
+            d_prev_.push_back(std::make_shared<Vector>("d Prev", naux));
+        }
+    }
+
+    std::vector<SharedMatrix> dD;
+    for (size_t N = 0; N < njk; N++) {
+        dD.push_back(D_ao_[N]->clone());
+        if (full) {
+            d_prev_[N]->zero();
+        } else {
+            dD[N]->subtract(D_prev_[N]);
+        }
+    }
+
+    // => gamma_P = \sum_mn (P|mn) dD_mn over the pairs dD does not screen out <= //
+
+    timer_on("DFJ: gamma");
+    std::vector<SharedMatrix> gamma_thread;
+    std::vector<std::vector<double>> dD_pair(omp_nthread_, std::vector<double>(njk * max_nbf * max_nbf));
+    for (int thread = 0; thread < omp_nthread_; thread++) {
+        gamma_thread.push_back(std::make_shared<Matrix>("gamma", njk, naux));
+    }
+
+#pragma omp parallel for schedule(dynamic) num_threads(omp_nthread_)
+    for (size_t MN = 0; MN < npairs; MN++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        int M = shell_pairs[MN].first;
+        int N = shell_pairs[MN].second;
+        int nM = primary_->shell(M).nfunction();
+        int nN = primary_->shell(N).nfunction();
+        int oM = primary_->shell(M).function_index();
+        int oN = primary_->shell(N).function_index();
+        double* Dv = dD_pair[thread].data();
+
+        // Off-diagonal pairs stand in for both mn and nm
+        double dmax = 0.0;
+        for (size_t A = 0; A < njk; A++) {
+            double** dDp = dD[A]->pointer();
+            double* DvA = Dv + A * nM * nN;
+            for (int m = 0; m < nM; m++) {
+                for (int n = 0; n < nN; n++) {
+                    double val = dDp[oM + m][oN + n];
+                    if (M != N) val += dDp[oN + n][oM + m];
+                    DvA[m * nN + n] = val;
+                    dmax = std::max(dmax, std::fabs(val));
+                }
+            }
+        }
+        if (dmax * pair_max_[MN] < cutoff_) continue;
+
+        double* Bp = Qmn_.data() + pair_offsets_[MN];
+        double** gp = gamma_thread[thread]->pointer();
+        for (size_t A = 0; A < njk; A++) {
+            C_DGEMV('T', nM * nN, naux, 1.0, Bp, naux, Dv + A * nM * nN, 1, 1.0, gp[A], 1);
+        }
+    }
+
+    auto gamma = std::make_shared<Matrix>("gamma", njk, naux);
+    for (int thread = 0; thread < omp_nthread_; thread++) {
+        gamma->add(gamma_thread[thread]);
+    }
+    timer_off("DFJ: gamma");
+
+    // => d = d_prev + (Q|P)^-1 gamma <= //
+
+    timer_on("DFJ: Fit");
+    double** gp = gamma->pointer();
+    C_DPOTRS('L', naux, njk, metric_chol_->pointer()[0], naux, gp[0], naux);
+    for (size_t A = 0; A < njk; A++) {
+        C_DAXPY(naux, 1.0, gp[A], 1, d_prev_[A]->pointer(), 1);
+    }
+    timer_off("DFJ: Fit");
+
+    // => J_mn = \sum_Q (mn|Q) d_Q <= //
+
+    timer_on("DFJ: J");
+    for (size_t A = 0; A < njk; A++) {
+        J_ao_[A]->zero();
+    }
+    std::vector<std::vector<double>> J_pair(omp_nthread_, std::vector<double>(max_nbf * max_nbf));
+
+#pragma omp parallel for schedule(dynamic) num_threads(omp_nthread_)
+    for (size_t MN = 0; MN < npairs; MN++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        int M = shell_pairs[MN].first;
+        int N = shell_pairs[MN].second;
+        int nM = primary_->shell(M).nfunction();
+        int nN = primary_->shell(N).nfunction();
+        int oM = primary_->shell(M).function_index();
+        int oN = primary_->shell(N).function_index();
+        double* Bp = Qmn_.data() + pair_offsets_[MN];
+        double* Jv = J_pair[thread].data();
+        for (size_t A = 0; A < njk; A++) {
+            C_DGEMV('N', nM * nN, naux, 1.0, Bp, naux, d_prev_[A]->pointer(), 1, 0.0, Jv, 1);
+            double** Jp = J_ao_[A]->pointer();
+            for (int m = 0; m < nM; m++) {
+                for (int n = 0; n < nN; n++) {
+                    Jp[oM + m][oN + n] = Jp[oN + n][oM + m] = Jv[m * nN + n];
+                }
+            }
+        }
+    }
+    timer_off("DFJ: J");
+
+    for (size_t A = 0; A < njk; A++) {
+        D_prev_[A]->copy(D_ao_[A]);
+    }
+    incfock_count_ = (full ? 0 : incfock_count_ + 1);
+
+    if (debug_) {
+        outfile->Printf("  DFJ: %s build\n", (full ? "full" : "incremental"));
+    }
+}
+void DFJ::postiterations() {
+    sieve_.reset();
+    metric_chol_.reset();
+    std::vector<double>().swap(Qmn_);
+    pair_offsets_.clear();
+    pair_max_.clear();
+    D_prev_.clear();
+    d_prev_.clear();
+}
+void DFJ::print_header() const {
+    if (print_) {
+        outfile->Printf("  ==> DFJ: Density-Fitted J Matrices <==\n\n");
+
+        outfile->Printf("    J tasked:           %11s\n", (do_J_ ? "Yes" : "No"));
+        outfile->Printf("    K tasked:           %11s\n", (do_K_ ? "Yes" : "No"));
+        outfile->Printf("    wK tasked:          %11s\n", (do_wK_ ? "Yes" : "No"));
+        outfile->Printf("    OpenMP threads:     %11d\n", omp_nthread_);
+        outfile->Printf("    Integrals threads:  %11d\n", df_ints_num_threads_);
+        outfile->Printf("    Memory [MiB]:       %11ld\n", (memory_ * 8L) / (1024L * 1024L));
+        outfile->Printf("    Schwarz Cutoff:     %11.0E\n", cutoff_);
+        outfile->Printf("    Incremental:        %11s\n", (incfock_ ? "Yes" : "No"));
+        if (incfock_) outfile->Printf("    Full Build Every:   %11d\n", incfock_full_fock_every_);
+        outfile->Printf("\n");
+
+        outfile->Printf("   => Auxiliary Basis Set <=\n\n");
+        auxiliary_->print_by_level("outfile", print_);
+    }
+}
+
+}  // namespace psi
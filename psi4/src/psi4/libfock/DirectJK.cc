@@ -36,6 +36,7 @@
 #include "psi4/libmints/sieve.h"
 #include "psi4/libiwl/iwl.hpp"
 #include "jk.h"
+#include "cfmm.h"
 //#include "jk_independent.h"
 //#include "link.h"
 //#include "direct_screening.h"
@@ -47,6 +48,7 @@
 #include "psi4/libmints/integral.h"
 #include "psi4/lib3index/cholesky.h"
 
+#include <algorithm>
 #include <sstream>
 #include "psi4/libpsi4util/PsiOutStream.h"
 #ifdef _OPENMP
@@ -83,6 +85,17 @@ void DirectJK::common_init() {
 #ifdef _OPENMP
     df_ints_num_threads_ = Process::environment.get_n_threads();
 #endif
+    density_screening_ = false;
+    incfock_ = false;
+    incfock_full_fock_every_ = 10;
+    incfock_full_fock_threshold_ = 0.1;
+    incfock_count_ = 0;
+    do_incfock_iter_ = false;
+    incfock_lr_symmetric_ = false;
+    incfock_omega_ = 0.0;
+    do_cfmm_ = false;
+    cfmm_order_ = 10;
+    cfmm_levels_ = 0;
 }
 size_t DirectJK::memory_estimate() {
     return 0; // Effectively
@@ -97,11 +110,33 @@ void DirectJK::print_header() const {
         if (do_wK_) outfile->Printf("    Omega:             %11.3E\n", omega_);
         outfile->Printf("    Integrals threads: %11d\n", df_ints_num_threads_);
         // outfile->Printf( "    Memory [MiB]:      %11ld\n", (memory_ *8L) / (1024L * 1024L));
+        outfile->Printf("    Density Screening: %11s\n", (density_screening_ ? "Yes" : "No"));
+        outfile->Printf("    Incremental Fock:  %11s\n", (incfock_ ? "Yes" : "No"));
+        if (incfock_) {
+            outfile->Printf("    Full Fock Every:   %11d\n", incfock_full_fock_every_);
+            outfile->Printf("    Full Fock Ratio:   %11.0E\n", incfock_full_fock_threshold_);
+        }
+        outfile->Printf("    CFMM J:            %11s\n", (do_cfmm_ ? "Yes" : "No"));
         outfile->Printf("    Schwarz Cutoff:    %11.0E\n\n", cutoff_);
     }
 }
 void DirectJK::preiterations() {
     sieve_ = std::make_shared<ERISieve>(primary_, cutoff_, do_csam_);
+    reset_incfock();
+
+    cfmm_.reset();
+    if (do_cfmm_ && do_J_) {
+        timer_on("DirectJK: CFMM Tree");
+        cfmm_ = std::make_shared<CFMM>(primary_);
+        cfmm_->set_print(print_);
+        cfmm_->set_nthread(df_ints_num_threads_);
+        cfmm_->set_cutoff(cutoff_);
+        cfmm_->set_order(cfmm_order_);
+        cfmm_->set_levels(cfmm_levels_);
+        cfmm_->initialize();
+        cfmm_->print_header();
+        timer_off("DirectJK: CFMM Tree");
+    }
     
 #ifdef USING_BrianQC
     if (brianEnable) {
@@ -272,6 +307,17 @@ void DirectJK::compute_JK() {
     }
 #endif
 
+    // => Incremental Fock Build <= //
+
+    if (incfock_) {
+        timer_on("DirectJK: INCFOCK Preprocessing");
+        incfock_setup();
+        timer_off("DirectJK: INCFOCK Preprocessing");
+    } else {
+        do_incfock_iter_ = false;
+    }
+    std::vector<SharedMatrix>& D = (do_incfock_iter_ ? delta_D_ : D_ao_);
+
     auto factory = std::make_shared<IntegralFactory>(primary_, primary_, primary_, primary_);
 
     if (do_wK_) {
@@ -280,18 +326,18 @@ void DirectJK::compute_JK() {
             ints.push_back(std::shared_ptr<TwoBodyAOInt>(factory->erf_eri(omega_)));
         }
         // TODO: Fast K algorithm
-        if (do_J_) {
-            build_JK(ints, D_ao_, J_ao_, wK_ao_);
-        } else {
-            std::vector<std::shared_ptr<Matrix> > temp;
-            for (size_t i = 0; i < D_ao_.size(); i++) {
-                temp.push_back(std::make_shared<Matrix>("temp", primary_->nbf(), primary_->nbf()));
-            }
-            build_JK(ints, D_ao_, temp, wK_ao_);
+        // J is never needed from the erf integrals, it is either built below or not requested
+        std::vector<std::shared_ptr<Matrix> > temp;
+        for (size_t i = 0; i < D.size(); i++) {
+            temp.push_back(std::make_shared<Matrix>("temp", primary_->nbf(), primary_->nbf()));
         }
+        build_JK(ints, D, temp, wK_ao_, false, true);
     }
 
-    if (do_J_ || do_K_) {
+    // With CFMM, J is built below and the four-index contraction only does K
+    bool do_J_direct = do_J_ && !cfmm_;
+
+    if (do_J_direct || do_K_) {
         std::vector<std::shared_ptr<TwoBodyAOInt> > ints;
         ints.push_back(std::shared_ptr<TwoBodyAOInt>(factory->eri()));
         for (int thread = 1; thread < df_ints_num_threads_; thread++) {
@@ -300,26 +346,110 @@ void DirectJK::compute_JK() {
             else
                 ints.push_back(std::shared_ptr<TwoBodyAOInt>(factory->eri()));
         }
-        if (do_J_ && do_K_) {
-            build_JK(ints, D_ao_, J_ao_, K_ao_);
-        } else if (do_J_) {
+        if (do_J_direct && do_K_) {
+            build_JK(ints, D, J_ao_, K_ao_);
+        } else if (do_J_direct) {
             std::vector<std::shared_ptr<Matrix> > temp;
-            for (size_t i = 0; i < D_ao_.size(); i++) {
+            for (size_t i = 0; i < D.size(); i++) {
                 temp.push_back(std::make_shared<Matrix>("temp", primary_->nbf(), primary_->nbf()));
             }
-            build_JK(ints, D_ao_, J_ao_, temp);
+            build_JK(ints, D, J_ao_, temp, true, false);
         } else {
             std::vector<std::shared_ptr<Matrix> > temp;
-            for (size_t i = 0; i < D_ao_.size(); i++) {
+            for (size_t i = 0; i < D.size(); i++) {
                 temp.push_back(std::make_shared<Matrix>("temp", primary_->nbf(), primary_->nbf()));
             }
-            build_JK(ints, D_ao_, temp, K_ao_);
+            build_JK(ints, D, temp, K_ao_, false, true);
         }
     }
+
+    if (do_J_ && cfmm_) {
+        timer_on("DirectJK: CFMM J");
+        cfmm_->build_J(D, J_ao_);
+        timer_off("DirectJK: CFMM J");
+    }
+
+    if (incfock_) {
+        timer_on("DirectJK: INCFOCK Postprocessing");
+        incfock_postiter();
+        timer_off("DirectJK: INCFOCK Postprocessing");
+    }
+}
+void DirectJK::postiterations() {
+    sieve_.reset();
+    cfmm_.reset();
+    reset_incfock();
+}
+void DirectJK::reset_incfock() {
+    incfock_count_ = 0;
+    do_incfock_iter_ = false;
+    D_prev_.clear();
+    delta_D_.clear();
+    J_prev_.clear();
+    K_prev_.clear();
+    wK_prev_.clear();
+}
+void DirectJK::incfock_setup() {
+    size_t njk = D_ao_.size();
+
+    // The stored J/K are only reusable for the same kind of densities and integrals
+    bool reset = (D_prev_.size() != njk);
+    reset = reset || (incfock_lr_symmetric_ != lr_symmetric_);
+    reset = reset || (do_J_ && J_prev_.size() != njk);
+    reset = reset || (do_K_ && K_prev_.size() != njk);
+    reset = reset || (do_wK_ && (wK_prev_.size() != njk || incfock_omega_ != omega_));
+
+    if (reset) {
+        reset_incfock();
+        int nbf = primary_->nbf();
+        for (size_t N = 0; N < njk; N++) {
+            D_prev_.push_back(std::make_shared<Matrix>("D Prev", nbf, nbf));
+            delta_D_.push_back(std::make_shared<Matrix>("Delta D", nbf, nbf));
+            if (do_J_) J_prev_.push_back(std::make_shared<Matrix>("J Prev", nbf, nbf));
+            if (do_K_) K_prev_.push_back(std::make_shared<Matrix>("K Prev", nbf, nbf));
+            if (do_wK_) wK_prev_.push_back(std::make_shared<Matrix>("wK Prev", nbf, nbf));
+        }
+        incfock_lr_symmetric_ = lr_symmetric_;
+        incfock_omega_ = omega_;
+        return;
+    }
+
+    // => Form dD and decide if it is small enough <= //
+
+    double max_ratio = 0.0;
+    for (size_t N = 0; N < njk; N++) {
+        delta_D_[N]->copy(D_ao_[N]);
+        delta_D_[N]->subtract(D_prev_[N]);
+        double Drms = D_ao_[N]->rms();
+        double dDrms = delta_D_[N]->rms();
+        double ratio = (Drms > 0.0 ? dDrms / Drms : (dDrms > 0.0 ? 1.0 : 0.0));
+        max_ratio = std::max(max_ratio, ratio);
+    }
+
+    do_incfock_iter_ = (incfock_count_ < incfock_full_fock_every_) && (max_ratio < incfock_full_fock_threshold_);
+
+    if (debug_) {
+        outfile->Printf("  DirectJK: RMS(dD)/RMS(D) = %11.3E, %s build\n", max_ratio,
+                        (do_incfock_iter_ ? "incremental" : "full"));
+    }
+}
+void DirectJK::incfock_postiter() {
+    for (size_t N = 0; N < D_prev_.size(); N++) {
+        if (do_incfock_iter_) {
+            if (do_J_) J_ao_[N]->add(J_prev_[N]);
+            if (do_K_) K_ao_[N]->add(K_prev_[N]);
+            if (do_wK_) wK_ao_[N]->add(wK_prev_[N]);
+        }
+        D_prev_[N]->copy(D_ao_[N]);
+        if (do_J_) J_prev_[N]->copy(J_ao_[N]);
+        if (do_K_) K_prev_[N]->copy(K_ao_[N]);
+        if (do_wK_) wK_prev_[N]->copy(wK_ao_[N]);
+    }
+    incfock_count_ = (do_incfock_iter_ ? incfock_count_ + 1 : 0);
 }
-void DirectJK::postiterations() { sieve_.reset(); }
 void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints, std::vector<std::shared_ptr<Matrix> >& D,
-                        std::vector<std::shared_ptr<Matrix> >& J, std::vector<std::shared_ptr<Matrix> >& K) {
+                        std::vector<std::shared_ptr<Matrix> >& J, std::vector<std::shared_ptr<Matrix> >& K,
+                        bool build_J, bool build_K) {
     // => Zeroing <= //
 
     for (size_t ind = 0; ind < J.size(); ind++) {
@@ -329,6 +459,14 @@ void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints, std::
         K[ind]->zero();
     }
 
+    // => Density Screening <= //
+
+    if (density_screening_) {
+        timer_on("DirectJK: Density Screening");
+        sieve_->set_density(D);
+        timer_off("DirectJK: Density Screening");
+    }
+
     // => Sizing <= //
 
     int nshell = primary_->nshell();
@@ -411,6 +549,37 @@ void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints, std::
     size_t ntask_pair = task_pairs.size();
     size_t ntask_pair2 = ntask_pair * ntask_pair;
 
+    // => Task Pair Ordering <= //
+
+    // Estimated cost of each task pair, summed over its significant shell pairs. The cost
+    // of a (PQ|RS) task is roughly cost(PQ) * cost(RS), so visiting the task pairs from most
+    // to least expensive hands the largest tasks out first and leaves the cheapest ones to
+    // fill the idle threads at the end of the dynamic schedule.
+    std::vector<double> task_pair_costs(ntask_pair, 0.0);
+    for (size_t PQtask = 0; PQtask < ntask_pair; PQtask++) {
+        int Ptask = task_pairs[PQtask].first;
+        int Qtask = task_pairs[PQtask].second;
+        double cost = 0.0;
+        for (int P2 = task_starts[Ptask]; P2 < task_starts[Ptask + 1]; P2++) {
+            for (int Q2 = task_starts[Qtask]; Q2 < task_starts[Qtask + 1]; Q2++) {
+                if (Q2 > P2) continue;
+                int P = task_shells[P2];
+                int Q = task_shells[Q2];
+                if (!sieve_->shell_pair_significant(P, Q)) continue;
+                const GaussianShell& Pshell = primary_->shell(P);
+                const GaussianShell& Qshell = primary_->shell(Q);
+                cost += (double)Pshell.nfunction() * Qshell.nfunction() * Pshell.nprimitive() * Qshell.nprimitive();
+            }
+        }
+        task_pair_costs[PQtask] = cost;
+    }
+    std::vector<size_t> task_pair_order(ntask_pair);
+    for (size_t PQtask = 0; PQtask < ntask_pair; PQtask++) {
+        task_pair_order[PQtask] = PQtask;
+    }
+    std::stable_sort(task_pair_order.begin(), task_pair_order.end(),
+                     [&task_pair_costs](size_t a, size_t b) { return task_pair_costs[a] > task_pair_costs[b]; });
+
     // => Intermediate Buffers <= //
 
     std::vector<std::vector<std::shared_ptr<Matrix> > > JKT;
@@ -425,13 +594,15 @@ void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints, std::
     // => Benchmarks <= //
 
     size_t computed_shells = 0L;
+    std::vector<size_t> thread_shells(nthread, 0L);
+    std::vector<double> thread_times(nthread, 0.0);
 
 // ==> Master Task Loop <== //
 
 #pragma omp parallel for num_threads(nthread) schedule(dynamic) reduction(+ : computed_shells)
     for (size_t task = 0L; task < ntask_pair2; task++) {
-        size_t task1 = task / ntask_pair;
-        size_t task2 = task % ntask_pair;
+        size_t task1 = task_pair_order[task / ntask_pair];
+        size_t task2 = task_pair_order[task % ntask_pair];
 
         int Ptask = task_pairs[task1].first;
         int Qtask = task_pairs[task1].second;
@@ -463,12 +634,16 @@ void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints, std::
         int dSsize = task_offsets[S2start + nStask] - task_offsets[S2start];
 
         int thread = 0;
+        double task_wtime = 0.0;
 #ifdef _OPENMP
         thread = omp_get_thread_num();
+        if (bench_) task_wtime = omp_get_wtime();
 #endif
 
         // => Master shell quartet loops <= //
 
+        // Quartets of this task, recorded once per task so that threads do not share cache lines
+        size_t task_quartets = 0L;
         bool touched = false;
         for (int P2 = P2start; P2 < P2start + nPtask; P2++) {
             for (int Q2 = Q2start; Q2 < Q2start + nQtask; Q2++) {
@@ -485,12 +660,21 @@ void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints, std::
                         if (!sieve_->shell_pair_significant(R, S)) continue;
                         if (!sieve_->shell_significant(P, Q, R, S)) continue;
 
+                        bool do_J_quartet = build_J;
+                        bool do_K_quartet = build_K;
+                        if (density_screening_) {
+                            do_J_quartet = do_J_quartet && sieve_->shell_significant_density_J(P, Q, R, S);
+                            do_K_quartet = do_K_quartet && sieve_->shell_significant_density_K(P, Q, R, S);
+                        }
+                        if (!do_J_quartet && !do_K_quartet) continue;
+
                         // printf("Quartet: %2d %2d %2d %2d\n", P, Q, R, S);
 
                         // if (thread == 0) timer_on("JK: Ints");
                         if (ints[thread]->compute_shell(P, Q, R, S) == 0)
                             continue;  // No integrals in this shell quartet
                         computed_shells++;
+                        task_quartets++;
                         // if (thread == 0) timer_off("JK: Ints");
 
                         const double* buffer = ints[thread]->buffer();
@@ -557,12 +741,18 @@ void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints, std::
                                 for (int q = 0; q < Qsize; q++) {
                                     for (int r = 0; r < Rsize; r++) {
                                         for (int s = 0; s < Ssize; s++) {
-                                            J1p[(p + Poff2) * dQsize + q + Qoff2] +=
-                                                prefactor * (Dp[r + Roff][s + Soff] + Dp[s + Soff][r + Roff]) *
-                                                (*buffer2);
-                                            J2p[(r + Roff2) * dSsize + s + Soff2] +=
-                                                prefactor * (Dp[p + Poff][q + Qoff] + Dp[q + Qoff][p + Poff]) *
-                                                (*buffer2);
+                                            if (do_J_quartet) {
+                                                J1p[(p + Poff2) * dQsize + q + Qoff2] +=
+                                                    prefactor * (Dp[r + Roff][s + Soff] + Dp[s + Soff][r + Roff]) *
+                                                    (*buffer2);
+                                                J2p[(r + Roff2) * dSsize + s + Soff2] +=
+                                                    prefactor * (Dp[p + Poff][q + Qoff] + Dp[q + Qoff][p + Poff]) *
+                                                    (*buffer2);
+                                            }
+                                            if (!do_K_quartet) {
+                                                buffer2++;
+                                                continue;
+                                            }
                                             K1p[(p + Poff2) * dRsize + r + Roff2] +=
                                                 prefactor * (Dp[q + Qoff][s + Soff]) * (*buffer2);
                                             K2p[(p + Poff2) * dSsize + s + Soff2] +=
@@ -594,7 +784,15 @@ void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints, std::
             }
         }  // End Shell Quartets
 
-        if (!touched) continue;
+        if (!touched) {
+            if (bench_) {
+                thread_shells[thread] += task_quartets;
+#ifdef _OPENMP
+                thread_times[thread] += omp_get_wtime() - task_wtime;
+#endif
+            }
+            continue;
+        }
 
         // => Stripe out <= //
 
@@ -766,6 +964,13 @@ void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints, std::
         }  // End stripe out
         // if (thread == 0) timer_off("JK: Atomic");
 
+        if (bench_) {
+            thread_shells[thread] += task_quartets;
+#ifdef _OPENMP
+            thread_times[thread] += omp_get_wtime() - task_wtime;
+#endif
+        }
+
     }  // End master task list
 
     for (size_t ind = 0; ind < D.size(); ind++) {
@@ -784,6 +989,18 @@ void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints, std::
         size_t possible_shells = ntri * (ntri + 1L) / 2L;
         printer->Printf("Computed %20zu Shell Quartets out of %20zu, (%11.3E ratio)\n", computed_shells,
                         possible_shells, computed_shells / (double)possible_shells);
+#ifdef _OPENMP
+        double max_time = 0.0;
+        double sum_time = 0.0;
+        for (int thread = 0; thread < nthread; thread++) {
+            printer->Printf("  Thread %4d: %20zu Shell Quartets, %11.3E [s]\n", thread, thread_shells[thread],
+                            thread_times[thread]);
+            max_time = std::max(max_time, thread_times[thread]);
+            sum_time += thread_times[thread];
+        }
+        printer->Printf("  Load Imbalance (max/avg thread time): %11.3E\n",
+                        (sum_time > 0.0 ? max_time * nthread / sum_time : 1.0));
+#endif
     }
     
 //     for (size_t ind = 0; ind < J.size(); ind++) {
@@ -38,6 +38,7 @@
 #include "psi4/libmints/vector.h"
 #include "psi4/libmints/twobody.h"
 #include "psi4/libmints/integral.h"
+#include "psi4/libmints/local.h"
 #include "psi4/lib3index/dftensor.h"
 #include "psi4/lib3index/dfhelper.h"
 
@@ -45,6 +46,7 @@
 
 #include <sstream>
 #include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/exception.h"
 #ifdef _OPENMP
 #include <omp.h>
 #include "psi4/libpsi4util/process.h"
@@ -61,7 +63,14 @@ MemDFJK::MemDFJK(std::shared_ptr<BasisSet> primary, std::shared_ptr<BasisSet> au
 
 MemDFJK::~MemDFJK() {}
 
-void MemDFJK::common_init() { dfh_ = std::make_shared<DFHelper>(primary_, auxiliary_); }
+void MemDFJK::common_init() {
+    dfh_ = std::make_shared<DFHelper>(primary_, auxiliary_);
+    do_block_sparse_K_ = false;
+    do_local_K_ = false;
+    local_K_type_ = "BOYS";
+    local_K_tolerance_ = 1.0E-5;
+    do_single_precision_ = false;
+}
 size_t MemDFJK::memory_estimate() {
     dfh_->set_nthreads(omp_nthread_);
     dfh_->set_schwarz_cutoff(cutoff_);
@@ -88,6 +97,13 @@ void MemDFJK::preiterations() {
     }
     dfh_->set_omega_alpha(omega_alpha_);
     dfh_->set_omega_beta(omega_beta_);
+    // the single precision contractions have no tiled or local K builders
+    if (do_single_precision_ && !do_wK_ && (do_block_sparse_K_ || do_local_K_))
+        throw PSIEXCEPTION("MemDFJK: mixed precision cannot be combined with block-sparse or local K.");
+    dfh_->set_block_sparse_K(do_block_sparse_K_);
+    dfh_->set_local_K(do_local_K_);
+    dfh_->set_local_K_tolerance(local_K_tolerance_);
+    dfh_->set_single_precision(do_single_precision_ && !do_wK_);
 
     // we need to prepare the AOs here, and that's it.
     // DFHelper takes care of all the housekeeping
@@ -95,8 +111,24 @@ void MemDFJK::preiterations() {
     dfh_->initialize();
 }
 void MemDFJK::compute_JK() {
-    dfh_->build_JK(C_left_ao_, C_right_ao_, D_ao_, J_ao_, K_ao_, wK_ao_, max_nocc(), do_J_, do_K_, do_wK_,
-                   lr_symmetric_);
+    // K is invariant to rotations among the occupied orbitals, so local K
+    // contracts the localized orbitals in place of the canonical ones
+    std::vector<SharedMatrix> C_left = C_left_ao_;
+    std::vector<SharedMatrix> C_right = C_right_ao_;
+    if (do_local_K_ && do_K_ && lr_symmetric_) {
+        timer_on("MemDFJK: Localize");
+        for (size_t N = 0; N < C_left.size(); N++) {
+            if (!C_left[N]->colspi()[0]) continue;
+            auto localizer = Localizer::build(local_K_type_, primary_, C_left[N]);
+            localizer->set_print(0);
+            localizer->localize();
+            C_left[N] = localizer->L();
+            C_right[N] = C_left[N];
+        }
+        timer_off("MemDFJK: Localize");
+    }
+
+    dfh_->build_JK(C_left, C_right, D_ao_, J_ao_, K_ao_, wK_ao_, max_nocc(), do_J_, do_K_, do_wK_, lr_symmetric_);
     if (lr_symmetric_) {
         if (do_wK_) {
             for (size_t N = 0; N < wK_ao_.size(); N++) {
@@ -120,6 +152,10 @@ void MemDFJK::print_header() const {
         outfile->Printf("    Algorithm:          %11s\n", (dfh_->get_AO_core() ? "Core" : "Disk"));
         outfile->Printf("    Schwarz Cutoff:     %11.0E\n", cutoff_);
         outfile->Printf("    Mask sparsity (%%):  %11.4f\n", 100. * dfh_->ao_sparsity());
+        outfile->Printf("    Block-Sparse K:     %11s\n", (dfh_->get_block_sparse_K() ? "Yes" : "No"));
+        outfile->Printf("    Local K:            %11s\n", (do_local_K_ ? local_K_type_.c_str() : "No"));
+        outfile->Printf("    AO Precision:       %11s\n", (dfh_->AO_single_precision() ? "Single" : "Double"));
+        if (do_local_K_) outfile->Printf("    Domain Tolerance:   %11.0E\n", local_K_tolerance_);
         outfile->Printf("    Fitting Condition:  %11.0E\n\n", condition_);
 
         outfile->Printf("   => Auxiliary Basis Set <=\n\n");
@@ -141,6 +177,18 @@ void MemDFJK::set_omega_beta(double beta){
     omega_beta_ = beta;
     dfh_->set_omega_beta(omega_beta_);
 }
+void MemDFJK::set_single_precision(bool single) {
+    do_single_precision_ = single;
+    dfh_->set_single_precision(single && !do_wK_);
+
+    // promote the stored AOs
+    if (!single && dfh_->AO_single_precision()) {
+        timer_on("MemDFJK: Double Precision AOs");
+        if (print_) outfile->Printf("  MemDFJK: rebuilding the AOs in double precision.\n\n");
+        dfh_->initialize();
+        timer_off("MemDFJK: Double Precision AOs");
+    }
+}
 void MemDFJK::set_do_wK(bool tf) { do_wK_ = tf; dfh_->set_do_wK(tf); }
 void MemDFJK::set_wcombine(bool wcombine) { 
     wcombine_ = wcombine;
@@ -0,0 +1,378 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2019 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "psi4/libfock/benchmark.h"
+#include "psi4/libfock/cubature.h"
+#include "psi4/libfock/jk.h"
+#include "psi4/libfock/v.h"
+#include "psi4/lib3index/dfhelper.h"
+#include "psi4/libfunctional/superfunctional.h"
+#include "psi4/libmints/basisset.h"
+#include "psi4/libmints/dimension.h"
+#include "psi4/libmints/integral.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libmints/molecule.h"
+#include "psi4/libmints/petitelist.h"
+#include "psi4/liboptions/liboptions.h"
+#include "psi4/libqt/qt.h"
+#include "psi4/libpsi4util/exception.h"
+#include "psi4/libpsi4util/libpsi4util.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace psi {
+
+void benchmark_dfhelper_io(std::shared_ptr<BasisSet> primary, std::shared_ptr<BasisSet> auxiliary, int nblock,
+                           double min_time) {
+    double T;
+    size_t rounds;
+    Timer* qq;
+
+    // A fixed, dense set of orbitals spanning the whole AO space, so the (Q|pq) tensor is naux x nbf x nbf
+    int nbf = primary->nbf();
+    auto C = std::make_shared<Matrix>("C", nbf, nbf);
+    for (int i = 0; i < nbf; i++) {
+        for (int a = 0; a < nbf; a++) {
+            C->set(i, a, std::sin(1.0 + i + 7.0 * a) / std::sqrt((double)nbf));
+        }
+    }
+
+    auto dfh = std::make_shared<DFHelper>(primary, auxiliary);
+    dfh->set_AO_core(false);
+    dfh->set_MO_core(false);
+    dfh->set_print_lvl(0);
+    dfh->initialize();
+    dfh->add_space("p", C);
+    dfh->add_transformation("BENCH", "p", "p", "Qpq");
+    dfh->transform();
+
+    std::tuple<size_t, size_t, size_t> shape = dfh->get_tensor_shape("BENCH");
+    size_t naux = std::get<0>(shape);
+    size_t np = std::get<1>(shape);
+    size_t nq = std::get<2>(shape);
+    size_t full_dim = naux * np * nq;
+
+    outfile->Printf("\n");
+    outfile->Printf("                              ------------------------------ \n");
+    outfile->Printf("                              ====> DFHELPER IO BENCHMARKS <= \n");
+    outfile->Printf("                              ------------------------------ \n");
+    outfile->Printf("\n");
+
+    outfile->Printf("  Parameters:\n");
+    outfile->Printf("   -Tensor (Q|pq): %zu x %zu x %zu doubles, %.3f [GiB] on disk.\n", naux, np, nq,
+                    8.0 * full_dim / (1024.0 * 1024.0 * 1024.0));
+    outfile->Printf("   -Blocks per pass: %d.\n", nblock);
+    outfile->Printf("   -Minimum runtime (per operation, per backend): %14.10f [s].\n", min_time);
+    outfile->Printf("\n");
+
+    outfile->Printf("  Operations:\n");
+    outfile->Printf("   -READ (Q blocks): Read the whole tensor as contiguous blocks of Q rows.\n");
+    outfile->Printf("   -READ (p blocks): Read the whole tensor as strided blocks of p, all Q.\n");
+    outfile->Printf("\n");
+
+    outfile->Printf("  Notes:\n");
+    outfile->Printf("   -STREAM is fseek/fread, MMAP is the memory-mapped backend with prefetch (set_mmap_io).\n");
+    outfile->Printf("   -The page cache is not dropped: a tensor smaller than RAM measures the copy paths,\n");
+    outfile->Printf("        only a tensor larger than RAM measures the disk.\n");
+    outfile->Printf("\n");
+
+    size_t Qblock = std::max((size_t)1, (naux + nblock - 1) / nblock);
+    size_t pblock = std::max((size_t)1, (np + nblock - 1) / nblock);
+    std::vector<double> buffer(std::max(Qblock * np * nq, naux * pblock * nq));
+
+    std::vector<std::string> ops;
+    ops.push_back("READ (Q blocks)");
+    ops.push_back("READ (p blocks)");
+    std::vector<std::string> backends;
+    backends.push_back("STREAM");
+    backends.push_back("MMAP");
+    std::map<std::string, std::vector<double> > timings;
+    for (size_t op = 0; op < ops.size(); op++) timings[ops[op]].resize(backends.size());
+
+    for (size_t b = 0; b < backends.size(); b++) {
+        dfh->set_mmap_io(backends[b] == "MMAP");
+
+        // READ (Q blocks)
+        T = 0.0;
+        rounds = 0L;
+        qq = new Timer();
+        while (T < min_time) {
+            for (size_t Q = 0; Q < naux; Q += Qblock) {
+                dfh->fill_tensor("BENCH", buffer.data(), {Q, std::min(naux, Q + Qblock)});
+            }
+            T = qq->get();
+            rounds++;
+        }
+        delete qq;
+        timings["READ (Q blocks)"][b] = T / (double)rounds;
+
+        // READ (p blocks)
+        T = 0.0;
+        rounds = 0L;
+        qq = new Timer();
+        while (T < min_time) {
+            for (size_t p = 0; p < np; p += pblock) {
+                dfh->fill_tensor("BENCH", buffer.data(), {0, naux}, {p, std::min(np, p + pblock)});
+            }
+            T = qq->get();
+            rounds++;
+        }
+        delete qq;
+        timings["READ (p blocks)"][b] = T / (double)rounds;
+    }
+
+    outfile->Printf("DFHelper IO Timings [s] and Performance [GiB/s]\n\n");
+    outfile->Printf("%-20s", "Operation");
+    for (size_t b = 0; b < backends.size(); b++) outfile->Printf("  %9s  %9s", backends[b].c_str(), "GiB/s");
+    outfile->Printf("\n");
+    for (size_t s = 0; s < ops.size(); s++) {
+        outfile->Printf("%-20s", ops[s].c_str());
+        for (size_t b = 0; b < backends.size(); b++) {
+            double t = timings[ops[s]][b];
+            outfile->Printf("  %9.3E  %9.3E", t, 8.0 * full_dim / (1024.0 * 1024.0 * 1024.0) / t);
+        }
+        outfile->Printf("\n");
+    }
+    outfile->Printf("\n");
+
+    dfh->clear_all();
+}
+
+void benchmark_vv10(std::shared_ptr<BasisSet> primary, std::shared_ptr<SuperFunctional> functional,
+                    SharedMatrix D, double min_time) {
+    double T;
+    size_t rounds;
+    Timer* qq;
+
+    if (!functional->needs_vv10()) {
+        throw PSIEXCEPTION("benchmark_vv10: The functional does not have a VV10 component.");
+    }
+
+    Options& options = Process::environment.options;
+    const bool screening = options.get_bool("DFT_VV10_SCREENING");
+
+    outfile->Printf("\n");
+    outfile->Printf("                              ------------------------- \n");
+    outfile->Printf("                              ====> VV10 BENCHMARKS <=== \n");
+    outfile->Printf("                              ------------------------- \n");
+    outfile->Printf("\n");
+
+    outfile->Printf("  Parameters:\n");
+    outfile->Printf("   -Functional: %s.\n", functional->name().c_str());
+    outfile->Printf("   -Basis functions: %d, atoms: %d.\n", primary->nbf(), primary->molecule()->natom());
+    outfile->Printf("   -Lump radius: %.2f, cutoff radius: %.2f [bohr].\n",
+                    options.get_double("DFT_VV10_LUMP_RADIUS"), options.get_double("DFT_VV10_CUTOFF_RADIUS"));
+    outfile->Printf("   -Minimum runtime (per path): %14.10f [s].\n", min_time);
+    outfile->Printf("\n");
+
+    outfile->Printf("  Notes:\n");
+    outfile->Printf("   -Each round is a full RV::compute_V, the semilocal part is identical for both paths.\n");
+    outfile->Printf("   -ALL PAIRS is DFT_VV10_SCREENING false, SCREENED is DFT_VV10_SCREENING true.\n");
+    outfile->Printf("\n");
+
+    std::vector<std::string> paths;
+    paths.push_back("ALL PAIRS");
+    paths.push_back("SCREENED");
+    std::vector<double> timings(paths.size());
+    std::vector<double> energies(paths.size());
+
+    for (size_t path = 0; path < paths.size(); path++) {
+        options.set_global_bool("DFT_VV10_SCREENING", paths[path] == "SCREENED");
+
+        std::shared_ptr<VBase> V = VBase::build_V(primary, functional, options, "RV");
+        V->initialize();
+        V->set_D({D});
+        auto Vmat = std::make_shared<Matrix>("V", D->rowspi(), D->colspi());
+
+        T = 0.0;
+        rounds = 0L;
+        qq = new Timer();
+        while (T < min_time) {
+            std::vector<SharedMatrix> ret = {Vmat};
+            V->compute_V(ret);
+            T = qq->get();
+            rounds++;
+        }
+        delete qq;
+        timings[path] = T / (double)rounds;
+        energies[path] = V->quadrature_values()["VV10"];
+        V->finalize();
+    }
+    options.set_global_bool("DFT_VV10_SCREENING", screening);
+
+    outfile->Printf("VV10 Timings [s] and Energies [Eh]\n\n");
+    outfile->Printf("%-12s  %9s  %20s  %9s\n", "Path", "Time", "VV10 Energy", "Speedup");
+    for (size_t path = 0; path < paths.size(); path++) {
+        outfile->Printf("%-12s  %9.3E  %20.12f  %9.3f\n", paths[path].c_str(), timings[path], energies[path],
+                        timings[0] / timings[path]);
+    }
+    outfile->Printf("\n");
+}
+
+void benchmark_dft_grid(std::vector<std::shared_ptr<BasisSet>> primaries, double min_time) {
+    double T;
+    size_t rounds;
+    Timer* qq;
+
+    Options& options = Process::environment.options;
+
+    outfile->Printf("\n");
+    outfile->Printf("                              ----------------------------- \n");
+    outfile->Printf("                              ====> DFT GRID BENCHMARKS <=== \n");
+    outfile->Printf("                              ----------------------------- \n");
+    outfile->Printf("\n");
+
+    outfile->Printf("  Parameters:\n");
+    outfile->Printf("   -Systems: %zu.\n", primaries.size());
+    outfile->Printf("   -Radial points: %d, spherical points: %d.\n", options.get_int("DFT_RADIAL_POINTS"),
+                    options.get_int("DFT_SPHERICAL_POINTS"));
+    outfile->Printf("   -Minimum runtime (per system, per scheme): %14.10f [s].\n", min_time);
+    outfile->Printf("\n");
+
+    outfile->Printf("  Notes:\n");
+    outfile->Printf("   -Each round is a full DFTGrid construction: atomic grids, nuclear weights,\n");
+    outfile->Printf("        blocking and basis extents. Only DFT_NUCLEAR_SCHEME changes between columns.\n");
+    outfile->Printf("   -STRATMANN and SBECKE screen atom pairs, TREUTLER and BECKE do not.\n");
+    outfile->Printf("\n");
+
+    std::vector<std::string> schemes;
+    schemes.push_back("TREUTLER");
+    schemes.push_back("BECKE");
+    schemes.push_back("STRATMANN");
+    schemes.push_back("SBECKE");
+
+    outfile->Printf("DFT Grid Build Timings [s]\n\n");
+    outfile->Printf("%6s  %10s", "Natom", "Npoints");
+    for (size_t s = 0; s < schemes.size(); s++) outfile->Printf("  %10s", schemes[s].c_str());
+    outfile->Printf("\n");
+
+    for (size_t sys = 0; sys < primaries.size(); sys++) {
+        std::shared_ptr<BasisSet> primary = primaries[sys];
+        std::shared_ptr<Molecule> molecule = primary->molecule();
+
+        std::vector<double> timings(schemes.size());
+        int npoints = 0;
+        for (size_t s = 0; s < schemes.size(); s++) {
+            std::map<std::string, std::string> opt_map;
+            opt_map["DFT_NUCLEAR_SCHEME"] = schemes[s];
+            std::map<std::string, int> opt_int_map;
+
+            T = 0.0;
+            rounds = 0L;
+            qq = new Timer();
+            while (T < min_time) {
+                DFTGrid grid(molecule, primary, opt_int_map, opt_map, options);
+                npoints = grid.npoints();
+                T = qq->get();
+                rounds++;
+            }
+            delete qq;
+            timings[s] = T / (double)rounds;
+        }
+
+        outfile->Printf("%6d  %10d", molecule->natom(), npoints);
+        for (size_t s = 0; s < schemes.size(); s++) outfile->Printf("  %10.3E", timings[s]);
+        outfile->Printf("\n");
+    }
+    outfile->Printf("\n");
+}
+
+void benchmark_directjk(std::shared_ptr<BasisSet> primary, int max_threads, double min_time) {
+    double T;
+    size_t rounds;
+    Timer* qq;
+
+    // A fixed, dense set of occupied orbitals (one in five SOs of each irrep)
+    auto integral = std::make_shared<IntegralFactory>(primary);
+    auto pet = std::make_shared<PetiteList>(primary, integral);
+    Dimension nsopi = pet->SO_basisdim();
+    Dimension noccpi(nsopi.n());
+    for (int h = 0; h < nsopi.n(); h++) noccpi[h] = std::max(1, nsopi[h] / 5);
+    auto C = std::make_shared<Matrix>("C", nsopi, noccpi);
+    for (int h = 0; h < nsopi.n(); h++) {
+        for (int i = 0; i < nsopi[h]; i++) {
+            for (int a = 0; a < noccpi[h]; a++) {
+                C->set(h, i, a, std::sin(1.0 + i + 7.0 * a) / std::sqrt((double)nsopi[h]));
+            }
+        }
+    }
+
+    outfile->Printf("\n");
+    outfile->Printf("                              ------------------------------ \n");
+    outfile->Printf("                              ======> DIRECTJK SCALING <==== \n");
+    outfile->Printf("                              ------------------------------ \n");
+    outfile->Printf("\n");
+
+    outfile->Printf("  Parameters:\n");
+    outfile->Printf("   -Basis functions: %d, shells: %d, atoms: %d.\n", primary->nbf(), primary->nshell(),
+                    primary->molecule()->natom());
+    outfile->Printf("   -Maximum number of threads: %d.\n", max_threads);
+    outfile->Printf("   -Minimum runtime (per thread count): %14.10f [s].\n", min_time);
+    outfile->Printf("\n");
+
+    outfile->Printf("  Notes:\n");
+    outfile->Printf("   -Timings are per J and K build, after a first untimed build.\n");
+    outfile->Printf("   -Efficiency is the speedup over one thread divided by the number of threads.\n");
+    outfile->Printf("\n");
+
+    outfile->Printf("  %7s %11s %9s %10s\n", "Threads", "T JK [s]", "Speedup", "Efficiency");
+    double t_one = 0.0;
+    for (int nthread = 1; nthread <= max_threads; nthread *= 2) {
+        auto jk = std::make_shared<DirectJK>(primary);
+        jk->set_df_ints_num_threads(nthread);
+        jk->set_omp_nthread(nthread);
+        jk->set_print(0);
+        jk->C_left().push_back(C);
+        jk->initialize();
+        jk->compute();
+
+        T = 0.0;
+        rounds = 0L;
+        qq = new Timer();
+        while (T < min_time) {
+            jk->compute();
+            T = qq->get();
+            rounds++;
+        }
+        delete qq;
+        double t = T / (double)rounds;
+        if (nthread == 1) t_one = t;
+
+        outfile->Printf("  %7d %11.3E %9.2f %10.2f\n", nthread, t, t_one / t, t_one / (t * nthread));
+    }
+    outfile->Printf("\n");
+}
+
+}  // namespace psi
@@ -0,0 +1,85 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2019 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _psi_src_lib_libfock_benchmark_h
+#define _psi_src_lib_libfock_benchmark_h
+
+#include <memory>
+#include <vector>
+
+namespace psi {
+
+class BasisSet;
+class Matrix;
+class SuperFunctional;
+
+/**
+ * Perform a benchmark of the DFHelper disk backends, fread streams
+ * against memory maps with prefetch, on the current hardware
+ * The (Q|pq) tensor of the full AO space is written once and read back
+ * in contiguous Q blocks and strided p blocks
+ * \param primary the orbital basis, with its molecule
+ * \param auxiliary the fitting basis
+ * \param nblock number of blocks per pass over the tensor
+ * \param min_time minimum time to run each operation [s]
+ **/
+void benchmark_dfhelper_io(std::shared_ptr<BasisSet> primary, std::shared_ptr<BasisSet> auxiliary, int nblock,
+                           double min_time);
+/**
+ * Perform a benchmark of the VV10 nonlocal kernel, the all-pairs path
+ * against the spatially screened one (DFT_VV10_SCREENING)
+ * Both paths run a full RV::compute_V so the VV10 energies can be compared
+ * \param primary the orbital basis, with its molecule
+ * \param functional a superfunctional with a VV10 component
+ * \param D the AO density matrix
+ * \param min_time minimum time to run each path [s]
+ **/
+void benchmark_vv10(std::shared_ptr<BasisSet> primary, std::shared_ptr<SuperFunctional> functional,
+                    std::shared_ptr<Matrix> D, double min_time);
+/**
+ * Perform a benchmark of the DFT grid build against the number of atoms
+ * Each system's DFTGrid is built once per nuclear weight scheme, so the
+ * scaling of the atom-pair screened schemes can be compared with the rest
+ * \param primaries the orbital bases of the systems, with their molecules,
+ * usually in order of increasing size
+ * \param min_time minimum time to run each build [s]
+ **/
+void benchmark_dft_grid(std::vector<std::shared_ptr<BasisSet>> primaries, double min_time);
+/**
+ * Perform a thread-scaling benchmark of the integral-direct
+ * J/K build (DirectJK) for a given basis on the current hardware
+ * Thread counts are doubled from 1 up to max_threads
+ * \param primary the orbital basis, with its molecule
+ * \param max_threads maximum number of threads to use
+ * \param min_time minimum time to run each thread count [s]
+ **/
+void benchmark_directjk(std::shared_ptr<BasisSet> primary, int max_threads, double min_time);
+
+}  // namespace psi
+
+#endif
@@ -0,0 +1,592 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2019 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "cfmm.h"
+
+#include "psi4/libqt/qt.h"
+#include "psi4/psi4-dec.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libmints/basisset.h"
+#include "psi4/libmints/integral.h"
+#include "psi4/libmints/onebody.h"
+#include "psi4/libmints/twobody.h"
+#include "psi4/libmints/sieve.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/exception.h"
+
+#include <algorithm>
+#include <cmath>
+#ifdef _OPENMP
+#include <omp.h>
+#include "psi4/libpsi4util/process.h"
+#endif
+
+namespace psi {
+
+CFMM::CFMM(std::shared_ptr<BasisSet> primary) : primary_(primary) {
+    print_ = 1;
+    nthread_ = 1;
+#ifdef _OPENMP
+    nthread_ = Process::environment.get_n_threads();
+#endif
+    cutoff_ = 1.0E-12;
+    order_ = 10;
+    levels_ = 0;
+    nlevels_ = 1;
+    separation_ = 1.5;
+    length_ = 1.0;
+}
+CFMM::~CFMM() {}
+
+void CFMM::initialize() {
+    if (order_ < 0) throw PSIEXCEPTION("CFMM: multipole order must be non-negative.");
+
+    sieve_ = std::make_shared<ERISieve>(primary_, cutoff_);
+    shell_pairs_ = sieve_->shell_pairs();
+    box_moments_.clear();
+
+    // => Cartesian components in MultipoleInt order <= //
+
+    components_.clear();
+    inverse_factorials_.clear();
+    component_index_.assign(order_ + 1, std::vector<std::vector<int>>(order_ + 1, std::vector<int>(order_ + 1, -1)));
+    std::vector<double> factorial(order_ + 1, 1.0);
+    for (int l = 1; l <= order_; l++) factorial[l] = l * factorial[l - 1];
+    for (int l = 0; l <= order_; l++) {
+        for (int ii = 0; ii <= l; ii++) {
+            int lx = l - ii;
+            for (int lz = 0; lz <= ii; lz++) {
+                int ly = ii - lz;
+                component_index_[lx][ly][lz] = components_.size();
+                components_.push_back({lx, ly, lz});
+                inverse_factorials_.push_back(1.0 / (factorial[lx] * factorial[ly] * factorial[lz]));
+            }
+        }
+    }
+
+    // => Centers and extents of the charge distributions <= //
+
+    // A primitive product exp(-p r^2) acts as a point charge beyond r = sqrt(-ln(tol) / p)
+    double log_tol = -std::log(std::max(cutoff_, 1.0E-16));
+    pair_centers_.resize(shell_pairs_.size());
+    pair_extents_.resize(shell_pairs_.size());
+    for (size_t MN = 0; MN < shell_pairs_.size(); MN++) {
+        const GaussianShell& Mshell = primary_->shell(shell_pairs_[MN].first);
+        const GaussianShell& Nshell = primary_->shell(shell_pairs_[MN].second);
+        Vector3 A = Mshell.center();
+        Vector3 B = Nshell.center();
+
+        double amin = Mshell.exp(0);
+        for (int i = 1; i < Mshell.nprimitive(); i++) amin = std::min(amin, Mshell.exp(i));
+        double bmin = Nshell.exp(0);
+        for (int j = 1; j < Nshell.nprimitive(); j++) bmin = std::min(bmin, Nshell.exp(j));
+        Vector3 P = (amin * A + bmin * B) / (amin + bmin);
+
+        double extent = 0.0;
+        for (int i = 0; i < Mshell.nprimitive(); i++) {
+            for (int j = 0; j < Nshell.nprimitive(); j++) {
+                double a = Mshell.exp(i);
+                double b = Nshell.exp(j);
+                Vector3 Pij = (a * A + b * B) / (a + b);
+                extent = std::max(extent, Pij.distance(P) + std::sqrt(log_tol / (a + b)));
+            }
+        }
+        pair_centers_[MN] = P;
+        pair_extents_[MN] = extent;
+    }
+
+    build_tree();
+}
+Vector3 CFMM::box_center(int level, int box) const {
+    int n = nside(level);
+    double size = length_ / n;
+    int iz = box % n;
+    int iy = (box / n) % n;
+    int ix = box / (n * n);
+    return Vector3(origin_[0] + (ix + 0.5) * size, origin_[1] + (iy + 0.5) * size, origin_[2] + (iz + 0.5) * size);
+}
+std::vector<int> CFMM::children(int level, int box) const {
+    int n = nside(level);
+    int iz = box % n;
+    int iy = (box / n) % n;
+    int ix = box / (n * n);
+    std::vector<int> ret;
+    for (int dx = 0; dx < 2; dx++) {
+        for (int dy = 0; dy < 2; dy++) {
+            for (int dz = 0; dz < 2; dz++) {
+                int child = ((2 * ix + dx) * 2 * n + (2 * iy + dy)) * 2 * n + (2 * iz + dz);
+                if (box_pairs_[level + 1][child].size()) ret.push_back(child);
+            }
+        }
+    }
+    return ret;
+}
+void CFMM::build_tree() {
+    // => Root box: the bounding cube of the charge centers <= //
+
+    Vector3 lo = pair_centers_.size() ? pair_centers_[0] : Vector3(0.0, 0.0, 0.0);
+    Vector3 hi = lo;
+    for (const auto& P : pair_centers_) {
+        for (int k = 0; k < 3; k++) {
+            lo[k] = std::min(lo[k], P[k]);
+            hi[k] = std::max(hi[k], P[k]);
+        }
+    }
+    length_ = std::max(std::max(hi[0] - lo[0], hi[1] - lo[1]), hi[2] - lo[2]);
+    double pad = 1.0E-6 * std::max(length_, 1.0);
+    length_ += 2.0 * pad;
+    origin_ = Vector3(lo[0] - pad, lo[1] - pad, lo[2] - pad);
+
+    // => Depth: leaf boxes of about 4 bohr unless set explicitly <= //
+
+    if (levels_ > 0) {
+        nlevels_ = levels_;
+    } else {
+        nlevels_ = 1;
+        while (length_ / nside(nlevels_ - 1) > 4.0 && nlevels_ < 6) nlevels_++;
+    }
+
+    // => Sort the shell pairs into the boxes of every level <= //
+
+    box_pairs_.assign(nlevels_, std::vector<std::vector<int>>());
+    box_radii_.assign(nlevels_, std::vector<double>());
+    for (int level = 0; level < nlevels_; level++) {
+        int n = nside(level);
+        double size = length_ / n;
+        box_pairs_[level].resize((size_t)n * n * n);
+        box_radii_[level].assign((size_t)n * n * n, 0.0);
+        for (size_t MN = 0; MN < pair_centers_.size(); MN++) {
+            const Vector3& P = pair_centers_[MN];
+            int ix = std::min(n - 1, (int)((P[0] - origin_[0]) / size));
+            int iy = std::min(n - 1, (int)((P[1] - origin_[1]) / size));
+            int iz = std::min(n - 1, (int)((P[2] - origin_[2]) / size));
+            int box = (ix * n + iy) * n + iz;
+            box_pairs_[level][box].push_back(MN);
+            double radius = P.distance(box_center(level, box)) + pair_extents_[MN];
+            box_radii_[level][box] = std::max(box_radii_[level][box], radius);
+        }
+    }
+
+    // => Interaction lists <= //
+
+    far_boxes_.assign(nlevels_, std::vector<std::vector<int>>());
+    for (int level = 0; level < nlevels_; level++) {
+        far_boxes_[level].resize(box_pairs_[level].size());
+    }
+    near_boxes_.clear();
+    if (pair_centers_.size()) classify(0, 0, 0);
+}
+void CFMM::classify(int level, int A, int B) {
+    bool leaf = (level == nlevels_ - 1);
+
+    if (A == B) {
+        if (leaf) {
+            near_boxes_.push_back(std::make_pair(A, A));
+            return;
+        }
+        std::vector<int> child = children(level, A);
+        for (size_t i = 0; i < child.size(); i++) {
+            for (size_t j = i; j < child.size(); j++) {
+                classify(level + 1, child[i], child[j]);
+            }
+        }
+        return;
+    }
+
+    double R = box_center(level, A).distance(box_center(level, B));
+    if (R >= separation_ * (box_radii_[level][A] + box_radii_[level][B])) {
+        far_boxes_[level][A].push_back(B);
+        far_boxes_[level][B].push_back(A);
+        return;
+    }
+
+    if (leaf) {
+        near_boxes_.push_back(std::make_pair(std::min(A, B), std::max(A, B)));
+        return;
+    }
+    std::vector<int> childA = children(level, A);
+    std::vector<int> childB = children(level, B);
+    for (int cA : childA) {
+        for (int cB : childB) {
+            classify(level + 1, std::min(cA, cB), std::max(cA, cB));
+        }
+    }
+}
+void CFMM::interaction_tensor(const Vector3& R, std::vector<double>& T, std::vector<double>& scratch) const {
+    // McMurchie-Davidson recursion for the derivatives of 1/R:
+    //   R^n_000 = (-1)^n (2n-1)!! / R^(2n+1)
+    //   R^n_{t,u,v} = (t-1) R^{n+1}_{t-2,u,v} + X R^{n+1}_{t-1,u,v}  (likewise for u, v)
+    //   T_tuv = R^0_tuv
+    const int p1 = order_ + 1;
+    auto idx = [p1](int n, int t, int u, int v) { return ((n * p1 + t) * p1 + u) * p1 + v; };
+
+    double r2 = R.dot(R);
+    double fn = 1.0 / std::sqrt(r2);
+    for (int n = 0; n <= order_; n++) {
+        scratch[idx(n, 0, 0, 0)] = fn;
+        fn *= -(2.0 * n + 1.0) / r2;
+    }
+
+    for (size_t c = 1; c < components_.size(); c++) {
+        int t = components_[c][0];
+        int u = components_[c][1];
+        int v = components_[c][2];
+        int L = t + u + v;
+        for (int n = 0; n <= order_ - L; n++) {
+            double val;
+            if (t > 0) {
+                val = R[0] * scratch[idx(n + 1, t - 1, u, v)];
+                if (t > 1) val += (t - 1) * scratch[idx(n + 1, t - 2, u, v)];
+            } else if (u > 0) {
+                val = R[1] * scratch[idx(n + 1, t, u - 1, v)];
+                if (u > 1) val += (u - 1) * scratch[idx(n + 1, t, u - 2, v)];
+            } else {
+                val = R[2] * scratch[idx(n + 1, t, u, v - 1)];
+                if (v > 1) val += (v - 1) * scratch[idx(n + 1, t, u, v - 2)];
+            }
+            scratch[idx(n, t, u, v)] = val;
+        }
+    }
+
+    for (size_t c = 0; c < components_.size(); c++) {
+        T[c] = scratch[idx(0, components_[c][0], components_[c][1], components_[c][2])];
+    }
+}
+void CFMM::build_J(std::vector<SharedMatrix>& D, std::vector<SharedMatrix>& J) {
+    int nbf = primary_->nbf();
+
+    // Per-thread J, only the M >= N shell blocks are accumulated
+    std::vector<std::vector<SharedMatrix>> JT(nthread_);
+    for (int thread = 0; thread < nthread_; thread++) {
+        for (size_t N = 0; N < D.size(); N++) {
+            JT[thread].push_back(std::make_shared<Matrix>("J thread", nbf, nbf));
+        }
+    }
+
+    timer_on("CFMM: Far Field");
+    build_J_far(D, JT);
+    timer_off("CFMM: Far Field");
+
+    timer_on("CFMM: Near Field");
+    build_J_near(D, JT);
+    timer_off("CFMM: Near Field");
+
+    // => Reduction and symmetrization <= //
+
+    for (size_t N = 0; N < D.size(); N++) {
+        J[N]->zero();
+        for (int thread = 0; thread < nthread_; thread++) {
+            J[N]->add(JT[thread][N]);
+        }
+        double** Jp = J[N]->pointer();
+        for (int M = 0; M < primary_->nshell(); M++) {
+            int nM = primary_->shell(M).nfunction();
+            int oM = primary_->shell_to_basis_function(M);
+            for (int R = 0; R < M; R++) {
+                int nR = primary_->shell(R).nfunction();
+                int oR = primary_->shell_to_basis_function(R);
+                for (int m = 0; m < nM; m++) {
+                    for (int r = 0; r < nR; r++) {
+                        Jp[oR + r][oM + m] = Jp[oM + m][oR + r];
+                    }
+                }
+            }
+        }
+    }
+}
+void CFMM::build_moments() {
+    const int ncomp = components_.size();
+
+    auto factory = std::make_shared<IntegralFactory>(primary_);
+    std::vector<std::shared_ptr<OneBodyAOInt>> Sints;
+    std::vector<std::shared_ptr<OneBodyAOInt>> Mints;
+    for (int thread = 0; thread < nthread_; thread++) {
+        Sints.push_back(std::shared_ptr<OneBodyAOInt>(factory->ao_overlap()));
+        if (order_ > 0) Mints.push_back(std::shared_ptr<OneBodyAOInt>(factory->ao_multipoles(order_)));
+    }
+
+    box_moments_.assign(nlevels_, std::vector<std::vector<double>>());
+    for (int level = 0; level < nlevels_; level++) {
+        box_moments_[level].resize(far_boxes_[level].size());
+        std::vector<int> boxes;
+        for (size_t box = 0; box < far_boxes_[level].size(); box++) {
+            if (far_boxes_[level][box].size()) boxes.push_back(box);
+        }
+
+        // Q_c,mn = \int m (r - C)^c n about the box center, the pairs of a box are stored back to back
+#pragma omp parallel for schedule(dynamic) num_threads(nthread_)
+        for (size_t ind = 0; ind < boxes.size(); ind++) {
+            int rank = 0;
+#ifdef _OPENMP
+            rank = omp_get_thread_num();
+#endif
+            int box = boxes[ind];
+            Vector3 C = box_center(level, box);
+            size_t size = 0;
+            for (int MN : box_pairs_[level][box]) {
+                size += (size_t)ncomp * primary_->shell(shell_pairs_[MN].first).nfunction() *
+                        primary_->shell(shell_pairs_[MN].second).nfunction();
+            }
+            std::vector<double>& Q = box_moments_[level][box];
+            Q.resize(size);
+
+            size_t offset = 0;
+            for (int MN : box_pairs_[level][box]) {
+                int M = shell_pairs_[MN].first;
+                int N = shell_pairs_[MN].second;
+                int nMN = primary_->shell(M).nfunction() * primary_->shell(N).nfunction();
+                Sints[rank]->compute_shell(M, N);
+                const double* Sbuf = Sints[rank]->buffer();
+                for (int mn = 0; mn < nMN; mn++) Q[offset + mn] = Sbuf[mn];
+                // MultipoleInt carries the electron charge, so flip it back
+                if (order_ > 0) {
+                    Mints[rank]->set_origin(C);
+                    Mints[rank]->compute_shell(M, N);
+                    const double* Mbuf = Mints[rank]->buffer();
+                    for (int c = 1; c < ncomp; c++) {
+                        for (int mn = 0; mn < nMN; mn++) {
+                            Q[offset + c * nMN + mn] = -Mbuf[(c - 1) * nMN + mn];
+                        }
+                    }
+                }
+                offset += (size_t)ncomp * nMN;
+            }
+        }
+    }
+}
+void CFMM::build_J_far(std::vector<SharedMatrix>& D, std::vector<std::vector<SharedMatrix>>& JT) {
+    const size_t nmat = D.size();
+    const int ncomp = components_.size();
+
+    // The pair moments depend only on the tree, so they are built on the first call and reused
+    if (box_moments_.size() != (size_t)nlevels_) {
+        timer_on("CFMM: Pair Moments");
+        build_moments();
+        timer_off("CFMM: Pair Moments");
+    }
+
+    std::vector<std::vector<double>> T_thread(nthread_, std::vector<double>(ncomp));
+    std::vector<std::vector<double>> scratch_thread(nthread_, std::vector<double>((size_t)std::pow(order_ + 1, 4)));
+    std::vector<std::vector<double>> L_thread(nthread_, std::vector<double>(nmat * ncomp));
+
+    for (int level = 0; level < nlevels_; level++) {
+        std::vector<int> boxes;
+        for (size_t box = 0; box < far_boxes_[level].size(); box++) {
+            if (far_boxes_[level][box].size()) boxes.push_back(box);
+        }
+        if (!boxes.size()) continue;
+
+        // => Multipoles of the boxes, scaled by 1 / b! <= //
+
+        std::vector<std::vector<double>> Mbox(far_boxes_[level].size());
+#pragma omp parallel for schedule(dynamic) num_threads(nthread_)
+        for (size_t ind = 0; ind < boxes.size(); ind++) {
+            int box = boxes[ind];
+            std::vector<double>& Mb = Mbox[box];
+            Mb.assign(nmat * ncomp, 0.0);
+            const double* Q = box_moments_[level][box].data();
+
+            for (int MN : box_pairs_[level][box]) {
+                int M = shell_pairs_[MN].first;
+                int N = shell_pairs_[MN].second;
+                int nM = primary_->shell(M).nfunction();
+                int nN = primary_->shell(N).nfunction();
+                int oM = primary_->shell_to_basis_function(M);
+                int oN = primary_->shell_to_basis_function(N);
+                int nMN = nM * nN;
+
+                for (size_t i = 0; i < nmat; i++) {
+                    double** Dp = D[i]->pointer();
+                    for (int m = 0, mn = 0; m < nM; m++) {
+                        for (int n = 0; n < nN; n++, mn++) {
+                            double Dmn = Dp[oM + m][oN + n] + (M != N ? Dp[oN + n][oM + m] : 0.0);
+                            for (int c = 0; c < ncomp; c++) {
+                                Mb[i * ncomp + c] += Dmn * Q[c * nMN + mn];
+                            }
+                        }
+                    }
+                }
+                Q += (size_t)ncomp * nMN;
+            }
+            for (size_t i = 0; i < nmat; i++) {
+                for (int c = 0; c < ncomp; c++) {
+                    Mb[i * ncomp + c] *= inverse_factorials_[c];
+                }
+            }
+        }
+
+        // => Local expansions and their contraction with the pair moments <= //
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthread_)
+        for (size_t ind = 0; ind < boxes.size(); ind++) {
+            int rank = 0;
+#ifdef _OPENMP
+            rank = omp_get_thread_num();
+#endif
+            int box = boxes[ind];
+            Vector3 C = box_center(level, box);
+            std::vector<double>& T = T_thread[rank];
+            std::vector<double>& L = L_thread[rank];
+            const double* Q = box_moments_[level][box].data();
+            std::fill(L.begin(), L.end(), 0.0);
+
+            for (int source : far_boxes_[level][box]) {
+                Vector3 R = box_center(level, source) - C;
+                interaction_tensor(R, T, scratch_thread[rank]);
+                const std::vector<double>& Mb = Mbox[source];
+                for (int a = 0; a < ncomp; a++) {
+                    const std::vector<int>& ka = components_[a];
+                    int la = ka[0] + ka[1] + ka[2];
+                    for (int b = 0; b < ncomp; b++) {
+                        const std::vector<int>& kb = components_[b];
+                        if (la + kb[0] + kb[1] + kb[2] > order_) break;
+                        double Tab = T[component_index_[ka[0] + kb[0]][ka[1] + kb[1]][ka[2] + kb[2]]];
+                        for (size_t i = 0; i < nmat; i++) {
+                            L[i * ncomp + a] += Tab * Mb[i * ncomp + b];
+                        }
+                    }
+                }
+            }
+            for (int a = 0; a < ncomp; a++) {
+                const std::vector<int>& ka = components_[a];
+                double sign = ((ka[0] + ka[1] + ka[2]) % 2 ? -1.0 : 1.0);
+                for (size_t i = 0; i < nmat; i++) {
+                    L[i * ncomp + a] *= sign * inverse_factorials_[a];
+                }
+            }
+
+            for (int MN : box_pairs_[level][box]) {
+                int M = shell_pairs_[MN].first;
+                int N = shell_pairs_[MN].second;
+                int nM = primary_->shell(M).nfunction();
+                int nN = primary_->shell(N).nfunction();
+                int oM = primary_->shell_to_basis_function(M);
+                int oN = primary_->shell_to_basis_function(N);
+                int nMN = nM * nN;
+
+                for (size_t i = 0; i < nmat; i++) {
+                    double** Jp = JT[rank][i]->pointer();
+                    for (int m = 0, mn = 0; m < nM; m++) {
+                        for (int n = 0; n < nN; n++, mn++) {
+                            double val = 0.0;
+                            for (int c = 0; c < ncomp; c++) {
+                                val += L[i * ncomp + c] * Q[c * nMN + mn];
+                            }
+                            Jp[oM + m][oN + n] += val;
+                        }
+                    }
+                }
+                Q += (size_t)ncomp * nMN;
+            }
+        }
+    }
+}
+void CFMM::build_J_near(std::vector<SharedMatrix>& D, std::vector<std::vector<SharedMatrix>>& JT) {
+    const size_t nmat = D.size();
+    const int leaf = nlevels_ - 1;
+
+    auto factory = std::make_shared<IntegralFactory>(primary_, primary_, primary_, primary_);
+    std::vector<std::shared_ptr<TwoBodyAOInt>> ints;
+    ints.push_back(std::shared_ptr<TwoBodyAOInt>(factory->eri()));
+    for (int thread = 1; thread < nthread_; thread++) {
+        if (ints[0]->cloneable())
+            ints.push_back(std::shared_ptr<TwoBodyAOInt>(ints[0]->clone()));
+        else
+            ints.push_back(std::shared_ptr<TwoBodyAOInt>(factory->eri()));
+    }
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthread_)
+    for (size_t ind = 0; ind < near_boxes_.size(); ind++) {
+        int rank = 0;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        int A = near_boxes_[ind].first;
+        int B = near_boxes_[ind].second;
+        const double* buffer = ints[rank]->buffer();
+
+        for (int MN : box_pairs_[leaf][A]) {
+            int M = shell_pairs_[MN].first;
+            int N = shell_pairs_[MN].second;
+            int nM = primary_->shell(M).nfunction();
+            int nN = primary_->shell(N).nfunction();
+            int oM = primary_->shell_to_basis_function(M);
+            int oN = primary_->shell_to_basis_function(N);
+            for (int RS : box_pairs_[leaf][B]) {
+                // Within a box, every pair of pairs once
+                if (A == B && RS > MN) break;
+                int R = shell_pairs_[RS].first;
+                int S = shell_pairs_[RS].second;
+                if (!sieve_->shell_significant(M, N, R, S)) continue;
+                int nR = primary_->shell(R).nfunction();
+                int nS = primary_->shell(S).nfunction();
+                int oR = primary_->shell_to_basis_function(R);
+                int oS = primary_->shell_to_basis_function(S);
+
+                ints[rank]->compute_shell(M, N, R, S);
+
+                for (size_t i = 0; i < nmat; i++) {
+                    double** Dp = D[i]->pointer();
+                    double** Jp = JT[rank][i]->pointer();
+                    const double* val = buffer;
+                    for (int m = 0; m < nM; m++) {
+                        for (int n = 0; n < nN; n++) {
+                            double Dmn = Dp[oM + m][oN + n] + (M != N ? Dp[oN + n][oM + m] : 0.0);
+                            double Jmn = 0.0;
+                            for (int r = 0; r < nR; r++) {
+                                for (int s = 0; s < nS; s++, val++) {
+                                    double Drs = Dp[oR + r][oS + s] + (R != S ? Dp[oS + s][oR + r] : 0.0);
+                                    Jmn += (*val) * Drs;
+                                    if (MN != RS) Jp[oR + r][oS + s] += (*val) * Dmn;
+                                }
+                            }
+                            Jp[oM + m][oN + n] += Jmn;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+void CFMM::print_header() const {
+    if (print_) {
+        size_t nfar = 0;
+        for (const auto& level : far_boxes_) {
+            for (const auto& box : level) nfar += box.size();
+        }
+        outfile->Printf("  ==> CFMM: Continuous Fast Multipole Coulomb <==\n\n");
+        outfile->Printf("    Multipole Order:   %11d\n", order_);
+        outfile->Printf("    Tree Levels:       %11d\n", nlevels_);
+        outfile->Printf("    Root Box [bohr]:   %11.3f\n", length_);
+        outfile->Printf("    Shell Pairs:       %11zu\n", shell_pairs_.size());
+        outfile->Printf("    Far Box Pairs:     %11zu\n", nfar / 2);
+        outfile->Printf("    Near Box Pairs:    %11zu\n\n", near_boxes_.size());
+    }
+}
+
+}  // namespace psi
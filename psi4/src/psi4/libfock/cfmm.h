@@ -0,0 +1,184 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2019 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef libfock_cfmm_H
+#define libfock_cfmm_H
+
+#include "psi4/pragma.h"
+#include "psi4/libmints/typedefs.h"
+#include "psi4/libmints/vector3.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace psi {
+
+class BasisSet;
+class ERISieve;
+
+/**
+ * Class CFMM
+ *
+ * Continuous fast multipole method for Coulomb (J) matrices.
+ *
+ * The significant shell pairs (charge distributions) are sorted by
+ * their centers into an octree. Box pairs are classified top-down:
+ * a box pair whose bounding spheres (box center to the farthest
+ * extent of any of its charge distributions) are well separated
+ * interacts through Cartesian multipoles of order p, otherwise the
+ * children are examined, and at the leaf level the remaining box
+ * pairs are handled with exact ERIs.
+ *
+ * The multipoles of a box about its center are contracted from the
+ * MultipoleInt integrals of its shell pairs, the local expansion
+ *
+ *   L^A_a = (-1)^|a| / a! \sum_B \sum_b T_{a+b}(R_AB) M^B_b / b!
+ *
+ * is formed with the derivatives T of 1/R, and then contracted back
+ * with the same integrals, J_mn = \sum_a L^A_a Q^A_mn,a.
+ *
+ * Usage:
+ *   auto cfmm = std::make_shared<CFMM>(primary);
+ *   cfmm->set_cutoff(1.0E-12);
+ *   cfmm->initialize();
+ *   cfmm->build_J(D, J);
+ *
+ * Only the symmetric part of D contributes to J, so generalized
+ * (non-symmetric) densities are fine. J is zeroed on entry.
+ */
+class PSI_API CFMM {
+   protected:
+    /// Primary basis set
+    std::shared_ptr<BasisSet> primary_;
+    /// Sieve for the significant shell pairs and near-field quartets
+    std::shared_ptr<ERISieve> sieve_;
+
+    /// Print flag
+    int print_;
+    /// Number of OpenMP threads
+    int nthread_;
+    /// Schwarz cutoff (also sets the extents of the charge distributions)
+    double cutoff_;
+    /// Multipole order p
+    int order_;
+    /// Number of tree levels, 0 to choose automatically
+    int levels_;
+    /// Number of tree levels in use
+    int nlevels_;
+    /// Bounding spheres must satisfy R >= separation * (r_A + r_B) for far field
+    double separation_;
+
+    // => Charge distributions <= //
+
+    /// Significant shell pairs (M >= N)
+    std::vector<std::pair<int, int>> shell_pairs_;
+    /// Centers of the shell pairs
+    std::vector<Vector3> pair_centers_;
+    /// Extents of the shell pairs
+    std::vector<double> pair_extents_;
+
+    // => Tree <= //
+
+    /// Origin (lowest corner) of the root box
+    Vector3 origin_;
+    /// Edge length of the root box
+    double length_;
+    /// Shell pairs in each box, [level][box]
+    std::vector<std::vector<std::vector<int>>> box_pairs_;
+    /// Bounding radius of each box about its center, [level][box]
+    std::vector<std::vector<double>> box_radii_;
+    /// Far-field interaction lists, [level][box] -> boxes on the same level
+    std::vector<std::vector<std::vector<int>>> far_boxes_;
+    /// Near-field leaf box pairs (A <= B)
+    std::vector<std::pair<int, int>> near_boxes_;
+
+    // => Multipole bookkeeping <= //
+
+    /// Cartesian components (lx, ly, lz) up to order p, in MultipoleInt order
+    std::vector<std::vector<int>> components_;
+    /// 1 / (lx! ly! lz!) of each component
+    std::vector<double> inverse_factorials_;
+    /// Index of each (lx, ly, lz) in components_, [lx][ly][lz]
+    std::vector<std::vector<std::vector<int>>> component_index_;
+    /// Pair moments Q_c,mn about the box center of every far-field box, [level][box],
+    /// built on the first build_J and kept until the next initialize
+    std::vector<std::vector<std::vector<double>>> box_moments_;
+
+    /// Number of boxes per edge on a level
+    int nside(int level) const { return 1 << level; }
+    /// Center of a box
+    Vector3 box_center(int level, int box) const;
+    /// Sort the shell pairs into the tree
+    void build_tree();
+    /// Classify a box pair on a level into far/near or descend
+    void classify(int level, int A, int B);
+    /// Children of a box that hold shell pairs
+    std::vector<int> children(int level, int box) const;
+
+    /// Derivatives T_tuv of 1/R up to order p, flattened over components_
+    void interaction_tensor(const Vector3& R, std::vector<double>& T, std::vector<double>& scratch) const;
+    /// Pair moments of the far-field boxes about their centers
+    void build_moments();
+    /// Far-field (multipole) part of J
+    void build_J_far(std::vector<SharedMatrix>& D, std::vector<std::vector<SharedMatrix>>& JT);
+    /// Near-field (exact ERI) part of J
+    void build_J_near(std::vector<SharedMatrix>& D, std::vector<std::vector<SharedMatrix>>& JT);
+
+   public:
+    // => Constructors <= //
+
+    /// @param primary primary basis set
+    CFMM(std::shared_ptr<BasisSet> primary);
+    virtual ~CFMM();
+
+    // => Computers <= //
+
+    /// Build the sieve, the tree and the interaction lists
+    void initialize();
+    /// J[N]_mn = \sum_ls (mn|ls) D[N]_ls
+    void build_J(std::vector<SharedMatrix>& D, std::vector<SharedMatrix>& J);
+    /// Print the header and tree statistics
+    void print_header() const;
+
+    // => Knobs <= //
+
+    void set_print(int print) { print_ = print; }
+    void set_nthread(int nthread) { nthread_ = nthread; }
+    void set_cutoff(double cutoff) { cutoff_ = cutoff; }
+    /// Multipole order, defaults to 10
+    void set_order(int order) { order_ = order; }
+    /// Number of tree levels, 0 (default) chooses ~4 bohr leaf boxes
+    void set_levels(int levels) { levels_ = levels; }
+    /// Well-separatedness ratio for bounding spheres, defaults to 1.5
+    void set_separation(double separation) { separation_ = separation; }
+};
+
+}  // namespace psi
+
+#endif
@@ -39,7 +39,9 @@
 #include "psi4/libmints/basisset.h"
 #include "psi4/libmints/molecule.h"
 #include "psi4/libmints/matrix.h"
+#include "psi4/libpsio/psio.hpp"
 
+#include <algorithm>
 #include <vector>
 #include <string>
 #include <sstream>
@@ -47,6 +49,20 @@
 #include <limits>
 #include <cctype>
 #include <cassert>
+#include <cstdint>
+
+#ifdef _MSC_VER
+#include <io.h>
+#include <process.h>
+#define SYSTEM_GETPID ::_getpid
+#else
+#include <dirent.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define SYSTEM_GETPID ::getpid
+#endif
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -2774,6 +2790,17 @@ class NuclearWeightMgr {
     std::shared_ptr<Molecule> molecule_;
     double **inv_dist_;
     double **amatrix_;
+    // For each atom i, the partner atoms j that enter its cell function, sorted by `cutoff'. Whenever
+    // dist(point, i) < cutoff the step function s(i,j) is exactly one, so the pair can be skipped.
+    struct AtomPair {
+        int B;
+        double cutoff;
+        double inv_dist;
+        double a;
+    };
+    std::vector<std::vector<AtomPair>> pairs_;
+    // zero_gap_[i][j]: once dist(point, i) - dist(point, j) exceeds this, s(i,j) == 0 and so does the cell function of i
+    double **zero_gap_;
     ////
 
     inline double distToAtom(MassPoint mp, int A) const {
@@ -2786,6 +2813,7 @@ class NuclearWeightMgr {
     static double SmoothBeckeMu(double ri, double rj, double inv_rij);
     static double BeckeStepFunction(double x);
     static double StratmannStepFunction(double mu);
+    static double StratmannMuCutoff(double aij);
 
     // Becke says u = (chi-1)/(chi+1), a = u/(u^2-1), then clip so that |a| <= 1/2.
     // We can save a step and find `a' directly from chi.
@@ -2802,6 +2830,7 @@ class NuclearWeightMgr {
     ~NuclearWeightMgr();
     double GetStratmannCutoff(int A) const;
     double computeNuclearWeight(MassPoint mp, int A, double stratmannCutoff) const;
+    void computeNuclearWeights(const MassPoint *pts, size_t npts, int A, double stratmannCutoff, double *w) const;
 };
 
 const char *NuclearWeightMgr::nuclearschemenames[] = {"NAIVE", "BECKE", "TREUTLER", "STRATMANN",
@@ -2813,6 +2842,7 @@ NuclearWeightMgr::NuclearWeightMgr(std::shared_ptr<Molecule> mol, int scheme) {
     molecule_ = mol;
     inv_dist_ = block_matrix(natom, natom);
     amatrix_ = block_matrix(natom, natom);
+    zero_gap_ = block_matrix(natom, natom);
 
     // inv_dist[A][B] = 1/(distance between atoms A and B)
     for (int A = 0; A < natom; A++) {
@@ -2841,11 +2871,45 @@ NuclearWeightMgr::NuclearWeightMgr(std::shared_ptr<Molecule> mol, int scheme) {
     } else {
         throw PSIEXCEPTION("Unrecognized weighting scheme!");
     }
+
+    // Atom-pair screening. By the triangle inequality mu(i,j) <= 2 r_i / R_ij - 1, so a point close enough
+    // to atom i lies deep inside its half of the (i,j) pair and s(i,j) == 1 exactly. Only the Stratmann and
+    // smoothed Becke step functions saturate; the plain Becke polynomial never reaches one inside the pair.
+    // The cutoffs are shrunk by a tiny relative margin to stay clear of rounding in the triangle inequality.
+    // The mirror image bounds the far side of the pair, where s(i,j) == 0 and atom i drops out altogether.
+    const double margin = 1.0 - 1.0E-10;
+    pairs_.resize(natom);
+    for (int i = 0; i < natom; i++) {
+        pairs_[i].clear();
+        for (int j = 0; j < natom; j++) {
+            if (i == j) continue;
+            double R = 1.0 / inv_dist_[i][j];
+            double cutoff = 0.0;
+            if (scheme_ == STRATMANN) {
+                cutoff = R * (1 + StratmannMuCutoff(amatrix_[i][j])) / 2;
+            } else if (scheme_ == SBECKE) {
+                cutoff = std::max(0.0, (R - 5.0) / 2);  // mu clips to -1 once r_j - r_i >= RCut
+            }
+            pairs_[i].push_back({j, cutoff * margin, inv_dist_[i][j], amatrix_[i][j]});
+
+            double gap = std::numeric_limits<double>::infinity();
+            if (scheme_ == STRATMANN) {
+                gap = -R * StratmannMuCutoff(-amatrix_[i][j]);  // nu(i,j) > 0.64 mirrors nu(j,i) < -0.64
+            } else if (scheme_ == SBECKE) {
+                gap = std::min(R, 5.0);  // mu clips to +1
+            }
+            zero_gap_[i][j] = gap / margin;
+        }
+        // Stable, so that the unscreened schemes keep the original product order
+        std::stable_sort(pairs_[i].begin(), pairs_[i].end(),
+                         [](const AtomPair &l, const AtomPair &r) { return l.cutoff < r.cutoff; });
+    }
 }
 
 NuclearWeightMgr::~NuclearWeightMgr() {
     free_block(inv_dist_);
     free_block(amatrix_);
+    free_block(zero_gap_);
 }
 int NuclearWeightMgr::WhichScheme(const char *schemename) {
     for (size_t i = 0; i < sizeof(nuclearschemenames) / sizeof(nuclearschemenames[0]); i++)
@@ -2855,24 +2919,17 @@ int NuclearWeightMgr::WhichScheme(const char *schemename) {
 }
 
 // See Becke, J. Chem. Phys. 88 (1988) 2547-2553 (standard mu)
-double NuclearWeightMgr::BeckeMu(double ri, double rj, double inv_rij) { return (ri - rj) * inv_rij; }
+inline double NuclearWeightMgr::BeckeMu(double ri, double rj, double inv_rij) { return (ri - rj) * inv_rij; }
 
 // smoother Becke (SBECKE) integration after Ochsenfeld J. Chem. Phys. 149, 204111 (2018); doi: 10.1063/1.5049435
-double NuclearWeightMgr::SmoothBeckeMu(double ri, double rj, double inv_rij) {
-    static double RCut = 5.0;
-    static double invRCut = 1.0 / RCut;
+inline double NuclearWeightMgr::SmoothBeckeMu(double ri, double rj, double inv_rij) {
+    const double invRCut = 1.0 / 5.0;  // RCut = 5.0
     double mu = (ri - rj) * std::max(inv_rij, invRCut);
-    if (mu <= -1.0) {
-        return -1.0;
-    } else if (mu >= 1.0) {
-        return 1.0;
-    } else {
-        return mu;
-    }
+    return std::min(std::max(mu, -1.0), 1.0);
 }
 
 // See Becke, J. Chem. Phys. 88 (1988) 2547-2553
-double NuclearWeightMgr::BeckeStepFunction(double x) {
+inline double NuclearWeightMgr::BeckeStepFunction(double x) {
     double px = x * (3 - x * x) / 2;
     double ppx = px * (3 - px * px) / 2;
     double pppx = ppx * (3 - ppx * ppx) / 2;  // Same as f(x)
@@ -2881,14 +2938,24 @@ double NuclearWeightMgr::BeckeStepFunction(double x) {
 
 // See R. E. Stratmann, G. E. Scuseria, and M. J. Frisch, Chem. Phys. Letters 257 (1996) 213-223
 // Note that we often plug `nu' into this step function, not `mu.'
-double NuclearWeightMgr::StratmannStepFunction(double mu) {
+// Written without branches so that it vectorizes: the polynomial is exactly +-1 at x = +-1, so clamping
+// x gives 1 when we are much closer to atom i than to atom j and 0 when we are very far from atom i.
+inline double NuclearWeightMgr::StratmannStepFunction(double mu) {
     const double a = 0.64;
-    if (mu < -a) return 1;  // We are much closer to atom i than to atom j.
-    if (mu > a) return 0;   // We are very far from atom i.
-    double x = mu / a;
+    double x = std::min(std::max(mu / a, -1.0), 1.0);
     double x2 = x * x;
     double z = x * (35 + x2 * (-35 + x2 * (21 + x2 * -5))) / 16;
-    return (1 - z) / 2;  // We are a medium distance from atom i.
+    return (1 - z) / 2;
+}
+
+// The value of mu below which nu = mu + aij*(1-mu*mu) < -0.64, so that the Stratmann step function is one.
+// See the derivation in GetStratmannCutoff.
+double NuclearWeightMgr::StratmannMuCutoff(double aij) {
+    return (aij == 0) ? -0.64  // Then nu = mu, so to get nu < -0.64 we need mu < -0.64
+                      : (aij >= 1 / 6.56)
+                            ? -1  // If aij > 1/6.56 = 1/(4*(1+0.64)), then there's no solution.
+                            : (aij > 0) ? (1 - sqrt(4 * aij * (aij + 0.64) + 1)) / (2 * aij)
+                                        : (1 + sqrt(4 * aij * (aij + 0.64) + 1)) / (2 * aij);  // aij < 0
 }
 
 // If the distance between a grid point and its parent atom is less than the number
@@ -2936,46 +3003,144 @@ double NuclearWeightMgr::GetStratmannCutoff(int A) const {
     //   whe
     // mu = 1+(-1\pm sqrt(1+4*a*(nu-1)))/(2*a)
     // If
-    double aij = maxAMatrixEntry;
-    double mucutoff = (aij == 0) ? -0.64  // Then nu = mu, so to get nu < -0.64 we need mu < -0.64
-                                 : (aij >= 1 / 6.56)
-                                       ? -1  // If aij > 1/6.56 = 1/(4*(1+0.64)), then there's no solution.
-                                       : (aij > 0) ? (1 - sqrt(4 * aij * (aij + 0.64) + 1)) / (2 * aij)
-                                                   : (1 + sqrt(4 * aij * (aij + 0.64) + 1)) / (2 * aij)  // aij < 0
-        ;
+    double mucutoff = StratmannMuCutoff(maxAMatrixEntry);
 
     return distToNearestAtom * (1 + mucutoff) / 2;
 }
 
 double NuclearWeightMgr::computeNuclearWeight(MassPoint mp, int A, double stratmannCutoff) const {
-    // Stratmann's step function gives us this handy check
-    if (scheme_ == STRATMANN && distToAtom(mp, A) <= stratmannCutoff) return 1;
+    double w;
+    computeNuclearWeights(&mp, 1, A, stratmannCutoff, &w);
+    return w;
+}
 
+// Computes the Becke partition weight of atom A for a batch of points (typically one radial shell).
+// The atom-pair loops run over the batch at once so that the step functions vectorize. For the
+// saturating schemes, points drop out of an atom's loop once its cell function vanishes, and the pair
+// list is cut short as soon as every remaining point sits inside the pair's cutoff.
+void NuclearWeightMgr::computeNuclearWeights(const MassPoint *pts, size_t npts, int A, double stratmannCutoff,
+                                             double *w) const {
+    const size_t max_batch = 128;
     int natom = molecule_->natom();
-    // Find the distance from point mp to each atom in the molecule.
-    std::vector<double> dist(natom);
-    for (int l = 0; l < natom; l++) dist[l] = distToAtom(mp, l);
 
-    double (*stepFunction)(double) = (scheme_ == STRATMANN) ? StratmannStepFunction : BeckeStepFunction;
-    double (*muFunction)(double, double, double) = (scheme_ == SBECKE) ? SmoothBeckeMu : BeckeMu;
+    std::vector<double> dist(natom * max_batch);
+    std::vector<double> prod(max_batch);
+    std::vector<double> numerator(max_batch);
+    std::vector<double> denominator(max_batch);
+    std::vector<double> px(max_batch), py(max_batch), pz(max_batch);
+    std::vector<size_t> index(max_batch);
+    std::vector<size_t> live(max_batch);
+    std::vector<double> live_r(max_batch);
+
+    size_t start = 0;
+    while (start < npts) {
+        // Gather the points that still need work. Stratmann's step function gives us a handy check
+        size_t nb = 0;
+        for (; start < npts && nb < max_batch; start++) {
+            const MassPoint &mp = pts[start];
+            if (scheme_ == STRATMANN && distToAtom(mp, A) <= stratmannCutoff) {
+                w[start] = 1;
+                continue;
+            }
+            px[nb] = mp.x;
+            py[nb] = mp.y;
+            pz[nb] = mp.z;
+            index[nb] = start;
+            nb++;
+        }
+        if (nb == 0) continue;
+
+        // Find the distance from each point to each atom in the molecule.
+        for (int l = 0; l < natom; l++) {
+            double *dl = &dist[l * max_batch];
+            const double Rx = molecule_->x(l);
+            const double Ry = molecule_->y(l);
+            const double Rz = molecule_->z(l);
+#pragma omp simd
+            for (size_t p = 0; p < nb; p++) {
+                double dx = px[p] - Rx;
+                double dy = py[p] - Ry;
+                double dz = pz[p] - Rz;
+                dl[p] = sqrt(dx * dx + dy * dy + dz * dz);
+            }
+        }
+
+        std::fill(denominator.begin(), denominator.begin() + nb, 0.0);
+        std::fill(numerator.begin(), numerator.begin() + nb, 0.0);
+        const bool saturates = (scheme_ == STRATMANN || scheme_ == SBECKE);
+        const double *rA = &dist[A * max_batch];
+        for (int i = 0; i < natom; i++) {
+            const double *ri = &dist[i * max_batch];
+
+            // Points of the batch where the cell function of atom i can still be nonzero. The batch
+            // surrounds atom A, so most distant atoms are cut off by A itself.
+            size_t nlive = 0;
+            double rmax = 0.0;
+            const double gap = (i == A) ? std::numeric_limits<double>::infinity() : zero_gap_[i][A];
+            for (size_t p = 0; p < nb; p++) {
+                if (ri[p] - rA[p] > gap) continue;
+                live[nlive] = p;
+                live_r[nlive] = ri[p];
+                prod[nlive] = 1.0;
+                rmax = std::max(rmax, ri[p]);
+                nlive++;
+            }
 
-    double numerator = NAN;
-    double denominator = 0;
-    for (int i = 0; i < natom; i++) {
-        double prod = 1;
-        for (int j = 0; j < natom; j++) {
-            if (i == j) continue;
-            // if ( dist[j] >= (dist[i]+RCut) ) continue; // sugested cutoff
-            double mu = muFunction(dist[i], dist[j], inv_dist_[i][j]);
-            double nu = mu + amatrix_[i][j] * (1 - mu * mu);  // Adjust for ratios between atomic radii
-            double s = stepFunction(nu);
-            prod *= s;
-            if (prod == 0) break;  // Under the Stratmann scheme, this should happen often enough to be worth the test.
+            for (const AtomPair &pair : pairs_[i]) {
+                if (nlive == 0 || pair.cutoff > rmax) break;  // All remaining pairs are exactly one
+                const double *rj = &dist[pair.B * max_batch];
+                const double inv_rij = pair.inv_dist;
+                const double aij = pair.a;
+                const double cutoff = pair.cutoff;
+                if (scheme_ == STRATMANN) {
+#pragma omp simd
+                    for (size_t q = 0; q < nlive; q++) {
+                        double mu = BeckeMu(live_r[q], rj[live[q]], inv_rij);
+                        double nu = mu + aij * (1 - mu * mu);  // Adjust for ratios between atomic radii
+                        double s = StratmannStepFunction(nu);
+                        prod[q] *= (live_r[q] < cutoff) ? 1.0 : s;
+                    }
+                } else if (scheme_ == SBECKE) {
+#pragma omp simd
+                    for (size_t q = 0; q < nlive; q++) {
+                        double mu = SmoothBeckeMu(live_r[q], rj[live[q]], inv_rij);
+                        double nu = mu + aij * (1 - mu * mu);
+                        double s = BeckeStepFunction(nu);
+                        prod[q] *= (live_r[q] < cutoff) ? 1.0 : s;
+                    }
+                } else {
+#pragma omp simd
+                    for (size_t q = 0; q < nlive; q++) {
+                        double mu = BeckeMu(live_r[q], rj[live[q]], inv_rij);
+                        double nu = mu + aij * (1 - mu * mu);
+                        prod[q] *= BeckeStepFunction(nu);
+                    }
+                }
+                if (!saturates) continue;
+
+                // Drop the points whose cell function just hit zero. Under the Stratmann scheme, this should
+                // happen often enough to be worth the test.
+                size_t nkeep = 0;
+                rmax = 0.0;
+                for (size_t q = 0; q < nlive; q++) {
+                    if (prod[q] == 0) continue;
+                    live[nkeep] = live[q];
+                    live_r[nkeep] = live_r[q];
+                    prod[nkeep] = prod[q];
+                    rmax = std::max(rmax, live_r[q]);
+                    nkeep++;
+                }
+                nlive = nkeep;
+            }
+
+            for (size_t q = 0; q < nlive; q++) denominator[live[q]] += prod[q];
+            if (i == A) {
+                for (size_t q = 0; q < nlive; q++) numerator[live[q]] = prod[q];
+            }
         }
-        if (i == A) numerator = prod;  // Meow: If we do `i == A' first, then we can check to see if numerator == 0...
-        denominator += prod;
+
+        for (size_t p = 0; p < nb; p++) w[index[p]] = numerator[p] / denominator[p];
     }
-    return numerator / denominator;
 }
 
 class OrientationMgr {
@@ -3748,6 +3913,8 @@ void MolecularGrid::buildGridFromOptions(MolecularGridOptions const &opt) {
     for (int A = 0; A < molecule_->natom(); A++) {
         int Z = molecule_->true_atomic_number(A);
         double stratmannCutoff = nuc.GetStratmannCutoff(A);
+        std::vector<MassPoint> shell;  // One radial shell (or named grid), weighted as a batch
+        std::vector<double> nucw;
         
 #ifdef USING_BrianQC
         if (brianEnable and brianEnableDFT) {
@@ -3800,12 +3967,17 @@ void MolecularGrid::buildGridFromOptions(MolecularGridOptions const &opt) {
 
                 // RMP: And this stuff! This whole thing is completely and utterly FUBAR.
                 spherical_grids_[A].push_back(SphericalGrid::build("Unknown", numAngPts, anggrid));
+                shell.resize(numAngPts);
+                nucw.resize(numAngPts);
                 for (int j = 0; j < numAngPts; j++) {
                     MassPoint mp = {r[i] * anggrid[j].x, r[i] * anggrid[j].y, r[i] * anggrid[j].z,
                                     wr[i] * anggrid[j].w};
-                    mp = std_orientation.MoveIntoPosition(mp, A);
-                    mp.w *= nuc.computeNuclearWeight(mp, A, stratmannCutoff);  // This ain't gonna fly. Must abate this
-                                                                               // mickey mouse a most rikky tikki tavi.
+                    shell[j] = std_orientation.MoveIntoPosition(mp, A);
+                }
+                nuc.computeNuclearWeights(shell.data(), numAngPts, A, stratmannCutoff, nucw.data());
+                for (int j = 0; j < numAngPts; j++) {
+                    MassPoint mp = shell[j];
+                    mp.w *= nucw[j];
                     if (std::abs(mp.w) > weightcut) {grid[A].push_back(mp);}
                     assert(!std::isnan(mp.w));
                 }
@@ -3821,11 +3993,13 @@ void MolecularGrid::buildGridFromOptions(MolecularGridOptions const &opt) {
             const MassPoint *sg =
                 (opt.namedGrid == 0) ? StandardGridMgr::GetSG0grid(Z) : StandardGridMgr::GetSG1grid(Z);
 
+            shell.resize(npts);
+            nucw.resize(npts);
+            for (int i = 0; i < npts; i++) shell[i] = std_orientation.MoveIntoPosition(sg[i], A);
+            nuc.computeNuclearWeights(shell.data(), npts, A, stratmannCutoff, nucw.data());
             for (int i = 0; i < npts; i++) {
-                MassPoint mp = std_orientation.MoveIntoPosition(sg[i], A);
-                mp.w *= nuc.computeNuclearWeight(
-                    mp, A,
-                    stratmannCutoff);  // This ain't gonna fly. Must abate this mickey mouse a most rikky tikki tavi.
+                MassPoint mp = shell[i];
+                mp.w *= nucw[i];
                 if (std::abs(mp.w) > weightcut) {grid[A].push_back(mp);}
                 assert(!std::isnan(mp.w));
             }
@@ -3953,6 +4127,8 @@ void MolecularGrid::buildGridFromOptions(MolecularGridOptions const &opt, const
     for (int A = 0; A < molecule_->natom(); A++) {
         int Z = molecule_->true_atomic_number(A);
         double stratmannCutoff = nuc.GetStratmannCutoff(A);
+        std::vector<MassPoint> shell;  // One radial shell (or named grid), weighted as a batch
+        std::vector<double> nucw;
 
         std::vector<double> r(rs[A].size()), wr(rs[A].size());
         double alpha = GetBSRadius(Z) * opt.bs_radius_alpha;
@@ -3975,12 +4151,16 @@ void MolecularGrid::buildGridFromOptions(MolecularGridOptions const &opt, const
             // RMP: And this stuff! This whole thing is completely and utterly FUBAR.
             spherical_grids_[A].push_back(SphericalGrid::build("Unknown", numAngPts, anggrid));
 
+            shell.resize(numAngPts);
+            nucw.resize(numAngPts);
             for (int j = 0; j < numAngPts; j++) {
                 MassPoint mp = {r[i] * anggrid[j].x, r[i] * anggrid[j].y, r[i] * anggrid[j].z, wr[i] * anggrid[j].w};
-                mp = std_orientation.MoveIntoPosition(mp, A);
-                mp.w *= nuc.computeNuclearWeight(
-                    mp, A,
-                    stratmannCutoff);  // This ain't gonna fly. Must abate this mickey mouse a most rikky tikki tavi.
+                shell[j] = std_orientation.MoveIntoPosition(mp, A);
+            }
+            nuc.computeNuclearWeights(shell.data(), numAngPts, A, stratmannCutoff, nucw.data());
+            for (int j = 0; j < numAngPts; j++) {
+                MassPoint mp = shell[j];
+                mp.w *= nucw[j];
                 if (std::abs(mp.w) > weightcut) {grid[A].push_back(mp);}
                 assert(!std::isnan(mp.w));
             }
@@ -4264,6 +4444,22 @@ void BlockOPoints::print(std::string out, int print) {
         printer->Printf("\n\n");
     }
 }
+// Raw bytes of everything a cached grid depends on
+class GridCacheKey {
+    std::string bytes_;
+
+   public:
+    template <typename T>
+    void add(const T &value) {
+        bytes_.append(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+    void add(const std::string &value) {
+        add<uint64_t>(value.size());
+        bytes_ += value;
+    }
+    const std::string &str() const { return bytes_; }
+};
+
 DFTGrid::DFTGrid(std::shared_ptr<Molecule> molecule, std::shared_ptr<BasisSet> primary, Options &options)
     : MolecularGrid(molecule), primary_(primary), options_(options) {
     std::map<std::string, std::string> opts_map;
@@ -4343,15 +4539,128 @@ void DFTGrid::buildGridFromOptions(std::map<std::string, int> int_opts_map,
         throw PSIEXCEPTION("Invalid number of spherical points (not a Lebedev number)");
     }
 
-    MolecularGrid::buildGridFromOptions(opt);
-
     // Blocking/sieving info
     int max_points = full_int_options["DFT_BLOCK_MAX_POINTS"];
     int min_points = full_int_options["DFT_BLOCK_MIN_POINTS"];
     double max_radius = options_.get_double("DFT_BLOCK_MAX_RADIUS");
     double epsilon = options_.get_double("DFT_BASIS_TOLERANCE");
     auto extents = std::make_shared<BasisExtents>(primary_, epsilon);
+
+    bool use_cache = options_.get_bool("DFT_GRID_CACHE");
+#ifdef USING_BrianQC
+    // BrianQC picks up the grid as a side effect of building it
+    if (brianEnable and brianEnableDFT) use_cache = false;
+#endif
+
+    // Everything the points, weights, and blocking depend on
+    GridCacheKey key;
+    std::string filename;
+    if (use_cache) {
+        key.add(molecule_->natom());
+        for (int A = 0; A < molecule_->natom(); A++) {
+            key.add(molecule_->Z(A));
+            key.add(molecule_->true_atomic_number(A));
+            key.add(molecule_->x(A));
+            key.add(molecule_->y(A));
+            key.add(molecule_->z(A));
+        }
+        key.add(primary_->nshell());
+        for (int Q = 0; Q < primary_->nshell(); Q++) {
+            const GaussianShell &shell = primary_->shell(Q);
+            key.add(shell.am());
+            key.add(shell.is_pure());
+            key.add(shell.ncenter());
+            key.add(shell.nprimitive());
+            for (int K = 0; K < shell.nprimitive(); K++) {
+                key.add(shell.exp(K));
+                key.add(shell.coef(K));
+            }
+        }
+        key.add(opt.bs_radius_alpha);
+        key.add(opt.pruning_alpha);
+        key.add(opt.radscheme);
+        key.add(opt.prunefunction);
+        key.add(opt.nucscheme);
+        key.add(opt.namedGrid);
+        key.add(opt.nradpts);
+        key.add(opt.nangpts);
+        key.add(opt.weights_cutoff);
+        key.add(opt.prunescheme);
+        key.add(opt.prunetype);
+        key.add(max_points);
+        key.add(min_points);
+        key.add(max_radius);
+        key.add(epsilon);
+        key.add(Process::environment.options.get_str("DFT_BLOCK_SCHEME"));
+
+        filename = cache_filename(key.str());
+        if (load_cache(filename, key.str(), extents)) {
+            MolecularGrid::options_ = opt;
+            return;
+        }
+    }
+
+    MolecularGrid::buildGridFromOptions(opt);
     postProcess(extents, max_points, min_points, max_radius);
+
+    if (use_cache) save_cache(filename, key.str());
+}
+
+std::string DFTGrid::cache_dir(Options &options) {
+    std::string path = options.get_str("DFT_GRID_CACHE_DIR");
+    if (path.empty()) path = PSIOManager::shared_object()->get_default_path();
+    if (path.back() != '/') path += '/';
+    return path;
+}
+
+size_t DFTGrid::clear_cache(Options &options) {
+    const std::string path = cache_dir(options);
+    const std::string prefix = "psi.dftgrid.";
+
+    // Only names of the form psi.dftgrid.<hash>.bin (and their unfinished .tmp files) are ours
+    std::vector<std::string> names;
+#ifdef _MSC_VER
+    struct _finddata_t entry;
+    intptr_t handle = _findfirst((path + prefix + "*").c_str(), &entry);
+    if (handle != -1) {
+        do {
+            names.push_back(entry.name);
+        } while (_findnext(handle, &entry) == 0);
+        _findclose(handle);
+    }
+#else
+    DIR *dir = opendir(path.c_str());
+    if (dir) {
+        while (struct dirent *entry = readdir(dir)) {
+            std::string name(entry->d_name);
+            if (name.compare(0, prefix.size(), prefix) == 0) names.push_back(name);
+        }
+        closedir(dir);
+    }
+#endif
+
+    size_t removed = 0;
+    for (const std::string &name : names) {
+        const bool bin = name.size() > 4 && name.compare(name.size() - 4, 4, ".bin") == 0;
+        const bool tmp = name.size() > 4 && name.compare(name.size() - 4, 4, ".tmp") == 0;
+        if (!bin && !tmp) continue;
+        if (std::remove((path + name).c_str()) == 0) removed++;
+    }
+    return removed;
+}
+
+std::string DFTGrid::cache_filename(const std::string &key) const {
+    std::string path = cache_dir(options_);
+
+    // 64-bit FNV-1a of the key. Collisions are caught by comparing the full key stored in the file
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : key) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)hash);
+    return path + "psi.dftgrid." + hex + ".bin";
 }
 
 PseudospectralGrid::PseudospectralGrid(std::shared_ptr<Molecule> molecule, std::shared_ptr<BasisSet> primary,
@@ -4392,7 +4701,7 @@ void PseudospectralGrid::buildGridFromOptions() {
 MolecularGrid::MolecularGrid(std::shared_ptr<Molecule> molecule)
     : debug_(0), molecule_(molecule), npoints_(0), max_points_(0), max_functions_(0) {}
 MolecularGrid::~MolecularGrid() {
-    if (npoints_) {
+    if (npoints_ && !storage_) {
         delete[] x_;
         delete[] y_;
         delete[] z_;
@@ -4487,6 +4796,196 @@ void MolecularGrid::postProcess(std::shared_ptr<BasisExtents> extents, int max_p
     block(max_points, min_points, max_radius);
 }
 
+// Grid cache file layout. Every field is 8-byte aligned so that the arrays can be used in place
+// from a memory map:
+//   magic[8], uint64 key size, key (padded)
+//   uint64 npoints, nblocks, max_points, max_functions, collocation_size
+//   double x[npoints], y[npoints], z[npoints], w[npoints], int32 index[npoints] (padded)
+//   uint64 {index, offset, npoints}[nblocks]
+//   uint64 natom; per atom: uint64 nrad, double alpha, double r[nrad], double wr[nrad], uint64 nsphere[nrad]
+static const char grid_cache_magic[8] = {'P', 'S', 'I', 'G', 'R', 'I', 'D', '1'};
+
+void MolecularGrid::save_cache(const std::string &filename, const std::string &key) const {
+    // Write to a private name and rename, so concurrent jobs never see a partial file
+    std::string tmpname = filename + "." + std::to_string(SYSTEM_GETPID()) + ".tmp";
+    FILE *fh = std::fopen(tmpname.c_str(), "wb");
+    if (!fh) {
+        outfile->Printf("    Unable to write the DFT grid cache %s.\n\n", filename.c_str());
+        return;
+    }
+
+    bool ok = true;
+    auto put = [&](const void *data, size_t bytes) {
+        if (bytes && std::fwrite(data, 1, bytes, fh) != bytes) ok = false;
+        static const char zeros[8] = {0};
+        size_t pad = (8 - bytes % 8) % 8;
+        if (pad && std::fwrite(zeros, 1, pad, fh) != pad) ok = false;
+    };
+    auto put_u64 = [&](size_t value) {
+        uint64_t v = value;
+        put(&v, sizeof(v));
+    };
+
+    put(grid_cache_magic, sizeof(grid_cache_magic));
+    put_u64(key.size());
+    put(key.data(), key.size());
+
+    put_u64(npoints_);
+    put_u64(blocks_.size());
+    put_u64(max_points_);
+    put_u64(max_functions_);
+    put_u64(collocation_size_);
+    put(x_, sizeof(double) * npoints_);
+    put(y_, sizeof(double) * npoints_);
+    put(z_, sizeof(double) * npoints_);
+    put(w_, sizeof(double) * npoints_);
+    static_assert(sizeof(int) == 4, "Grid cache assumes 32-bit int");
+    put(index_, sizeof(int) * npoints_);
+
+    std::vector<uint64_t> block_data;
+    for (const auto &block : blocks_) {
+        block_data.push_back(block->index());
+        block_data.push_back(block->x() - x_);
+        block_data.push_back(block->npoints());
+    }
+    put(block_data.data(), sizeof(uint64_t) * block_data.size());
+
+    put_u64(radial_grids_.size());
+    for (size_t A = 0; A < radial_grids_.size(); A++) {
+        size_t nrad = radial_grids_[A]->npoints();
+        double alpha = radial_grids_[A]->alpha();
+        put_u64(nrad);
+        put(&alpha, sizeof(double));
+        put(radial_grids_[A]->r(), sizeof(double) * nrad);
+        put(radial_grids_[A]->w(), sizeof(double) * nrad);
+        std::vector<uint64_t> nsphere(nrad);
+        for (size_t R = 0; R < nrad; R++) nsphere[R] = spherical_grids_[A][R]->npoints();
+        put(nsphere.data(), sizeof(uint64_t) * nrad);
+    }
+
+    if (std::fclose(fh) != 0) ok = false;
+    if (!ok || std::rename(tmpname.c_str(), filename.c_str()) != 0) {
+        std::remove(tmpname.c_str());
+        outfile->Printf("    Unable to write the DFT grid cache %s.\n\n", filename.c_str());
+    }
+}
+
+bool MolecularGrid::load_cache(const std::string &filename, const std::string &key,
+                               std::shared_ptr<BasisExtents> extents) {
+    // Map the whole file, the point arrays are then used in place
+    size_t bytes = 0;
+    std::shared_ptr<char> storage;
+#ifdef _MSC_VER
+    FILE *fh = std::fopen(filename.c_str(), "rb");
+    if (!fh) return false;
+    std::fseek(fh, 0, SEEK_END);
+    bytes = std::ftell(fh);
+    std::fseek(fh, 0, SEEK_SET);
+    storage = std::shared_ptr<char>(new char[bytes], std::default_delete<char[]>());
+    size_t nread = std::fread(storage.get(), 1, bytes, fh);
+    std::fclose(fh);
+    if (nread != bytes) return false;
+#else
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    bytes = static_cast<size_t>(st.st_size);
+    // Private, writable pages: nothing written through x_ etc. ever reaches the file
+    void *map = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return false;
+    storage = std::shared_ptr<char>(static_cast<char *>(map), [bytes](char *p) { munmap(p, bytes); });
+#endif
+
+    // Bounds-checked cursor over the file
+    size_t offset = 0;
+    auto take = [&](size_t nbytes) -> char * {
+        size_t padded = nbytes + (8 - nbytes % 8) % 8;
+        if (offset + padded > bytes) return nullptr;
+        char *ptr = storage.get() + offset;
+        offset += padded;
+        return ptr;
+    };
+    auto take_u64 = [&](size_t &value) {
+        char *ptr = take(sizeof(uint64_t));
+        if (ptr) value = *reinterpret_cast<uint64_t *>(ptr);
+        return ptr != nullptr;
+    };
+
+    size_t key_size = 0;
+    char *magic = take(sizeof(grid_cache_magic));
+    if (!magic || std::memcmp(magic, grid_cache_magic, sizeof(grid_cache_magic)) != 0) return false;
+    if (!take_u64(key_size) || key_size != key.size()) return false;
+    char *key_data = take(key_size);
+    if (!key_data || std::memcmp(key_data, key.data(), key_size) != 0) return false;
+
+    size_t npoints, nblocks, max_points, max_functions, collocation_size;
+    if (!take_u64(npoints) || !take_u64(nblocks) || !take_u64(max_points) || !take_u64(max_functions) ||
+        !take_u64(collocation_size))
+        return false;
+    char *x = take(sizeof(double) * npoints);
+    char *y = take(sizeof(double) * npoints);
+    char *z = take(sizeof(double) * npoints);
+    char *w = take(sizeof(double) * npoints);
+    char *index = take(sizeof(int) * npoints);
+    auto *block_data = reinterpret_cast<uint64_t *>(take(sizeof(uint64_t) * 3 * nblocks));
+    if (!x || !y || !z || !w || !index || !block_data) return false;
+    for (size_t Q = 0; Q < nblocks; Q++) {
+        if (block_data[3 * Q + 1] + block_data[3 * Q + 2] > npoints) return false;
+    }
+
+    size_t natom;
+    if (!take_u64(natom)) return false;
+    std::vector<std::shared_ptr<RadialGrid>> radial_grids(natom);
+    std::vector<std::vector<std::shared_ptr<SphericalGrid>>> spherical_grids(natom);
+    for (size_t A = 0; A < natom; A++) {
+        size_t nrad;
+        if (!take_u64(nrad)) return false;
+        char *alpha = take(sizeof(double));
+        char *r = take(sizeof(double) * nrad);
+        char *wr = take(sizeof(double) * nrad);
+        auto *nsphere = reinterpret_cast<uint64_t *>(take(sizeof(uint64_t) * nrad));
+        if (!alpha || !r || !wr || !nsphere) return false;
+        radial_grids[A] = RadialGrid::build("Unknown", nrad, reinterpret_cast<double *>(r),
+                                            reinterpret_cast<double *>(wr), *reinterpret_cast<double *>(alpha),
+                                            molecule_->true_atomic_number(A));
+        for (size_t R = 0; R < nrad; R++) {
+            const MassPoint *anggrid = LebedevGridMgr::findGridByNPoints(nsphere[R]);
+            if (!anggrid) return false;
+            spherical_grids[A].push_back(SphericalGrid::build("Unknown", nsphere[R], anggrid));
+        }
+    }
+
+    // The file checks out, adopt it
+    storage_ = storage;
+    npoints_ = npoints;
+    max_points_ = max_points;
+    max_functions_ = max_functions;
+    collocation_size_ = collocation_size;
+    x_ = reinterpret_cast<double *>(x);
+    y_ = reinterpret_cast<double *>(y);
+    z_ = reinterpret_cast<double *>(z);
+    w_ = reinterpret_cast<double *>(w);
+    index_ = reinterpret_cast<int *>(index);
+    radial_grids_ = radial_grids;
+    spherical_grids_ = spherical_grids;
+    orientation_ = OrientationMgr(molecule_).orientation();
+
+    extents_ = extents;
+    primary_ = extents_->basis();
+    blocks_.clear();
+    for (size_t Q = 0; Q < nblocks; Q++) {
+        size_t off = block_data[3 * Q + 1];
+        blocks_.push_back(std::make_shared<BlockOPoints>(block_data[3 * Q], block_data[3 * Q + 2], &x_[off],
+                                                         &y_[off], &z_[off], &w_[off], extents_));
+    }
+    return true;
+}
+
 void MolecularGrid::print(std::string out, int /*print*/) const {
     std::shared_ptr<psi::PsiOutStream> printer = (out == "outfile" ? outfile : std::make_shared<PsiOutStream>(out));
     printer->Printf("   => Molecular Quadrature <=\n\n");
@@ -4506,6 +5005,7 @@ void MolecularGrid::print(std::string out, int /*print*/) const {
     printer->Printf("    Max Points             = %14d\n", max_points_);
     printer->Printf("    Max Functions          = %14d\n", max_functions_);
     printer->Printf("    Weights Tolerance      = %14.2E\n", options_.weights_cutoff);
+    if (storage_) printer->Printf("    Read from Grid Cache   = %14s\n", "TRUE");
     // printer->Printf("    Collocation Size [MiB] = %14d\n", (int)((8.0 * collocation_size_) / (1024.0 * 1024.0)));
     printer->Printf("\n");
     Process::environment.globals["XC GRID TOTAL POINTS"] = npoints_;
@@ -110,6 +110,13 @@ class MolecularGrid {
     void remove_distant_points(double Rcut);
     void block(int max_points, int min_points, double max_radius);
 
+    /// Owner of x_, y_, z_, w_, and index_ when they were read from a grid cache file (otherwise null)
+    std::shared_ptr<char> storage_;
+    /// Read the points and blocking from a grid cache file. Returns false if the file is missing or stale
+    bool load_cache(const std::string& filename, const std::string& key, std::shared_ptr<BasisExtents> extents);
+    /// Write the points and blocking to a grid cache file
+    void save_cache(const std::string& filename, const std::string& key) const;
+
    public:
     struct MolecularGridOptions {
         double bs_radius_alpha;
@@ -180,6 +187,8 @@ class MolecularGrid {
     const std::vector<std::shared_ptr<BlockOPoints> >& blocks() const { return blocks_; }
 
     void set_debug(int debug) { debug_ = debug; }
+    /// Was this grid read from a grid cache file?
+    bool from_cache() const { return storage_ != nullptr; }
 };
 
 class PseudospectralGrid : public MolecularGrid {
@@ -209,12 +218,20 @@ class DFTGrid : public MolecularGrid {
     void buildGridFromOptions(std::map<std::string, int> int_opts_map, std::map<std::string, std::string> opts_map);
     /// The Options object
     Options& options_;
+    /// Path of the grid cache file for this molecule, basis, and grid specification
+    std::string cache_filename(const std::string& key) const;
+    /// Directory holding the grid cache files (DFT_GRID_CACHE_DIR, or the scratch directory)
+    static std::string cache_dir(Options& options);
 
    public:
     DFTGrid(std::shared_ptr<Molecule> molecule, std::shared_ptr<BasisSet> primary, Options& options);
     DFTGrid(std::shared_ptr<Molecule> molecule, std::shared_ptr<BasisSet> primary,
             std::map<std::string, int> int_opts_map, std::map<std::string, std::string> opts_map, Options& options);
     ~DFTGrid() override;
+
+    /// Remove every grid cache file from the cache directory, returns the number of files removed.
+    /// Cache files are never removed automatically, since reuse across jobs is their purpose
+    static size_t clear_cache(Options& options);
 };
 
 class RadialGrid {
@@ -408,6 +425,12 @@ class BlockOPoints {
     double* z() const { return z_; }
     /// The weights. You do not own this
     double* w() const { return w_; }
+    /// Center of the bounding sphere
+    const Vector3& center() const { return xc_; }
+    /// Radius of the bounding sphere
+    double radius() const { return R_; }
+    /// The basis extents used to populate this block
+    std::shared_ptr<BasisExtents> extents() const { return extents_; }
 
     /// Relevant shells, local -> global
     const std::vector<int>& shells_local_to_global() const { return shells_local_to_global_; }
@@ -124,8 +124,8 @@ inline void rks_integrator(std::shared_ptr<BlockOPoints> block, std::shared_ptr<
     ansatz = (ansatz == -1 ? fworker->ansatz() : ansatz);
     // printf("Ansatz %d\n", ansatz);
 
-    // Block data
-    const std::vector<int>& function_map = block->functions_local_to_global();
+    // Block data, the worker may have screened out some of the block's functions
+    const std::vector<int>& function_map = pworker->function_map();
     int nlocal = function_map.size();
     int npoints = block->npoints();
     double* w = block->w();
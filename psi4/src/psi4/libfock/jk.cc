@@ -58,6 +58,11 @@ namespace psi {
 
 template <class T>
 void _set_dfjk_options(T* jk, Options& options) {
+    // An exact CFMM J would not match the fitted K, gradients and response of a DF calculation.
+    // The DF guess of a DIRECT calculation turns CFMM off and builds the fitted J.
+    std::string scf_type = options.get_str("SCF_TYPE");
+    if (options.get_bool("CFMM") && (scf_type == "DF" || scf_type == "MEM_DF" || scf_type == "DISK_DF"))
+        throw PSIEXCEPTION("JK: CFMM builds the exact J and cannot be combined with density-fitted SCF_TYPEs.");
     if (options["INTS_TOLERANCE"].has_changed()) jk->set_cutoff(options.get_double("INTS_TOLERANCE"));
     if (options["PRINT"].has_changed()) jk->set_print(options.get_int("PRINT"));
     if (options["DEBUG"].has_changed()) jk->set_debug(options.get_int("DEBUG"));
@@ -106,8 +111,30 @@ std::shared_ptr<JK> JK::build_JK(std::shared_ptr<BasisSet> primary, std::shared_
         jk->set_wcombine(true);
         _set_dfjk_options<MemDFJK>(jk, options);
         if (options["WCOMBINE"].has_changed()) { jk->set_wcombine(options.get_bool("WCOMBINE")); }
+        if (options["DF_BLOCK_SPARSE_K"].has_changed()) jk->set_block_sparse_K(options.get_bool("DF_BLOCK_SPARSE_K"));
+        if (options["DF_LOCAL_K"].has_changed()) jk->set_local_K(options.get_bool("DF_LOCAL_K"));
+        if (options["DF_LOCAL_K_TYPE"].has_changed()) jk->set_local_K_type(options.get_str("DF_LOCAL_K_TYPE"));
+        if (options["DF_LOCAL_K_TOLERANCE"].has_changed())
+            jk->set_local_K_tolerance(options.get_double("DF_LOCAL_K_TOLERANCE"));
+        if (options["DF_MIXED_PRECISION"].has_changed())
+            jk->set_single_precision(options.get_bool("DF_MIXED_PRECISION"));
 
         return std::shared_ptr<JK>(jk);
+    } else if (jk_type == "DF_J") {
+        DFJ* jk = new DFJ(primary, auxiliary);
+
+        if (options["INTS_TOLERANCE"].has_changed()) jk->set_cutoff(options.get_double("INTS_TOLERANCE"));
+        if (options["PRINT"].has_changed()) jk->set_print(options.get_int("PRINT"));
+        if (options["DEBUG"].has_changed()) jk->set_debug(options.get_int("DEBUG"));
+        if (options["BENCH"].has_changed()) jk->set_bench(options.get_int("BENCH"));
+        if (options["DF_INTS_NUM_THREADS"].has_changed())
+            jk->set_df_ints_num_threads(options.get_int("DF_INTS_NUM_THREADS"));
+        if (options["INCFOCK"].has_changed()) jk->set_incfock(options.get_bool("INCFOCK"));
+        if (options["INCFOCK_FULL_FOCK_EVERY"].has_changed())
+            jk->set_incfock_full_fock_every(options.get_int("INCFOCK_FULL_FOCK_EVERY"));
+
+        return std::shared_ptr<JK>(jk);
+
     } else if (jk_type == "PK") {
         PKJK* jk = new PKJK(primary, options);
 
@@ -133,12 +160,38 @@ std::shared_ptr<JK> JK::build_JK(std::shared_ptr<BasisSet> primary, std::shared_
         DirectJK* jk = new DirectJK(primary);
 
         if (options["INTS_TOLERANCE"].has_changed()) jk->set_cutoff(options.get_double("INTS_TOLERANCE"));
-        if (options["SCREENING"].has_changed()) jk->set_csam(options.get_str("SCREENING") == "CSAM");
+        if (options["SCREENING"].has_changed()) {
+            jk->set_csam(options.get_str("SCREENING") == "CSAM");
+            jk->set_density_screening(options.get_str("SCREENING") == "DENSITY");
+        }
         if (options["PRINT"].has_changed()) jk->set_print(options.get_int("PRINT"));
         if (options["DEBUG"].has_changed()) jk->set_debug(options.get_int("DEBUG"));
         if (options["BENCH"].has_changed()) jk->set_bench(options.get_int("BENCH"));
         if (options["DF_INTS_NUM_THREADS"].has_changed())
             jk->set_df_ints_num_threads(options.get_int("DF_INTS_NUM_THREADS"));
+        if (options["INCFOCK"].has_changed()) jk->set_incfock(options.get_bool("INCFOCK"));
+        if (options["INCFOCK_FULL_FOCK_EVERY"].has_changed())
+            jk->set_incfock_full_fock_every(options.get_int("INCFOCK_FULL_FOCK_EVERY"));
+        if (options["INCFOCK_FULL_FOCK_THRESHOLD"].has_changed())
+            jk->set_incfock_full_fock_threshold(options.get_double("INCFOCK_FULL_FOCK_THRESHOLD"));
+        if (options["CFMM"].has_changed()) jk->set_cfmm(options.get_bool("CFMM"));
+        if (options["CFMM_ORDER"].has_changed()) jk->set_cfmm_order(options.get_int("CFMM_ORDER"));
+        if (options["CFMM_LEVELS"].has_changed()) jk->set_cfmm_levels(options.get_int("CFMM_LEVELS"));
+
+        return std::shared_ptr<JK>(jk);
+
+    } else if (jk_type == "COSX") {
+        COSXJK* jk = new COSXJK(primary, auxiliary, options);
+
+        if (options["INTS_TOLERANCE"].has_changed()) jk->set_cutoff(options.get_double("INTS_TOLERANCE"));
+        if (options["PRINT"].has_changed()) jk->set_print(options.get_int("PRINT"));
+        if (options["DEBUG"].has_changed()) jk->set_debug(options.get_int("DEBUG"));
+        if (options["BENCH"].has_changed()) jk->set_bench(options.get_int("BENCH"));
+        jk->set_condition(options.get_double("DF_FITTING_CONDITION"));
+        jk->set_cosx_radial_points(options.get_int("COSX_RADIAL_POINTS"));
+        jk->set_cosx_spherical_points(options.get_int("COSX_SPHERICAL_POINTS"));
+        if (options["COSX_OVERLAP_FITTING"].has_changed())
+            jk->set_overlap_fitted(options.get_bool("COSX_OVERLAP_FITTING"));
 
         return std::shared_ptr<JK>(jk);
 
@@ -47,6 +47,10 @@ class TwoBodyAOInt;
 class Options;
 class PSIO;
 class DFHelper;
+class DFTGrid;
+class BasisFunctions;
+class PotentialInt;
+class CFMM;
 
 namespace pk {
 class PKManager;
@@ -705,6 +709,49 @@ class PSI_API DirectJK : public JK {
     int df_ints_num_threads_;
     /// ERI Sieve
     std::shared_ptr<ERISieve> sieve_;
+    /// Weight the Schwarz bound by max |D| of each shell quartet? Defaults to false
+    bool density_screening_;
+
+    // => Incremental Fock Build <= //
+
+    /// Build J/K from the change in density, D_n - D_{n-1}? Defaults to false
+    bool incfock_;
+    /// Maximum number of consecutive incremental builds before a full rebuild
+    int incfock_full_fock_every_;
+    /// Relative RMS(dD)/RMS(D) above which a full rebuild is forced
+    double incfock_full_fock_threshold_;
+    /// Number of incremental builds performed since the last full build
+    int incfock_count_;
+    /// Was the current (or last) build incremental?
+    bool do_incfock_iter_;
+    /// lr_symmetric_ value of the previous build
+    bool incfock_lr_symmetric_;
+    /// omega_ value of the previous build
+    double incfock_omega_;
+    /// AO densities of the previous build
+    std::vector<SharedMatrix> D_prev_;
+    /// AO density differences for the current build
+    std::vector<SharedMatrix> delta_D_;
+    /// AO J/K/wK matrices of the previous build
+    std::vector<SharedMatrix> J_prev_;
+    std::vector<SharedMatrix> K_prev_;
+    std::vector<SharedMatrix> wK_prev_;
+
+    // => Continuous Fast Multipole Method <= //
+
+    /// Build J with CFMM instead of the four-index contraction? Defaults to false
+    bool do_cfmm_;
+    /// CFMM multipole order
+    int cfmm_order_;
+    /// CFMM tree levels, 0 to choose automatically
+    int cfmm_levels_;
+    /// CFMM J builder
+    std::shared_ptr<CFMM> cfmm_;
+
+    /// Decide between an incremental or full build and form delta_D_
+    void incfock_setup();
+    /// Add the previous J/K/wK to an incremental result and store the current ones
+    void incfock_postiter();
 
     std::string name() override { return "DirectJK"; }
     size_t memory_estimate() override;
@@ -720,9 +767,10 @@ class PSI_API DirectJK : public JK {
     /// Delete integrals, files, etc
     void postiterations() override;
 
-    /// Build the J and K matrices for this integral class
+    /// Build the J and K matrices for this integral class, contractions are skipped if !build_J or !build_K
     void build_JK(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints, std::vector<std::shared_ptr<Matrix> >& D,
-                  std::vector<std::shared_ptr<Matrix> >& J, std::vector<std::shared_ptr<Matrix> >& K);
+                  std::vector<std::shared_ptr<Matrix> >& J, std::vector<std::shared_ptr<Matrix> >& K,
+                  bool build_J = true, bool build_K = true);
 
     /// Common initialization
     void common_init();
@@ -748,9 +796,56 @@ class PSI_API DirectJK : public JK {
      * @param val a positive integer
      */
     void set_df_ints_num_threads(int val) { df_ints_num_threads_ = val; }
+    /**
+     * Skip shell quartets whose Schwarz bound times the largest
+     * density element they are contracted with falls below the cutoff,
+     * tested separately for J and K
+     * @param density_screening do density screening, defaults to false
+     */
+    void set_density_screening(bool density_screening) { density_screening_ = density_screening; }
+    /**
+     * Build J/K incrementally from the density change between calls
+     * to compute(), J[D_n] = J[D_{n-1}] + J[D_n - D_{n-1}]
+     * @param incfock do incremental builds, defaults to false
+     */
+    void set_incfock(bool incfock) { incfock_ = incfock; }
+    /**
+     * Maximum number of consecutive incremental builds
+     * @param val a positive integer, defaults to 10
+     */
+    void set_incfock_full_fock_every(int val) { incfock_full_fock_every_ = val; }
+    /**
+     * Relative density change above which a full build is done
+     * @param val ratio RMS(D_n - D_{n-1}) / RMS(D_n), defaults to 0.1
+     */
+    void set_incfock_full_fock_threshold(double val) { incfock_full_fock_threshold_ = val; }
+    /**
+     * Build J with the continuous fast multipole method, near
+     * field with exact ERIs, far field with multipoles
+     * @param do_cfmm use CFMM for J, defaults to false
+     */
+    void set_cfmm(bool do_cfmm) { do_cfmm_ = do_cfmm; }
+    /**
+     * CFMM multipole order
+     * @param val a non-negative integer, defaults to 10
+     */
+    void set_cfmm_order(int val) { cfmm_order_ = val; }
+    /**
+     * CFMM tree levels
+     * @param val a positive integer, or 0 (default) to choose automatically
+     */
+    void set_cfmm_levels(int val) { cfmm_levels_ = val; }
+    /**
+     * Discard the stored densities, the next call to compute()
+     * will perform a full build
+     */
+    void reset_incfock();
 
     // => Accessors <= //
 
+    /// Was the last build incremental?
+    bool do_incfock_iter() const { return do_incfock_iter_; }
+
     /**
     * Print header information regarding JK
     * type on output file
@@ -1039,6 +1134,23 @@ class PSI_API MemDFJK : public JK {
     /// Condition cutoff in fitting metric, defaults to 1.0E-12
     double condition_ = 1.0E-12;
 
+    /// Contract K tile by tile, skipping the negligible atom-block tiles? Defaults to false
+    bool do_block_sparse_K_;
+
+    // => Local Exchange <= //
+
+    /// Localize the occupied orbitals and build K over orbital domains? Defaults to false
+    bool do_local_K_;
+    /// Localization method, BOYS or PIPEK_MEZEY
+    std::string local_K_type_;
+    /// Atomic domain tolerance for localized orbitals
+    double local_K_tolerance_;
+
+    // => Mixed Precision <= //
+
+    /// Store the AOs and contract J/K in single precision? Defaults to false
+    bool do_single_precision_;
+
     // => Required Algorithm-Specific Methods <= //
 
     int max_nocc() const;
@@ -1083,6 +1195,36 @@ class PSI_API MemDFJK : public JK {
      * @param val a positive integer
      */
     void set_df_ints_num_threads(int val) { df_ints_num_threads_ = val; }
+    /**
+     * Contract K over atom-block tiles, skipping tiles whose per-orbital
+     * norm bound is below the cutoff
+     * @param do_block_sparse_K use block-sparse K, defaults to false
+     */
+    void set_block_sparse_K(bool do_block_sparse_K) { do_block_sparse_K_ = do_block_sparse_K; }
+    /**
+     * Localize the occupied orbitals each build and restrict each
+     * orbital's half-transform to its atomic domain (lr_symmetric K only)
+     * @param do_local_K use local K, defaults to false
+     */
+    void set_local_K(bool do_local_K) { do_local_K_ = do_local_K; }
+    /**
+     * Localization method for local K
+     * @param type BOYS (default) or PIPEK_MEZEY
+     */
+    void set_local_K_type(const std::string& type) { local_K_type_ = type; }
+    /**
+     * Atoms enter an orbital's domain if its squared coefficients on
+     * the atom sum to more than the square of this tolerance
+     * @param val a positive double, defaults to 1.0E-5
+     */
+    void set_local_K_tolerance(double val) { local_K_tolerance_ = val; }
+    /**
+     * Store the metric-contracted AOs and build J/K in single precision.
+     * Turning it off after initialize() rebuilds the AOs in double precision.
+     * @param single use single precision, defaults to false
+     */
+    void set_single_precision(bool single);
+    bool get_single_precision() const { return do_single_precision_; }
 
     /**
  * A set_do_wK function that affects the dfhelper object.
@@ -1108,6 +1250,218 @@ class PSI_API MemDFJK : public JK {
     std::shared_ptr<DFHelper> dfh() { return dfh_; }
 };
 
+/**
+ * Class DFJ
+ *
+ * J-only density-fitted (RI-J) implementation for pure DFT.
+ * The significant (P|mn) blocks are held in core, one per Schwarz
+ * significant shell pair, and each build forms the fitted density
+ *
+ *   d_Q = (Q|P)^-1 \sum_mn (P|mn) D_mn
+ *
+ * through the Cholesky factor of the metric, computed once per SCF.
+ * Between full builds only the change dD enters the contraction, and
+ * shell pairs whose |dD| times the largest (P|mn) in the block falls
+ * under the cutoff are skipped. J_mn = \sum_Q (Q|mn) d_Q is rebuilt
+ * from the accumulated d, so J itself carries no incremental error.
+ */
+class PSI_API DFJ : public JK {
+   protected:
+    std::string name() override { return "DFJ"; }
+    size_t memory_estimate() override;
+
+    /// Auxiliary basis set
+    std::shared_ptr<BasisSet> auxiliary_;
+    /// Number of threads for DF integrals
+    int df_ints_num_threads_;
+
+    // => Sparse three-index integrals <= //
+
+    /// Schwarz sieve, supplies the significant M >= N shell pairs
+    std::shared_ptr<ERISieve> sieve_;
+    /// Offset of each significant shell pair's (mn|Q) block in Qmn_
+    std::vector<size_t> pair_offsets_;
+    /// (mn|Q) blocks, row mn of pair MN, column Q
+    std::vector<double> Qmn_;
+    /// Largest |(mn|Q)| in each shell pair block
+    std::vector<double> pair_max_;
+    /// Cholesky factor of the fitting metric (Q|P)
+    SharedMatrix metric_chol_;
+
+    // => Incremental fitted density <= //
+
+    /// Update the fitted density from dD between full builds? Defaults to true
+    bool incfock_;
+    /// Maximum number of consecutive incremental builds, defaults to 10
+    int incfock_full_fock_every_;
+    /// Number of incremental builds since the last full one
+    int incfock_count_;
+    /// Densities of the previous build
+    std::vector<SharedMatrix> D_prev_;
+    /// Fitted densities d_Q of the previous build
+    std::vector<SharedVector> d_prev_;
+
+    // => Required Algorithm-Specific Methods <= //
+
+    /// Do we need to backtransform to C1 under the hood?
+    bool C1() const override { return true; }
+    /// Setup integrals and metric factor
+    void preiterations() override;
+    /// Compute J for current D
+    void compute_JK() override;
+    /// Delete integrals
+    void postiterations() override;
+
+    /// Number of doubles in the sparse (mn|Q) store
+    size_t sparse_size();
+
+    /// Common initialization
+    void common_init();
+
+   public:
+    // => Constructors < = //
+
+    /**
+     * @param primary primary basis set for this system.
+     * @param auxiliary auxiliary basis set for this system.
+     */
+    DFJ(std::shared_ptr<BasisSet> primary, std::shared_ptr<BasisSet> auxiliary);
+
+    /// Destructor
+    ~DFJ() override;
+
+    // => Knobs <= //
+
+    /**
+     * What number of threads to compute integrals on
+     * @param val a positive integer
+     */
+    void set_df_ints_num_threads(int val) { df_ints_num_threads_ = val; }
+    /**
+     * Contract only the change in the density between full builds
+     * @param val do incremental builds, defaults to true
+     */
+    void set_incfock(bool val) { incfock_ = val; }
+    /**
+     * Maximum number of consecutive incremental builds
+     * @param val a positive integer, defaults to 10
+     */
+    void set_incfock_full_fock_every(int val) { incfock_full_fock_every_ = val; }
+
+    // => Accessors <= //
+
+    /**
+    * Print header information regarding JK
+    * type on output file
+    */
+    void print_header() const override;
+};
+
+/**
+ * Class COSXJK
+ *
+ * JK implementation using density-fitted J (wraps lib3index/DFHelper)
+ * and seminumerical (chain-of-spheres) K: the exchange is contracted on
+ * a DFTGrid with analytic three-center potential integrals,
+ *
+ *   K_mn = \sum_g w_g X_gm \sum_s A_ns(g) \sum_l X_gl D_ls
+ *
+ * where X_gm is the basis function collocation and A_ns(g) the
+ * electrostatic potential integral of a unit charge at grid point g.
+ * Cost scales with the number of grid points instead of ERI quartets.
+ */
+class PSI_API COSXJK : public JK {
+   protected:
+    std::string name() override { return "COSXJK"; }
+    size_t memory_estimate() override;
+
+    /// Options object, used to build the COSX grid
+    Options& options_;
+
+    // => DF (Coulomb) stuff <= //
+
+    /// DFHelper object for J
+    std::shared_ptr<DFHelper> dfh_;
+    /// Auxiliary basis set
+    std::shared_ptr<BasisSet> auxiliary_;
+    /// Condition cutoff in fitting metric, defaults to 1.0E-12
+    double condition_ = 1.0E-12;
+
+    // => Seminumerical (exchange) stuff <= //
+
+    /// Grid for the exchange contraction
+    std::shared_ptr<DFTGrid> grid_;
+    /// Number of radial points per atom in the COSX grid
+    int cosx_radial_points_;
+    /// Number of spherical points per radial shell in the COSX grid
+    int cosx_spherical_points_;
+    /// Per-thread basis function collocation workers
+    std::vector<std::shared_ptr<BasisFunctions>> basis_workers_;
+    /// Significant shell pairs of the potential integrals
+    std::shared_ptr<ERISieve> sieve_;
+    /// Per-thread potential integral objects
+    std::vector<std::shared_ptr<PotentialInt>> potential_ints_;
+    /// Overlap fitting matrix S (X^T W X)^-1, which removes most of the grid error in K
+    SharedMatrix overlap_fitting_;
+    /// Apply the overlap fitting to K?
+    bool overlap_fitted_;
+
+    // => Required Algorithm-Specific Methods <= //
+
+    int max_nocc() const;
+    /// Do we need to backtransform to C1 under the hood?
+    bool C1() const override { return true; }
+    /// Setup integrals, grid, etc
+    void preiterations() override;
+    /// Compute J/K for current C/D
+    void compute_JK() override;
+    /// Delete integrals, grid, etc
+    void postiterations() override;
+
+    /// Seminumerical K build over the grid. Each block only contracts the
+    /// shells l whose F_gl is above the cutoff and their Schwarz partners n.
+    void build_K_sn(std::vector<SharedMatrix>& D, std::vector<SharedMatrix>& K);
+
+    /// Common initialization
+    void common_init();
+
+   public:
+    // => Constructors < = //
+
+    /**
+     * @param primary primary basis set for this system.
+     * @param auxiliary auxiliary basis set for J
+     * @param options Options reference, used to build the COSX grid
+     */
+    COSXJK(std::shared_ptr<BasisSet> primary, std::shared_ptr<BasisSet> auxiliary, Options& options);
+
+    /// Destructor
+    ~COSXJK() override;
+
+    // => Knobs <= //
+
+    /**
+     * Minimum relative eigenvalue to retain in fitting inverse
+     * @param condition minimum relative eigenvalue allowed,
+     *        defaults to 1.0E-12
+     */
+    void set_condition(double condition) { condition_ = condition; }
+    /// Radial points per atom in the COSX grid, defaults to COSX_RADIAL_POINTS
+    void set_cosx_radial_points(int val) { cosx_radial_points_ = val; }
+    /// Spherical points per radial shell in the COSX grid, defaults to COSX_SPHERICAL_POINTS
+    void set_cosx_spherical_points(int val) { cosx_spherical_points_ = val; }
+    /// Apply the overlap fitting of Neese et al. to K? Defaults to true
+    void set_overlap_fitted(bool val) { overlap_fitted_ = val; }
+
+    // => Accessors <= //
+
+    /**
+    * Print header information regarding JK
+    * type on output file
+    */
+    void print_header() const override;
+};
+
 }
 
 #endif
@@ -38,7 +38,15 @@
 
 #include "gau2grid/gau2grid.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#ifndef _MSC_VER
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 namespace psi {
 
@@ -60,13 +68,7 @@ void SAPFunctions::allocate() {
 }
 void SAPFunctions::compute_points(std::shared_ptr<BlockOPoints> block, bool force_compute) {
     // => Build basis function values <= //
-    block_index_ = block->index();
-    if (!force_compute && cache_map_ && (cache_map_->find(block->index()) != cache_map_->end())) {
-        current_basis_map_ = &(*cache_map_)[block->index()];
-    } else {
-        current_basis_map_ = &basis_values_;
-        BasisFunctions::compute_functions(block);
-    }
+    compute_basis_values(block, force_compute);
 }
 void SAPFunctions::print(std::string out, int print) const {
     std::shared_ptr<psi::PsiOutStream> printer = (out == "outfile" ? outfile : std::make_shared<PsiOutStream>(out));
@@ -101,6 +103,64 @@ void SAPFunctions::set_pointers(SharedMatrix /*Ca_AO*/) {
     throw PSIEXCEPTION("SAPFunctions::orbitals are not appropriate. Read the source.");
 }
 
+void PointFunctions::compute_basis_values(std::shared_ptr<BlockOPoints> block, bool force_compute) {
+    block_index_ = block->index();
+    if (!force_compute && cache_map_ && (cache_map_->find(block->index()) != cache_map_->end())) {
+        current_basis_map_ = &(*cache_map_)[block->index()];
+    } else if (!force_compute && disk_cache_ && disk_cache_->read(block->index(), basis_values_)) {
+        current_basis_map_ = &basis_values_;
+    } else {
+        current_basis_map_ = &basis_values_;
+        BasisFunctions::compute_functions(block);
+    }
+}
+void PointFunctions::screen_functions(std::shared_ptr<BlockOPoints> block) {
+    const std::vector<int>& block_map = block->functions_local_to_global();
+    function_map_ = block_map;
+    if (function_screening_ <= 0.0) return;
+
+    const size_t npoints = block->npoints();
+    const size_t nlocal = block_map.size();
+
+    // Largest value or gradient component of each function over the block
+    std::vector<std::string> keys = {"PHI"};
+    if (deriv_ >= 1) keys.insert(keys.end(), {"PHI_X", "PHI_Y", "PHI_Z"});
+
+    std::vector<double> phi_max(nlocal, 0.0);
+    for (const auto& key : keys) {
+        double** phip = (*current_basis_map_)[key]->pointer();
+        for (size_t P = 0; P < npoints; P++) {
+            for (size_t ml = 0; ml < nlocal; ml++) {
+                phi_max[ml] = std::max(phi_max[ml], std::fabs(phip[P][ml]));
+            }
+        }
+    }
+
+    std::vector<size_t> active;
+    for (size_t ml = 0; ml < nlocal; ml++) {
+        if (phi_max[ml] >= function_screening_) active.push_back(ml);
+    }
+    if (active.size() == nlocal) return;
+
+    function_map_.clear();
+    for (size_t ml : active) function_map_.push_back(block_map[ml]);
+
+    // Compact the kept columns into basis_values_, in place unless the values came from the cache.
+    // active is ascending so the in-place copy never overwrites a column before it is read.
+    for (auto& kv : basis_values_) {
+        auto src_it = current_basis_map_->find(kv.first);
+        if (src_it == current_basis_map_->end()) continue;
+        double** srcp = src_it->second->pointer();
+        double** dstp = kv.second->pointer();
+        for (size_t P = 0; P < npoints; P++) {
+            for (size_t k = 0; k < active.size(); k++) {
+                dstp[P][k] = srcp[P][active[k]];
+            }
+        }
+    }
+    current_basis_map_ = &basis_values_;
+}
+
 RKSFunctions::RKSFunctions(std::shared_ptr<BasisSet> primary, int max_points, int max_functions)
     : PointFunctions(primary, max_points, max_functions) {
     set_ansatz(0);
@@ -153,17 +213,14 @@ void RKSFunctions::compute_points(std::shared_ptr<BlockOPoints> block, bool forc
     if (!D_AO_) throw PSIEXCEPTION("RKSFunctions: call set_pointers.");
 
     // => Build basis function values <= //
-    block_index_ = block->index();
-    if (!force_compute && cache_map_ && (cache_map_->find(block->index()) != cache_map_->end())) {
-        current_basis_map_ = &(*cache_map_)[block->index()];
-    } else {
-        current_basis_map_ = &basis_values_;
-        BasisFunctions::compute_functions(block);
-    }
+    compute_basis_values(block, force_compute);
+
+    // => Drop functions that are dead on this block <= //
+    screen_functions(block);
 
     // => Global information <= //
     int npoints = block->npoints();
-    const std::vector<int>& function_map = block->functions_local_to_global();
+    const std::vector<int>& function_map = function_map_;
     int nglobal = max_functions_;
     int nlocal = function_map.size();
 
@@ -298,13 +355,7 @@ void RKSFunctions::set_Cs(SharedMatrix /*Ca_AO*/, SharedMatrix /*Cb_AO*/) {
 }
 void RKSFunctions::compute_orbitals(std::shared_ptr<BlockOPoints> block, bool force_compute) {
     // => Build basis function values <= //
-    block_index_ = block->index();
-    if (!force_compute && cache_map_ && (cache_map_->find(block->index()) != cache_map_->end())) {
-        current_basis_map_ = &(*cache_map_)[block->index()];
-    } else {
-        current_basis_map_ = &basis_values_;
-        BasisFunctions::compute_functions(block);
-    }
+    compute_basis_values(block, force_compute);
     // timer_off("Functions: Points");
 
     // => Global information <= //
@@ -422,13 +473,7 @@ void UKSFunctions::compute_points(std::shared_ptr<BlockOPoints> block, bool forc
     if (!Da_AO_) throw PSIEXCEPTION("UKSFunctions: call set_pointers.");
 
     // => Build basis function values <= //
-    block_index_ = block->index();
-    if (!force_compute && cache_map_ && (cache_map_->find(block->index()) != cache_map_->end())) {
-        current_basis_map_ = &(*cache_map_)[block->index()];
-    } else {
-        current_basis_map_ = &basis_values_;
-        BasisFunctions::compute_functions(block);
-    }
+    compute_basis_values(block, force_compute);
 
     // => Global information <= //
     int npoints = block->npoints();
@@ -568,13 +613,7 @@ void UKSFunctions::set_Cs(SharedMatrix Ca_AO, SharedMatrix Cb_AO) {
 }
 void UKSFunctions::compute_orbitals(std::shared_ptr<BlockOPoints> block, bool force_compute) {
     // => Build basis function values <= //
-    block_index_ = block->index();
-    if (!force_compute && cache_map_ && (cache_map_->find(block->index()) != cache_map_->end())) {
-        current_basis_map_ = &(*cache_map_)[block->index()];
-    } else {
-        current_basis_map_ = &basis_values_;
-        BasisFunctions::compute_functions(block);
-    }
+    compute_basis_values(block, force_compute);
 
     // => Global information <= //
 
@@ -695,32 +734,45 @@ void BasisFunctions::allocate() {
     }
 
     if (deriv_ >= 3) throw PSIEXCEPTION("BasisFunctions: Only up to Hessians are currently supported");
+
+    const int ncomponents = (deriv_ == 0 ? 1 : (deriv_ == 1 ? 4 : 10));
+    xyz_.resize(3L * max_points_);
+    sparse_xyz_.resize(3L * max_points_);
+    sparse_temps_.resize((size_t)ncomponents * max_cart * max_points_);
+    sparse_points_.reserve(max_points_);
 }
 void BasisFunctions::compute_functions(std::shared_ptr<BlockOPoints> block) {
     // Pull out data
-    int npoints = block->npoints();
+    size_t npoints = block->npoints();
     double* x = block->x();
     double* y = block->y();
     double* z = block->z();
-    double* xyz = new double[npoints * 3];
+    double* xyz = xyz_.data();
     ::memcpy(xyz, x, sizeof(double) * npoints);
     ::memcpy(xyz + npoints, y, sizeof(double) * npoints);
     ::memcpy(xyz + 2 * npoints, z, sizeof(double) * npoints);
 
     const std::vector<int>& shells = block->shells_local_to_global();
 
+    // Shell extents, anything beyond them is below the basis tolerance delta
+    const double delta = block->extents()->delta();
+    const double* Rp = block->extents()->shell_extents()->pointer();
+
     // Declare tmps
     std::vector<double> center(3, 0.0);
+    std::vector<double> prim_alpha, prim_norm;
 
     // Declare pointers
     double *tmpp, *tmp_xp, *tmp_yp, *tmp_zp;
     double *tmp_xxp, *tmp_xyp, *tmp_xzp, *tmp_yyp, *tmp_yzp, *tmp_zzp;
     double *valuesp, *values_xp, *values_yp, *values_zp;
     double *values_xxp, *values_xyp, *values_xzp, *values_yyp, *values_yzp, *values_zzp;
+    std::vector<double*> tmps;
 
     if (deriv_ >= 0) {
         tmpp = basis_temps_["PHI"]->pointer()[0];
         valuesp = basis_values_["PHI"]->pointer()[0];
+        tmps.push_back(tmpp);
     }
     if (deriv_ >= 1) {
         tmp_xp = basis_temps_["PHI_X"]->pointer()[0];
@@ -729,6 +781,7 @@ void BasisFunctions::compute_functions(std::shared_ptr<BlockOPoints> block) {
         values_xp = basis_values_["PHI_X"]->pointer()[0];
         values_yp = basis_values_["PHI_Y"]->pointer()[0];
         values_zp = basis_values_["PHI_Z"]->pointer()[0];
+        tmps.insert(tmps.end(), {tmp_xp, tmp_yp, tmp_zp});
     }
     if (deriv_ >= 2) {
         tmp_xxp = basis_temps_["PHI_XX"]->pointer()[0];
@@ -743,8 +796,26 @@ void BasisFunctions::compute_functions(std::shared_ptr<BlockOPoints> block) {
         values_yyp = basis_values_["PHI_YY"]->pointer()[0];
         values_yzp = basis_values_["PHI_YZ"]->pointer()[0];
         values_zzp = basis_values_["PHI_ZZ"]->pointer()[0];
+        tmps.insert(tmps.end(), {tmp_xxp, tmp_xyp, tmp_xzp, tmp_yyp, tmp_yzp, tmp_zzp});
     }
+    const int order = (int)puream_ ? GG_SPHERICAL_GAUSSIAN : GG_CARTESIAN_CCA;
+
+    // gau2grid evaluates a shell over a set of points into rows of stride np, out holds one pointer per component
+    auto collocate = [&](int L, size_t np, const double* xyzp, std::vector<double*>& out) {
+        int nprim = prim_alpha.size();
+        if (deriv_ == 0) {
+            gg_collocation(L, np, xyzp, 1, nprim, prim_norm.data(), prim_alpha.data(), center.data(), order,
+                           out[0]);
+        } else if (deriv_ == 1) {
+            gg_collocation_deriv1(L, np, xyzp, 1, nprim, prim_norm.data(), prim_alpha.data(), center.data(), order,
+                                  out[0], out[1], out[2], out[3]);
+        } else if (deriv_ == 2) {
+            gg_collocation_deriv2(L, np, xyzp, 1, nprim, prim_norm.data(), prim_alpha.data(), center.data(), order,
+                                  out[0], out[1], out[2], out[3], out[4], out[5], out[6], out[7], out[8], out[9]);
+        }
+    };
 
+    std::vector<double*> out(tmps.size());
     int nvals = 0;
     for (size_t Qlocal = 0; Qlocal < shells.size(); Qlocal++) {
         int Qglobal = shells[Qlocal];
@@ -755,6 +826,7 @@ void BasisFunctions::compute_functions(std::shared_ptr<BlockOPoints> block) {
         int nprim = Qshell.nprimitive();
         const double* alpha = Qshell.exps();
         const double* norm = Qshell.coefs();
+        const int nrows = (puream_ ? 2 * L + 1 : nQ);
 
         // Copy over centerp to a double*
         center[0] = v[0];
@@ -763,38 +835,95 @@ void BasisFunctions::compute_functions(std::shared_ptr<BlockOPoints> block) {
 
         // Make new pointers, gg computes along rows so we need to skip down `nval` rows.
         size_t row_shift = nvals * npoints;
-        double* phi_start = tmpp + row_shift;
-        const int order = (int)puream_ ? GG_SPHERICAL_GAUSSIAN : GG_CARTESIAN_CCA;
+        nvals += nrows;
+
+        // => Sparsity <= //
+
+        // The block only knows the shell reaches some of its points, find which ones
+        const double Rext = Rp[Qglobal];
+        const double R2ext = (Rext < std::sqrt(std::numeric_limits<double>::max()) ? Rext * Rext
+                                                                                   : std::numeric_limits<double>::max());
+        double R2min = std::numeric_limits<double>::max();
+        sparse_points_.clear();
+        for (size_t P = 0; P < npoints; P++) {
+            const double dx = x[P] - v[0];
+            const double dy = y[P] - v[1];
+            const double dz = z[P] - v[2];
+            const double R2 = dx * dx + dy * dy + dz * dz;
+            if (R2 <= R2ext) {
+                sparse_points_.push_back(P);
+                R2min = std::min(R2min, R2);
+            }
+        }
+        const size_t nactive = sparse_points_.size();
+
+        // Drop primitives that stay below delta / nprim even at the closest significant point
+        // The bound covers every requested derivative, each x derivative of x^l exp(-a r^2) brings down
+        // l / x - 2 a x so the gradient is bounded by (L r^(L-1) + 2a r^(L+1)) exp(-a r^2), likewise the Hessian
+        prim_alpha.clear();
+        prim_norm.clear();
+        if (nactive) {
+            const double Rmin = std::sqrt(R2min);
+            for (int K = 0; K < nprim; K++) {
+                const double a = alpha[K];
+                // r^n exp(-a r^2) peaks at r = sqrt(n / 2a), take its largest value beyond Rmin
+                auto radial = [&](int n) {
+                    const double R = std::max(Rmin, std::sqrt(n / (2.0 * a)));
+                    return std::pow(R, n) * std::exp(-a * R * R);
+                };
+                double bound = radial(L);
+                if (deriv_ >= 1) {
+                    double grad = 2.0 * a * radial(L + 1);
+                    if (L >= 1) grad += L * radial(L - 1);
+                    bound = std::max(bound, grad);
+                }
+                if (deriv_ >= 2) {
+                    double hess = 2.0 * a * (2 * L + 1) * radial(L) + 4.0 * a * a * radial(L + 2);
+                    if (L >= 2) hess += L * (L - 1) * radial(L - 2);
+                    bound = std::max(bound, hess);
+                }
+                bound *= std::fabs(norm[K]);
+                if (bound * nprim < delta) continue;
+                prim_alpha.push_back(alpha[K]);
+                prim_norm.push_back(norm[K]);
+            }
+        }
 
-        // Copmute collocation
-        if (deriv_ == 0) {
-            gg_collocation(L, npoints, xyz, 1, nprim, norm, alpha, center.data(), order, phi_start);
-        } else if (deriv_ == 1) {
-            double* phi_x_start = tmp_xp + row_shift;
-            double* phi_y_start = tmp_yp + row_shift;
-            double* phi_z_start = tmp_zp + row_shift;
-            gg_collocation_deriv1(L, npoints, xyz, 1, nprim, norm, alpha, center.data(), order, phi_start,
-                                  phi_x_start, phi_y_start, phi_z_start);
+        // Nothing significant, the temps are reused between blocks so zero the rows
+        if (nactive == 0 || prim_alpha.empty()) {
+            for (double* tmp : tmps) {
+                std::fill(tmp + row_shift, tmp + row_shift + nrows * npoints, 0.0);
+            }
+            continue;
+        }
 
-        } else if (deriv_ == 2) {
-            double* phi_x_start = tmp_xp + row_shift;
-            double* phi_y_start = tmp_yp + row_shift;
-            double* phi_z_start = tmp_zp + row_shift;
-            double* phi_xx_start = tmp_xxp + row_shift;
-            double* phi_xy_start = tmp_xyp + row_shift;
-            double* phi_xz_start = tmp_xzp + row_shift;
-            double* phi_yy_start = tmp_yyp + row_shift;
-            double* phi_yz_start = tmp_yzp + row_shift;
-            double* phi_zz_start = tmp_zzp + row_shift;
-            gg_collocation_deriv2(L, npoints, xyz, 1, nprim, norm, alpha, center.data(), order, phi_start,
-                                  phi_x_start, phi_y_start, phi_z_start, phi_xx_start, phi_xy_start, phi_xz_start,
-                                  phi_yy_start, phi_yz_start, phi_zz_start);
+        // Compute collocation
+        if (nactive == npoints) {
+            for (size_t c = 0; c < tmps.size(); c++) out[c] = tmps[c] + row_shift;
+            collocate(L, npoints, xyz, out);
+            continue;
         }
 
-        if (puream_) {
-            nvals += 2 * L + 1;
-        } else {
-            nvals += nQ;  // Cartesian is already computed
+        // Gather the significant points, collocate them compactly and scatter back
+        double* sxyz = sparse_xyz_.data();
+        for (size_t k = 0; k < nactive; k++) {
+            const size_t P = sparse_points_[k];
+            sxyz[k] = x[P];
+            sxyz[nactive + k] = y[P];
+            sxyz[2 * nactive + k] = z[P];
+        }
+        for (size_t c = 0; c < tmps.size(); c++) out[c] = sparse_temps_.data() + c * nrows * nactive;
+        collocate(L, nactive, sxyz, out);
+
+        for (size_t c = 0; c < tmps.size(); c++) {
+            for (int r = 0; r < nrows; r++) {
+                double* dst = tmps[c] + row_shift + r * npoints;
+                const double* src = out[c] + r * nactive;
+                std::fill(dst, dst + npoints, 0.0);
+                for (size_t k = 0; k < nactive; k++) {
+                    dst[sparse_points_[k]] = src[k];
+                }
+            }
         }
     }
 
@@ -815,6 +944,114 @@ void BasisFunctions::compute_functions(std::shared_ptr<BlockOPoints> block) {
         gg_fast_transpose(nso, npoints, tmp_zzp, values_zzp);
     }
 }
+CollocationDiskCache::CollocationDiskCache(const std::string& filename, bool single_precision)
+    : filename_(filename), single_precision_(single_precision) {
+    file_ = std::fopen(filename_.c_str(), "wb+");
+    if (!file_) throw PSIEXCEPTION("CollocationDiskCache: unable to open " + filename_);
+}
+CollocationDiskCache::~CollocationDiskCache() {
+    std::fclose(file_);
+    std::remove(filename_.c_str());
+}
+void CollocationDiskCache::write(size_t block, std::map<std::string, SharedMatrix>& values, size_t nrows,
+                                 size_t ncols) {
+    // Pack outside of the lock
+    const size_t nelem = nrows * ncols;
+    std::vector<double> dbuf;
+    std::vector<float> fbuf;
+    Entry entry;
+    entry.nrows = nrows;
+    entry.ncols = ncols;
+    if (single_precision_) {
+        fbuf.resize(values.size() * nelem);
+    } else {
+        dbuf.resize(values.size() * nelem);
+    }
+
+    size_t comp = 0;
+    for (auto& kv : values) {
+        double** valp = kv.second->pointer();
+        for (size_t i = 0; i < nrows; i++) {
+            if (single_precision_) {
+                std::copy(valp[i], valp[i] + ncols, fbuf.data() + comp * nelem + i * ncols);
+            } else {
+                std::copy(valp[i], valp[i] + ncols, dbuf.data() + comp * nelem + i * ncols);
+            }
+        }
+        entry.keys.push_back(kv.first);
+        comp++;
+    }
+    const size_t nbytes = comp * nelem * element_size();
+    const void* buf = (single_precision_ ? (const void*)fbuf.data() : (const void*)dbuf.data());
+
+    std::lock_guard<std::mutex> guard(lock_);
+    entry.offset = bytes_;
+    if (nbytes && std::fwrite(buf, 1, nbytes, file_) != nbytes) {
+        throw PSIEXCEPTION("CollocationDiskCache: write to " + filename_ + " failed");
+    }
+    bytes_ += nbytes;
+    extents_[entry.offset] = nbytes;
+    entries_[block] = entry;
+}
+void CollocationDiskCache::flush() {
+    std::lock_guard<std::mutex> guard(lock_);
+    std::fflush(file_);
+}
+bool CollocationDiskCache::read(size_t block, std::map<std::string, SharedMatrix>& values) {
+    auto it = entries_.find(block);
+    if (it == entries_.end()) return false;
+    const Entry& entry = it->second;
+    for (auto& kv : values) {
+        if (std::find(entry.keys.begin(), entry.keys.end(), kv.first) == entry.keys.end()) return false;
+    }
+
+    const size_t nelem = entry.nrows * entry.ncols;
+    const size_t nbytes = entry.keys.size() * nelem * element_size();
+    std::vector<char> buf(nbytes);
+
+#ifdef _MSC_VER
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        std::fseek(file_, entry.offset, SEEK_SET);
+        if (std::fread(buf.data(), 1, nbytes, file_) != nbytes) {
+            throw PSIEXCEPTION("CollocationDiskCache: read from " + filename_ + " failed");
+        }
+    }
+#else
+    const int fd = fileno(file_);
+    size_t nread = 0;
+    while (nread < nbytes) {
+        ssize_t ret = pread(fd, buf.data() + nread, nbytes - nread, entry.offset + nread);
+        if (ret <= 0) throw PSIEXCEPTION("CollocationDiskCache: read from " + filename_ + " failed");
+        nread += ret;
+    }
+#if defined(__linux__)
+    // Blocks are written roughly in grid order, so warm the page cache with the next one
+    auto next = extents_.upper_bound(entry.offset);
+    if (next != extents_.end()) {
+        posix_fadvise(fd, next->first, next->second, POSIX_FADV_WILLNEED);
+    }
+#endif
+#endif
+
+    // Unpack into the leading block of each component
+    for (size_t comp = 0; comp < entry.keys.size(); comp++) {
+        auto vit = values.find(entry.keys[comp]);
+        if (vit == values.end()) continue;
+        double** valp = vit->second->pointer();
+        for (size_t i = 0; i < entry.nrows; i++) {
+            if (single_precision_) {
+                const float* src = reinterpret_cast<const float*>(buf.data()) + comp * nelem + i * entry.ncols;
+                std::copy(src, src + entry.ncols, valp[i]);
+            } else {
+                const double* src = reinterpret_cast<const double*>(buf.data()) + comp * nelem + i * entry.ncols;
+                std::copy(src, src + entry.ncols, valp[i]);
+            }
+        }
+    }
+    return true;
+}
+
 void BasisFunctions::print(std::string out, int print) const {
     std::shared_ptr<psi::PsiOutStream> printer = (out == "outfile" ? outfile : std::make_shared<PsiOutStream>(out));
     printer->Printf("   => BasisFunctions: Derivative = %d, Max Points = %d <=\n\n", deriv_, max_points_);
@@ -34,6 +34,8 @@
 
 #include <cstdio>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <tuple>
 #include <vector>
@@ -45,6 +47,52 @@ class BasisSet;
 class Vector;
 class BlockOPoints;
 
+/**
+ * Scratch-disk tier of the DFT collocation cache. Blocks that do not fit in memory are packed
+ * (npoints x local_nbf per component, optionally as floats) and appended to one file, then read
+ * back on demand with the next block in file order prefetched.
+ **/
+class PSI_API CollocationDiskCache {
+   protected:
+    struct Entry {
+        size_t offset;
+        size_t nrows;
+        size_t ncols;
+        std::vector<std::string> keys;
+    };
+
+    /// Scratch file, removed on destruction
+    std::string filename_;
+    std::FILE* file_;
+    /// Store as floats?
+    bool single_precision_;
+    /// Block index -> location in the file
+    std::unordered_map<size_t, Entry> entries_;
+    /// File offset -> length of the block written there, for the prefetch
+    std::map<size_t, size_t> extents_;
+    /// Bytes written so far
+    size_t bytes_ = 0;
+    /// Guards writes (and reads where pread is unavailable)
+    std::mutex lock_;
+
+    size_t element_size() const { return (single_precision_ ? sizeof(float) : sizeof(double)); }
+
+   public:
+    CollocationDiskCache(const std::string& filename, bool single_precision);
+    ~CollocationDiskCache();
+
+    /// Append the leading nrows x ncols of each component of values, thread safe
+    void write(size_t block, std::map<std::string, SharedMatrix>& values, size_t nrows, size_t ncols);
+    /// Make the written blocks visible to read
+    void flush();
+    /// Fill the leading block of each component of values, thread safe. False if the block or any component is absent
+    bool read(size_t block, std::map<std::string, SharedMatrix>& values);
+
+    size_t nblocks() const { return entries_.size(); }
+    size_t bytes() const { return bytes_; }
+    bool single_precision() const { return single_precision_; }
+};
+
 class PSI_API BasisFunctions {
    protected:
     /// Basis set for this BasisFunctions
@@ -61,6 +109,14 @@ class PSI_API BasisFunctions {
     std::map<std::string, SharedMatrix> basis_values_;
     /// Map of temp names to Matrices containing temps
     std::map<std::string, SharedMatrix> basis_temps_;
+    /// Blocked x, y, z coordinates of the current block, handed to gau2grid
+    std::vector<double> xyz_;
+    /// Coordinates of the points inside the current shell's extent
+    std::vector<double> sparse_xyz_;
+    /// Collocation of one shell on its significant points, all derivative components
+    std::vector<double> sparse_temps_;
+    /// Indices of the points inside the current shell's extent
+    std::vector<size_t> sparse_points_;
     /// Allocate registers
     virtual void allocate();
 
@@ -114,11 +170,26 @@ class PointFunctions : public BasisFunctions {
     // Contains a pointer to the current map to use for basis_values
     std::map<std::string, SharedMatrix>* current_basis_map_ = nullptr;
 
+    // Blocks spilled to disk, consulted after cache_map_
+    std::shared_ptr<CollocationDiskCache> disk_cache_;
+
+    /// Point current_basis_map_ at this block's basis values, from the caches when allowed
+    void compute_basis_values(std::shared_ptr<BlockOPoints> block, bool force_compute);
+
     /// Ansatz (0 - LSDA, 1 - GGA, 2 - Meta-GGA)
     int ansatz_;
     /// Map of value names to Vectors containing values
     std::map<std::string, std::shared_ptr<Vector>> point_values_;
 
+    // => Function Screening <= //
+
+    /// Functions whose values and gradients never reach this on a block are dropped (<= 0.0 disables)
+    double function_screening_ = 0.0;
+    /// Global indices of the functions kept on the current block
+    std::vector<int> function_map_;
+    /// Build function_map_ and compact the basis values onto the kept functions
+    void screen_functions(std::shared_ptr<BlockOPoints> block);
+
     // => Orbital Collocation <= //
 
     /// Map of value names to Matrices containing values
@@ -134,6 +205,9 @@ class PointFunctions : public BasisFunctions {
     void set_cache_map(std::unordered_map<size_t, std::map<std::string, SharedMatrix>>* cache_map) {
         cache_map_ = cache_map;
     }
+    void set_disk_cache(std::shared_ptr<CollocationDiskCache> disk_cache) { disk_cache_ = disk_cache; }
+    /// Drop functions whose collocation stays below tol on a block, only honored by RKSFunctions::compute_points
+    void set_function_screening(double tol) { function_screening_ = tol; }
 
     // => Computers <= //
 
@@ -145,6 +219,8 @@ class PointFunctions : public BasisFunctions {
     std::map<std::string, SharedVector>& point_values() { return point_values_; }
 
     SharedMatrix basis_value(const std::string& key) { return (*current_basis_map_)[key]; }
+    /// Global indices of the columns of basis_value for the current block (RKS)
+    const std::vector<int>& function_map() const { return function_map_; }
     std::map<std::string, SharedMatrix>& basis_values() { return (*current_basis_map_); }
 
     virtual std::vector<SharedMatrix> scratch() = 0;
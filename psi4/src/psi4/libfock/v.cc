@@ -46,12 +46,24 @@
 #include "psi4/libmints/vector.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/process.h"
+#include "psi4/libpsio/psio.hpp"
 
+#include <array>
+#include <cmath>
 #include <cstdlib>
 #include <numeric>
 #include <sstream>
 #include <string>
 #include <algorithm>
+#include <chrono>
+
+#ifdef _MSC_VER
+#include <process.h>
+#define SYSTEM_GETPID ::_getpid
+#else
+#include <unistd.h>
+#define SYSTEM_GETPID ::getpid
+#endif
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -102,6 +114,14 @@ void VBase::common_init() {
     debug_ = options_.get_int("DEBUG");
     v2_rho_cutoff_ = options_.get_double("DFT_V2_RHO_CUTOFF");
     vv10_rho_cutoff_ = options_.get_double("DFT_VV10_RHO_CUTOFF");
+    block_screening_tolerance_ = options_.get_double("DFT_BLOCK_SCREENING_TOLERANCE");
+    vx_batch_size_ = options_.get_int("DFT_VX_BATCH_SIZE");
+    xc_batch_points_ = options_.get_int("DFT_XC_BATCH_POINTS");
+    collocation_disk_ = options_.get_bool("DFT_COLLOCATION_DISK");
+    collocation_disk_single_ = (options_.get_str("DFT_COLLOCATION_DISK_PRECISION") == "SINGLE");
+    vv10_screening_ = options_.get_bool("DFT_VV10_SCREENING");
+    vv10_lump_radius_ = options_.get_double("DFT_VV10_LUMP_RADIUS");
+    vv10_cutoff_radius_ = options_.get_double("DFT_VV10_CUTOFF_RADIUS");
     grac_initialized_ = false;
     cache_map_deriv_ = -1;
     num_threads_ = 1;
@@ -169,6 +189,7 @@ void VBase::set_D(std::vector<SharedMatrix> Dvec) {
 void VBase::initialize() {
     timer_on("V: Grid");
     grid_ = std::make_shared<DFTGrid>(primary_->molecule(), primary_, options_);
+    build_block_order();
     timer_off("V: Grid");
 
     for (size_t i = 0; i < num_threads_; i++) {
@@ -667,6 +688,54 @@ void VBase::initialize() {
     }
 #endif
 }
+void VBase::build_block_order() {
+    const auto& blocks = grid_->blocks();
+    std::vector<double> cost(blocks.size());
+    for (size_t Q = 0; Q < blocks.size(); Q++) {
+        // Collocation and density/potential GEMMs dominate: npoints * nlocal * (nlocal + 1)
+        const double npoints = blocks[Q]->npoints();
+        const double nlocal = blocks[Q]->local_nbf();
+        cost[Q] = npoints * nlocal * (nlocal + 1.0);
+    }
+
+    block_order_.resize(blocks.size());
+    std::iota(block_order_.begin(), block_order_.end(), 0);
+    std::stable_sort(block_order_.begin(), block_order_.end(),
+                     [&cost](size_t a, size_t b) { return cost[a] > cost[b]; });
+
+    // The cheap blocks end up together at the tail, where they are coalesced for the functional
+    xc_group_offsets_.assign(1, 0);
+    xc_group_max_points_ = 0;
+    xc_group_max_blocks_ = 0;
+    size_t group_points = 0;
+    for (size_t Qorder = 0; Qorder < block_order_.size(); Qorder++) {
+        const size_t npoints = blocks[block_order_[Qorder]]->npoints();
+        if (Qorder > xc_group_offsets_.back() && group_points + npoints > (size_t)xc_batch_points_) {
+            xc_group_offsets_.push_back(Qorder);
+            group_points = 0;
+        }
+        group_points += npoints;
+        xc_group_max_points_ = std::max(xc_group_max_points_, group_points);
+        xc_group_max_blocks_ = std::max(xc_group_max_blocks_, Qorder + 1 - xc_group_offsets_.back());
+    }
+    xc_group_offsets_.push_back(block_order_.size());
+}
+void VBase::print_thread_balance(const std::string& label, const std::vector<double>& thread_time,
+                                 const std::vector<size_t>& thread_blocks) const {
+    if (print_ < 3 || thread_time.empty()) return;
+
+    const double tmax = *std::max_element(thread_time.begin(), thread_time.end());
+    const double tmin = *std::min_element(thread_time.begin(), thread_time.end());
+    const double tavg = std::accumulate(thread_time.begin(), thread_time.end(), 0.0) / thread_time.size();
+
+    outfile->Printf("  ==> %s: Thread Load Balance <==\n\n", label.c_str());
+    outfile->Printf("    %6s %10s %12s\n", "Thread", "Blocks", "Time [s]");
+    for (size_t i = 0; i < thread_time.size(); i++) {
+        outfile->Printf("    %6zu %10zu %12.4f\n", i, thread_blocks[i], thread_time[i]);
+    }
+    outfile->Printf("\n    Min / Avg / Max = %.4f / %.4f / %.4f [s], Imbalance (Max / Avg) = %.3f\n\n", tmin, tavg,
+                    tmax, (tavg > 0.0 ? tmax / tavg : 1.0));
+}
 SharedMatrix VBase::compute_gradient() { throw PSIEXCEPTION("VBase: gradient not implemented for this V instance."); }
 SharedMatrix VBase::compute_hessian() { throw PSIEXCEPTION("VBase: hessian not implemented for this V instance."); }
 void VBase::compute_V(std::vector<SharedMatrix> ret) {
@@ -713,6 +782,14 @@ void VBase::set_grac_shift(double grac_shift) {
             functional_workers_[i]->allocate();
             functional_workers_[i]->set_lock(true);
         }
+        // The batch workers were built in initialize, before the functional knew about GRAC
+        for (auto& batch_worker : xc_batch_functional_workers_) {
+            batch_worker->set_grac_alpha(grac_alpha);
+            batch_worker->set_grac_beta(grac_beta);
+            batch_worker->set_grac_x_functional(grac_x_func->build_worker());
+            batch_worker->set_grac_c_functional(grac_c_func->build_worker());
+            batch_worker->allocate();
+        }
         grac_initialized_ = true;
     }
 
@@ -724,6 +801,9 @@ void VBase::set_grac_shift(double grac_shift) {
         functional_workers_[i]->set_grac_shift(grac_shift);
         functional_workers_[i]->set_lock(true);
     }
+    for (auto& batch_worker : xc_batch_functional_workers_) {
+        batch_worker->set_grac_shift(grac_shift);
+    }
 }
 void VBase::print_header() const {
     outfile->Printf("  ==> DFT Potential <==\n\n");
@@ -752,20 +832,35 @@ void VBase::build_collocation_cache(size_t memory) {
     if (stride == 0) {
         stride = 1;
     }
-    cache_map_.clear();
+    clear_collocation_cache();
+
+    // Blocks that miss the in-core stride go to disk if requested
+    const size_t nblocks = grid_->blocks().size();
+    const bool in_core = (stride <= nblocks);
+    const bool do_disk = collocation_disk_ && (stride > 1);
 
     // Effectively zero blocks saved.
-    if (stride > grid_->blocks().size()) {
+    if (!in_core && !do_disk) {
         return;
     }
 
+    if (do_disk) {
+        std::string filename = PSIOManager::shared_object()->get_default_path();
+        filename += "psi." + std::to_string(SYSTEM_GETPID()) + "." + primary_->molecule()->name() + ".collocation." +
+                    std::to_string(rand()) + ".dat";
+        disk_cache_ = std::make_shared<CollocationDiskCache>(filename, collocation_disk_single_);
+    }
+
     cache_map_deriv_ = point_workers_[0]->deriv();
     auto saved_size_rank = std::vector<size_t>(num_threads_, 0);
     auto ncomputed_rank = std::vector<size_t>(num_threads_, 0);
+    auto disk_size_rank = std::vector<size_t>(num_threads_, 0);
+    auto ndisk_rank = std::vector<size_t>(num_threads_, 0);
+    const size_t Qstep = (do_disk ? 1 : stride);
 
 // Loop over the blocks
 #pragma omp parallel for schedule(guided) num_threads(num_threads_)
-    for (size_t Q = 0; Q < grid_->blocks().size(); Q += stride) {
+    for (size_t Q = 0; Q < nblocks; Q += Qstep) {
         // Get thread info
         int rank = 0;
 #ifdef _OPENMP
@@ -780,6 +875,15 @@ void VBase::build_collocation_cache(size_t memory) {
         // Build temps
         size_t nrows = block->npoints();
         size_t ncols = block->local_nbf();
+
+        // Off-stride blocks are spilled
+        if (!in_core || (Q % stride)) {
+            disk_cache_->write(block->index(), pworker->basis_values(), nrows, ncols);
+            disk_size_rank[rank] += nrows * ncols * pworker->basis_values().size();
+            ndisk_rank[rank]++;
+            continue;
+        }
+
         std::map<std::string, SharedMatrix> collocation_map;
 
         // Loop over components PHI, PHI_X, PHI_Y, ...
@@ -808,8 +912,32 @@ void VBase::build_collocation_cache(size_t memory) {
     double gib_saved = 8.0 * (double)saved_size / 1024.0 / 1024.0 / 1024.0;
     double fraction = (double)ncomputed / grid_->blocks().size() * 100;
     if (print_) {
-        outfile->Printf("  Cached %.1lf%% of DFT collocation blocks in %.3lf [GiB].\n\n", fraction, gib_saved);
+        outfile->Printf("  Cached %.1lf%% of DFT collocation blocks in %.3lf [GiB].\n", fraction, gib_saved);
+    }
+
+    if (do_disk) {
+        disk_cache_->flush();
+        for (size_t i = 0; i < num_threads_; i++) {
+            point_workers_[i]->set_disk_cache(disk_cache_);
+        }
+
+        size_t disk_size = std::accumulate(disk_size_rank.begin(), disk_size_rank.end(), 0.0);
+        size_t ndisk = std::accumulate(ndisk_rank.begin(), ndisk_rank.end(), 0.0);
+        double gib_disk = (collocation_disk_single_ ? 4.0 : 8.0) * (double)disk_size / 1024.0 / 1024.0 / 1024.0;
+        double disk_fraction = (double)ndisk / grid_->blocks().size() * 100;
+        if (print_) {
+            outfile->Printf("  Spilled %.1lf%% of DFT collocation blocks to disk in %.3lf [GiB] (%s).\n",
+                            disk_fraction, gib_disk, (collocation_disk_single_ ? "FP32" : "FP64"));
+        }
     }
+    if (print_) outfile->Printf("\n");
+}
+void VBase::clear_collocation_cache() {
+    cache_map_.clear();
+    for (auto& pworker : point_workers_) {
+        pworker->set_disk_cache(nullptr);
+    }
+    disk_cache_.reset();
 }
 void VBase::prepare_vv10_cache(DFTGrid& nlgrid, SharedMatrix D,
                                std::vector<std::map<std::string, SharedVector>>& vv10_cache,
@@ -890,6 +1018,124 @@ void VBase::prepare_vv10_cache(DFTGrid& nlgrid, SharedMatrix D,
 
         offset += csize;
     }
+
+    if (!vv10_screening_) return;
+
+    // => Spatial cells for the screened kernel <=
+    // Bin the right-hand points into cubes a quarter of the lumping radius across so that a lumped cell
+    // is always small compared to its distance from the left-hand block
+    const double cell_edge = (vv10_lump_radius_ > 0.0 ? 0.25 * vv10_lump_radius_ : 2.5);
+    const long group_edge = 4;
+    std::map<std::array<long, 3>, std::vector<size_t>> cell_points;
+    for (size_t P = 0; P < total_size; P++) {
+        std::array<long, 3> key = {{(long)std::floor(x_vecp[P] / cell_edge), (long)std::floor(y_vecp[P] / cell_edge),
+                                    (long)std::floor(z_vecp[P] / cell_edge)}};
+        cell_points[key].push_back(P);
+    }
+
+    // Cells are gathered into groups of group_edge^3 neighbouring cells, the first cell of each group carries
+    // the group's lumped point so the kernel can skip or lump a whole group without visiting its cells
+    std::map<std::array<long, 3>, std::vector<std::map<std::string, SharedVector>>> group_cells;
+    for (const auto& kv : cell_points) {
+        const std::vector<size_t>& points = kv.second;
+        const size_t csize = points.size();
+
+        std::map<std::string, SharedVector> cell;
+        cell["W"] = std::make_shared<Vector>("W Grid points", csize);
+        cell["X"] = std::make_shared<Vector>("X Grid points", csize);
+        cell["Y"] = std::make_shared<Vector>("Y Grid points", csize);
+        cell["Z"] = std::make_shared<Vector>("Z Grid points", csize);
+        cell["RHO"] = std::make_shared<Vector>("RHO Grid points", csize);
+        cell["W0"] = std::make_shared<Vector>("W0 Grid points", csize);
+        cell["KAPPA"] = std::make_shared<Vector>("KAPPA Grid points", csize);
+        cell["CELL"] = std::make_shared<Vector>("Cell lumped point", 7);
+
+        double* cwp = cell["W"]->pointer();
+        double* cxp = cell["X"]->pointer();
+        double* cyp = cell["Y"]->pointer();
+        double* czp = cell["Z"]->pointer();
+        double* crhop = cell["RHO"]->pointer();
+        double* cw0p = cell["W0"]->pointer();
+        double* ckappap = cell["KAPPA"]->pointer();
+        double* cellp = cell["CELL"]->pointer();
+
+        // Copy the points and accumulate the w * rho weighted centroid and moduli
+        double wrho_sum = 0.0;
+        for (size_t k = 0; k < csize; k++) {
+            const size_t P = points[k];
+            cwp[k] = w_vecp[P];
+            cxp[k] = x_vecp[P];
+            cyp[k] = y_vecp[P];
+            czp[k] = z_vecp[P];
+            crhop[k] = rho_vecp[P];
+            cw0p[k] = w0_vecp[P];
+            ckappap[k] = kappa_vecp[P];
+
+            const double wrho = w_vecp[P] * rho_vecp[P];
+            wrho_sum += wrho;
+            cellp[0] += wrho * x_vecp[P];
+            cellp[1] += wrho * y_vecp[P];
+            cellp[2] += wrho * z_vecp[P];
+            cellp[5] += wrho * w0_vecp[P];
+            cellp[6] += wrho * kappa_vecp[P];
+        }
+        const double wrho_inv = (wrho_sum > 0.0 ? 1.0 / wrho_sum : 0.0);
+        for (size_t k : {0, 1, 2, 5, 6}) cellp[k] *= wrho_inv;
+        cellp[4] = wrho_sum;
+
+        // Bounding radius about the centroid
+        double R2 = 0.0;
+        for (size_t k = 0; k < csize; k++) {
+            const double dx = cxp[k] - cellp[0];
+            const double dy = cyp[k] - cellp[1];
+            const double dz = czp[k] - cellp[2];
+            R2 = std::max(R2, dx * dx + dy * dy + dz * dz);
+        }
+        cellp[3] = std::sqrt(R2);
+
+        std::array<long, 3> gkey;
+        for (size_t k = 0; k < 3; k++) {
+            gkey[k] = (kv.first[k] >= 0 ? kv.first[k] / group_edge : -((-kv.first[k] - 1) / group_edge) - 1);
+        }
+        group_cells[gkey].push_back(cell);
+    }
+
+    std::vector<std::map<std::string, SharedVector>> vv10_cells;
+    vv10_cells.reserve(cell_points.size());
+    for (auto& kv : group_cells) {
+        std::vector<std::map<std::string, SharedVector>>& cells = kv.second;
+
+        // Group is [x, y, z, radius, sum w * rho, <W0>, <kappa>, ncells]
+        auto group = std::make_shared<Vector>("Group lumped point", 8);
+        double* groupp = group->pointer();
+        for (const auto& cell : cells) {
+            const double* cellp = cell.find("CELL")->second->pointer();
+            const double wrho = cellp[4];
+            groupp[0] += wrho * cellp[0];
+            groupp[1] += wrho * cellp[1];
+            groupp[2] += wrho * cellp[2];
+            groupp[4] += wrho;
+            groupp[5] += wrho * cellp[5];
+            groupp[6] += wrho * cellp[6];
+        }
+        const double wrho_inv = (groupp[4] > 0.0 ? 1.0 / groupp[4] : 0.0);
+        for (size_t k : {0, 1, 2, 5, 6}) groupp[k] *= wrho_inv;
+
+        double R = 0.0;
+        for (const auto& cell : cells) {
+            const double* cellp = cell.find("CELL")->second->pointer();
+            const double dx = cellp[0] - groupp[0];
+            const double dy = cellp[1] - groupp[1];
+            const double dz = cellp[2] - groupp[2];
+            R = std::max(R, std::sqrt(dx * dx + dy * dy + dz * dz) + cellp[3]);
+        }
+        groupp[3] = R;
+        groupp[7] = (double)cells.size();
+
+        cells[0]["GROUP"] = group;
+        for (auto& cell : cells) vv10_cells.push_back(cell);
+    }
+    vv10_cache.swap(vv10_cells);
 }
 double VBase::vv10_nlc(SharedMatrix D, SharedMatrix ret) {
     timer_on("V: VV10");
@@ -945,7 +1191,8 @@ double VBase::vv10_nlc(SharedMatrix D, SharedMatrix ret) {
         std::map<std::string, SharedVector> vals = fworker->values();
 
         parallel_timer_on("Kernel", rank);
-        vv10_exc[rank] += fworker->compute_vv10_kernel(pworker->point_values(), vv10_cache, block);
+        vv10_exc[rank] += fworker->compute_vv10_kernel(pworker->point_values(), vv10_cache, block, -1, false,
+                                                       vv10_lump_radius_, vv10_cutoff_radius_);
         parallel_timer_off("Kernel", rank);
 
         parallel_timer_on("VV10 Fock", rank);
@@ -1040,7 +1287,8 @@ SharedMatrix VBase::vv10_nlc_gradient(SharedMatrix D) {
         std::map<std::string, SharedVector> vals = fworker->values();
 
         parallel_timer_on("Kernel", rank);
-        vv10_exc[rank] += fworker->compute_vv10_kernel(pworker->point_values(), vv10_cache, block, npoints, true);
+        vv10_exc[rank] += fworker->compute_vv10_kernel(pworker->point_values(), vv10_cache, block, npoints, true,
+                                                       vv10_lump_radius_, vv10_cutoff_radius_);
         parallel_timer_off("Kernel", rank);
 
         parallel_timer_on("V_xc gradient", rank);
@@ -1257,6 +1505,26 @@ void RV::initialize() {
         point_tmp->set_cache_map(&cache_map_);
         point_workers_.push_back(point_tmp);
     }
+
+    // Workers for coalesced functional evaluation, only needed if some group holds several blocks. They only
+    // hold point values (xc_group_max_points_ each), the blocks of a group share the thread's point worker.
+    xc_batch_functional_workers_.clear();
+    xc_batch_inputs_.clear();
+    if (xc_group_max_blocks_ > 1) {
+        for (size_t i = 0; i < num_threads_; i++) {
+            auto batch_worker = functional_->build_worker();
+            batch_worker->set_lock(false);
+            batch_worker->set_max_points(xc_group_max_points_);
+            batch_worker->allocate();
+            xc_batch_functional_workers_.push_back(batch_worker);
+
+            std::map<std::string, SharedVector> inputs;
+            for (const auto& kv : point_workers_[i]->point_values()) {
+                inputs[kv.first] = std::make_shared<Vector>(kv.first, xc_group_max_points_);
+            }
+            xc_batch_inputs_.push_back(inputs);
+        }
+    }
 }
 void RV::finalize() { VBase::finalize(); }
 void RV::print_header() const { VBase::print_header(); }
@@ -1305,15 +1573,21 @@ void RV::compute_V(std::vector<SharedMatrix> ret) {
     int max_functions = grid_->max_functions();
     int max_points = grid_->max_points();
 
-    // Setup the pointers
+    // Setup the pointers, function screening is only consistent with the unpacking below
     for (size_t i = 0; i < num_threads_; i++) {
         point_workers_[i]->set_pointers(D_AO_[0]);
+        point_workers_[i]->set_function_screening(block_screening_tolerance_);
     }
 
-    // Per thread temporaries
-    std::vector<SharedMatrix> V_local;
-    for (size_t i = 0; i < num_threads_; i++) {
-        V_local.push_back(std::make_shared<Matrix>("V Temp", max_functions, max_functions));
+    // Per thread temporaries, allocated (and first touched) by the owning thread
+    std::vector<SharedMatrix> V_local(num_threads_);
+#pragma omp parallel num_threads(num_threads_)
+    {
+        size_t trank = 0;
+#ifdef _OPENMP
+        trank = omp_get_thread_num();
+#endif
+        V_local[trank] = std::make_shared<Matrix>("V Temp", max_functions, max_functions);
     }
 
     auto V_AO = std::make_shared<Matrix>("V AO Temp", nbf_, nbf_);
@@ -1324,68 +1598,124 @@ void RV::compute_V(std::vector<SharedMatrix> ret) {
     std::vector<double> rhoaxq(num_threads_);
     std::vector<double> rhoayq(num_threads_);
     std::vector<double> rhoazq(num_threads_);
+    std::vector<double> thread_time(num_threads_);
+    std::vector<size_t> thread_blocks(num_threads_);
 
 // VV10 kernel data if requested
 
-// Traverse the blocks of points
-#pragma omp parallel for private(rank) schedule(guided) num_threads(num_threads_)
-    for (size_t Q = 0; Q < grid_->blocks().size(); Q++) {
+// Traverse the groups of blocks, most expensive first. Most groups hold a single block; the cheap
+// blocks at the tail are grouped so that the functional is evaluated on one large batch of points.
+    const size_t ngroups = xc_group_offsets_.size() - 1;
+#pragma omp parallel for private(rank) schedule(dynamic) num_threads(num_threads_)
+    for (size_t G = 0; G < ngroups; G++) {
 // Get thread info
 #ifdef _OPENMP
         rank = omp_get_thread_num();
 #endif
+        const size_t group_start = xc_group_offsets_[G];
+        const size_t group_size = xc_group_offsets_[G + 1] - group_start;
+        auto block_start = std::chrono::steady_clock::now();
 
         // Get per-rank workers
-        std::shared_ptr<BlockOPoints> block = grid_->blocks()[Q];
         std::shared_ptr<SuperFunctional> fworker = functional_workers_[rank];
         std::shared_ptr<PointFunctions> pworker = point_workers_[rank];
 
-        // Compute Rho, Phi, etc
-        parallel_timer_on("Properties", rank);
-        pworker->compute_points(block, false);
-        parallel_timer_off("Properties", rank);
+        // Compute Rho, Phi, etc and the functional values. A group of several blocks gathers only the point
+        // values of each block into one batch; the collocation of a block is recomputed for its integration.
+        if (group_size == 1) {
+            parallel_timer_on("Properties", rank);
+            pworker->compute_points(grid_->blocks()[block_order_[group_start]], false);
+            parallel_timer_off("Properties", rank);
 
-        // Compute functional values
-        parallel_timer_on("Functional", rank);
-        fworker->compute_functional(pworker->point_values());
-        parallel_timer_off("Functional", rank);
+            parallel_timer_on("Functional", rank);
+            fworker->compute_functional(pworker->point_values(), grid_->blocks()[block_order_[group_start]]->npoints());
+            parallel_timer_off("Functional", rank);
+        } else {
+            size_t offset = 0;
+            for (size_t k = 0; k < group_size; k++) {
+                std::shared_ptr<BlockOPoints> block = grid_->blocks()[block_order_[group_start + k]];
+                const size_t npoints = block->npoints();
+                parallel_timer_on("Properties", rank);
+                pworker->compute_points(block, false);
+                parallel_timer_off("Properties", rank);
+                for (auto& kv : xc_batch_inputs_[rank]) {
+                    const double* src = pworker->point_values()[kv.first]->pointer();
+                    std::copy(src, src + npoints, kv.second->pointer() + offset);
+                }
+                offset += npoints;
+            }
 
-        if (debug_ > 4) {
-            block->print("outfile", debug_);
-            pworker->print("outfile", debug_);
+            parallel_timer_on("Functional", rank);
+            xc_batch_functional_workers_[rank]->compute_functional(xc_batch_inputs_[rank], offset);
+            parallel_timer_off("Functional", rank);
         }
 
-        parallel_timer_on("V_xc", rank);
+        size_t offset = 0;
+        for (size_t k = 0; k < group_size; k++) {
+            std::shared_ptr<BlockOPoints> block = grid_->blocks()[block_order_[group_start + k]];
+            const size_t npoints = block->npoints();
+
+            // Recompute this block's collocation and scatter its slice of the batch into the per-block
+            // functional worker
+            if (group_size > 1) {
+                parallel_timer_on("Properties", rank);
+                pworker->compute_points(block, false);
+                parallel_timer_off("Properties", rank);
+
+                for (auto& kv : xc_batch_functional_workers_[rank]->values()) {
+                    const double* src = kv.second->pointer() + offset;
+                    std::copy(src, src + npoints, fworker->values()[kv.first]->pointer());
+                }
+                offset += npoints;
+            }
 
-        // => Compute quadrature <= //
-        std::vector<double> qvals = dft_integrators::rks_quadrature_integrate(block, fworker, pworker);
-        functionalq[rank] += qvals[0];
-        rhoaq[rank] += qvals[1];
-        rhoaxq[rank] += qvals[2];
-        rhoayq[rank] += qvals[3];
-        rhoazq[rank] += qvals[4];
+            if (debug_ > 4) {
+                block->print("outfile", debug_);
+                pworker->print("outfile", debug_);
+            }
 
-        // => LSDA, GGA, and meta contribution (symmetrized) <= //
-        dft_integrators::rks_integrator(block, fworker, pworker, V_local[rank]);
+            parallel_timer_on("V_xc", rank);
 
-        // => Unpacking <= //
-        double** V2p = V_local[rank]->pointer();
-        const std::vector<int>& function_map = block->functions_local_to_global();
-        int nlocal = function_map.size();
+            // => Compute quadrature <= //
+            std::vector<double> qvals = dft_integrators::rks_quadrature_integrate(block, fworker, pworker);
+            functionalq[rank] += qvals[0];
+            rhoaq[rank] += qvals[1];
+            rhoaxq[rank] += qvals[2];
+            rhoayq[rank] += qvals[3];
+            rhoazq[rank] += qvals[4];
 
-        for (int ml = 0; ml < nlocal; ml++) {
-            int mg = function_map[ml];
-            for (int nl = 0; nl < ml; nl++) {
-                int ng = function_map[nl];
-#pragma omp atomic update
-                Vp[mg][ng] += V2p[ml][nl];
+            // => LSDA, GGA, and meta contribution (symmetrized) <= //
+            dft_integrators::rks_integrator(block, fworker, pworker, V_local[rank]);
+
+            // => Unpacking <= //
+            // The function map is ascending, so only the lower triangle is scattered; it is mirrored below
+            double** V2p = V_local[rank]->pointer();
+            const std::vector<int>& function_map = pworker->function_map();
+            int nlocal = function_map.size();
+
+            for (int ml = 0; ml < nlocal; ml++) {
+                int mg = function_map[ml];
+                for (int nl = 0; nl <= ml; nl++) {
+                    int ng = function_map[nl];
 #pragma omp atomic update
-                Vp[ng][mg] += V2p[ml][nl];
+                    Vp[mg][ng] += V2p[ml][nl];
+                }
             }
-#pragma omp atomic update
-            Vp[mg][mg] += V2p[ml][ml];
+            parallel_timer_off("V_xc", rank);
+        }
+
+        thread_time[rank] += std::chrono::duration<double>(std::chrono::steady_clock::now() - block_start).count();
+        thread_blocks[rank] += group_size;
+    }
+    print_thread_balance("RV", thread_time, thread_blocks);
+
+    for (size_t i = 0; i < num_threads_; i++) {
+        point_workers_[i]->set_function_screening(0.0);
+    }
+    for (int m = 0; m < nbf_; m++) {
+        for (int n = 0; n < m; n++) {
+            Vp[n][m] = Vp[m][n];
         }
-        parallel_timer_off("V_xc", rank);
     }
 
     // Do we need VV10?
@@ -1712,12 +2042,17 @@ void RV::compute_Vx(std::vector<SharedMatrix> Dx, std::vector<SharedMatrix> ret)
         }
     }
 
+    // Response densities are contracted in batches, one wide GEMM per batch and block
+    const size_t nbatch = std::max<size_t>(1, std::min<size_t>(Dx_vec.size(), vx_batch_size_));
+    const size_t batch_cols = nbatch * max_functions;
+
     // Per [R]ank quantities
-    std::vector<SharedMatrix> R_Vx_local, R_Dx_local;
+    std::vector<SharedMatrix> R_Vx_local, R_Dx_local, R_T_local;
     std::vector<std::shared_ptr<Vector>> R_rho_k, R_rho_k_x, R_rho_k_y, R_rho_k_z, R_gamma_k;
     for (size_t i = 0; i < num_threads_; i++) {
-        R_Vx_local.push_back(std::make_shared<Matrix>("Vx Temp", max_functions, max_functions));
-        R_Dx_local.push_back(std::make_shared<Matrix>("Dk Temp", max_functions, max_functions));
+        R_Vx_local.push_back(std::make_shared<Matrix>("Vx Temp", max_functions, batch_cols));
+        R_Dx_local.push_back(std::make_shared<Matrix>("Dk Temp", max_functions, batch_cols));
+        R_T_local.push_back(std::make_shared<Matrix>("T Temp", max_points, batch_cols));
 
         R_rho_k.push_back(std::make_shared<Vector>("Rho K Temp", max_points));
 
@@ -1753,7 +2088,7 @@ void RV::compute_Vx(std::vector<SharedMatrix> Dx, std::vector<SharedMatrix> ret)
         double** Dx_localp = R_Dx_local[rank]->pointer();
 
         // => Compute blocks <= //
-        double** Tp = pworker->scratch()[0]->pointer();
+        double** Tp = R_T_local[rank]->pointer();
 
         std::shared_ptr<BlockOPoints> block = grid_->blocks()[Q];
         int npoints = block->npoints();
@@ -1807,114 +2142,128 @@ void RV::compute_Vx(std::vector<SharedMatrix> Dx, std::vector<SharedMatrix> ret)
         // Meta
         // Forget that!
 
-        // Loop over perturbation tensors
-        for (size_t dindex = 0; dindex < Dx_vec.size(); dindex++) {
-            double** Dxp = Dx_vec[dindex]->pointer();
+        // Loop over batches of perturbation tensors
+        for (size_t dstart = 0; dstart < Dx_vec.size(); dstart += nbatch) {
+            const size_t nD = std::min(nbatch, Dx_vec.size() - dstart);
+            const size_t ncols = nD * nlocal;
 
             // => Build Rotated Densities <= //
-            for (int ml = 0; ml < nlocal; ml++) {
-                int mg = function_map[ml];
-                for (int nl = 0; nl < nlocal; nl++) {
-                    int ng = function_map[nl];
-                    Dx_localp[ml][nl] = Dxp[mg][ng];
+            // Packed side by side, (D^k + D^k^T) so that a single GEMM gives both halves of phi D^k phi
+            for (size_t k = 0; k < nD; k++) {
+                double** Dxp = Dx_vec[dstart + k]->pointer();
+                for (int ml = 0; ml < nlocal; ml++) {
+                    int mg = function_map[ml];
+                    double* Dx_row = Dx_localp[ml] + k * nlocal;
+                    for (int nl = 0; nl < nlocal; nl++) {
+                        int ng = function_map[nl];
+                        Dx_row[nl] = Dxp[mg][ng] + Dxp[ng][mg];
+                    }
                 }
             }
 
             parallel_timer_on("Derivative Properties", rank);
-            // Rho_a = D^k_xy phi_xa phi_ya
-            C_DGEMM('N', 'N', npoints, nlocal, nlocal, 1.0, phi[0], coll_funcs, Dx_localp[0], max_functions, 0.0, Tp[0],
-                    max_functions);
-            C_DGEMM('N', 'T', npoints, nlocal, nlocal, 1.0, phi[0], coll_funcs, Dx_localp[0], max_functions, 1.0, Tp[0],
-                    max_functions);
+            // T^k = phi (D^k + D^k^T) for the whole batch
+            C_DGEMM('N', 'N', npoints, ncols, nlocal, 1.0, phi[0], coll_funcs, Dx_localp[0], batch_cols, 0.0, Tp[0],
+                    batch_cols);
+            parallel_timer_off("Derivative Properties", rank);
 
-            for (int P = 0; P < npoints; P++) {
-                rho_k[P] = 0.5 * C_DDOT(nlocal, phi[P], 1, Tp[P], 1);
-            }
+            for (size_t k = 0; k < nD; k++) {
+                const size_t koff = k * nlocal;
 
-            // Rho^d_k and gamma_k
-            if (ansatz >= 1) {
+                parallel_timer_on("Derivative Properties", rank);
+                // Rho_a = D^k_xy phi_xa phi_ya
                 for (int P = 0; P < npoints; P++) {
-                    rho_k_x[P] = C_DDOT(nlocal, phi_x[P], 1, Tp[P], 1);
-                    rho_k_y[P] = C_DDOT(nlocal, phi_y[P], 1, Tp[P], 1);
-                    rho_k_z[P] = C_DDOT(nlocal, phi_z[P], 1, Tp[P], 1);
-                    gamma_k[P] = rho_k_x[P] * rho_x[P];
-                    gamma_k[P] += rho_k_y[P] * rho_y[P];
-                    gamma_k[P] += rho_k_z[P] * rho_z[P];
-                    gamma_k[P] *= 2;
+                    rho_k[P] = 0.5 * C_DDOT(nlocal, phi[P], 1, Tp[P] + koff, 1);
                 }
-            }
-            parallel_timer_off("Derivative Properties", rank);
 
-            // => LSDA contribution (symmetrized) <= //
-            parallel_timer_on("V_XCd", rank);
-            // parallel_timer_on("LSDA", rank);
-            for (int P = 0; P < npoints; P++) {
-                std::fill(Tp[P], Tp[P] + nlocal, 0.0);
-                if (rho_a[P] < v2_rho_cutoff_) continue;
-                C_DAXPY(nlocal, 0.5 * v2_rho2[P] * w[P] * rho_k[P], phi[P], 1, Tp[P], 1);
-            }
-            // parallel_timer_off("LSDA", rank);
-
-            // => GGA contribution <= //
-            // parallel_timer_on("GGA", rank);
-            if (ansatz >= 1) {
-                double* v_gamma = vals["V_GAMMA_AA"]->pointer();
-                double* v2_gamma_gamma = vals["V_GAMMA_AA_GAMMA_AA"]->pointer();
-                double* v2_rho_gamma = vals["V_RHO_A_GAMMA_AA"]->pointer();
-                double tmp_val = 0.0, v2_val = 0.0;
+                // Rho^d_k and gamma_k
+                if (ansatz >= 1) {
+                    for (int P = 0; P < npoints; P++) {
+                        rho_k_x[P] = C_DDOT(nlocal, phi_x[P], 1, Tp[P] + koff, 1);
+                        rho_k_y[P] = C_DDOT(nlocal, phi_y[P], 1, Tp[P] + koff, 1);
+                        rho_k_z[P] = C_DDOT(nlocal, phi_z[P], 1, Tp[P] + koff, 1);
+                        gamma_k[P] = rho_k_x[P] * rho_x[P];
+                        gamma_k[P] += rho_k_y[P] * rho_y[P];
+                        gamma_k[P] += rho_k_z[P] * rho_z[P];
+                        gamma_k[P] *= 2;
+                    }
+                }
+                parallel_timer_off("Derivative Properties", rank);
 
+                // => LSDA contribution (symmetrized) <= //
+                // T^k is no longer needed, its columns are overwritten with the kernel contraction
+                parallel_timer_on("V_XCd", rank);
                 for (int P = 0; P < npoints; P++) {
+                    double* TPk = Tp[P] + koff;
+                    std::fill(TPk, TPk + nlocal, 0.0);
                     if (rho_a[P] < v2_rho_cutoff_) continue;
+                    C_DAXPY(nlocal, 0.5 * v2_rho2[P] * w[P] * rho_k[P], phi[P], 1, TPk, 1);
+                }
 
-                    // V contributions
-                    C_DAXPY(nlocal, (0.5 * w[P] * v2_rho_gamma[P] * gamma_k[P]), phi[P], 1, Tp[P], 1);
+                // => GGA contribution <= //
+                if (ansatz >= 1) {
+                    double* v_gamma = vals["V_GAMMA_AA"]->pointer();
+                    double* v2_gamma_gamma = vals["V_GAMMA_AA_GAMMA_AA"]->pointer();
+                    double* v2_rho_gamma = vals["V_RHO_A_GAMMA_AA"]->pointer();
+                    double tmp_val = 0.0, v2_val = 0.0;
 
-                    // W contributions
-                    v2_val = (v2_rho_gamma[P] * rho_k[P] + v2_gamma_gamma[P] * gamma_k[P]);
+                    for (int P = 0; P < npoints; P++) {
+                        if (rho_a[P] < v2_rho_cutoff_) continue;
+                        double* TPk = Tp[P] + koff;
 
-                    tmp_val = 2.0 * w[P] * (v_gamma[P] * rho_k_x[P] + v2_val * rho_x[P]);
-                    C_DAXPY(nlocal, tmp_val, phi_x[P], 1, Tp[P], 1);
+                        // V contributions
+                        C_DAXPY(nlocal, (0.5 * w[P] * v2_rho_gamma[P] * gamma_k[P]), phi[P], 1, TPk, 1);
 
-                    tmp_val = 2.0 * w[P] * (v_gamma[P] * rho_k_y[P] + v2_val * rho_y[P]);
-                    C_DAXPY(nlocal, tmp_val, phi_y[P], 1, Tp[P], 1);
+                        // W contributions
+                        v2_val = (v2_rho_gamma[P] * rho_k[P] + v2_gamma_gamma[P] * gamma_k[P]);
 
-                    tmp_val = 2.0 * w[P] * (v_gamma[P] * rho_k_z[P] + v2_val * rho_z[P]);
-                    C_DAXPY(nlocal, tmp_val, phi_z[P], 1, Tp[P], 1);
-                }
-            }
-            // parallel_timer_off("GGA", rank);
+                        tmp_val = 2.0 * w[P] * (v_gamma[P] * rho_k_x[P] + v2_val * rho_x[P]);
+                        C_DAXPY(nlocal, tmp_val, phi_x[P], 1, TPk, 1);
 
-            // Put it all together
-            // parallel_timer_on("LSDA", rank);
-            C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, phi[0], coll_funcs, Tp[0], max_functions, 0.0, Vx_localp[0],
-                    max_functions);
-            // parallel_timer_off("LSDA", rank);
+                        tmp_val = 2.0 * w[P] * (v_gamma[P] * rho_k_y[P] + v2_val * rho_y[P]);
+                        C_DAXPY(nlocal, tmp_val, phi_y[P], 1, TPk, 1);
 
-            // Symmetrization (V is *always* Hermitian)
-            for (int m = 0; m < nlocal; m++) {
-                for (int n = 0; n <= m; n++) {
-                    Vx_localp[m][n] = Vx_localp[n][m] = Vx_localp[m][n] + Vx_localp[n][m];
+                        tmp_val = 2.0 * w[P] * (v_gamma[P] * rho_k_z[P] + v2_val * rho_z[P]);
+                        C_DAXPY(nlocal, tmp_val, phi_z[P], 1, TPk, 1);
+                    }
                 }
+                parallel_timer_off("V_XCd", rank);
             }
 
-            // => Unpacking <= //
-            double** Vxp = Vx_AO[dindex]->pointer();
-            for (int ml = 0; ml < nlocal; ml++) {
-                int mg = function_map[ml];
-                for (int nl = 0; nl < ml; nl++) {
-                    int ng = function_map[nl];
-#pragma omp atomic update
-                    Vxp[mg][ng] += Vx_localp[ml][nl];
+            // Put it all together, one GEMM for the batch
+            parallel_timer_on("V_XCd", rank);
+            C_DGEMM('T', 'N', nlocal, ncols, npoints, 1.0, phi[0], coll_funcs, Tp[0], batch_cols, 0.0, Vx_localp[0],
+                    batch_cols);
+
+            for (size_t k = 0; k < nD; k++) {
+                const size_t koff = k * nlocal;
+
+                // => Unpacking <= //
+                // Symmetrized (V is *always* Hermitian) into the lower triangle, mirrored after the block loop
+                double** Vxp = Vx_AO[dstart + k]->pointer();
+                for (int ml = 0; ml < nlocal; ml++) {
+                    int mg = function_map[ml];
+                    for (int nl = 0; nl <= ml; nl++) {
+                        int ng = function_map[nl];
+                        double Vval = Vx_localp[ml][koff + nl] + Vx_localp[nl][koff + ml];
 #pragma omp atomic update
-                    Vxp[ng][mg] += Vx_localp[ml][nl];
+                        Vxp[mg][ng] += Vval;
+                    }
                 }
-#pragma omp atomic update
-                Vxp[mg][mg] += Vx_localp[ml][ml];
             }
             parallel_timer_off("V_XCd", rank);
         }
     }
 
+    for (size_t i = 0; i < Dx.size(); i++) {
+        double** Vxp = Vx_AO[i]->pointer();
+        for (int m = 0; m < nbf_; m++) {
+            for (int n = 0; n < m; n++) {
+                Vxp[n][m] = Vxp[m][n];
+            }
+        }
+    }
+
     // Set the result
     for (size_t i = 0; i < Dx.size(); i++) {
         if (Dx[i]->nirrep() != 1) {
@@ -2451,14 +2800,19 @@ void UV::compute_V(std::vector<SharedMatrix> ret) {
         point_workers_[i]->set_pointers(D_AO_[0], D_AO_[1]);
     }
 
-    // Per thread temporaries
-    std::vector<SharedMatrix> Va_local, Vb_local;
-    std::vector<std::shared_ptr<Vector>> Qa_temp, Qb_temp;
-    for (size_t i = 0; i < num_threads_; i++) {
-        Va_local.push_back(std::make_shared<Matrix>("Va Temp", max_functions, max_functions));
-        Vb_local.push_back(std::make_shared<Matrix>("Vb Temp", max_functions, max_functions));
-        Qa_temp.push_back(std::make_shared<Vector>("Quadrature A Temp", max_points));
-        Qb_temp.push_back(std::make_shared<Vector>("Quadrature B Temp", max_points));
+    // Per thread temporaries, allocated (and first touched) by the owning thread
+    std::vector<SharedMatrix> Va_local(num_threads_), Vb_local(num_threads_);
+    std::vector<std::shared_ptr<Vector>> Qa_temp(num_threads_), Qb_temp(num_threads_);
+#pragma omp parallel num_threads(num_threads_)
+    {
+        size_t trank = 0;
+#ifdef _OPENMP
+        trank = omp_get_thread_num();
+#endif
+        Va_local[trank] = std::make_shared<Matrix>("Va Temp", max_functions, max_functions);
+        Vb_local[trank] = std::make_shared<Matrix>("Vb Temp", max_functions, max_functions);
+        Qa_temp[trank] = std::make_shared<Vector>("Quadrature A Temp", max_points);
+        Qb_temp[trank] = std::make_shared<Vector>("Quadrature B Temp", max_points);
     }
 
     auto Va_AO = std::make_shared<Matrix>("Va Temp", nbf_, nbf_);
@@ -2475,13 +2829,18 @@ void UV::compute_V(std::vector<SharedMatrix> ret) {
     std::vector<double> rhobxq(num_threads_);
     std::vector<double> rhobyq(num_threads_);
     std::vector<double> rhobzq(num_threads_);
+    std::vector<double> thread_time(num_threads_);
+    std::vector<size_t> thread_blocks(num_threads_);
 
-    // Loop over grid
-    for (size_t Q = 0; Q < grid_->blocks().size(); Q++) {
+// Loop over grid, most expensive blocks first
+#pragma omp parallel for private(rank) schedule(dynamic) num_threads(num_threads_)
+    for (size_t Qorder = 0; Qorder < block_order_.size(); Qorder++) {
 // Get thread info
 #ifdef _OPENMP
         rank = omp_get_thread_num();
 #endif
+        const size_t Q = block_order_[Qorder];
+        auto block_start = std::chrono::steady_clock::now();
 
         std::shared_ptr<SuperFunctional> fworker = functional_workers_[rank];
         std::shared_ptr<PointFunctions> pworker = point_workers_[rank];
@@ -2658,7 +3017,11 @@ void UV::compute_V(std::vector<SharedMatrix> ret) {
             Vbp[mg][mg] += Vb2p[ml][ml];
         }
         parallel_timer_off("V_xc", rank);
+
+        thread_time[rank] += std::chrono::duration<double>(std::chrono::steady_clock::now() - block_start).count();
+        thread_blocks[rank]++;
     }
+    print_thread_balance("UV", thread_time, thread_blocks);
 
     // Do we need VV10?
     double vv10_e = 0.0;
@@ -2756,17 +3119,20 @@ void UV::compute_Vx(std::vector<SharedMatrix> Dx, std::vector<SharedMatrix> ret)
         }
     }
 
+    // Alpha and beta response densities are contracted in batches of pairs, one wide GEMM per batch and block
+    const size_t npair = Dx_vec.size() / 2;
+    const size_t nbatch = std::max<size_t>(1, std::min<size_t>(npair, vx_batch_size_));
+    const size_t batch_cols = 2 * nbatch * max_functions;
+
     // Per [R]ank quantities
-    std::vector<SharedMatrix> R_Vax_local, R_Dax_local;
-    std::vector<SharedMatrix> R_Vbx_local, R_Dbx_local;
+    std::vector<SharedMatrix> R_Vx_local, R_Dx_local, R_T_local;
     std::vector<std::shared_ptr<Vector>> R_rho_ak, R_rho_ak_x, R_rho_ak_y, R_rho_ak_z, R_gamma_ak;
     std::vector<std::shared_ptr<Vector>> R_rho_bk, R_rho_bk_x, R_rho_bk_y, R_rho_bk_z, R_gamma_bk;
     std::vector<std::shared_ptr<Vector>> R_gamma_abk;
     for (size_t i = 0; i < num_threads_; i++) {
-        R_Vax_local.push_back(std::make_shared<Matrix>("Vax Temp", max_functions, max_functions));
-        R_Vbx_local.push_back(std::make_shared<Matrix>("Vbx Temp", max_functions, max_functions));
-        R_Dax_local.push_back(std::make_shared<Matrix>("Dak Temp", max_functions, max_functions));
-        R_Dbx_local.push_back(std::make_shared<Matrix>("Dbk Temp", max_functions, max_functions));
+        R_Vx_local.push_back(std::make_shared<Matrix>("Vx Temp", max_functions, batch_cols));
+        R_Dx_local.push_back(std::make_shared<Matrix>("Dk Temp", max_functions, batch_cols));
+        R_T_local.push_back(std::make_shared<Matrix>("T Temp", max_points, batch_cols));
 
         R_rho_ak.push_back(std::make_shared<Vector>("Rho aK Temp", max_points));
         R_rho_bk.push_back(std::make_shared<Vector>("Rho bK Temp", max_points));
@@ -2808,14 +3174,11 @@ void UV::compute_Vx(std::vector<SharedMatrix> Dx, std::vector<SharedMatrix> ret)
         // => Setup <= //
         std::shared_ptr<SuperFunctional> fworker = functional_workers_[rank];
         std::shared_ptr<PointFunctions> pworker = point_workers_[rank];
-        double** Vax_localp = R_Vax_local[rank]->pointer();
-        double** Vbx_localp = R_Vbx_local[rank]->pointer();
-        double** Dax_localp = R_Dax_local[rank]->pointer();
-        double** Dbx_localp = R_Dbx_local[rank]->pointer();
+        double** Vx_localp = R_Vx_local[rank]->pointer();
+        double** Dx_localp = R_Dx_local[rank]->pointer();
 
         // => Compute blocks <= //
-        double** Tap = pworker->scratch()[0]->pointer();
-        double** Tbp = pworker->scratch()[1]->pointer();
+        double** Tp = R_T_local[rank]->pointer();
 
         std::shared_ptr<BlockOPoints> block = grid_->blocks()[Q];
         int npoints = block->npoints();
@@ -2889,282 +3252,284 @@ void UV::compute_Vx(std::vector<SharedMatrix> Dx, std::vector<SharedMatrix> ret)
         // Meta
         // Forget that!
 
-        // Loop over perturbation tensors
-        for (size_t dindex = 0; dindex < (Dx_vec.size() / 2); dindex++) {
-            double** Daxp = Dx_vec[2 * dindex]->pointer();
-            double** Dbxp = Dx_vec[2 * dindex + 1]->pointer();
+        // Loop over batches of perturbation pairs
+        for (size_t dstart = 0; dstart < npair; dstart += nbatch) {
+            const size_t nD = std::min(nbatch, npair - dstart);
+            const size_t ncols = 2 * nD * nlocal;
 
             // => Build Rotated Densities <= //
-            for (int ml = 0; ml < nlocal; ml++) {
-                int mg = function_map[ml];
-                for (int nl = 0; nl < nlocal; nl++) {
-                    int ng = function_map[nl];
-                    Dax_localp[ml][nl] = Daxp[mg][ng];
-                    Dbx_localp[ml][nl] = Dbxp[mg][ng];
-                    // printf("%d %d: %16.8f %16.8f\n", ml, nl, Dax_localp[ml][nl], Dbx_localp[ml][nl]);
+            // Alpha and beta of each pair side by side, (D^k + D^k^T) so that a single GEMM gives both halves
+            for (size_t k = 0; k < 2 * nD; k++) {
+                double** Dxp = Dx_vec[2 * dstart + k]->pointer();
+                for (int ml = 0; ml < nlocal; ml++) {
+                    int mg = function_map[ml];
+                    double* Dx_row = Dx_localp[ml] + k * nlocal;
+                    for (int nl = 0; nl < nlocal; nl++) {
+                        int ng = function_map[nl];
+                        Dx_row[nl] = Dxp[mg][ng] + Dxp[ng][mg];
+                    }
                 }
             }
 
-            // Rho_a = D^k_xy phi_xa phi_ya
-            // Alpha
+            // T^k = phi (D^k + D^k^T) for the whole batch
             parallel_timer_on("Derivative Properties", rank);
-            C_DGEMM('N', 'N', npoints, nlocal, nlocal, 1.0, phi[0], coll_funcs, Dax_localp[0], max_functions, 0.0,
-                    Tap[0], max_functions);
-            C_DGEMM('N', 'T', npoints, nlocal, nlocal, 1.0, phi[0], coll_funcs, Dax_localp[0], max_functions, 1.0,
-                    Tap[0], max_functions);
-
-            // Beta
-            C_DGEMM('N', 'N', npoints, nlocal, nlocal, 1.0, phi[0], coll_funcs, Dbx_localp[0], max_functions, 0.0,
-                    Tbp[0], max_functions);
-            C_DGEMM('N', 'T', npoints, nlocal, nlocal, 1.0, phi[0], coll_funcs, Dbx_localp[0], max_functions, 1.0,
-                    Tbp[0], max_functions);
-
-            for (int P = 0; P < npoints; P++) {
-                rho_ak[P] = 0.5 * C_DDOT(nlocal, phi[P], 1, Tap[P], 1);
-                rho_bk[P] = 0.5 * C_DDOT(nlocal, phi[P], 1, Tbp[P], 1);
-            }
-
-            // Rho^d_k and gamma_k
-            if (ansatz >= 1) {
-                for (int P = 0; P < npoints; P++) {
-                    // Alpha
-                    rho_ak_x[P] = C_DDOT(nlocal, phi_x[P], 1, Tap[P], 1);
-                    rho_ak_y[P] = C_DDOT(nlocal, phi_y[P], 1, Tap[P], 1);
-                    rho_ak_z[P] = C_DDOT(nlocal, phi_z[P], 1, Tap[P], 1);
-                    gamma_aak[P] = rho_ak_x[P] * rho_ax[P];
-                    gamma_aak[P] += rho_ak_y[P] * rho_ay[P];
-                    gamma_aak[P] += rho_ak_z[P] * rho_az[P];
-                    gamma_aak[P] *= 2.0;
-
-                    // Beta
-                    rho_bk_x[P] = C_DDOT(nlocal, phi_x[P], 1, Tbp[P], 1);
-                    rho_bk_y[P] = C_DDOT(nlocal, phi_y[P], 1, Tbp[P], 1);
-                    rho_bk_z[P] = C_DDOT(nlocal, phi_z[P], 1, Tbp[P], 1);
-                    gamma_bbk[P] = rho_bk_x[P] * rho_bx[P];
-                    gamma_bbk[P] += rho_bk_y[P] * rho_by[P];
-                    gamma_bbk[P] += rho_ak_z[P] * rho_bz[P];
-                    gamma_bbk[P] *= 2.0;
-
-                    // Alpha-Beta
-                    gamma_abk[P] = rho_ak_x[P] * rho_bx[P] + rho_bk_x[P] * rho_ax[P];
-                    gamma_abk[P] += rho_ak_y[P] * rho_by[P] + rho_bk_y[P] * rho_ay[P];
-                    gamma_abk[P] += rho_ak_z[P] * rho_bz[P] + rho_bk_z[P] * rho_az[P];
-                }
-            }
+            C_DGEMM('N', 'N', npoints, ncols, nlocal, 1.0, phi[0], coll_funcs, Dx_localp[0], batch_cols, 0.0, Tp[0],
+                    batch_cols);
             parallel_timer_off("Derivative Properties", rank);
 
-            parallel_timer_on("V_XCd", rank);
-            // => LSDA contribution (symmetrized) <= //
-            double tmp_val = 0.0, tmp_ab_val = 0.0;
-            for (int P = 0; P < npoints; P++) {
-                std::fill(Tap[P], Tap[P] + nlocal, 0.0);
-                std::fill(Tbp[P], Tbp[P] + nlocal, 0.0);
+            for (size_t k = 0; k < nD; k++) {
+                const size_t aoff = 2 * k * nlocal;
+                const size_t boff = aoff + nlocal;
 
-                if (rho_a[P] > v2_rho_cutoff_) {
-                    tmp_val = v2_rho2_aa[P] * rho_ak[P];
-                    tmp_val += v2_rho2_ab[P] * rho_bk[P];
-                    tmp_val *= 0.5 * w[P];
-                    C_DAXPY(nlocal, tmp_val, phi[P], 1, Tap[P], 1);
+                // Rho_a = D^k_xy phi_xa phi_ya
+                parallel_timer_on("Derivative Properties", rank);
+                for (int P = 0; P < npoints; P++) {
+                    rho_ak[P] = 0.5 * C_DDOT(nlocal, phi[P], 1, Tp[P] + aoff, 1);
+                    rho_bk[P] = 0.5 * C_DDOT(nlocal, phi[P], 1, Tp[P] + boff, 1);
                 }
 
-                if (rho_b[P] > v2_rho_cutoff_) {
-                    tmp_val = v2_rho2_bb[P] * rho_bk[P];
-                    tmp_val += v2_rho2_ab[P] * rho_ak[P];
-                    tmp_val *= 0.5 * w[P];
-                    C_DAXPY(nlocal, tmp_val, phi[P], 1, Tbp[P], 1);
+                // Rho^d_k and gamma_k
+                if (ansatz >= 1) {
+                    for (int P = 0; P < npoints; P++) {
+                        // Alpha
+                        rho_ak_x[P] = C_DDOT(nlocal, phi_x[P], 1, Tp[P] + aoff, 1);
+                        rho_ak_y[P] = C_DDOT(nlocal, phi_y[P], 1, Tp[P] + aoff, 1);
+                        rho_ak_z[P] = C_DDOT(nlocal, phi_z[P], 1, Tp[P] + aoff, 1);
+                        gamma_aak[P] = rho_ak_x[P] * rho_ax[P];
+                        gamma_aak[P] += rho_ak_y[P] * rho_ay[P];
+                        gamma_aak[P] += rho_ak_z[P] * rho_az[P];
+                        gamma_aak[P] *= 2.0;
+
+                        // Beta
+                        rho_bk_x[P] = C_DDOT(nlocal, phi_x[P], 1, Tp[P] + boff, 1);
+                        rho_bk_y[P] = C_DDOT(nlocal, phi_y[P], 1, Tp[P] + boff, 1);
+                        rho_bk_z[P] = C_DDOT(nlocal, phi_z[P], 1, Tp[P] + boff, 1);
+                        gamma_bbk[P] = rho_bk_x[P] * rho_bx[P];
+                        gamma_bbk[P] += rho_bk_y[P] * rho_by[P];
+                        gamma_bbk[P] += rho_ak_z[P] * rho_bz[P];
+                        gamma_bbk[P] *= 2.0;
+
+                        // Alpha-Beta
+                        gamma_abk[P] = rho_ak_x[P] * rho_bx[P] + rho_bk_x[P] * rho_ax[P];
+                        gamma_abk[P] += rho_ak_y[P] * rho_by[P] + rho_bk_y[P] * rho_ay[P];
+                        gamma_abk[P] += rho_ak_z[P] * rho_bz[P] + rho_bk_z[P] * rho_az[P];
+                    }
                 }
-            }
+                parallel_timer_off("Derivative Properties", rank);
 
-            // // => GGA contribution <= //
-            if (ansatz >= 1) {
-                double* gamma_aa = pworker->point_value("GAMMA_AA")->pointer();
-                double* gamma_ab = pworker->point_value("GAMMA_AB")->pointer();
-                double* gamma_bb = pworker->point_value("GAMMA_BB")->pointer();
-
-                double* v_gamma_aa = vals["V_GAMMA_AA"]->pointer();
-                double* v_gamma_ab = vals["V_GAMMA_AB"]->pointer();
-                double* v_gamma_bb = vals["V_GAMMA_BB"]->pointer();
-
-                double* v2_gamma_aa_gamma_aa = vals["V_GAMMA_AA_GAMMA_AA"]->pointer();
-                double* v2_gamma_aa_gamma_ab = vals["V_GAMMA_AA_GAMMA_AB"]->pointer();
-                double* v2_gamma_aa_gamma_bb = vals["V_GAMMA_AA_GAMMA_BB"]->pointer();
-                double* v2_gamma_ab_gamma_ab = vals["V_GAMMA_AB_GAMMA_AB"]->pointer();
-                double* v2_gamma_ab_gamma_bb = vals["V_GAMMA_AB_GAMMA_BB"]->pointer();
-                double* v2_gamma_bb_gamma_bb = vals["V_GAMMA_BB_GAMMA_BB"]->pointer();
-
-                double* v2_rho_a_gamma_aa = vals["V_RHO_A_GAMMA_AA"]->pointer();
-                double* v2_rho_a_gamma_ab = vals["V_RHO_A_GAMMA_AB"]->pointer();
-                double* v2_rho_a_gamma_bb = vals["V_RHO_A_GAMMA_BB"]->pointer();
-                double* v2_rho_b_gamma_aa = vals["V_RHO_B_GAMMA_AA"]->pointer();
-                double* v2_rho_b_gamma_ab = vals["V_RHO_B_GAMMA_AB"]->pointer();
-                double* v2_rho_b_gamma_bb = vals["V_RHO_B_GAMMA_BB"]->pointer();
-
-                double tmp_val = 0.0, v2_val_aa = 0.0, v2_val_ab = 0.0, v2_val_bb = 0.0;
-
-                // This one is a doozy
+                parallel_timer_on("V_XCd", rank);
+                // => LSDA contribution (symmetrized) <= //
+                double tmp_val = 0.0, tmp_ab_val = 0.0;
                 for (int P = 0; P < npoints; P++) {
-                    // V alpha contributions
+                    std::fill(Tp[P] + aoff, Tp[P] + aoff + nlocal, 0.0);
+                    std::fill(Tp[P] + boff, Tp[P] + boff + nlocal, 0.0);
+
                     if (rho_a[P] > v2_rho_cutoff_) {
-                        tmp_val = v2_rho_a_gamma_aa[P] * gamma_aak[P];
-                        tmp_val += v2_rho_a_gamma_ab[P] * gamma_abk[P];
-                        tmp_val += v2_rho_a_gamma_bb[P] * gamma_bbk[P];
-                        C_DAXPY(nlocal, (0.5 * w[P] * tmp_val), phi[P], 1, Tap[P], 1);
+                        tmp_val = v2_rho2_aa[P] * rho_ak[P];
+                        tmp_val += v2_rho2_ab[P] * rho_bk[P];
+                        tmp_val *= 0.5 * w[P];
+                        C_DAXPY(nlocal, tmp_val, phi[P], 1, Tp[P] + aoff, 1);
                     }
 
-                    // V beta contributions
                     if (rho_b[P] > v2_rho_cutoff_) {
-                        tmp_val = v2_rho_b_gamma_aa[P] * gamma_aak[P];
-                        tmp_val += v2_rho_b_gamma_ab[P] * gamma_abk[P];
-                        tmp_val += v2_rho_b_gamma_bb[P] * gamma_bbk[P];
-                        C_DAXPY(nlocal, (0.5 * w[P] * tmp_val), phi[P], 1, Tbp[P], 1);
+                        tmp_val = v2_rho2_bb[P] * rho_bk[P];
+                        tmp_val += v2_rho2_ab[P] * rho_ak[P];
+                        tmp_val *= 0.5 * w[P];
+                        C_DAXPY(nlocal, tmp_val, phi[P], 1, Tp[P] + boff, 1);
                     }
-
-                    // => Alpha W terms <= //
-                    if ((rho_a[P] < v2_rho_cutoff_) || (rho_b[P] < v2_rho_cutoff_)) continue;
-
-                    // rho_ak
-                    v2_val_aa = v2_rho_a_gamma_aa[P] * rho_ak[P];
-                    v2_val_ab = v2_rho_a_gamma_ab[P] * rho_ak[P];
-
-                    // rho_bk
-                    v2_val_aa += v2_rho_b_gamma_aa[P] * rho_bk[P];
-                    v2_val_ab += v2_rho_b_gamma_ab[P] * rho_bk[P];
-
-                    // gamma_aak
-                    v2_val_aa += v2_gamma_aa_gamma_aa[P] * gamma_aak[P];
-                    v2_val_ab += v2_gamma_aa_gamma_ab[P] * gamma_aak[P];
-
-                    // gamma_abk
-                    v2_val_aa += v2_gamma_aa_gamma_ab[P] * gamma_abk[P];
-                    v2_val_ab += v2_gamma_ab_gamma_ab[P] * gamma_abk[P];
-
-                    // gamma_bbk
-                    v2_val_aa += v2_gamma_aa_gamma_bb[P] * gamma_bbk[P];
-                    v2_val_ab += v2_gamma_ab_gamma_bb[P] * gamma_bbk[P];
-
-                    // Wx
-                    tmp_val = 2.0 * v_gamma_aa[P] * rho_ak_x[P];
-                    tmp_val += v_gamma_ab[P] * rho_bk_x[P];
-                    tmp_val += 2.0 * v2_val_aa * rho_ax[P];
-                    tmp_val += v2_val_ab * rho_bx[P];
-                    tmp_val *= w[P];
-
-                    C_DAXPY(nlocal, tmp_val, phi_x[P], 1, Tap[P], 1);
-
-                    // Wy
-                    tmp_val = 2.0 * v_gamma_aa[P] * rho_ak_y[P];
-                    tmp_val += v_gamma_ab[P] * rho_bk_y[P];
-                    tmp_val += 2.0 * v2_val_aa * rho_ay[P];
-                    tmp_val += v2_val_ab * rho_by[P];
-                    tmp_val *= w[P];
-
-                    C_DAXPY(nlocal, tmp_val, phi_y[P], 1, Tap[P], 1);
-
-                    // Wz
-                    tmp_val = 2.0 * v_gamma_aa[P] * rho_ak_z[P];
-                    tmp_val += v_gamma_ab[P] * rho_bk_z[P];
-                    tmp_val += 2.0 * v2_val_aa * rho_az[P];
-                    tmp_val += v2_val_ab * rho_bz[P];
-                    tmp_val *= w[P];
-
-                    C_DAXPY(nlocal, tmp_val, phi_z[P], 1, Tap[P], 1);
-
-                    // => Beta W terms <= //
-
-                    // rho_ak
-                    v2_val_bb = v2_rho_a_gamma_bb[P] * rho_ak[P];
-                    v2_val_ab = v2_rho_a_gamma_ab[P] * rho_ak[P];
-
-                    // rho_bk
-                    v2_val_bb += v2_rho_b_gamma_bb[P] * rho_bk[P];
-                    v2_val_ab += v2_rho_b_gamma_ab[P] * rho_bk[P];
-
-                    // gamma_bbk
-                    v2_val_bb += v2_gamma_bb_gamma_bb[P] * gamma_bbk[P];
-                    v2_val_ab += v2_gamma_ab_gamma_bb[P] * gamma_bbk[P];
-
-                    // gamma_abk
-                    v2_val_bb += v2_gamma_ab_gamma_bb[P] * gamma_abk[P];
-                    v2_val_ab += v2_gamma_ab_gamma_ab[P] * gamma_abk[P];
-
-                    // gamma_aak
-                    v2_val_bb += v2_gamma_aa_gamma_bb[P] * gamma_aak[P];
-                    v2_val_ab += v2_gamma_aa_gamma_ab[P] * gamma_aak[P];
-
-                    // Wx
-                    tmp_val = 2.0 * v_gamma_bb[P] * rho_bk_x[P];
-                    tmp_val += v_gamma_ab[P] * rho_ak_x[P];
-                    tmp_val += 2.0 * v2_val_bb * rho_bx[P];
-                    tmp_val += v2_val_ab * rho_ax[P];
-                    tmp_val *= w[P];
-
-                    C_DAXPY(nlocal, tmp_val, phi_x[P], 1, Tbp[P], 1);
-
-                    // Wy
-                    tmp_val = 2.0 * v_gamma_bb[P] * rho_bk_y[P];
-                    tmp_val += v_gamma_ab[P] * rho_ak_y[P];
-                    tmp_val += 2.0 * v2_val_bb * rho_by[P];
-                    tmp_val += v2_val_ab * rho_ay[P];
-                    tmp_val *= w[P];
-
-                    C_DAXPY(nlocal, tmp_val, phi_y[P], 1, Tbp[P], 1);
-
-                    // Wz
-                    tmp_val = 2.0 * v_gamma_bb[P] * rho_bk_z[P];
-                    tmp_val += v_gamma_ab[P] * rho_ak_z[P];
-                    tmp_val += 2.0 * v2_val_bb * rho_bz[P];
-                    tmp_val += v2_val_ab * rho_az[P];
-                    tmp_val *= w[P];
-
-                    C_DAXPY(nlocal, tmp_val, phi_z[P], 1, Tbp[P], 1);
                 }
-            }
 
-            // Put it all together
-            C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, phi[0], coll_funcs, Tap[0], max_functions, 0.0,
-                    Vax_localp[0], max_functions);
-            C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, phi[0], coll_funcs, Tbp[0], max_functions, 0.0,
-                    Vbx_localp[0], max_functions);
-
-            // Symmetrization (V is *always* Hermitian)
-            for (int m = 0; m < nlocal; m++) {
-                for (int n = 0; n <= m; n++) {
-                    Vax_localp[m][n] = Vax_localp[n][m] = Vax_localp[m][n] + Vax_localp[n][m];
-                    Vbx_localp[m][n] = Vbx_localp[n][m] = Vbx_localp[m][n] + Vbx_localp[n][m];
+                // // => GGA contribution <= //
+                if (ansatz >= 1) {
+                    double* gamma_aa = pworker->point_value("GAMMA_AA")->pointer();
+                    double* gamma_ab = pworker->point_value("GAMMA_AB")->pointer();
+                    double* gamma_bb = pworker->point_value("GAMMA_BB")->pointer();
+
+                    double* v_gamma_aa = vals["V_GAMMA_AA"]->pointer();
+                    double* v_gamma_ab = vals["V_GAMMA_AB"]->pointer();
+                    double* v_gamma_bb = vals["V_GAMMA_BB"]->pointer();
+
+                    double* v2_gamma_aa_gamma_aa = vals["V_GAMMA_AA_GAMMA_AA"]->pointer();
+                    double* v2_gamma_aa_gamma_ab = vals["V_GAMMA_AA_GAMMA_AB"]->pointer();
+                    double* v2_gamma_aa_gamma_bb = vals["V_GAMMA_AA_GAMMA_BB"]->pointer();
+                    double* v2_gamma_ab_gamma_ab = vals["V_GAMMA_AB_GAMMA_AB"]->pointer();
+                    double* v2_gamma_ab_gamma_bb = vals["V_GAMMA_AB_GAMMA_BB"]->pointer();
+                    double* v2_gamma_bb_gamma_bb = vals["V_GAMMA_BB_GAMMA_BB"]->pointer();
+
+                    double* v2_rho_a_gamma_aa = vals["V_RHO_A_GAMMA_AA"]->pointer();
+                    double* v2_rho_a_gamma_ab = vals["V_RHO_A_GAMMA_AB"]->pointer();
+                    double* v2_rho_a_gamma_bb = vals["V_RHO_A_GAMMA_BB"]->pointer();
+                    double* v2_rho_b_gamma_aa = vals["V_RHO_B_GAMMA_AA"]->pointer();
+                    double* v2_rho_b_gamma_ab = vals["V_RHO_B_GAMMA_AB"]->pointer();
+                    double* v2_rho_b_gamma_bb = vals["V_RHO_B_GAMMA_BB"]->pointer();
+
+                    double tmp_val = 0.0, v2_val_aa = 0.0, v2_val_ab = 0.0, v2_val_bb = 0.0;
+
+                    // This one is a doozy
+                    for (int P = 0; P < npoints; P++) {
+                        // V alpha contributions
+                        if (rho_a[P] > v2_rho_cutoff_) {
+                            tmp_val = v2_rho_a_gamma_aa[P] * gamma_aak[P];
+                            tmp_val += v2_rho_a_gamma_ab[P] * gamma_abk[P];
+                            tmp_val += v2_rho_a_gamma_bb[P] * gamma_bbk[P];
+                            C_DAXPY(nlocal, (0.5 * w[P] * tmp_val), phi[P], 1, Tp[P] + aoff, 1);
+                        }
+
+                        // V beta contributions
+                        if (rho_b[P] > v2_rho_cutoff_) {
+                            tmp_val = v2_rho_b_gamma_aa[P] * gamma_aak[P];
+                            tmp_val += v2_rho_b_gamma_ab[P] * gamma_abk[P];
+                            tmp_val += v2_rho_b_gamma_bb[P] * gamma_bbk[P];
+                            C_DAXPY(nlocal, (0.5 * w[P] * tmp_val), phi[P], 1, Tp[P] + boff, 1);
+                        }
+
+                        // => Alpha W terms <= //
+                        if ((rho_a[P] < v2_rho_cutoff_) || (rho_b[P] < v2_rho_cutoff_)) continue;
+
+                        // rho_ak
+                        v2_val_aa = v2_rho_a_gamma_aa[P] * rho_ak[P];
+                        v2_val_ab = v2_rho_a_gamma_ab[P] * rho_ak[P];
+
+                        // rho_bk
+                        v2_val_aa += v2_rho_b_gamma_aa[P] * rho_bk[P];
+                        v2_val_ab += v2_rho_b_gamma_ab[P] * rho_bk[P];
+
+                        // gamma_aak
+                        v2_val_aa += v2_gamma_aa_gamma_aa[P] * gamma_aak[P];
+                        v2_val_ab += v2_gamma_aa_gamma_ab[P] * gamma_aak[P];
+
+                        // gamma_abk
+                        v2_val_aa += v2_gamma_aa_gamma_ab[P] * gamma_abk[P];
+                        v2_val_ab += v2_gamma_ab_gamma_ab[P] * gamma_abk[P];
+
+                        // gamma_bbk
+                        v2_val_aa += v2_gamma_aa_gamma_bb[P] * gamma_bbk[P];
+                        v2_val_ab += v2_gamma_ab_gamma_bb[P] * gamma_bbk[P];
+
+                        // Wx
+                        tmp_val = 2.0 * v_gamma_aa[P] * rho_ak_x[P];
+                        tmp_val += v_gamma_ab[P] * rho_bk_x[P];
+                        tmp_val += 2.0 * v2_val_aa * rho_ax[P];
+                        tmp_val += v2_val_ab * rho_bx[P];
+                        tmp_val *= w[P];
+
+                        C_DAXPY(nlocal, tmp_val, phi_x[P], 1, Tp[P] + aoff, 1);
+
+                        // Wy
+                        tmp_val = 2.0 * v_gamma_aa[P] * rho_ak_y[P];
+                        tmp_val += v_gamma_ab[P] * rho_bk_y[P];
+                        tmp_val += 2.0 * v2_val_aa * rho_ay[P];
+                        tmp_val += v2_val_ab * rho_by[P];
+                        tmp_val *= w[P];
+
+                        C_DAXPY(nlocal, tmp_val, phi_y[P], 1, Tp[P] + aoff, 1);
+
+                        // Wz
+                        tmp_val = 2.0 * v_gamma_aa[P] * rho_ak_z[P];
+                        tmp_val += v_gamma_ab[P] * rho_bk_z[P];
+                        tmp_val += 2.0 * v2_val_aa * rho_az[P];
+                        tmp_val += v2_val_ab * rho_bz[P];
+                        tmp_val *= w[P];
+
+                        C_DAXPY(nlocal, tmp_val, phi_z[P], 1, Tp[P] + aoff, 1);
+
+                        // => Beta W terms <= //
+
+                        // rho_ak
+                        v2_val_bb = v2_rho_a_gamma_bb[P] * rho_ak[P];
+                        v2_val_ab = v2_rho_a_gamma_ab[P] * rho_ak[P];
+
+                        // rho_bk
+                        v2_val_bb += v2_rho_b_gamma_bb[P] * rho_bk[P];
+                        v2_val_ab += v2_rho_b_gamma_ab[P] * rho_bk[P];
+
+                        // gamma_bbk
+                        v2_val_bb += v2_gamma_bb_gamma_bb[P] * gamma_bbk[P];
+                        v2_val_ab += v2_gamma_ab_gamma_bb[P] * gamma_bbk[P];
+
+                        // gamma_abk
+                        v2_val_bb += v2_gamma_ab_gamma_bb[P] * gamma_abk[P];
+                        v2_val_ab += v2_gamma_ab_gamma_ab[P] * gamma_abk[P];
+
+                        // gamma_aak
+                        v2_val_bb += v2_gamma_aa_gamma_bb[P] * gamma_aak[P];
+                        v2_val_ab += v2_gamma_aa_gamma_ab[P] * gamma_aak[P];
+
+                        // Wx
+                        tmp_val = 2.0 * v_gamma_bb[P] * rho_bk_x[P];
+                        tmp_val += v_gamma_ab[P] * rho_ak_x[P];
+                        tmp_val += 2.0 * v2_val_bb * rho_bx[P];
+                        tmp_val += v2_val_ab * rho_ax[P];
+                        tmp_val *= w[P];
+
+                        C_DAXPY(nlocal, tmp_val, phi_x[P], 1, Tp[P] + boff, 1);
+
+                        // Wy
+                        tmp_val = 2.0 * v_gamma_bb[P] * rho_bk_y[P];
+                        tmp_val += v_gamma_ab[P] * rho_ak_y[P];
+                        tmp_val += 2.0 * v2_val_bb * rho_by[P];
+                        tmp_val += v2_val_ab * rho_ay[P];
+                        tmp_val *= w[P];
+
+                        C_DAXPY(nlocal, tmp_val, phi_y[P], 1, Tp[P] + boff, 1);
+
+                        // Wz
+                        tmp_val = 2.0 * v_gamma_bb[P] * rho_bk_z[P];
+                        tmp_val += v_gamma_ab[P] * rho_ak_z[P];
+                        tmp_val += 2.0 * v2_val_bb * rho_bz[P];
+                        tmp_val += v2_val_ab * rho_az[P];
+                        tmp_val *= w[P];
+
+                        C_DAXPY(nlocal, tmp_val, phi_z[P], 1, Tp[P] + boff, 1);
+                    }
                 }
-            }
-            // R_Vax_local[rank]->print();
-            // R_Vbx_local[rank]->print();
-
-            // => Unpacking <= //
-            double** Vaxp = Vax_AO[dindex]->pointer();
-            double** Vbxp = Vbx_AO[dindex]->pointer();
-            for (int ml = 0; ml < nlocal; ml++) {
-                int mg = function_map[ml];
-                for (int nl = 0; nl < ml; nl++) {
-                    int ng = function_map[nl];
 
-#pragma omp atomic update
-                    Vaxp[mg][ng] += Vax_localp[ml][nl];
-#pragma omp atomic update
-                    Vaxp[ng][mg] += Vax_localp[ml][nl];
+                parallel_timer_off("V_XCd", rank);
+            }
 
+            // Put it all together, one GEMM for the batch
+            parallel_timer_on("V_XCd", rank);
+            C_DGEMM('T', 'N', nlocal, ncols, npoints, 1.0, phi[0], coll_funcs, Tp[0], batch_cols, 0.0, Vx_localp[0],
+                    batch_cols);
+
+            for (size_t k = 0; k < nD; k++) {
+                const size_t aoff = 2 * k * nlocal;
+                const size_t boff = aoff + nlocal;
+
+                // => Unpacking <= //
+                // Symmetrized (V is *always* Hermitian) into the lower triangle, mirrored after the block loop
+                double** Vaxp = Vax_AO[dstart + k]->pointer();
+                double** Vbxp = Vbx_AO[dstart + k]->pointer();
+                for (int ml = 0; ml < nlocal; ml++) {
+                    int mg = function_map[ml];
+                    for (int nl = 0; nl <= ml; nl++) {
+                        int ng = function_map[nl];
+                        double Vaval = Vx_localp[ml][aoff + nl] + Vx_localp[nl][aoff + ml];
+                        double Vbval = Vx_localp[ml][boff + nl] + Vx_localp[nl][boff + ml];
 #pragma omp atomic update
-                    Vbxp[mg][ng] += Vbx_localp[ml][nl];
+                        Vaxp[mg][ng] += Vaval;
 #pragma omp atomic update
-                    Vbxp[ng][mg] += Vbx_localp[ml][nl];
+                        Vbxp[mg][ng] += Vbval;
+                    }
                 }
-#pragma omp atomic update
-                Vaxp[mg][mg] += Vax_localp[ml][ml];
-#pragma omp atomic update
-                Vbxp[mg][mg] += Vbx_localp[ml][ml];
             }
             parallel_timer_off("V_XCd", rank);
         }
     }
 
+    for (size_t i = 0; i < npair; i++) {
+        double** Vaxp = Vax_AO[i]->pointer();
+        double** Vbxp = Vbx_AO[i]->pointer();
+        for (int m = 0; m < nbf_; m++) {
+            for (int n = 0; n < m; n++) {
+                Vaxp[n][m] = Vaxp[m][n];
+                Vbxp[n][m] = Vbxp[m][n];
+            }
+        }
+    }
+
     // Set the result
-    for (size_t i = 0; i < (Dx.size() / 2); i++) {
+    for (size_t i = 0; i < npair; i++) {
         if (Dx[i]->nirrep() != 1) {
             ret[2 * i]->apply_symmetry(Vax_AO[i], AO2USO_);
             ret[2 * i + 1]->apply_symmetry(Vbx_AO[i], AO2USO_);
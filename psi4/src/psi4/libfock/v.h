@@ -40,6 +40,7 @@ class BasisSet;
 class Options;
 class DFTGrid;
 class PointFunctions;
+class CollocationDiskCache;
 class SuperFunctional;
 class BlockOPoints;
 
@@ -66,6 +67,18 @@ class PSI_API VBase {
     double v2_rho_cutoff_;
     /// VV10 interior kernel threshold
     double vv10_rho_cutoff_;
+    /// Drop basis functions below this on a block during the RKS V build
+    double block_screening_tolerance_;
+    /// Number of response densities contracted together per block in compute_Vx
+    int vx_batch_size_;
+    /// Coalesce small blocks into batches of up to this many points for the functional evaluation
+    int xc_batch_points_;
+    /// Split the VV10 grid into spatial cells and screen the nonlocal kernel?
+    bool vv10_screening_;
+    /// Cells further than this (bohr) from a block are lumped into a single point
+    double vv10_lump_radius_;
+    /// Cells further than this (bohr) from a block are neglected
+    double vv10_cutoff_radius_;
     /// Options object, used to build grid
     Options& options_;
     /// Basis set used in the integration
@@ -83,6 +96,12 @@ class PSI_API VBase {
     // Caches collocation grids
     std::unordered_map<size_t, std::map<std::string, SharedMatrix>> cache_map_;
     int cache_map_deriv_;
+    // Blocks of the collocation cache that did not fit in memory
+    std::shared_ptr<CollocationDiskCache> disk_cache_;
+    // Spill the blocks that do not fit in memory to disk?
+    bool collocation_disk_;
+    // Store the spilled blocks as floats?
+    bool collocation_disk_single_;
 
     /// AO2USO matrix (if not C1)
     SharedMatrix AO2USO_;
@@ -101,6 +120,23 @@ class PSI_API VBase {
     double vv10_nlc(SharedMatrix D, SharedMatrix ret);
     SharedMatrix vv10_nlc_gradient(SharedMatrix D);
 
+    /// Grid blocks sorted by decreasing estimated cost, for largest-first dynamic dispatch
+    std::vector<size_t> block_order_;
+    /// Estimate the per-block cost (npoints x local functions^2) and fill block_order_ and xc_group_offsets_
+    void build_block_order();
+    /// Groups of consecutive block_order_ entries whose functional is evaluated in one batch.
+    /// Group g is block_order_[xc_group_offsets_[g]] ... block_order_[xc_group_offsets_[g + 1] - 1]
+    std::vector<size_t> xc_group_offsets_;
+    /// Most points and most blocks in any group
+    size_t xc_group_max_points_;
+    size_t xc_group_max_blocks_;
+    /// Per thread functional workers sized for a whole group, and the gathered group inputs
+    std::vector<std::shared_ptr<SuperFunctional>> xc_batch_functional_workers_;
+    std::vector<std::map<std::string, SharedVector>> xc_batch_inputs_;
+    /// Report how evenly the blocks were spread over the threads
+    void print_thread_balance(const std::string& label, const std::vector<double>& thread_time,
+                              const std::vector<size_t>& thread_blocks) const;
+
     /// Set things up
     void common_init();
 
@@ -122,7 +158,7 @@ class PSI_API VBase {
 
     // Creates a collocation cache map based on stride
     void build_collocation_cache(size_t memory);
-    void clear_collocation_cache() { cache_map_.clear(); }
+    void clear_collocation_cache();
 
     // Set the D matrix, get it back if needed
     void set_D(std::vector<SharedMatrix> Dvec);
@@ -68,6 +68,9 @@ class LibXCFunctional : public Functional {
     // User defined tweakers
     std::vector<double> user_tweakers_;
 
+    // Scratch for compute_functional, reused across calls
+    std::vector<double> scratch_;
+
    public:
     LibXCFunctional(std::string xc_name, bool unpolarized);
     ~LibXCFunctional() override;
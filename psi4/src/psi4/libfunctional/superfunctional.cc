@@ -37,6 +37,7 @@
 #include "functional.h"
 #include "LibXCfunctional.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 
@@ -612,9 +613,10 @@ std::map<std::string, SharedVector>& SuperFunctional::compute_functional(
     const std::map<std::string, SharedVector>& vals, int npoints) {
     npoints = (npoints == -1 ? vals.find("RHO_A")->second->dimpi()[0] : npoints);
 
-    // Zero out values
-    for (auto kv : values_) {
-        kv.second->zero();
+    // Zero out the values in use, by reference so that the map entries are not copied on every call
+    for (auto& kv : values_) {
+        double* valp = kv.second->pointer();
+        std::fill(valp, valp + npoints, 0.0);
     }
 
     for (int i = 0; i < x_functionals_.size(); i++) {
@@ -810,7 +812,8 @@ std::map<std::string, SharedVector> SuperFunctional::compute_vv10_cache(const st
 }
 double SuperFunctional::compute_vv10_kernel(const std::map<std::string, SharedVector>& vals,
                                             const std::vector<std::map<std::string, SharedVector>>& vv10_cache,
-                                            std::shared_ptr<BlockOPoints> block, int npoints, bool do_grad) {
+                                            std::shared_ptr<BlockOPoints> block, int npoints, bool do_grad,
+                                            double lump_radius, double cutoff_radius) {
     // Kernel between left (*this) and right (vv10_cache) grids
 
     // Compute the vv10 cache in place
@@ -842,6 +845,102 @@ double SuperFunctional::compute_vv10_kernel(const std::map<std::string, SharedVe
     const double* l_W0 = vv_values_["W0"]->pointer();
     const double* l_kappa = vv_values_["KAPPA"]->pointer();
 
+    // => Right points <= //
+    // The weight and density only ever appear as a product, lumped cells carry their total w * rho in W
+    // and a unit density
+    struct RightPoints {
+        const double* x;
+        const double* y;
+        const double* z;
+        const double* w;
+        const double* rho;
+        const double* W0;
+        const double* kappa;
+        size_t npoints;
+    };
+    std::vector<RightPoints> r_blocks;
+    std::vector<double> lump_x, lump_y, lump_z, lump_w, lump_W0, lump_kappa;
+
+    const Vector3& l_center = block->center();
+    const double l_radius = block->radius();
+    // A group is lumped once it is as far away, relative to its size, as a lumped cell (groups are four cells across)
+    const double group_lump_radius = 4.0 * lump_radius;
+    for (size_t ind = 0; ind < vv10_cache.size(); ind++) {
+        const auto& r_block = vv10_cache[ind];
+
+        auto group = r_block.find("GROUP");
+        if ((group != r_block.end()) && (lump_radius > 0.0 || cutoff_radius > 0.0)) {
+            // Group is [x, y, z, radius, sum w * rho, <W0>, <kappa>, ncells], its cells follow contiguously
+            const double* groupp = group->second->pointer();
+            const double g_x = l_center[0] - groupp[0];
+            const double g_y = l_center[1] - groupp[1];
+            const double g_z = l_center[2] - groupp[2];
+            const double dist = std::sqrt(g_x * g_x + g_y * g_y + g_z * g_z) - l_radius - groupp[3];
+            const size_t ncells = (size_t)groupp[7];
+
+            if (cutoff_radius > 0.0 && dist > cutoff_radius) {
+                ind += ncells - 1;
+                continue;
+            }
+            if (lump_radius > 0.0 && dist > group_lump_radius) {
+                lump_x.push_back(groupp[0]);
+                lump_y.push_back(groupp[1]);
+                lump_z.push_back(groupp[2]);
+                lump_w.push_back(groupp[4]);
+                lump_W0.push_back(groupp[5]);
+                lump_kappa.push_back(groupp[6]);
+                ind += ncells - 1;
+                continue;
+            }
+        }
+
+        auto cell = r_block.find("CELL");
+        if ((cell != r_block.end()) && (lump_radius > 0.0 || cutoff_radius > 0.0)) {
+            // Cell is [x, y, z, radius, sum w * rho, <W0>, <kappa>]
+            const double* cellp = cell->second->pointer();
+            const double c_x = l_center[0] - cellp[0];
+            const double c_y = l_center[1] - cellp[1];
+            const double c_z = l_center[2] - cellp[2];
+            const double dist = std::sqrt(c_x * c_x + c_y * c_y + c_z * c_z) - l_radius - cellp[3];
+
+            if (cutoff_radius > 0.0 && dist > cutoff_radius) continue;
+            if (lump_radius > 0.0 && dist > lump_radius) {
+                lump_x.push_back(cellp[0]);
+                lump_y.push_back(cellp[1]);
+                lump_z.push_back(cellp[2]);
+                lump_w.push_back(cellp[4]);
+                lump_W0.push_back(cellp[5]);
+                lump_kappa.push_back(cellp[6]);
+                continue;
+            }
+        }
+
+        RightPoints r_points;
+        r_points.x = r_block.find("X")->second->pointer();
+        r_points.y = r_block.find("Y")->second->pointer();
+        r_points.z = r_block.find("Z")->second->pointer();
+        r_points.w = r_block.find("W")->second->pointer();
+        r_points.rho = r_block.find("RHO")->second->pointer();
+        r_points.W0 = r_block.find("W0")->second->pointer();
+        r_points.kappa = r_block.find("KAPPA")->second->pointer();
+        r_points.npoints = r_block.find("KAPPA")->second->dimpi()[0];
+        r_blocks.push_back(r_points);
+    }
+
+    std::vector<double> lump_rho(lump_w.size(), 1.0);
+    if (lump_w.size()) {
+        RightPoints r_points;
+        r_points.x = lump_x.data();
+        r_points.y = lump_y.data();
+        r_points.z = lump_z.data();
+        r_points.w = lump_w.data();
+        r_points.rho = lump_rho.data();
+        r_points.W0 = lump_W0.data();
+        r_points.kappa = lump_kappa.data();
+        r_points.npoints = lump_w.size();
+        r_blocks.push_back(r_points);
+    }
+
     for (size_t i = 0; i < l_npoints; i++) {
         // Add Phi agnostic quantities
         vv10_e += l_w[i] * l_rho[i] * vv10_beta;
@@ -857,17 +956,17 @@ double SuperFunctional::compute_vv10_kernel(const std::map<std::string, SharedVe
         double xc = 0.0;
         double yc = 0.0;
         double zc = 0.0;
-        for (auto r_block : vv10_cache) {
+        for (const auto& r_block : r_blocks) {
             // Get right points
-            const double* r_x = r_block["X"]->pointer();
-            const double* r_y = r_block["Y"]->pointer();
-            const double* r_z = r_block["Z"]->pointer();
-            const double* r_w = r_block["W"]->pointer();
-            const double* r_rho = r_block["RHO"]->pointer();
-            const double* r_W0 = r_block["W0"]->pointer();
-            const double* r_kappa = r_block["KAPPA"]->pointer();
-
-            const size_t r_npoints = r_block["KAPPA"]->dimpi()[0];
+            const double* r_x = r_block.x;
+            const double* r_y = r_block.y;
+            const double* r_z = r_block.z;
+            const double* r_w = r_block.w;
+            const double* r_rho = r_block.rho;
+            const double* r_W0 = r_block.W0;
+            const double* r_kappa = r_block.kappa;
+
+            const size_t r_npoints = r_block.npoints;
 
             // Interior Kernel
             if (do_grad) {
@@ -140,9 +140,13 @@ class SuperFunctional {
                                                            int npoints = -1, bool internal = false);
 
     // Copmutes the Cache data for VV10 dispersion
+    // If the cache is split into cells (see VBase::prepare_vv10_cache), cells further than lump_radius from the
+    // block are replaced by a single pseudo-point and cells further than cutoff_radius are skipped entirely.
+    // Groups of neighbouring cells are tested first, so distant groups are lumped or skipped as a whole.
     double compute_vv10_kernel(const std::map<std::string, SharedVector>& vals,
                                const std::vector<std::map<std::string, SharedVector>>& vv10_cache,
-                               std::shared_ptr<BlockOPoints> block, int npoints = -1, bool do_grad = false);
+                               std::shared_ptr<BlockOPoints> block, int npoints = -1, bool do_grad = false,
+                               double lump_radius = 0.0, double cutoff_radius = 0.0);
 
     // => Input/Output <= //
 
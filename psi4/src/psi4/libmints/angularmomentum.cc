@@ -62,6 +62,10 @@ AngularMomentumInt::AngularMomentumInt(std::vector<SphericalTransform>& spherica
 
 AngularMomentumInt::~AngularMomentumInt() { delete[] buffer_; }
 
+OneBodyAOInt *AngularMomentumInt::clone() const {
+    return clone_settings(new AngularMomentumInt(spherical_transforms_, bs1_, bs2_, deriv_));
+}
+
 // The engine only supports segmented basis sets
 void AngularMomentumInt::compute_pair(const GaussianShell& s1, const GaussianShell& s2) {
     int ao12;
@@ -64,6 +64,9 @@ class AngularMomentumInt : public OneBodyAOInt {
     //! Virtual destructor
     ~AngularMomentumInt() override;
 
+    bool cloneable() const override { return true; }
+    OneBodyAOInt* clone() const override;
+
     //! Does the method provide first derivatives?
     bool has_deriv1() override { return true; }
 };
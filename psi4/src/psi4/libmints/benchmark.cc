@@ -30,6 +30,7 @@
 #include "psi4/libmints/molecule.h"
 #include "psi4/libmints/integral.h"
 #include "psi4/libmints/3coverlap.h"
+#include "psi4/libmints/fjt.h"
 
 #include "psi4/libqt/qt.h"
 #include "psi4/libciomr/libciomr.h"
@@ -39,6 +40,7 @@
 #include "psi4/libpsi4util/libpsi4util.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 
+#include <algorithm>
 #include <map>
 #include <string>
 #include <cmath>
@@ -2223,6 +2225,91 @@ void benchmark_math(double min_time) {
     }
     outfile->Printf("\n");
 }
+void benchmark_boys(int max_J, double min_time) {
+    double T;
+    size_t rounds;
+    Timer* qq;
+
+    // Arguments spanning the interpolation and asymptotic regions
+    const size_t npoint = 4096;
+    const double max_T = 60.0;
+    std::vector<double> Ts(npoint);
+    for (size_t i = 0; i < npoint; i++) Ts[i] = max_T * (i + 0.5) / npoint;
+
+    Taylor_Fjt fjt(max_J, 1.0E-15);
+    std::vector<double> batch((max_J + 1) * npoint);
+
+    outfile->Printf("\n");
+    outfile->Printf("                              ------------------------------ \n");
+    outfile->Printf("                              ======> BOYS BENCHMARKS <===== \n");
+    outfile->Printf("                              ------------------------------ \n");
+    outfile->Printf("\n");
+
+    outfile->Printf("  Parameters:\n");
+    outfile->Printf("   -Maximum order J: %d.\n", max_J);
+    outfile->Printf("   -Minimum runtime (per order, per method): %14.10f [s].\n", min_time);
+    outfile->Printf("   -%zu arguments T evenly spread over (0, %.1f).\n", npoint, max_T);
+    outfile->Printf("\n");
+
+    outfile->Printf("  Notes:\n");
+    outfile->Printf("   -Errors are the largest absolute deviation of F_0 ... F_J from the series\n");
+    outfile->Printf("        exp(-T) sum_k (2T)^k / ((2j + 1)(2j + 3)...(2j + 2k + 1)), summed in long double.\n");
+    outfile->Printf("   -Timings are reported per argument T, each producing J + 1 values.\n");
+    outfile->Printf("\n");
+
+    outfile->Printf("  %2s %11s %11s %11s %11s %9s\n", "J", "Err Scalar", "Err Batch", "T Scalar", "T Batch",
+                    "Speedup");
+    for (int J = 0; J <= max_J; J++) {
+        // Accuracy
+        double scalar_error = 0.0;
+        double batch_error = 0.0;
+        fjt.values(J, Ts.data(), npoint, batch.data());
+        for (size_t i = 0; i < npoint; i++) {
+            double* F = fjt.values(J, Ts[i]);
+            for (int j = 0; j <= J; j++) {
+                long double x = Ts[i];
+                long double term = 1.0L / (2 * j + 1);
+                long double sum = term;
+                for (int k = 1; term > 1.0E-22L * sum; k++) {
+                    term *= 2.0L * x / (2 * j + 2 * k + 1);
+                    sum += term;
+                }
+                double ref = (double)(std::exp(-x) * sum);
+                scalar_error = std::max(scalar_error, std::fabs(F[j] - ref));
+                batch_error = std::max(batch_error, std::fabs(batch[j * npoint + i] - ref));
+            }
+        }
+
+        // One argument at a time
+        T = 0.0;
+        rounds = 0L;
+        qq = new Timer();
+        while (T < min_time) {
+            for (size_t i = 0; i < npoint; i++) fjt.values(J, Ts[i]);
+            T = qq->get();
+            rounds++;
+        }
+        delete qq;
+        double t_scalar = T / (double)(rounds * npoint);
+
+        // Batched
+        T = 0.0;
+        rounds = 0L;
+        qq = new Timer();
+        while (T < min_time) {
+            fjt.values(J, Ts.data(), npoint, batch.data());
+            T = qq->get();
+            rounds++;
+        }
+        delete qq;
+        double t_batch = T / (double)(rounds * npoint);
+
+        outfile->Printf("  %2d %11.3E %11.3E %11.3E %11.3E %9.2f\n", J, scalar_error, batch_error, t_scalar, t_batch,
+                        t_scalar / t_batch);
+    }
+    outfile->Printf("\n");
+}
+
 void benchmark_integrals(int max_am, double min_time) {
     double T;
     size_t rounds;
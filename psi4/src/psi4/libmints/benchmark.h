@@ -81,6 +81,14 @@ void benchmark_integrals(int max_am, double min_time);
  * \param min_time minimum amount of time to run each routine [s]
  **/
 void benchmark_math(double min_time);
+/**
+ * Perform a benchmark of the Boys function engine (Taylor_Fjt)
+ * on the current hardware, one argument at a time and batched
+ * Accuracy is checked against the defining series in long double
+ * \param max_J maximum order to consider
+ * \param min_time minimum time to run each order [s]
+ **/
+void benchmark_boys(int max_J, double min_time);
 
 }  // namespace psi
 
@@ -64,6 +64,10 @@ DipoleInt::DipoleInt(std::vector<SphericalTransform> &spherical_transforms, std:
 
 DipoleInt::~DipoleInt() { delete[] buffer_; }
 
+OneBodyAOInt *DipoleInt::clone() const {
+    return clone_settings(new DipoleInt(spherical_transforms_, bs1_, bs2_, deriv_));
+}
+
 SharedVector DipoleInt::nuclear_contribution(std::shared_ptr<Molecule> mol, const Vector3 &origin) {
     auto sret = std::make_shared<Vector>(3);
     double *ret = sret->pointer();
@@ -60,6 +60,9 @@ class DipoleInt : public OneBodyAOInt {
     //! Virtual destructor
     ~DipoleInt() override;
 
+    bool cloneable() const override { return true; }
+    OneBodyAOInt* clone() const override;
+
     //! Does the method provide first derivatives?
     bool has_deriv1() override { return true; }
 
@@ -655,6 +655,8 @@ ECPInt::ECPInt(std::vector<SphericalTransform> &st, std::shared_ptr<BasisSet> bs
 
 ECPInt::~ECPInt() { delete[] buffer_; }
 
+OneBodyAOInt *ECPInt::clone() const { return clone_settings(new ECPInt(spherical_transforms_, bs1_, bs2_, deriv_)); }
+
 double ECPInt::calcC(int a, int m, double A) const {
     double value = 1.0 - 2 * ((a - m) % 2);
     value *= pow(A, a - m);
@@ -356,6 +356,9 @@ class ECPInt : public OneBodyAOInt {
      */
     ECPInt(std::vector<SphericalTransform> &, std::shared_ptr<BasisSet>, std::shared_ptr<BasisSet>, int deriv = 0);
     ~ECPInt() override;
+
+    bool cloneable() const override { return true; }
+    OneBodyAOInt* clone() const override;
 };
 
 class ECPSOInt : public OneBodySOInt {
@@ -62,6 +62,10 @@ ElectricFieldInt::ElectricFieldInt(std::vector<SphericalTransform>& spherical_tr
 
 ElectricFieldInt::~ElectricFieldInt() { delete[] buffer_; }
 
+OneBodyAOInt *ElectricFieldInt::clone() const {
+    return clone_settings(new ElectricFieldInt(spherical_transforms_, bs1_, bs2_, deriv_));
+}
+
 Vector3 ElectricFieldInt::nuclear_contribution(const Vector3& origin, std::shared_ptr<Molecule> mol) {
     int natom = mol->natom();
 
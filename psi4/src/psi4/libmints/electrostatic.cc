@@ -47,6 +47,11 @@ ElectrostaticInt::ElectrostaticInt(std::vector<SphericalTransform>& st, std::sha
 
 ElectrostaticInt::~ElectrostaticInt() {}
 
+OneBodyAOInt* ElectrostaticInt::clone() const {
+    auto* clone = new ElectrostaticInt(spherical_transforms_, bs1_, bs2_, deriv_);
+    return clone_settings(clone);
+}
+
 void ElectrostaticInt::compute(SharedMatrix& result, const Vector3& C) {
     // Do not worry about zeroing out result
     int ns1 = bs1_->nshell();
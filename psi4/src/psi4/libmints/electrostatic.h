@@ -71,6 +71,9 @@ class ElectrostaticInt : public PotentialInt {
     /// Does the method provide first derivatives?
     bool has_deriv1() override { return false; }
 
+    /// Clones must stay ElectrostaticInt, PotentialInt::clone would return the base class
+    OneBodyAOInt* clone() const override;
+
     static SharedVector nuclear_contribution(std::shared_ptr<Molecule> mol);
 };
 
@@ -32,6 +32,7 @@
 #include <libint/libint.h>
 #include <libderiv/libderiv.h>
 #include "psi4/libmints/twobody.h"
+#include "psi4/libmints/shellpaircache.h"
 
 namespace psi {
 
@@ -42,31 +43,6 @@ class Fjt;
 class AOShellCombinationsIterator;
 class CorrelationFactor;
 
-/**
- * \ingroup MINTS
- * Structure to hold precomputed shell pair information
- */
-typedef struct ShellPair_typ {
-    //! Shells for this information.
-    int i, j;
-    //! Matrix over primitives with x, y, z coordinate of average Gaussian
-    double*** P;
-    //! Distance between shell i and shell j centers
-    double AB[3];
-    //! Distance between P and shell i center
-    double*** PA;
-    //! Distance between P and shell j center
-    double*** PB;
-    //! Array of alphas for both centers
-    double *ai, *aj;
-    //! Array of the gammas (ai + aj)
-    double** gamma;
-    //! Contraction coefficients
-    double *ci, *cj;
-    //! Overlap between primitives on i and j
-    double** overlap;
-} ShellPair;
-
 /*! \ingroup MINTS
  *  \class ERI
  *  \brief Capable of computing two-electron repulsion integrals.
@@ -83,6 +59,8 @@ class TwoElectronInt : public TwoBodyAOInt {
 
     //! Computes the fundamental
     Fjt* fjt_;
+    //! Arguments and values of the fundamental for a batch of primitive quartets
+    std::vector<double> fjt_batch_;
 
     //! Computes the ERIs between four shells.
     size_t compute_quartet(int, int, int, int);
@@ -93,25 +71,16 @@ class TwoElectronInt : public TwoBodyAOInt {
     //! Computes the ERI second derivative between four shells.
     size_t compute_quartet_deriv2(int, int, int, int);
 
-    //! Form shell pair information. Must be smart enough to handle arbitrary basis sets
-    void init_shell_pairs12();
-    void init_shell_pairs34();
-
-    //! Free shell pair information
-    void free_shell_pairs12();
-    void free_shell_pairs34();
-
-    //! Should we use shell pair information?
+    //! Should we use the cached primitive pair data of the factory?
     bool use_shell_pairs_;
 
-    //! Stack memory pointer, used in init_shell_pairs, freed in destructor
-    double *stack12_, *stack34_;
-
-    //! Shell pair information
-    ShellPair **pairs12_, **pairs34_;
+    //! Primitive pair data of the bra (basis1, basis2) and ket (basis3, basis4) shell pairs
+    std::shared_ptr<ShellPairCache> pairs12_, pairs34_;
 
-    //! Evaluates how much memory (in doubles) is needed to store shell pair data
-    size_t memory_to_store_shell_pairs(const std::shared_ptr<BasisSet>&, const std::shared_ptr<BasisSet>&);
+    //! Primitive pairs of shells sh1 of bs1_ and sh2 of bs2_, from whichever of pairs12_ and pairs34_ holds them
+    const ShellPairCache::PrimitivePair* primitive_pairs(const std::shared_ptr<BasisSet>& bs1,
+                                                        const std::shared_ptr<BasisSet>& bs2, int sh1, int sh2,
+                                                        int& npair, bool& swapped) const;
 
     //! Original shell index requested
     int osh1_, osh2_, osh3_, osh4_;
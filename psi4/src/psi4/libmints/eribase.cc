@@ -37,6 +37,8 @@
 #include "psi4/libmints/wavefunction.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 
+#include <algorithm>
+#include <cmath>
 #include <stdexcept>
 #include <string>
 
@@ -1646,137 +1648,133 @@ static void handle_reordering12(PermutedOrder permutation, Libderiv_t &libderiv_
 }
 
 /**
- * @brief Fills the primitive data structure used by libint/libderiv with information from the ShellPairs
+ * @brief Fills the primitive data structure used by libint/libderiv with information from the cached primitive pairs
  * @param PrimQuartet The structure to hold the data.
  * @param fjt Object used to compute the fundamental integrals.
- * @param p12 ShellPair data structure for the left
- * @param p34 ShellPair data structure for the right
+ * @param fjt_batch Scratch for the batched evaluation of the fundamental integrals, grown as needed.
+ * @param p12 Primitive pairs of the bra, sorted by decreasing bound
+ * @param npair12 Number of primitive pairs of the bra
+ * @param swap12 Are the bra pairs stored with their two shells exchanged?
+ * @param p34 Primitive pairs of the ket, sorted by decreasing bound
+ * @param npair34 Number of primitive pairs of the ket
+ * @param swap34 Are the ket pairs stored with their two shells exchanged?
+ * @param cutoff Primitive quartets whose prefactor bound, including the derivative factors, is below this are skipped
  * @param am Total angular momentum of this quartet
- * @param nprim1 Number of primitives on center 1
- * @param nprim2 Number of primitives on center 2
- * @param nprim3 Number of primitives on center 3
- * @param nprim4 Number of primitives on center 4
- * @param sh1eqsh2 Is the shell on center 1 identical to that on center 2?
- * @param sh3eqsh4 Is the shell on center 3 identical to that on center 4?
  * @param deriv_lvl Derivitive level of the integral
  * @return The total number of primitive combinations found. This is passed to libint/libderiv.
  */
-static size_t fill_primitive_data(prim_data *PrimQuartet, Fjt *fjt, const ShellPair *p12, const ShellPair *p34, int am,
-                                  int nprim1, int nprim2, int nprim3, int nprim4, bool sh1eqsh2, bool sh3eqsh4,
-                                  int deriv_lvl) {
-    double zeta, eta, ooze, rho, poz, coef1, PQx, PQy, PQz, PQ2, Wx, Wy, Wz, o12, o34, T, *F;
-    double a1, a2, a3, a4;
-    int p1, p2, p3, p4, i;
+static size_t fill_primitive_data(prim_data *PrimQuartet, Fjt *fjt, std::vector<double> &fjt_batch,
+                                  const ShellPairCache::PrimitivePair *p12, int npair12, bool swap12,
+                                  const ShellPairCache::PrimitivePair *p34, int npair34, bool swap34, double cutoff,
+                                  int am, int deriv_lvl) {
+    double zeta, eta, ooze, rho, poz, coef1, PQx, PQy, PQz, PQ2, Wx, Wy, Wz, o12, o34;
+    int i;
     size_t nprim = 0L;
-    double *pai = p12->ai;
-    double *pgamma12 = p12->gamma[0];
-    double *poverlap12 = p12->overlap[0];
-    for (p1 = 0; p1 < nprim1; ++p1) {
-        a1 = *pai;
-        ++pai;
-        double *paj = p12->aj;
-        for (p2 = 0; p2 < nprim2; ++p2) {
-            a2 = *paj;
-            zeta = *pgamma12;
-            o12 = *poverlap12;
-            ++paj;
-            ++pgamma12;
-            ++poverlap12;
-            double PAx = p12->PA[p1][p2][0];
-            double PAy = p12->PA[p1][p2][1];
-            double PAz = p12->PA[p1][p2][2];
-            double PBx = p12->PB[p1][p2][0];
-            double PBy = p12->PB[p1][p2][1];
-            double PBz = p12->PB[p1][p2][2];
-            double PABx = p12->P[p1][p2][0];
-            double PABy = p12->P[p1][p2][1];
-            double PABz = p12->P[p1][p2][2];
-
-            double *pak = p34->ai;
-            double *pgamma34 = p34->gamma[0];
-            double *poverlap34 = p34->overlap[0];
-            for (p3 = 0; p3 < nprim3; ++p3) {
-                a3 = *pak;
-                ++pak;
-                double *pal = p34->aj;
-                for (p4 = 0; p4 < nprim4; ++p4) {
-                    a4 = *pal;
-                    eta = *pgamma34;
-                    o34 = *poverlap34;
-                    ++pal;
-                    ++pgamma34;
-                    ++poverlap34;
-
-                    double PCx = p34->PA[p3][p4][0];
-                    double PCy = p34->PA[p3][p4][1];
-                    double PCz = p34->PA[p3][p4][2];
-                    double PDx = p34->PB[p3][p4][0];
-                    double PDy = p34->PB[p3][p4][1];
-                    double PDz = p34->PB[p3][p4][2];
-                    double PCDx = p34->P[p3][p4][0];
-                    double PCDy = p34->P[p3][p4][1];
-                    double PCDz = p34->P[p3][p4][2];
-
-                    ooze = 1.0 / (zeta + eta);
-                    poz = eta * ooze;
-                    rho = zeta * poz;
-                    coef1 = 2.0 * sqrt(rho * M_1_PI) * o12 * o34;
-
-                    PrimQuartet[nprim].poz = poz;
-                    PrimQuartet[nprim].oo2zn = 0.5 * ooze;
-                    PrimQuartet[nprim].pon = zeta * ooze;
-                    PrimQuartet[nprim].oo2z = 0.5 / zeta;
-                    PrimQuartet[nprim].oo2n = 0.5 / eta;
-                    PrimQuartet[nprim].twozeta_a = 2.0 * a1;
-                    PrimQuartet[nprim].twozeta_b = 2.0 * a2;
-                    PrimQuartet[nprim].twozeta_c = 2.0 * a3;
-                    PrimQuartet[nprim].twozeta_d = 2.0 * a4;
-
-                    PQx = PABx - PCDx;
-                    PQy = PABy - PCDy;
-                    PQz = PABz - PCDz;
-                    PQ2 = PQx * PQx + PQy * PQy + PQz * PQz;
-
-                    Wx = (PABx * zeta + PCDx * eta) * ooze;
-                    Wy = (PABy * zeta + PCDy * eta) * ooze;
-                    Wz = (PABz * zeta + PCDz * eta) * ooze;
-
-                    // PA
-                    PrimQuartet[nprim].U[0][0] = PAx;
-                    PrimQuartet[nprim].U[0][1] = PAy;
-                    PrimQuartet[nprim].U[0][2] = PAz;
-                    // PB
-                    PrimQuartet[nprim].U[1][0] = PBx;
-                    PrimQuartet[nprim].U[1][1] = PBy;
-                    PrimQuartet[nprim].U[1][2] = PBz;
-                    // QC
-                    PrimQuartet[nprim].U[2][0] = PCx;
-                    PrimQuartet[nprim].U[2][1] = PCy;
-                    PrimQuartet[nprim].U[2][2] = PCz;
-                    // QD
-                    PrimQuartet[nprim].U[3][0] = PDx;
-                    PrimQuartet[nprim].U[3][1] = PDy;
-                    PrimQuartet[nprim].U[3][2] = PDz;
-                    // WP
-                    PrimQuartet[nprim].U[4][0] = Wx - PABx;
-                    PrimQuartet[nprim].U[4][1] = Wy - PABy;
-                    PrimQuartet[nprim].U[4][2] = Wz - PABz;
-                    // WQ
-                    PrimQuartet[nprim].U[5][0] = Wx - PCDx;
-                    PrimQuartet[nprim].U[5][1] = Wy - PCDy;
-                    PrimQuartet[nprim].U[5][2] = Wz - PCDz;
-
-                    T = rho * PQ2;
-                    fjt->set_rho(rho);
-                    F = fjt->values(am + deriv_lvl, T);
-
-                    for (i = 0; i <= am + deriv_lvl; ++i) PrimQuartet[nprim].F[i] = F[i] * coef1;
-
-                    nprim++;
-                }
+
+    // The Boys functions of all primitive quartets are evaluated together once the arguments are known
+    const int J = am + deriv_lvl;
+    const size_t max_nprim = (size_t)npair12 * npair34;
+    if (fjt_batch.size() < (J + 4) * max_nprim) fjt_batch.resize((J + 4) * max_nprim);
+    double *Tvals = fjt_batch.data();
+    double *rhovals = Tvals + max_nprim;
+    double *coefvals = rhovals + max_nprim;
+    double *Fvals = coefvals + max_nprim;
+
+    // The quartet prefactor 2 sqrt(rho / pi) K_ab K_cd is at most sqrt(2 / pi) bound_ab bound_cd, and each
+    // derivative brings down at most a factor 2 alpha of the differentiated primitive
+    auto deriv_factor = [deriv_lvl](const ShellPairCache::PrimitivePair &pair) {
+        return std::pow(std::max(1.0, 2.0 * std::max(pair.ai, pair.aj)), deriv_lvl);
+    };
+    double dmax12 = 1.0, dmax34 = 1.0;
+    if (deriv_lvl) {
+        for (int p = 0; p < npair12; ++p) dmax12 = std::max(dmax12, deriv_factor(p12[p]));
+        for (int q = 0; q < npair34; ++q) dmax34 = std::max(dmax34, deriv_factor(p34[q]));
+    }
+    const double scaled_cutoff = cutoff / std::sqrt(2.0 * M_1_PI);
+
+    for (int p = 0; p < npair12; ++p) {
+        const ShellPairCache::PrimitivePair &bra = p12[p];
+        // Both lists are sorted by bound, so nothing further can survive; the first quartet is always kept
+        if (nprim && bra.bound * dmax12 * p34[0].bound * dmax34 < scaled_cutoff) break;
+        const double b12 = deriv_lvl ? bra.bound * deriv_factor(bra) : bra.bound;
+        o12 = bra.K;
+
+        double a1 = swap12 ? bra.aj : bra.ai;
+        double a2 = swap12 ? bra.ai : bra.aj;
+        const double *PA = swap12 ? bra.PB : bra.PA;
+        const double *PB = swap12 ? bra.PA : bra.PB;
+        const double *PAB = bra.P;
+        zeta = bra.gamma;
+
+        for (int q = 0; q < npair34; ++q) {
+            const ShellPairCache::PrimitivePair &ket = p34[q];
+            if (nprim && b12 * ket.bound * dmax34 < scaled_cutoff) break;
+            if (nprim && deriv_lvl && b12 * ket.bound * deriv_factor(ket) < scaled_cutoff) continue;
+            o34 = ket.K;
+
+            double a3 = swap34 ? ket.aj : ket.ai;
+            double a4 = swap34 ? ket.ai : ket.aj;
+            const double *PC = swap34 ? ket.PB : ket.PA;
+            const double *PD = swap34 ? ket.PA : ket.PB;
+            const double *PCD = ket.P;
+            eta = ket.gamma;
+
+            ooze = 1.0 / (zeta + eta);
+            poz = eta * ooze;
+            rho = zeta * poz;
+            coef1 = 2.0 * sqrt(rho * M_1_PI) * o12 * o34;
+
+            PrimQuartet[nprim].poz = poz;
+            PrimQuartet[nprim].oo2zn = 0.5 * ooze;
+            PrimQuartet[nprim].pon = zeta * ooze;
+            PrimQuartet[nprim].oo2z = 0.5 / zeta;
+            PrimQuartet[nprim].oo2n = 0.5 / eta;
+            PrimQuartet[nprim].twozeta_a = 2.0 * a1;
+            PrimQuartet[nprim].twozeta_b = 2.0 * a2;
+            PrimQuartet[nprim].twozeta_c = 2.0 * a3;
+            PrimQuartet[nprim].twozeta_d = 2.0 * a4;
+
+            PQx = PAB[0] - PCD[0];
+            PQy = PAB[1] - PCD[1];
+            PQz = PAB[2] - PCD[2];
+            PQ2 = PQx * PQx + PQy * PQy + PQz * PQz;
+
+            Wx = (PAB[0] * zeta + PCD[0] * eta) * ooze;
+            Wy = (PAB[1] * zeta + PCD[1] * eta) * ooze;
+            Wz = (PAB[2] * zeta + PCD[2] * eta) * ooze;
+
+            for (i = 0; i < 3; ++i) {
+                // PA
+                PrimQuartet[nprim].U[0][i] = PA[i];
+                // PB
+                PrimQuartet[nprim].U[1][i] = PB[i];
+                // QC
+                PrimQuartet[nprim].U[2][i] = PC[i];
+                // QD
+                PrimQuartet[nprim].U[3][i] = PD[i];
             }
+            // WP
+            PrimQuartet[nprim].U[4][0] = Wx - PAB[0];
+            PrimQuartet[nprim].U[4][1] = Wy - PAB[1];
+            PrimQuartet[nprim].U[4][2] = Wz - PAB[2];
+            // WQ
+            PrimQuartet[nprim].U[5][0] = Wx - PCD[0];
+            PrimQuartet[nprim].U[5][1] = Wy - PCD[1];
+            PrimQuartet[nprim].U[5][2] = Wz - PCD[2];
+
+            Tvals[nprim] = rho * PQ2;
+            rhovals[nprim] = rho;
+            coefvals[nprim] = coef1;
+
+            nprim++;
         }
     }
+
+    fjt->values(J, Tvals, nprim, Fvals, rhovals);
+    for (i = 0; i <= J; ++i) {
+        const double *Fi = Fvals + i * nprim;
+        for (size_t p = 0; p < nprim; ++p) PrimQuartet[p].F[i] = Fi[p] * coefvals[p];
+    }
     return nprim;
 }
 
@@ -1876,16 +1874,10 @@ TwoElectronInt::TwoElectronInt(const IntegralFactory *integral, int deriv, bool
     }
     memset(source_, 0, sizeof(double) * size);
 
-    if (basis1() != basis2() || basis1() != basis3() || basis2() != basis4()) {
-        use_shell_pairs_ = false;
-    }
-
     if (use_shell_pairs_) {
-        // Precompute a bunch of information
-        init_shell_pairs12();
-        // If basis3 and basis4 equals basis1 and basis2, then the following function will do nothing,
-        // except assign pairs34_ to pairs12_
-        init_shell_pairs34();
+        // Built once by the factory and shared with every other integral object it creates
+        pairs12_ = integral->shell_pairs(basis1(), basis2());
+        pairs34_ = integral->shell_pairs(basis3(), basis4());
     }
 
     // form the blocking. We use the default
@@ -1898,305 +1890,14 @@ TwoElectronInt::~TwoElectronInt() {
     delete[] source_full_;
     free_libint(&libint_);
     if (deriv_) free_libderiv(&libderiv_);
-    free_shell_pairs12();
-    free_shell_pairs34();  // This shouldn't do anything, but this might change in the future
-}
-
-void TwoElectronInt::init_shell_pairs12() {
-    ShellPair *sp;
-    Vector3 P, PA, PB, AB, A, B;
-    int i, j, si, sj, np_i, np_j;
-    size_t memd;
-    double a1, a2, ab2, gam, c1, c2;
-    double *curr_stack_ptr;
-
-    // Estimate memory needed by allocated space for the dynamically allocated parts of ShellPair structure
-    memd = TwoElectronInt::memory_to_store_shell_pairs(basis1(), basis2());
-
-    // Allocate a stack of memory
-    stack12_ = new double[memd];
-    curr_stack_ptr = stack12_;
-
-    // Allocate shell pair memory
-    pairs12_ = new ShellPair *[basis1()->nshell()];
-    for (i = 0; i < basis1()->nshell(); ++i) pairs12_[i] = new ShellPair[basis2()->nshell()];
-
-    // Loop over all shell pairs (si, sj) and create primitive pairs pairs
-    for (si = 0; si < basis1()->nshell(); ++si) {
-        A = basis1()->shell(si).center();
-
-        for (sj = 0; sj < basis2()->nshell(); ++sj) {
-            B = basis2()->shell(sj).center();
-
-            AB = A - B;
-            ab2 = AB.dot(AB);
-
-            // Get the pointer for convenience
-            sp = &(pairs12_[si][sj]);
-
-            // Save some information
-            sp->i = si;
-            sp->j = sj;
-            sp->AB[0] = AB[0];
-            sp->AB[1] = AB[1];
-            sp->AB[2] = AB[2];
-
-            np_i = basis1()->shell(si).nprimitive();
-            np_j = basis2()->shell(sj).nprimitive();
-
-            // Reserve some memory for the primitives
-            sp->ai = curr_stack_ptr;
-            curr_stack_ptr += np_i;
-            sp->aj = curr_stack_ptr;
-            curr_stack_ptr += np_j;
-
-            // Allocate and reserve memory for gammas
-            sp->gamma = new double *[np_i];
-            for (i = 0; i < np_i; ++i) {
-                sp->gamma[i] = curr_stack_ptr;
-                curr_stack_ptr += np_j;
-            }
-
-            // Reserve space for contraction coefficients
-            sp->ci = curr_stack_ptr;
-            curr_stack_ptr += np_i;
-            sp->cj = curr_stack_ptr;
-            curr_stack_ptr += np_j;
-
-            // Allocate and reserve space for overlaps
-            sp->overlap = new double *[np_i];
-            for (i = 0; i < np_i; ++i) {
-                sp->overlap[i] = curr_stack_ptr;
-                curr_stack_ptr += np_j;
-            }
-
-            // Allocate and reserve space for P, PA, and PB.
-            sp->P = new double **[np_i];
-            sp->PA = new double **[np_i];
-            sp->PB = new double **[np_i];
-            for (i = 0; i < np_i; ++i) {
-                sp->P[i] = new double *[np_j];
-                sp->PA[i] = new double *[np_j];
-                sp->PB[i] = new double *[np_j];
-
-                for (j = 0; j < np_j; ++j) {
-                    sp->P[i][j] = curr_stack_ptr;
-                    curr_stack_ptr += 3;
-                    sp->PA[i][j] = curr_stack_ptr;
-                    curr_stack_ptr += 3;
-                    sp->PB[i][j] = curr_stack_ptr;
-                    curr_stack_ptr += 3;
-                }
-            }
-
-            // All memory has been reserved/allocated for this shell primitive pair pair.
-            // Pre-compute all data that we can:
-            for (i = 0; i < np_i; ++i) {
-                a1 = basis1()->shell(si).exp(i);
-                c1 = basis1()->shell(si).coef(i);
-
-                // Save some information
-                sp->ai[i] = a1;
-                sp->ci[i] = c1;
-
-                for (j = 0; j < np_j; ++j) {
-                    a2 = basis2()->shell(sj).exp(j);
-                    c2 = basis2()->shell(sj).coef(j);
-
-                    gam = a1 + a2;
-
-                    // Compute Gaussian product and component distances
-                    P = (A * a1 + B * a2) / gam;
-                    PA = P - A;
-                    PB = P - B;
-
-                    // Copy data into pairs array
-                    sp->aj[j] = a2;
-                    sp->cj[j] = c2;
-                    sp->gamma[i][j] = gam;
-                    sp->P[i][j][0] = P[0];
-                    sp->P[i][j][1] = P[1];
-                    sp->P[i][j][2] = P[2];
-                    sp->PA[i][j][0] = PA[0];
-                    sp->PA[i][j][1] = PA[1];
-                    sp->PA[i][j][2] = PA[2];
-                    sp->PB[i][j][0] = PB[0];
-                    sp->PB[i][j][1] = PB[1];
-                    sp->PB[i][j][2] = PB[2];
-                    sp->overlap[i][j] = pow(M_PI / gam, 3.0 / 2.0) * exp(-a1 * a2 * ab2 / gam) * c1 * c2;
-                }
-            }
-        }
-    }
 }
 
-void TwoElectronInt::init_shell_pairs34() {
-    // If basis1 == basis3 && basis2 == basis4, then we don't need to do anything except use the pointer
-    // of pairs12_.
-    if (use_shell_pairs_ == true) {
-        // This assumes init_shell_pairs12 was called and precomputed the values.
-        pairs34_ = pairs12_;
-        stack34_ = nullptr;
-        return;
-    }
-#if 0
-                                                                                                                            outfile->Printf( "  Pre-computing additional values for two-electron integrals. [ |34) does not equal (12| ]\n");
-
-    // Estimate memory needed by allocated space for the dynamically allocated parts of ShellPair structure
-    memd = ERIBase::memory_to_store_shell_pairs(basis3(), basis4());
-
-    // Allocate a stack of memory
-    stack34_ = new double[memd];
-    curr_stack_ptr = stack34_;
-
-    // Allocate shell pair memory
-    pairs34_ = new ShellPair*[basis3()->nprimitive()];
-    for (i=0; i<basis3()->nprimitive(); ++i)
-        pairs34_[i] = new ShellPair[basis4()->nprimitive()];
-
-    // Loop over all shell pairs (si, sj) and create primitive pairs pairs
-    for (si=0; si<basis3()->nprimitive(); ++si) {
-        A = basis3()->shell(si).center();
-
-        for (sj=0; sj<basis4()->nprimitive(); ++sj) {
-            B = basis4()->shell(sj).center();
-
-            AB = A - B;
-            ab2 = AB.dot(AB);
-
-            // Get the pointer for convenience
-            sp = &(pairs34_[si][sj]);
-
-            // Save some information
-            sp->i = si;
-            sp->j = sj;
-            sp->AB[0] = AB[0]; sp->AB[1] = AB[1]; sp->AB[2] = AB[2];
-
-            np_i = basis3()->shell(si).nprimitive();
-            np_j = basis4()->shell(sj).nprimitive();
-
-            // Reserve some memory for the primitives
-            sp->ai = curr_stack_ptr; curr_stack_ptr += np_i;
-            sp->aj = curr_stack_ptr; curr_stack_ptr += np_j;
-
-            // Allocate and reserve memory for gammas
-            sp->gamma = new double*[np_i];
-            for (i=0; i<np_i; ++i) {
-                sp->gamma[i] = curr_stack_ptr; curr_stack_ptr += np_j;
-            }
-
-            // Reserve space for contraction coefficients
-            sp->ci = curr_stack_ptr; curr_stack_ptr += np_i;
-            sp->cj = curr_stack_ptr; curr_stack_ptr += np_j;
-
-            // Allocate and reserve space for overlaps
-            sp->overlap = new double*[np_i];
-            for (i=0; i<np_i; ++i) {
-                sp->overlap[i] = curr_stack_ptr; curr_stack_ptr += np_j;
-            }
-
-            // Allocate and reserve space for P, PA, and PB.
-            sp->P  = new double**[np_i];
-            sp->PA = new double**[np_i];
-            sp->PB = new double**[np_i];
-            for (i=0; i<np_i; ++i) {
-                sp->P[i]  = new double*[np_j];
-                sp->PA[i] = new double*[np_j];
-                sp->PB[i] = new double*[np_j];
-
-                for (j=0; j<np_j; ++j) {
-                    sp->P[i][j]  = curr_stack_ptr; curr_stack_ptr += 3;
-                    sp->PA[i][j] = curr_stack_ptr; curr_stack_ptr += 3;
-                    sp->PB[i][j] = curr_stack_ptr; curr_stack_ptr += 3;
-                }
-            }
-
-            // All memory has been reserved/allocated for this shell primitive pair pair.
-            // Pre-compute all data that we can:
-            for (i=0; i<np_i; ++i) {
-                a1 = basis3()->shell(si)->exp(i);
-                c1 = basis3()->shell(si)->coef(i);
-
-                // Save some information
-                sp->ai[i] = a1;
-                sp->ci[i] = c1;
-
-                for (j=0; j<np_j; ++j) {
-                    a2 = basis4()->shell(sj)->exp(j);
-                    c2 = basis4()->shell(sj)->coef(j);
-
-                    gam = a1 + a2;
-
-                    // Compute some distances
-                    P = ( A * a1 + B * a2 ) / gam;
-                    PA = P - A;
-                    PB = P - B;
-
-                    // Copy data into pairs array
-                    sp->aj[j] = a2;
-                    sp->cj[j] = c2;
-                    sp->gamma[i][j] = gam;
-                    sp->P[i][j][0]  = P[0];  sp->P[i][j][1]  = P[1];  sp->P[i][j][2]  = P[2];
-                    sp->PA[i][j][0] = PA[0]; sp->PA[i][j][1] = PA[1]; sp->PA[i][j][2] = PA[2];
-                    sp->PB[i][j][0] = PB[0]; sp->PB[i][j][1] = PB[1]; sp->PB[i][j][2] = PB[2];
-                    sp->overlap[i][j] = pow(M_PI/gam, 3.0/2.0) * exp(-a1*a2*ab2/gam) * c1 * c2;
-                }
-            }
-        }
-    }
-#endif
-}
-
-void TwoElectronInt::free_shell_pairs12() {
-    int i, si, sj;
-    ShellPair *sp;
-    int np_i;
-
-    if (!use_shell_pairs_) return;
-
-    delete[] stack12_;
-    for (si = 0; si < basis1()->nshell(); ++si) {
-        for (sj = 0; sj < basis2()->nshell(); ++sj) {
-            np_i = basis1()->shell(si).nprimitive();
-            sp = &(pairs12_[si][sj]);
-
-            delete[] sp->gamma;
-            delete[] sp->overlap;
-
-            if (sp->P != nullptr) {
-                for (i = 0; i < np_i; ++i) delete[] sp->P[i];
-                delete[] sp->P;
-            }
-            if (sp->PA != nullptr) {
-                for (i = 0; i < np_i; ++i) delete[] sp->PA[i];
-                delete[] sp->PA;
-            }
-            if (sp->PB != nullptr) {
-                for (i = 0; i < np_i; ++i) delete[] sp->PB[i];
-                delete[] sp->PB;
-            }
-        }
-    }
-
-    for (si = 0; si < basis1()->nshell(); ++si) delete[] pairs12_[si];
-    delete[] pairs12_;
-}
-
-void TwoElectronInt::free_shell_pairs34() {}
-
-size_t TwoElectronInt::memory_to_store_shell_pairs(const std::shared_ptr<BasisSet> &bs1,
-                                                   const std::shared_ptr<BasisSet> &bs2) {
-    int i, j, np_i, np_j;
-    size_t mem = 0;
-
-    for (i = 0; i < bs1->nshell(); ++i) {
-        np_i = bs1->shell(i).nprimitive();
-        for (j = 0; j < bs2->nshell(); ++j) {
-            np_j = bs2->shell(j).nprimitive();
-            mem += (2 * (np_i + np_j) + 11 * np_i * np_j);
-        }
-    }
-    return mem;
+const ShellPairCache::PrimitivePair *TwoElectronInt::primitive_pairs(const std::shared_ptr<BasisSet> &bs1,
+                                                                     const std::shared_ptr<BasisSet> &bs2, int sh1,
+                                                                     int sh2, int &npair, bool &swapped) const {
+    // After the libint reordering, the bra may hold the shells of either original pair, in either order
+    const auto &pairs = pairs12_->covers(bs1, bs2) ? pairs12_ : pairs34_;
+    return pairs->pairs(bs1, bs2, sh1, sh2, npair, swapped);
 }
 
 size_t TwoElectronInt::compute_shell(const AOShellCombinationsIterator &shellIter) {
@@ -2423,13 +2124,13 @@ size_t TwoElectronInt::compute_quartet(int sh1, int sh2, int sh3, int sh4) {
 
     // If we can, use the precomputed values found in ShellPair.
     if (use_shell_pairs_) {
-        ShellPair *p12, *p34;
-        // 1234 -> 1234 no change
-        p12 = &(pairs12_[sh1][sh2]);
-        p34 = &(pairs34_[sh3][sh4]);
+        int npair12, npair34;
+        bool swap12, swap34;
+        const ShellPairCache::PrimitivePair *p12 = primitive_pairs(bs1_, bs2_, sh1, sh2, npair12, swap12);
+        const ShellPairCache::PrimitivePair *p34 = primitive_pairs(bs3_, bs4_, sh3, sh4, npair34, swap34);
 
-        nprim = fill_primitive_data(libint_.PrimQuartet, fjt_, p12, p34, am, nprim1, nprim2, nprim3, nprim4, sh1 == sh2,
-                                    sh3 == sh4, 0);
+        nprim = fill_primitive_data(libint_.PrimQuartet, fjt_, fjt_batch_, p12, npair12, swap12, p34, npair34, swap34,
+                                    pairs12_->threshold(), am, 0);
     } else {
         const double *a1s = s1.exps();
         const double *a2s = s2.exps();
@@ -2440,7 +2141,7 @@ size_t TwoElectronInt::compute_quartet(int sh1, int sh2, int sh3, int sh4) {
         const double *c3s = s3.coefs();
         const double *c4s = s4.coefs();
 
-        // Old version - without ShellPair - STILL USED BY RI CODES
+        // Computed on the fly, without the shared primitive pair data
         for (int p1 = 0; p1 < nprim1; ++p1) {
             double a1 = a1s[p1];
             double c1 = c1s[p1];
@@ -2787,12 +2488,13 @@ size_t TwoElectronInt::compute_quartet_deriv1(int sh1, int sh2, int sh3, int sh4
     nprim = 0;
 
     if (use_shell_pairs_) {
-        ShellPair *p12, *p34;
-        p12 = &(pairs12_[sh1][sh2]);
-        p34 = &(pairs34_[sh3][sh4]);
+        int npair12, npair34;
+        bool swap12, swap34;
+        const ShellPairCache::PrimitivePair *p12 = primitive_pairs(bs1_, bs2_, sh1, sh2, npair12, swap12);
+        const ShellPairCache::PrimitivePair *p34 = primitive_pairs(bs3_, bs4_, sh3, sh4, npair34, swap34);
 
-        nprim = fill_primitive_data(libderiv_.PrimQuartet, fjt_, p12, p34, am, nprim1, nprim2, nprim3, nprim4,
-                                    sh1 == sh2, sh3 == sh4, 1);
+        nprim = fill_primitive_data(libderiv_.PrimQuartet, fjt_, fjt_batch_, p12, npair12, swap12, p34, npair34, swap34,
+                                    pairs12_->threshold(), am, 1);
     } else {
         for (int p1 = 0; p1 < nprim1; ++p1) {
             double a1 = s1.exp(p1);
@@ -3128,12 +2830,13 @@ size_t TwoElectronInt::compute_quartet_deriv2(int sh1, int sh2, int sh3, int sh4
 
     // prepare all the data needed for libderiv
     if (use_shell_pairs_) {
-        ShellPair *p12, *p34;
-        p12 = &(pairs12_[sh1][sh2]);
-        p34 = &(pairs34_[sh3][sh4]);
+        int npair12, npair34;
+        bool swap12, swap34;
+        const ShellPairCache::PrimitivePair *p12 = primitive_pairs(bs1_, bs2_, sh1, sh2, npair12, swap12);
+        const ShellPairCache::PrimitivePair *p34 = primitive_pairs(bs3_, bs4_, sh3, sh4, npair34, swap34);
 
-        nprim = fill_primitive_data(libderiv_.PrimQuartet, fjt_, p12, p34, am, nprim1, nprim2, nprim3, nprim4,
-                                    sh1 == sh2, sh3 == sh4, 2);
+        nprim = fill_primitive_data(libderiv_.PrimQuartet, fjt_, fjt_batch_, p12, npair12, swap12, p34, npair34, swap34,
+                                    pairs12_->threshold(), am, 2);
     } else {
         for (int p1 = 0; p1 < nprim1; ++p1) {
             double a1 = s1.exp(p1);
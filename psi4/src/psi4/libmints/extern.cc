@@ -32,12 +32,17 @@
 #include "psi4/libmints/matrix.h"
 #include "psi4/libmints/integral.h"
 #include "psi4/libmints/potential.h"
+#include "psi4/libmints/vector3.h"
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/libqt/qt.h"
 #include "psi4/physconst.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/process.h"
 
+#include <array>
+#include <cmath>
+#include <map>
+
 #ifdef _OPENMP
 #include <omp.h>
 #endif
@@ -92,16 +97,9 @@ void ExternalPotential::print(std::string out) const {
     }
 }
 
-SharedMatrix ExternalPotential::computePotentialMatrix(std::shared_ptr<BasisSet> basis) {
-    int n = basis->nbf();
-    auto V = std::make_shared<Matrix>("External Potential", n, n);
-    auto fact = std::make_shared<IntegralFactory>(basis, basis, basis, basis);
-
+SharedMatrix ExternalPotential::charge_field(std::shared_ptr<Molecule> mol) const {
     double convfac = 1.0;
-    if (basis->molecule()->units() == Molecule::Angstrom) convfac /= pc_bohr2angstroms;
-
-    // Monopoles
-    auto V_charge = std::make_shared<Matrix>("External Potential (Charges)", n, n);
+    if (mol->units() == Molecule::Angstrom) convfac /= pc_bohr2angstroms;
 
     auto Zxyz = std::make_shared<Matrix>("Charges (Z,x,y,z)", charges_.size(), 4);
     double **Zxyzp = Zxyz->pointer();
@@ -111,14 +109,445 @@ SharedMatrix ExternalPotential::computePotentialMatrix(std::shared_ptr<BasisSet>
         Zxyzp[i][2] = convfac * std::get<2>(charges_[i]);
         Zxyzp[i][3] = convfac * std::get<3>(charges_[i]);
     }
+    return Zxyz;
+}
+
+namespace {
+
+// Edge length [bohr] of the cubic boxes that shell pairs and external charges are binned into
+const double box_edge = 4.0;
+// Primitive pairs whose overlap prefactor falls below this are dropped
+const double pair_cutoff = 1.0e-14;
+// Charge distributions are considered to have vanished where their Gaussian falls below this
+const double extent_cutoff = 1.0e-10;
+
+typedef std::array<long, 3> BoxIndex;
+
+BoxIndex box_index(const Vector3 &r) {
+    return BoxIndex{{(long)std::floor(r[0] / box_edge), (long)std::floor(r[1] / box_edge),
+                     (long)std::floor(r[2] / box_edge)}};
+}
+
+Vector3 box_center(const BoxIndex &index) {
+    return Vector3((index[0] + 0.5) * box_edge, (index[1] + 0.5) * box_edge, (index[2] + 0.5) * box_edge);
+}
+
+/// A cell of external charges, with its multipole moments about the cell center
+struct ChargeCell {
+    Vector3 center;
+    /// Largest distance of a member charge from the center
+    double radius = 0.0;
+    std::vector<size_t> charges;
+    /// sum_s q_s (-d_s)^{abc} / (a! b! c!), stored as [(a * (order + 1) + b) * (order + 1) + c]
+    std::vector<double> moments;
+};
+
+/// A box of significant shell pairs that share one Taylor expansion of the far-field potential
+struct PairBox {
+    Vector3 center;
+    /// Radius outside of which the charge distributions of all pairs in the box are negligible
+    double radius = 0.0;
+    /// Shell pairs (M >= N)
+    std::vector<std::pair<int, int> > pairs;
+    /// Charges integrated exactly, as (Z,x,y,z)
+    SharedMatrix near;
+    /// Taylor coefficients of the far-field potential about center: the constant term first, then the
+    /// components in MultipoleInt order
+    std::vector<double> taylor;
+};
+
+/*
+ * Derivatives d^{t+u+v} / dX^t dY^u dZ^v of 1 / |R| for all t + u + v <= L, from the point-charge limit of the
+ * McMurchie-Davidson recursion. Results are stored as [(t * (L + 1) + u) * (L + 1) + v].
+ */
+void coulomb_derivatives(int L, const Vector3 &R, std::vector<double> &work, std::vector<double> &out) {
+    const int dim = L + 1;
+    work.assign((size_t)dim * dim * dim * dim, 0.0);
+    out.assign((size_t)dim * dim * dim, 0.0);
+    auto W = [&work, dim](int n, int t, int u, int v) -> double & { return work[((n * dim + t) * dim + u) * dim + v]; };
+
+    double r2 = R.dot(R);
+    W(0, 0, 0, 0) = 1.0 / std::sqrt(r2);
+    for (int n = 1; n <= L; ++n) W(n, 0, 0, 0) = -(2 * n - 1) / r2 * W(n - 1, 0, 0, 0);
+
+    for (int N = 1; N <= L; ++N) {
+        for (int t = 0; t <= N; ++t) {
+            for (int u = 0; u <= N - t; ++u) {
+                int v = N - t - u;
+                for (int n = 0; n <= L - N; ++n) {
+                    double &val = W(n, t, u, v);
+                    if (t) {
+                        val = R[0] * W(n + 1, t - 1, u, v) + (t > 1 ? (t - 1) * W(n + 1, t - 2, u, v) : 0.0);
+                    } else if (u) {
+                        val = R[1] * W(n + 1, t, u - 1, v) + (u > 1 ? (u - 1) * W(n + 1, t, u - 2, v) : 0.0);
+                    } else {
+                        val = R[2] * W(n + 1, t, u, v - 1) + (v > 1 ? (v - 1) * W(n + 1, t, u, v - 2) : 0.0);
+                    }
+                }
+                out[(t * dim + u) * dim + v] = W(0, t, u, v);
+            }
+        }
+    }
+    out[0] = W(0, 0, 0, 0);
+}
+
+/*
+ * Sort the significant shell pairs of basis into boxes and, for each box, split the external charges Zxyz into
+ * the cells near enough to be integrated exactly and those lumped into a Taylor expansion of order about the box
+ * center. A cell is expanded when (box radius + cell radius) / distance <= theta.
+ */
+std::vector<PairBox> build_pair_boxes(std::shared_ptr<BasisSet> basis, SharedMatrix Zxyz, double theta, int order,
+                                      int nthread, int print) {
+    if (theta <= 0.0 || theta >= 1.0) throw PSIEXCEPTION("EXTERNAL_POTENTIAL_THETA must lie strictly between 0 and 1.");
+    if (order < 0) throw PSIEXCEPTION("EXTERNAL_POTENTIAL_MULTIPOLE_ORDER must not be negative.");
+
+    // => Shell pairs <= //
+    std::map<BoxIndex, size_t> box_map;
+    std::vector<PairBox> boxes;
+    size_t npair = 0;
+    for (int M = 0; M < basis->nshell(); M++) {
+        const GaussianShell &sM = basis->shell(M);
+        const Vector3 &A = sM.center();
+        for (int N = 0; N <= M; N++) {
+            const GaussianShell &sN = basis->shell(N);
+            const Vector3 &B = sN.center();
+            double AB2 = A.distance(B) * A.distance(B);
+
+            // Significant primitive pairs, as (center, extent); the most diffuse one places the pair in a box
+            std::vector<std::pair<Vector3, double> > prims;
+            double gamma_min = 0.0;
+            Vector3 P_min;
+            for (int p1 = 0; p1 < sM.nprimitive(); p1++) {
+                for (int p2 = 0; p2 < sN.nprimitive(); p2++) {
+                    double a1 = sM.exp(p1);
+                    double a2 = sN.exp(p2);
+                    double gamma = a1 + a2;
+                    double pf = std::fabs(sM.coef(p1) * sN.coef(p2)) * std::exp(-a1 * a2 * AB2 / gamma) *
+                                std::pow(M_PI / gamma, 1.5);
+                    if (pf < pair_cutoff) continue;
+                    Vector3 P = (a1 * A + a2 * B) / gamma;
+                    double extent = std::sqrt((-std::log(extent_cutoff) + sM.am() + sN.am()) / gamma);
+                    prims.push_back(std::make_pair(P, extent));
+                    if (gamma_min == 0.0 || gamma < gamma_min) {
+                        gamma_min = gamma;
+                        P_min = P;
+                    }
+                }
+            }
+            if (prims.empty()) continue;
+
+            BoxIndex index = box_index(P_min);
+            auto it = box_map.find(index);
+            if (it == box_map.end()) {
+                it = box_map.insert(std::make_pair(index, boxes.size())).first;
+                boxes.push_back(PairBox());
+                boxes.back().center = box_center(index);
+            }
+            PairBox &box = boxes[it->second];
+            box.pairs.push_back(std::make_pair(M, N));
+            for (const auto &prim : prims) {
+                box.radius = std::max(box.radius, prim.first.distance(box.center) + prim.second);
+            }
+            npair++;
+        }
+    }
+
+    // => Charge cells and their moments <= //
+    double **Zxyzp = Zxyz->pointer();
+    size_t ncharge = Zxyz->rowspi()[0];
+    const int dim = order + 1;
+    std::map<BoxIndex, size_t> cell_map;
+    std::vector<ChargeCell> cells;
+    for (size_t s = 0; s < ncharge; s++) {
+        BoxIndex index = box_index(Vector3(Zxyzp[s][1], Zxyzp[s][2], Zxyzp[s][3]));
+        auto it = cell_map.find(index);
+        if (it == cell_map.end()) {
+            it = cell_map.insert(std::make_pair(index, cells.size())).first;
+            cells.push_back(ChargeCell());
+            cells.back().center = box_center(index);
+        }
+        cells[it->second].charges.push_back(s);
+    }
+
+    std::vector<double> inv_factorial(2 * order + 1, 1.0);
+    for (int k = 1; k <= 2 * order; k++) inv_factorial[k] = inv_factorial[k - 1] / k;
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
+    for (size_t c = 0; c < cells.size(); c++) {
+        ChargeCell &cell = cells[c];
+        cell.moments.assign((size_t)dim * dim * dim, 0.0);
+        std::vector<double> dx(dim), dy(dim), dz(dim);
+        for (size_t s : cell.charges) {
+            Vector3 d(Zxyzp[s][1] - cell.center[0], Zxyzp[s][2] - cell.center[1], Zxyzp[s][3] - cell.center[2]);
+            cell.radius = std::max(cell.radius, d.norm());
+            dx[0] = dy[0] = dz[0] = 1.0;
+            for (int k = 1; k <= order; k++) {
+                dx[k] = -d[0] * dx[k - 1];
+                dy[k] = -d[1] * dy[k - 1];
+                dz[k] = -d[2] * dz[k - 1];
+            }
+            for (int a = 0; a <= order; a++) {
+                for (int b = 0; b <= order - a; b++) {
+                    for (int cc = 0; cc <= order - a - b; cc++) {
+                        cell.moments[(a * dim + b) * dim + cc] += Zxyzp[s][0] * dx[a] * dy[b] * dz[cc] *
+                                                                  inv_factorial[a] * inv_factorial[b] *
+                                                                  inv_factorial[cc];
+                    }
+                }
+            }
+        }
+    }
+
+    // => Near lists and far-field Taylor coefficients, per box <= //
+    const int ncoef = (order + 1) * (order + 2) * (order + 3) / 6;
+    const int L = 2 * order;
+    const int ldim = L + 1;
+    size_t nfar = 0;
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthread) reduction(+ : nfar)
+    for (size_t b = 0; b < boxes.size(); b++) {
+        PairBox &box = boxes[b];
+        std::vector<double> T((size_t)dim * dim * dim, 0.0);
+        std::vector<double> work, R;
+        std::vector<size_t> near;
+        for (const ChargeCell &cell : cells) {
+            Vector3 X = box.center - cell.center;
+            double dist = X.norm();
+            if (dist * theta < box.radius + cell.radius) {
+                near.insert(near.end(), cell.charges.begin(), cell.charges.end());
+                continue;
+            }
+            nfar++;
+            coulomb_derivatives(L, X, work, R);
+            for (int t = 0; t <= order; t++) {
+                for (int u = 0; u <= order - t; u++) {
+                    for (int v = 0; v <= order - t - u; v++) {
+                        double val = 0.0;
+                        for (int a = 0; a <= order; a++) {
+                            for (int bb = 0; bb <= order - a; bb++) {
+                                for (int cc = 0; cc <= order - a - bb; cc++) {
+                                    val += cell.moments[(a * dim + bb) * dim + cc] *
+                                           R[((a + t) * ldim + bb + u) * ldim + cc + v];
+                                }
+                            }
+                        }
+                        T[(t * dim + u) * dim + v] += val;
+                    }
+                }
+            }
+        }
+
+        box.near = std::make_shared<Matrix>("Near Charges (Z,x,y,z)", near.size(), 4);
+        double **nearp = box.near->pointer();
+        for (size_t i = 0; i < near.size(); i++) {
+            for (int k = 0; k < 4; k++) nearp[i][k] = Zxyzp[near[i]][k];
+        }
+
+        // Reorder into the constant term followed by the MultipoleInt components
+        box.taylor.resize(ncoef);
+        box.taylor[0] = T[0];
+        int index = 1;
+        for (int l = 1; l <= order; ++l) {
+            for (int ii = 0; ii <= l; ii++) {
+                int lx = l - ii;
+                for (int lz = 0; lz <= ii; lz++) {
+                    int ly = ii - lz;
+                    box.taylor[index++] = T[(lx * dim + ly) * dim + lz] * inv_factorial[lx] * inv_factorial[ly] *
+                                          inv_factorial[lz];
+                }
+            }
+        }
+    }
+
+    if (print > 1) {
+        outfile->Printf("    External potential: %zu shell pairs in %zu boxes, %zu charges in %zu cells.\n", npair,
+                        boxes.size(), ncharge, cells.size());
+        outfile->Printf("    External potential: %zu of %zu box-cell interactions expanded to order %d.\n\n", nfar,
+                        boxes.size() * cells.size(), order);
+    }
+
+    return boxes;
+}
+
+/// The (box, pair) work items of a set of boxes
+std::vector<std::pair<size_t, size_t> > box_tasks(const std::vector<PairBox> &boxes) {
+    std::vector<std::pair<size_t, size_t> > tasks;
+    for (size_t b = 0; b < boxes.size(); b++) {
+        for (size_t p = 0; p < boxes[b].pairs.size(); p++) tasks.push_back(std::make_pair(b, p));
+    }
+    return tasks;
+}
+
+/// Potential matrix of the charges Zxyz, with the charges far from each shell-pair box expanded about its center
+SharedMatrix multipole_potential_matrix(std::shared_ptr<BasisSet> basis, SharedMatrix Zxyz, double theta, int order,
+                                       int print) {
+    int nthread = Process::environment.get_n_threads();
+    std::vector<PairBox> boxes = build_pair_boxes(basis, Zxyz, theta, order, nthread, print);
+    std::vector<std::pair<size_t, size_t> > tasks = box_tasks(boxes);
 
-    std::shared_ptr<PotentialInt> pot(static_cast<PotentialInt *>(fact->ao_potential()));
-    pot->set_charge_field(Zxyz);
-    pot->compute(V_charge);
+    auto fact = std::make_shared<IntegralFactory>(basis, basis, basis, basis);
+    std::vector<std::shared_ptr<PotentialInt> > Vint;
+    std::vector<std::shared_ptr<OneBodyAOInt> > Sint, Mint;
+    for (int t = 0; t < nthread; t++) {
+        Vint.push_back(std::shared_ptr<PotentialInt>(static_cast<PotentialInt *>(fact->ao_potential())));
+        Sint.push_back(std::shared_ptr<OneBodyAOInt>(fact->ao_overlap()));
+        if (order) Mint.push_back(std::shared_ptr<OneBodyAOInt>(fact->ao_multipoles(order)));
+    }
+
+    int n = basis->nbf();
+    auto V = std::make_shared<Matrix>("External Potential (Charges)", n, n);
+    double **Vp = V->pointer();
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
+    for (size_t task = 0; task < tasks.size(); task++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        const PairBox &box = boxes[tasks[task].first];
+        int M = box.pairs[tasks[task].second].first;
+        int N = box.pairs[tasks[task].second].second;
+        int nM = basis->shell(M).nfunction();
+        int oM = basis->shell(M).function_index();
+        int nN = basis->shell(N).nfunction();
+        int oN = basis->shell(N).function_index();
+        int nMN = nM * nN;
+
+        // Far field: -T_000 S_mn plus the higher Taylor terms against the (negative) multipole integrals
+        std::vector<double> block(nMN, 0.0);
+        Sint[thread]->compute_shell(M, N);
+        C_DAXPY(nMN, -box.taylor[0], const_cast<double *>(Sint[thread]->buffer()), 1, block.data(), 1);
+        if (order) {
+            Mint[thread]->set_origin(box.center);
+            Mint[thread]->compute_shell(M, N);
+            const double *buffer = Mint[thread]->buffer();
+            for (size_t c = 1; c < box.taylor.size(); c++) {
+                C_DAXPY(nMN, box.taylor[c], const_cast<double *>(buffer + (c - 1) * nMN), 1, block.data(), 1);
+            }
+        }
 
-    V->add(V_charge);
-    V_charge.reset();
-    pot.reset();
+        // Near field, exactly
+        if (box.near->rowspi()[0]) {
+            Vint[thread]->set_charge_field(box.near);
+            Vint[thread]->compute_shell(M, N);
+            C_DAXPY(nMN, 1.0, const_cast<double *>(Vint[thread]->buffer()), 1, block.data(), 1);
+        }
+
+        for (int m = 0; m < nM; m++) {
+            for (int nn = 0; nn < nN; nn++) {
+                Vp[oM + m][oN + nn] = block[m * nN + nn];
+                Vp[oN + nn][oM + m] = block[m * nN + nn];
+            }
+        }
+    }
+
+    return V;
+}
+
+/// Electronic gradient of the charges Zxyz for the density Dt, with the same near/far partitioning as above
+SharedMatrix multipole_potential_gradient(std::shared_ptr<BasisSet> basis, SharedMatrix Zxyz, SharedMatrix Dt,
+                                          double theta, int order, int print) {
+    int nthread = Process::environment.get_n_threads();
+    std::vector<PairBox> boxes = build_pair_boxes(basis, Zxyz, theta, order, nthread, print);
+    std::vector<std::pair<size_t, size_t> > tasks = box_tasks(boxes);
+
+    int natom = basis->molecule()->natom();
+    auto fact = std::make_shared<IntegralFactory>(basis, basis, basis, basis);
+    std::vector<std::shared_ptr<PotentialInt> > Vint;
+    std::vector<std::shared_ptr<OneBodyAOInt> > Sint, Mint;
+    std::vector<SharedMatrix> Gtemps;
+    for (int t = 0; t < nthread; t++) {
+        Vint.push_back(std::shared_ptr<PotentialInt>(static_cast<PotentialInt *>(fact->ao_potential(1))));
+        Sint.push_back(std::shared_ptr<OneBodyAOInt>(fact->ao_overlap(1)));
+        if (order) Mint.push_back(std::shared_ptr<OneBodyAOInt>(fact->ao_multipoles(order, 1)));
+        Gtemps.push_back(std::make_shared<Matrix>("External Potential Gradient", natom, 3));
+    }
+    const int n_mult = (order + 1) * (order + 2) * (order + 3) / 6 - 1;
+    double **Dp = Dt->pointer();
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
+    for (size_t task = 0; task < tasks.size(); task++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        const PairBox &box = boxes[tasks[task].first];
+        int M = box.pairs[tasks[task].second].first;
+        int N = box.pairs[tasks[task].second].second;
+        int nM = basis->shell(M).nfunction();
+        int oM = basis->shell(M).function_index();
+        int nN = basis->shell(N).nfunction();
+        int oN = basis->shell(N).function_index();
+        int nMN = nM * nN;
+        int center[2] = {basis->shell(M).ncenter(), basis->shell(N).ncenter()};
+        double perm = (M == N ? 1.0 : 2.0);
+        double **Gp = Gtemps[thread]->pointer();
+
+        std::vector<double> Dblock(nMN);
+        for (int m = 0; m < nM; m++) {
+            for (int nn = 0; nn < nN; nn++) Dblock[m * nN + nn] = perm * Dp[oM + m][oN + nn];
+        }
+
+        // Far field, differentiated with respect to the two basis function centers
+        Sint[thread]->compute_shell_deriv1(M, N);
+        const double *Sbuf = Sint[thread]->buffer();
+        const double *Mbuf = nullptr;
+        if (order) {
+            Mint[thread]->set_origin(box.center);
+            Mint[thread]->compute_shell_deriv1(M, N);
+            Mbuf = Mint[thread]->buffer();
+        }
+        for (int c = 0; c < 2; c++) {
+            for (int k = 0; k < 3; k++) {
+                const double *Sref = Sbuf + (3 * c + k) * nMN;
+                double val = -box.taylor[0] * C_DDOT(nMN, Dblock.data(), 1, const_cast<double *>(Sref), 1);
+                for (int comp = 0; comp < n_mult; comp++) {
+                    const double *ref = Mbuf + ((3 * c + k) * n_mult + comp) * nMN;
+                    val += box.taylor[comp + 1] * C_DDOT(nMN, Dblock.data(), 1, const_cast<double *>(ref), 1);
+                }
+                Gp[center[c]][k] += val;
+            }
+        }
+
+        // Near field, exactly
+        if (box.near->rowspi()[0]) {
+            Vint[thread]->set_charge_field(box.near);
+            Vint[thread]->compute_shell_deriv1_no_charge_term(M, N);
+            const double *buffer = Vint[thread]->buffer();
+            for (int A = 0; A < natom; A++) {
+                for (int k = 0; k < 3; k++) {
+                    Gp[A][k] += C_DDOT(nMN, Dblock.data(), 1, const_cast<double *>(buffer + (3 * A + k) * nMN), 1);
+                }
+            }
+        }
+    }
+
+    auto grad = std::make_shared<Matrix>("External Potential Gradient", natom, 3);
+    for (int t = 0; t < nthread; t++) grad->add(Gtemps[t]);
+    return grad;
+}
+
+}  // namespace
+
+SharedMatrix ExternalPotential::computePotentialMatrix(std::shared_ptr<BasisSet> basis) {
+    int n = basis->nbf();
+    auto V = std::make_shared<Matrix>("External Potential", n, n);
+    auto fact = std::make_shared<IntegralFactory>(basis, basis, basis, basis);
+
+    // Monopoles
+    SharedMatrix Zxyz = charge_field(basis->molecule());
+    double theta = Process::environment.options.get_double("EXTERNAL_POTENTIAL_THETA");
+    if (theta > 0.0 && charges_.size()) {
+        // Distant charges lumped into multipole expansions about shell-pair boxes
+        int order = Process::environment.options.get_int("EXTERNAL_POTENTIAL_MULTIPOLE_ORDER");
+        V->add(multipole_potential_matrix(basis, Zxyz, theta, order, print_));
+    } else {
+        auto V_charge = std::make_shared<Matrix>("External Potential (Charges)", n, n);
+        std::shared_ptr<PotentialInt> pot(static_cast<PotentialInt *>(fact->ao_potential()));
+        pot->set_charge_field(Zxyz);
+        pot->compute(V_charge);
+        V->add(V_charge);
+    }
 
     // Diffuse Bases
     for (size_t ind = 0; ind < bases_.size(); ind++) {
@@ -171,19 +600,9 @@ SharedMatrix ExternalPotential::computePotentialGradients(std::shared_ptr<BasisS
     auto grad = std::make_shared<Matrix>("External Potential Gradient", natom, 3);
     double **Gp = grad->pointer();
 
-    auto Zxyz = std::make_shared<Matrix>("Charges (Z,x,y,z)", charges_.size(), 4);
+    SharedMatrix Zxyz = charge_field(mol);
     double **Zxyzp = Zxyz->pointer();
 
-    double convfac = 1.0;
-    if (mol->units() == Molecule::Angstrom) convfac /= pc_bohr2angstroms;
-
-    for (size_t i = 0; i < charges_.size(); i++) {
-        Zxyzp[i][0] = std::get<0>(charges_[i]);
-        Zxyzp[i][1] = convfac * std::get<1>(charges_[i]);
-        Zxyzp[i][2] = convfac * std::get<2>(charges_[i]);
-        Zxyzp[i][3] = convfac * std::get<3>(charges_[i]);
-    }
-
     // Start with the nuclear contribution
     grad->zero();
     for (int cen = 0; cen < natom; ++cen) {
@@ -205,6 +624,14 @@ SharedMatrix ExternalPotential::computePotentialGradients(std::shared_ptr<BasisS
     }
 
     // Now the electronic contribution.
+    double theta = Process::environment.options.get_double("EXTERNAL_POTENTIAL_THETA");
+    if (theta > 0.0 && nextc) {
+        // Distant charges lumped into multipole expansions about shell-pair boxes
+        int order = Process::environment.options.get_int("EXTERNAL_POTENTIAL_MULTIPOLE_ORDER");
+        grad->add(multipole_potential_gradient(basis, Zxyz, Dt, theta, order, print_));
+        return grad;
+    }
+
     auto fact = std::make_shared<IntegralFactory>(basis, basis, basis, basis);
 #if 0
     // Slow, but correct, memory hog version
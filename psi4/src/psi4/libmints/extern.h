@@ -62,6 +62,9 @@ class PSI_API ExternalPotential {
     /// Auxiliary basis sets (with accompanying molecules and coefs) of diffuse charges
     std::vector<std::pair<std::shared_ptr<BasisSet>, SharedVector> > bases_;
 
+    /// Charges as a (Z,x,y,z) matrix in bohr
+    SharedMatrix charge_field(std::shared_ptr<Molecule> mol) const;
+
    public:
     /// Constructur, does nothing
     ExternalPotential();
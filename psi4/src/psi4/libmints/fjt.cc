@@ -62,6 +62,7 @@
 #include "psi4/psi4-dec.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 
+#include <algorithm>
 #include <cmath>
 
 using namespace psi;
@@ -83,7 +84,15 @@ const double oon[] = {0.0,       1.0,       1.0 / 2.0, 1.0 / 3.0, 1.0 / 4.0,  1.
 Fjt::Fjt() {}
 Fjt::~Fjt() {}
 
-double Taylor_Fjt::relative_zero_(1e-6);
+void Fjt::values(int J, const double* T, size_t n, double* out, const double* rho) {
+    for (size_t i = 0; i < n; ++i) {
+        if (rho) set_rho(rho[i]);
+        const double* F = values(J, T[i]);
+        for (int j = 0; j <= J; ++j) out[j * n + i] = F[j];
+    }
+}
+
+double Taylor_Fjt::relative_zero_(1e-14);
 
 /*------------------------------------------------------
   Initialize Taylor_Fm_Eval object (computes incomplete
@@ -188,6 +197,10 @@ Taylor_Fjt::Taylor_Fjt(size_t mmax, double accuracy)
             grid_[T_idx][m] = sum;
         }
     }
+
+    // exp(-T) on the same grid, for the downward recursion of the batched values()
+    exp_grid_.resize(max_T_ + 1);
+    for (int T_idx = 0; T_idx <= max_T_; ++T_idx) exp_grid_[T_idx] = std::exp(-T_idx * delT_);
 }
 
 Taylor_Fjt::~Taylor_Fjt() {
@@ -326,6 +339,95 @@ And then do downward recursion in j
     return F_;
 }
 
+namespace {
+/// F_row[offset + k] + h / (k + 1) * (F_row[offset + k + 1] + ...), unrolled at compile time
+template <int k>
+struct TaylorSeries {
+    static inline double eval(const double* F_row, int offset, double h) {
+        return F_row[offset + k] + oon[k + 1] * h * TaylorSeries<k + 1>::eval(F_row, offset, h);
+    }
+};
+template <>
+struct TaylorSeries<TAYLOR_INTERPOLATION_ORDER> {
+    static inline double eval(const double* F_row, int offset, double /*h*/) {
+        return F_row[offset + TAYLOR_INTERPOLATION_ORDER];
+    }
+};
+}  // namespace
+
+/* The batched counterpart of the function above. Gathering a Taylor row for every j does not vectorize well, so
+ * only F_l(T) is interpolated (or taken from the asymptotic formula); the lower orders follow from the downward
+ * recursion F_j = (2T F_j+1 + exp(-T)) / (2j + 1), which is stable. exp(-T) is interpolated from a table on the
+ * same grid. Every loop runs over the elements of a cache-sized block and vectorizes.
+ */
+void Taylor_Fjt::values(int l, const double* T, size_t n, double* out, const double* /*rho*/) {
+    const size_t block = 64;
+    if (batch_row_.size() < block) {
+        batch_row_.resize(block);
+        batch_h_.resize(block);
+        batch_X_.resize(block);
+        batch_asym_.resize(block);
+    }
+    int* row = batch_row_.data();
+    double* h = batch_h_.data();
+    double* X = batch_X_.data();
+    double* asym = batch_asym_.data();
+
+    const double T_crit = T_crit_[l];
+    const double delT = delT_;
+    const double oodelT = oodelT_;
+    const int ncol = max_m_ + 1;
+    const double* grid = grid_[0];
+    const double* exp_grid = exp_grid_.data();
+
+    for (size_t start = 0; start < n; start += block) {
+        const size_t nblock = std::min(block, n - start);
+        const double* Tb = T + start;
+        double* Fl = out + l * n + start;
+
+#pragma omp simd
+        for (size_t i = 0; i < nblock; ++i) {
+            const bool asymptotic = Tb[i] > T_crit;
+            const int T_ind = asymptotic ? 0 : (int)(0.5 + Tb[i] * oodelT);
+            row[i] = T_ind;
+            h[i] = T_ind * delT - Tb[i];
+            // X = 1 / 2T where the asymptotic formula is used, zero flags interpolation
+            X[i] = asymptotic ? 0.5 / Tb[i] : 0.0;
+            asym[i] = M_SQRT_PI_2 * std::sqrt(X[i]);
+            Fl[i] = TaylorSeries<0>::eval(grid + l, T_ind * ncol, h[i]);
+        }
+
+        // Asymptotic F_l = (2l - 1)!! X^l F_0
+        for (int j = 0; j < l; ++j) {
+#pragma omp simd
+            for (size_t i = 0; i < nblock; ++i) asym[i] *= (2 * j + 1) * X[i];
+        }
+
+        // exp(-T) = exp(-T0) exp(h), dropped in the asymptotic region just as in the scalar code
+#pragma omp simd
+        for (size_t i = 0; i < nblock; ++i) {
+            const double hh = h[i];
+            double exph = 1.0 + hh * oon[6];
+            exph = 1.0 + hh * oon[5] * exph;
+            exph = 1.0 + hh * oon[4] * exph;
+            exph = 1.0 + hh * oon[3] * exph;
+            exph = 1.0 + hh * oon[2] * exph;
+            exph = 1.0 + hh * exph;
+            const bool asymptotic = X[i] > 0.0;
+            Fl[i] = asymptotic ? asym[i] : Fl[i];
+            h[i] = asymptotic ? 0.0 : exp_grid[row[i]] * exph;
+        }
+
+        for (int j = l - 1; j >= 0; --j) {
+            const double oo2jp1 = 1.0 / (2 * j + 1);
+            const double* Fjp1 = out + (j + 1) * n + start;
+            double* Fj = out + j * n + start;
+#pragma omp simd
+            for (size_t i = 0; i < nblock; ++i) Fj[i] = (2.0 * Tb[i] * Fjp1[i] + h[i]) * oo2jp1;
+        }
+    }
+}
+
 /////////////////////////////////////////////////////////////////////////////
 
 /* Tablesize should always be at least 121. */
@@ -58,6 +58,9 @@
 
 #include "psi4/pragma.h"
 
+#include <cstddef>
+#include <vector>
+
 namespace psi {
 
 class CorrelationFactor;
@@ -72,6 +75,10 @@ class Fjt {
         The values will be overwritten with the next call to this functions.
         The pointer will be invalidated after the call to ~Fjt. */
     virtual double* values(int J, double T) = 0;
+    /** Computes F_j(T_i) for every 0 <= j <= J and each of the n arguments T_i, stored as out[j * n + i].
+        If rho is given, the value of set_rho for T_i is taken from rho[i].
+        The default evaluates one T at a time; table-driven engines override it with a vectorized loop. */
+    virtual void values(int J, const double* T, size_t n, double* out, const double* rho = nullptr);
     virtual void set_rho(double /*rho*/) {}
 };
 
@@ -89,6 +96,10 @@ class Taylor_Fjt : public Fjt {
     ~Taylor_Fjt() override;
     /// Implements Fjt::values()
     double* values(int J, double T) override;
+    /// Implements the batched Fjt::values(), the same interpolation vectorized over the T_i
+    void values(int J, const double* T, size_t n, double* out, const double* rho = nullptr) override;
+    /// Largest T at which F_m(T) is interpolated from the table, the asymptotic formula is used beyond it
+    double T_crit(int m) const { return T_crit_[m]; }
 
    private:
     double** grid_;    /* Table of "exact" Fm(T) values. Row index corresponds to
@@ -106,6 +117,12 @@ class Taylor_Fjt : public Fjt {
                           for a given m and T_idx <= max_T_idx[m] use Taylor interpolation,
                           for a given m and T_idx > max_T_idx[m] use the asymptotic formula */
     double* F_;        /* Here computed values of Fj(T) are stored */
+    std::vector<double> exp_grid_; /* exp(-T) at the grid points */
+    /* Scratch for the batched values(): table row, interpolation step and asymptotic terms of each T */
+    std::vector<int> batch_row_;
+    std::vector<double> batch_h_;
+    std::vector<double> batch_X_;
+    std::vector<double> batch_asym_;
 };
 
 /// "Old" intv3 code from Curt
@@ -126,6 +143,7 @@ class FJT : public Fjt {
    public:
     FJT(int n);
     ~FJT() override;
+    using Fjt::values;
     /// implementation of Fjt::values()
     double* values(int J, double T) override;
 };
@@ -140,6 +158,8 @@ class GaussianFundamental : public Fjt {
     GaussianFundamental(std::shared_ptr<CorrelationFactor> cf, int max);
     ~GaussianFundamental() override;
 
+    using Fjt::values;
+
     double* values(int J, double T) override = 0;
     void set_rho(double rho) override;
 };
@@ -0,0 +1,369 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2019 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "psi4/libmints/gridesp.h"
+#include "psi4/libmints/basisset.h"
+#include "psi4/libmints/gshell.h"
+#include "psi4/libmints/integral.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libmints/fjt.h"
+#include "psi4/libpsi4util/exception.h"
+#include "psi4/libpsi4util/process.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace psi {
+
+namespace {
+
+/// Cartesian exponents of the components of a shell of angular momentum l, in the order of the integral codes
+std::vector<std::array<int, 3> > cartesian_components(int l) {
+    std::vector<std::array<int, 3> > comps;
+    for (int ii = 0; ii <= l; ii++) {
+        int lx = l - ii;
+        for (int lz = 0; lz <= ii; lz++) {
+            comps.push_back(std::array<int, 3>{{lx, ii - lz, lz}});
+        }
+    }
+    return comps;
+}
+
+/// Cartesian block of D for shells s1, s2, back-transformed from the pure functions where needed
+std::vector<double> cartesian_density(const GaussianShell &s1, const GaussianShell &s2, double **Dp) {
+    int n1 = s1.nfunction();
+    int o1 = s1.function_index();
+    int o2 = s2.function_index();
+    int nc1 = s1.ncartesian();
+    int nc2 = s2.ncartesian();
+
+    // Transform the second index
+    std::vector<double> half(n1 * nc2, 0.0);
+    if (s2.is_pure() && s2.am() > 0) {
+        SphericalTransform trans(s2.am());
+        for (int i = 0; i < n1; i++) {
+            for (int k = 0; k < trans.n(); k++) {
+                half[i * nc2 + trans.cartindex(k)] += trans.coef(k) * Dp[o1 + i][o2 + trans.pureindex(k)];
+            }
+        }
+    } else {
+        for (int i = 0; i < n1; i++) {
+            for (int j = 0; j < nc2; j++) half[i * nc2 + j] = Dp[o1 + i][o2 + j];
+        }
+    }
+
+    // Transform the first index
+    std::vector<double> cart(nc1 * nc2, 0.0);
+    if (s1.is_pure() && s1.am() > 0) {
+        SphericalTransform trans(s1.am());
+        for (int k = 0; k < trans.n(); k++) {
+            for (int j = 0; j < nc2; j++) {
+                cart[trans.cartindex(k) * nc2 + j] += trans.coef(k) * half[trans.pureindex(k) * nc2 + j];
+            }
+        }
+    } else {
+        cart = half;
+    }
+    return cart;
+}
+
+/// 1D Hermite expansion coefficients E[i][j][t] of the product of (x - A)^i and (x - B)^j about P, for exponent p
+void hermite_coefficients(int am1, int am2, double p, double PA, double PB, std::vector<double> &E) {
+    int dim = am1 + am2 + 1;
+    auto idx = [&](int i, int j, int t) { return (i * (am2 + 1) + j) * dim + t; };
+    E.assign((size_t)(am1 + 1) * (am2 + 1) * dim, 0.0);
+    double oo2p = 0.5 / p;
+    E[idx(0, 0, 0)] = 1.0;
+    for (int i = 0; i <= am1; i++) {
+        for (int j = 0; j <= am2; j++) {
+            if (i == 0 && j == 0) continue;
+            // Raise whichever index is nonzero, preferring the first center
+            int i0 = (i ? i - 1 : i);
+            int j0 = (i ? j : j - 1);
+            double X = (i ? PA : PB);
+            for (int t = 0; t <= i + j; t++) {
+                double val = X * E[idx(i0, j0, t)];
+                if (t) val += oo2p * E[idx(i0, j0, t - 1)];
+                if (t + 1 <= i0 + j0) val += (t + 1) * E[idx(i0, j0, t + 1)];
+                E[idx(i, j, t)] = val;
+            }
+        }
+    }
+}
+
+}  // namespace
+
+GridESP::GridESP(std::shared_ptr<BasisSet> basis, SharedMatrix D, double cutoff)
+    : basis_(basis), max_L_(0), batch_size_(128), cutoff_(cutoff) {
+    if (D->nirrep() != 1 || D->rowdim() != basis->nbf() || D->coldim() != basis->nbf()) {
+        throw PSIEXCEPTION("GridESP: the density must be a C1 AO matrix of the basis set.");
+    }
+    double **Dp = D->pointer();
+
+    // Hermite index table, long enough for the field of the highest pair
+    int L_table = 2 * basis->max_am() + 1;
+    for (int N = 0; N <= L_table; N++) {
+        for (int t = N; t >= 0; t--) {
+            for (int u = N - t; u >= 0; u--) tuv_.push_back(std::array<int, 3>{{t, u, N - t - u}});
+        }
+    }
+
+    std::vector<double> Ex, Ey, Ez;
+    for (int M = 0; M < basis->nshell(); M++) {
+        const GaussianShell &s1 = basis->shell(M);
+        for (int N = 0; N <= M; N++) {
+            const GaussianShell &s2 = basis->shell(N);
+            int am1 = s1.am();
+            int am2 = s2.am();
+            int L = am1 + am2;
+            int ncoef = (L + 1) * (L + 2) * (L + 3) / 6;
+
+            // Symmetrized Cartesian density block, counting both (M,N) and (N,M)
+            std::vector<double> Dcart = cartesian_density(s1, s2, Dp);
+            if (M != N) {
+                std::vector<double> DcartT = cartesian_density(s2, s1, Dp);
+                int nc1 = s1.ncartesian();
+                int nc2 = s2.ncartesian();
+                for (int a = 0; a < nc1; a++) {
+                    for (int b = 0; b < nc2; b++) Dcart[a * nc2 + b] += DcartT[b * nc1 + a];
+                }
+            }
+            double Dmax = 0.0;
+            for (double val : Dcart) Dmax = std::max(Dmax, std::fabs(val));
+            if (Dmax == 0.0) continue;
+
+            std::vector<std::array<int, 3> > comps1 = cartesian_components(am1);
+            std::vector<std::array<int, 3> > comps2 = cartesian_components(am2);
+            const Vector3 &A = s1.center();
+            const Vector3 &B = s2.center();
+            double AB2 = A.distance(B) * A.distance(B);
+            int dim = L + 1;
+            auto eidx = [&](int i, int j, int t) { return (i * (am2 + 1) + j) * dim + t; };
+
+            for (int p1 = 0; p1 < s1.nprimitive(); p1++) {
+                for (int p2 = 0; p2 < s2.nprimitive(); p2++) {
+                    double a1 = s1.exp(p1);
+                    double a2 = s2.exp(p2);
+                    double p = a1 + a2;
+                    // Electrons are negative; 2 pi / p is the Coulomb prefactor of the Hermite Gaussians
+                    double pref = -2.0 * M_PI / p * s1.coef(p1) * s2.coef(p2) * std::exp(-a1 * a2 * AB2 / p);
+                    if (std::fabs(pref) * Dmax * std::pow(M_PI / p, 1.5) < cutoff) continue;
+
+                    Vector3 P = (a1 * A + a2 * B) / p;
+                    hermite_coefficients(am1, am2, p, P[0] - A[0], P[0] - B[0], Ex);
+                    hermite_coefficients(am1, am2, p, P[1] - A[1], P[1] - B[1], Ey);
+                    hermite_coefficients(am1, am2, p, P[2] - A[2], P[2] - B[2], Ez);
+
+                    HermitePair pair;
+                    pair.p = p;
+                    pair.P = P;
+                    pair.L = L;
+                    pair.offset = coefs_.size();
+                    coefs_.resize(coefs_.size() + ncoef, 0.0);
+                    double *Dh = coefs_.data() + pair.offset;
+
+                    for (size_t a = 0; a < comps1.size(); a++) {
+                        const std::array<int, 3> &c1 = comps1[a];
+                        for (size_t b = 0; b < comps2.size(); b++) {
+                            const std::array<int, 3> &c2 = comps2[b];
+                            double Dab = pref * Dcart[a * comps2.size() + b];
+                            if (Dab == 0.0) continue;
+                            for (int k = 0; k < ncoef; k++) {
+                                const std::array<int, 3> &h = tuv_[k];
+                                if (h[0] > c1[0] + c2[0] || h[1] > c1[1] + c2[1] || h[2] > c1[2] + c2[2]) continue;
+                                Dh[k] += Dab * Ex[eidx(c1[0], c2[0], h[0])] * Ey[eidx(c1[1], c2[1], h[1])] *
+                                         Ez[eidx(c1[2], c2[2], h[2])];
+                            }
+                        }
+                    }
+                    pair.sum_offset = order_sums_.size();
+                    order_sums_.resize(order_sums_.size() + L + 1, 0.0);
+                    for (int k = 0; k < ncoef; k++) {
+                        const std::array<int, 3> &h = tuv_[k];
+                        order_sums_[pair.sum_offset + h[0] + h[1] + h[2]] += std::fabs(Dh[k]);
+                    }
+                    pairs_.push_back(pair);
+                    max_L_ = std::max(max_L_, L);
+                }
+            }
+        }
+    }
+}
+
+SharedMatrix GridESP::compute(SharedMatrix points, bool field) const {
+    if (points->nirrep() != 1 || points->coldim() != 3) {
+        throw PSIEXCEPTION("GridESP: the points must be given as an N x 3 matrix.");
+    }
+    int npoints = points->rowdim();
+    double **Pp = points->pointer();
+    auto result = std::make_shared<Matrix>("ESP and Field", npoints, field ? 4 : 1);
+    double **Rp = result->pointer();
+
+    int nthread = Process::environment.get_n_threads();
+    const int Lmax = max_L_ + (field ? 1 : 0);
+    const int dim = Lmax + 1;
+    std::vector<std::unique_ptr<Taylor_Fjt> > fjt;
+    for (int t = 0; t < nthread; t++) fjt.emplace_back(new Taylor_Fjt(Lmax + 1, 1.0E-15));
+
+    const int nbatch = (npoints + batch_size_ - 1) / batch_size_;
+
+#pragma omp parallel num_threads(nthread)
+    {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        // R^{(n)}_{tuv}, only the entries with n + t + u + v <= L are touched
+        std::vector<double> W((size_t)dim * dim * dim * dim);
+        auto w = [&W, dim](int n, int t, int u, int v) -> double & { return W[((n * dim + t) * dim + u) * dim + v]; };
+        std::vector<double> Tvals(batch_size_);
+        std::vector<double> boys((size_t)batch_size_ * (Lmax + 1));
+        std::vector<double> values((size_t)batch_size_ * 4);
+        // Bounds b(n, N) >= |R^{(n)}_{tuv}| with t + u + v = N over the whole batch, and F_n at the closest approach
+        std::vector<double> B((size_t)dim * dim);
+        auto b = [&B, dim](int n, int N) -> double & { return B[n * dim + N]; };
+        std::vector<double> Fmin(dim);
+
+#pragma omp for schedule(dynamic)
+        for (int batch = 0; batch < nbatch; batch++) {
+            int start = batch * batch_size_;
+            int nbatch_points = std::min(batch_size_, npoints - start);
+            std::fill(values.begin(), values.end(), 0.0);
+
+            // Sphere enclosing the batch
+            Vector3 center(0.0, 0.0, 0.0);
+            for (int i = 0; i < nbatch_points; i++) {
+                center += Vector3(Pp[start + i][0], Pp[start + i][1], Pp[start + i][2]);
+            }
+            center /= (double)nbatch_points;
+            double radius = 0.0;
+            for (int i = 0; i < nbatch_points; i++) {
+                Vector3 point(Pp[start + i][0], Pp[start + i][1], Pp[start + i][2]);
+                radius = std::max(radius, center.distance(point));
+            }
+
+            for (const HermitePair &pair : pairs_) {
+                const int L = pair.L + (field ? 1 : 0);
+                const double *Dh = coefs_.data() + pair.offset;
+                const int ncoef = (pair.L + 1) * (pair.L + 2) * (pair.L + 3) / 6;
+
+                // Bound the pair over the batch: F_n decreases with T, so it is largest at the closest approach
+                // Rmin, and every |PC| component is at most Rmax. The recursion below then bounds R_tuv by order.
+                double dist = pair.P.distance(center);
+                double Rmin = std::max(0.0, dist - radius);
+                double Rmax = dist + radius;
+                double Tmin = pair.p * Rmin * Rmin;
+                fjt[thread]->values(L, &Tmin, 1, Fmin.data());
+                double twop = 1.0;
+                for (int n = 0; n <= L; n++) {
+                    b(n, 0) = twop * Fmin[n];
+                    twop *= 2.0 * pair.p;
+                }
+                for (int N = 1; N <= L; N++) {
+                    for (int n = 0; n <= L - N; n++) {
+                        b(n, N) = Rmax * b(n + 1, N - 1) + (N > 1 ? (N - 1) * b(n + 1, N - 2) : 0.0);
+                    }
+                }
+                const double *sums = order_sums_.data() + pair.sum_offset;
+                double Vbound = 0.0;
+                double Ebound = 0.0;
+                for (int N = 0; N <= pair.L; N++) {
+                    Vbound += sums[N] * b(0, N);
+                    if (field) Ebound += sums[N] * b(0, N + 1);
+                }
+                if (Vbound < cutoff_ && Ebound < cutoff_) continue;
+
+                // Boys functions of the whole batch at once, F_n(T_i) in boys[n * nbatch_points + i]
+                for (int i = 0; i < nbatch_points; i++) {
+                    double X = pair.P[0] - Pp[start + i][0];
+                    double Y = pair.P[1] - Pp[start + i][1];
+                    double Z = pair.P[2] - Pp[start + i][2];
+                    Tvals[i] = pair.p * (X * X + Y * Y + Z * Z);
+                }
+                fjt[thread]->values(L, Tvals.data(), nbatch_points, boys.data());
+
+                for (int i = 0; i < nbatch_points; i++) {
+                    double PC[3] = {pair.P[0] - Pp[start + i][0], pair.P[1] - Pp[start + i][1],
+                                    pair.P[2] - Pp[start + i][2]};
+
+                    // McMurchie-Davidson recursion for the Hermite Coulomb integrals
+                    double m2p = 1.0;
+                    for (int n = 0; n <= L; n++) {
+                        w(n, 0, 0, 0) = m2p * boys[n * nbatch_points + i];
+                        m2p *= -2.0 * pair.p;
+                    }
+                    for (int N = 1; N <= L; N++) {
+                        for (int t = 0; t <= N; t++) {
+                            for (int u = 0; u <= N - t; u++) {
+                                int v = N - t - u;
+                                for (int n = 0; n <= L - N; n++) {
+                                    double &val = w(n, t, u, v);
+                                    if (t) {
+                                        val = PC[0] * w(n + 1, t - 1, u, v) +
+                                              (t > 1 ? (t - 1) * w(n + 1, t - 2, u, v) : 0.0);
+                                    } else if (u) {
+                                        val = PC[1] * w(n + 1, t, u - 1, v) +
+                                              (u > 1 ? (u - 1) * w(n + 1, t, u - 2, v) : 0.0);
+                                    } else {
+                                        val = PC[2] * w(n + 1, t, u, v - 1) +
+                                              (v > 1 ? (v - 1) * w(n + 1, t, u, v - 2) : 0.0);
+                                    }
+                                }
+                            }
+                        }
+                    }
+
+                    // V = sum_tuv D_tuv R_tuv, and E = -grad_C V = sum_tuv D_tuv R_{tuv + 1}
+                    double *val = values.data() + 4 * i;
+                    for (int k = 0; k < ncoef; k++) {
+                        const std::array<int, 3> &h = tuv_[k];
+                        val[0] += Dh[k] * w(0, h[0], h[1], h[2]);
+                        if (field) {
+                            val[1] += Dh[k] * w(0, h[0] + 1, h[1], h[2]);
+                            val[2] += Dh[k] * w(0, h[0], h[1] + 1, h[2]);
+                            val[3] += Dh[k] * w(0, h[0], h[1], h[2] + 1);
+                        }
+                    }
+                }
+            }
+
+            for (int i = 0; i < nbatch_points; i++) {
+                for (int c = 0; c < (field ? 4 : 1); c++) Rp[start + i][c] = values[4 * i + c];
+            }
+        }
+    }
+
+    return result;
+}
+
+}  // namespace psi
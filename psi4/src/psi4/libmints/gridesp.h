@@ -0,0 +1,109 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2019 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _psi_src_lib_libmints_gridesp_h_
+#define _psi_src_lib_libmints_gridesp_h_
+
+#include <array>
+#include <vector>
+#include "typedefs.h"
+#include "psi4/pragma.h"
+#include "psi4/libmints/vector3.h"
+
+namespace psi {
+
+class BasisSet;
+
+/*! \ingroup MINTS
+ *  \class GridESP
+ *  \brief Electronic electrostatic potential and field of a density at many points.
+ *
+ *  The AO density is contracted once into McMurchie-Davidson Hermite coefficients for each significant
+ *  primitive pair, so that each point only costs one Boys function and one Hermite recursion per primitive
+ *  pair, rather than a full nbf x nbf set of potential integrals. Primitive pairs whose density-weighted
+ *  overlap falls below the cutoff are dropped. Points are processed in threaded batches; a pair is skipped for a
+ *  whole batch when a bound on its Hermite Coulomb integrals over the sphere enclosing the batch puts its
+ *  contribution below the cutoff. As the monopole of a pair only decays as 1/R, this mostly removes weak pairs far
+ *  from the batch, and it pays off most when neighbouring points are passed next to each other.
+ */
+class PSI_API GridESP {
+   protected:
+    /// A significant primitive pair of the density
+    struct HermitePair {
+        /// Total exponent
+        double p;
+        /// Gaussian product center
+        Vector3 P;
+        /// Highest Hermite order
+        int L;
+        /// Offset of the Hermite coefficients in coefs_
+        size_t offset;
+        /// Offset of the L + 1 per-order sums of |D_tuv| in order_sums_
+        size_t sum_offset;
+    };
+
+    /// Basis set of the density
+    std::shared_ptr<BasisSet> basis_;
+    /// Significant primitive pairs
+    std::vector<HermitePair> pairs_;
+    /// Density-contracted Hermite coefficients of every pair, in the order of tuv_
+    std::vector<double> coefs_;
+    /// Sum of |D_tuv| over t + u + v = N for every pair, used to screen pairs against a batch of points
+    std::vector<double> order_sums_;
+    /// Hermite indices (t,u,v) ordered by increasing t + u + v
+    std::vector<std::array<int, 3> > tuv_;
+    /// Highest Hermite order over all pairs
+    int max_L_;
+    /// Number of points per batch
+    int batch_size_;
+    /// Neglect threshold for primitive pairs, and for their bounded contribution to a batch
+    double cutoff_;
+
+   public:
+    /**
+     * @param basis  the AO basis of D
+     * @param D      the (total) AO density matrix
+     * @param cutoff primitive pairs whose density-weighted overlap, or whose bounded contribution to a batch of
+     *               points, is below this are neglected
+     */
+    GridESP(std::shared_ptr<BasisSet> basis, SharedMatrix D, double cutoff = 1.0E-14);
+
+    /// Set the number of points handed to a thread at a time
+    void set_batch_size(int batch_size) { batch_size_ = batch_size; }
+
+    /**
+     * The electronic potential (column 0) and, if requested, electric field (columns 1-3) at each point.
+     * @param points N x 3 matrix of Cartesian coordinates in bohr
+     * @param field  also compute the field?
+     */
+    SharedMatrix compute(SharedMatrix points, bool field = true) const;
+};
+
+}  // namespace psi
+
+#endif
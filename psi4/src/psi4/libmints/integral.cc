@@ -50,6 +50,7 @@
 #include "psi4/libmints/ecpint.h"
 #include "psi4/libmints/basisset.h"
 #include "psi4/libmints/erd_eri.h"
+#include "psi4/libmints/shellpaircache.h"
 
 #ifdef USING_simint
 #include "psi4/libmints/siminteri.h"
@@ -83,10 +84,26 @@ void IntegralFactory::set_basis(std::shared_ptr<BasisSet> bs1, std::shared_ptr<B
     bs3_ = bs3;
     bs4_ = bs4;
 
+    {
+        std::lock_guard<std::mutex> lock(shell_pairs_lock_);
+        shell_pairs_.clear();
+    }
+
     // Use the max am from libint
     init_spherical_harmonics(LIBINT_MAX_AM + 1);
 }
 
+std::shared_ptr<ShellPairCache> IntegralFactory::shell_pairs(std::shared_ptr<BasisSet> bsP,
+                                                            std::shared_ptr<BasisSet> bsQ) const {
+    std::lock_guard<std::mutex> lock(shell_pairs_lock_);
+    for (const auto& pairs : shell_pairs_) {
+        if (pairs->covers(bsP, bsQ)) return pairs;
+    }
+    double threshold = Process::environment.options.get_double("INTS_PRIMITIVE_TOLERANCE");
+    shell_pairs_.push_back(std::make_shared<ShellPairCache>(bsP, bsQ, threshold));
+    return shell_pairs_.back();
+}
+
 OneBodyAOInt* IntegralFactory::ao_overlap(int deriv) {
     return new OverlapInt(spherical_transforms_, bs1_, bs2_, deriv);
 }
@@ -109,8 +126,10 @@ OneBodySOInt* IntegralFactory::so_kinetic(int deriv) {
     return new OneBodySOInt(ao_int, this);
 }
 
-OneBodyAOInt* IntegralFactory::ao_potential(int deriv) {
-    return new PotentialInt(spherical_transforms_, bs1_, bs2_, deriv);
+OneBodyAOInt* IntegralFactory::ao_potential(int deriv, bool use_shell_pairs) {
+    auto* ints = new PotentialInt(spherical_transforms_, bs1_, bs2_, deriv);
+    if (use_shell_pairs) ints->set_shell_pairs(shell_pairs(bs1_, bs2_));
+    return ints;
 }
 
 OneBodySOInt* IntegralFactory::so_potential(int deriv) {
@@ -177,8 +196,8 @@ OneBodySOInt* IntegralFactory::so_quadrupole() {
     return new OneBodySOInt(ao_int, this);
 }
 
-OneBodyAOInt* IntegralFactory::ao_multipoles(int order) {
-    return new MultipoleInt(spherical_transforms_, bs1_, bs2_, order);
+OneBodyAOInt* IntegralFactory::ao_multipoles(int order, int deriv) {
+    return new MultipoleInt(spherical_transforms_, bs1_, bs2_, order, deriv);
 }
 
 OneBodyAOInt* IntegralFactory::ao_multipole_potential(int max_k, int deriv) {
@@ -34,6 +34,7 @@ PRAGMA_WARNING_PUSH
 PRAGMA_WARNING_IGNORE_DEPRECATED_DECLARATIONS
 #include <memory>
 PRAGMA_WARNING_POP
+#include <mutex>
 #include <vector>
 
 #include "onebody.h"
@@ -79,6 +80,7 @@ class ShellRotation;
 class SymmetryOperation;
 class SOBasisSet;
 class CorrelationFactor;
+class ShellPairCache;
 
 /*! \ingroup MINTS */
 class PSI_API SphericalTransformComponent {
@@ -387,6 +389,11 @@ class PSI_API IntegralFactory {
     /// Provides ability to transform from sphericals (d=0, f=1, g=2)
     std::vector<ISphericalTransform> ispherical_transforms_;
 
+    /// Primitive pair data built so far, shared by the integral objects of this factory
+    mutable std::vector<std::shared_ptr<ShellPairCache>> shell_pairs_;
+    /// Guards shell_pairs_, as integral objects may be created from several threads
+    mutable std::mutex shell_pairs_lock_;
+
    public:
     /** Initialize IntegralFactory object given a BasisSet for each center. */
     IntegralFactory(std::shared_ptr<BasisSet> bs1, std::shared_ptr<BasisSet> bs2, std::shared_ptr<BasisSet> bs3,
@@ -409,6 +416,9 @@ class PSI_API IntegralFactory {
     virtual void set_basis(std::shared_ptr<BasisSet> bs1, std::shared_ptr<BasisSet> bs2, std::shared_ptr<BasisSet> bs3,
                            std::shared_ptr<BasisSet> bs4);
 
+    /// Primitive pair data of the shell pairs of (bsP, bsQ), built on first request and reused afterwards
+    std::shared_ptr<ShellPairCache> shell_pairs(std::shared_ptr<BasisSet> bsP, std::shared_ptr<BasisSet> bsQ) const;
+
     /// Returns an OneBodyInt that computes the overlap integral.
     virtual OneBodyAOInt* ao_overlap(int deriv = 0);
 
@@ -423,7 +433,7 @@ class PSI_API IntegralFactory {
     virtual OneBodySOInt* so_kinetic(int deriv = 0);
 
     /// Returns an OneBodyInt that computes the nuclear attraction integral.
-    virtual OneBodyAOInt* ao_potential(int deriv = 0);
+    virtual OneBodyAOInt* ao_potential(int deriv = 0, bool use_shell_pairs = true);
     virtual OneBodySOInt* so_potential(int deriv = 0);
 
     /// Returns an OneBodyInt that computes the ECP integral.
@@ -447,7 +457,7 @@ class PSI_API IntegralFactory {
     virtual OneBodySOInt* so_quadrupole();
 
     /// Returns an OneBodyInt that computes arbitrary-order multipole integrals.
-    virtual OneBodyAOInt* ao_multipoles(int order);
+    virtual OneBodyAOInt* ao_multipoles(int order, int deriv = 0);
     virtual OneBodySOInt* so_multipoles(int order);
 
     /// Returns an OneBodyInt that computes the traceless quadrupole integral.
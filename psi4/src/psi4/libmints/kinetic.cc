@@ -67,6 +67,10 @@ KineticInt::KineticInt(std::vector<SphericalTransform> &st, std::shared_ptr<Basi
 
 KineticInt::~KineticInt() { delete[] buffer_; }
 
+OneBodyAOInt *KineticInt::clone() const {
+    return clone_settings(new KineticInt(spherical_transforms_, bs1_, bs2_, deriv_));
+}
+
 // The engine only supports segmented basis sets
 void KineticInt::compute_pair(const GaussianShell &s1, const GaussianShell &s2) {
     int ao12;
@@ -66,6 +66,9 @@ class KineticInt : public OneBodyAOInt {
     //! Virtual destructor.
     ~KineticInt() override;
 
+    bool cloneable() const override { return true; }
+    OneBodyAOInt* clone() const override;
+
     /// Does the method provide first derivatives?
     bool has_deriv1() override { return true; }
 
@@ -208,6 +208,8 @@ void MintsHelper::common_init() {
 
     // Integral cutoff
     cutoff_ = Process::environment.options.get_double("INTS_TOLERANCE");
+
+    use_shell_pairs_ = true;
 }
 
 std::shared_ptr<PetiteList> MintsHelper::petite_list() const {
@@ -658,7 +660,7 @@ SharedMatrix MintsHelper::ao_kinetic(std::shared_ptr<BasisSet> bs1, std::shared_
 SharedMatrix MintsHelper::ao_potential() {
     std::vector<std::shared_ptr<OneBodyAOInt>> ints_vec;
     for (size_t i = 0; i < nthread_; i++) {
-        ints_vec.push_back(std::shared_ptr<OneBodyAOInt>(integral_->ao_potential()));
+        ints_vec.push_back(std::shared_ptr<OneBodyAOInt>(integral_->ao_potential(0, use_shell_pairs_)));
     }
     SharedMatrix potential_mat =
         std::make_shared<Matrix>("AO-basis Potential Ints", basisset_->nbf(), basisset_->nbf());
@@ -681,7 +683,7 @@ SharedMatrix MintsHelper::ao_potential(std::shared_ptr<BasisSet> bs1, std::share
     IntegralFactory factory(bs1, bs2, bs1, bs2);
     std::vector<std::shared_ptr<OneBodyAOInt>> ints_vec;
     for (size_t i = 0; i < nthread_; i++) {
-        ints_vec.push_back(std::shared_ptr<OneBodyAOInt>(factory.ao_potential()));
+        ints_vec.push_back(std::shared_ptr<OneBodyAOInt>(factory.ao_potential(0, use_shell_pairs_)));
     }
     auto potential_mat = std::make_shared<Matrix>("AO-basis Potential Ints", bs1->nbf(), bs2->nbf());
     one_body_ao_computer(ints_vec, potential_mat, false);
@@ -875,13 +877,13 @@ SharedMatrix MintsHelper::ao_eri(std::shared_ptr<IntegralFactory> input_factory)
         factory = integral_;
     }
 
-    return ao_helper("AO ERI Tensor", std::shared_ptr<TwoBodyAOInt>(factory->eri()));
+    return ao_helper("AO ERI Tensor", std::shared_ptr<TwoBodyAOInt>(factory->eri(0, use_shell_pairs_)));
 }
 
 SharedMatrix MintsHelper::ao_eri(std::shared_ptr<BasisSet> bs1, std::shared_ptr<BasisSet> bs2,
                                  std::shared_ptr<BasisSet> bs3, std::shared_ptr<BasisSet> bs4) {
     IntegralFactory intf(bs1, bs2, bs3, bs4);
-    std::shared_ptr<TwoBodyAOInt> ints(intf.eri());
+    std::shared_ptr<TwoBodyAOInt> ints(intf.eri(0, use_shell_pairs_));
     return ao_helper("AO ERI Tensor", ints);
 }
 
@@ -3061,9 +3063,9 @@ std::vector<SharedMatrix> MintsHelper::ao_tei_deriv1(int atom, double omega,
 
     std::shared_ptr<TwoBodyAOInt> ints;
     if (omega == 0.0) {
-        ints = std::shared_ptr<TwoBodyAOInt>(factory->eri(1));
+        ints = std::shared_ptr<TwoBodyAOInt>(factory->eri(1, use_shell_pairs_));
     } else {
-        ints = std::shared_ptr<TwoBodyAOInt>(factory->erf_eri(omega, 1));
+        ints = std::shared_ptr<TwoBodyAOInt>(factory->erf_eri(omega, 1, use_shell_pairs_));
     }
 
     std::shared_ptr<BasisSet> bs1 = ints->basis1();
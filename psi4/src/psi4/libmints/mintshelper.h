@@ -68,6 +68,8 @@ class PSI_API MintsHelper {
 
     int print_;
     int nthread_;
+    /// Do the ERI and potential integral objects use the factory's cached primitive pairs?
+    bool use_shell_pairs_;
 
     std::map<std::pair<std::string, bool>, SharedMatrix> cached_oe_ints_;
 
@@ -132,6 +134,8 @@ class PSI_API MintsHelper {
     /// Sets the print level
     void set_print(int print) { print_ = print; }
     void set_nthread(int nthread) { nthread_ = nthread; }
+    /// Sets whether ERI and potential integrals use the cached, screened primitive pairs (default true)
+    void set_use_shell_pairs(bool use_shell_pairs) { use_shell_pairs_ = use_shell_pairs; }
 
     /// Returns petite list that is capable of transforming basis functions (nbf) to SO's.
     std::shared_ptr<PetiteList> petite_list() const;
@@ -72,6 +72,10 @@ MultipolePotentialInt::MultipolePotentialInt(std::vector<SphericalTransform> &sp
 
 MultipolePotentialInt::~MultipolePotentialInt() { delete[] buffer_; }
 
+OneBodyAOInt *MultipolePotentialInt::clone() const {
+    return clone_settings(new MultipolePotentialInt(spherical_transforms_, bs1_, bs2_, max_k_, deriv_));
+}
+
 void MultipolePotentialInt::compute_pair(const GaussianShell &s1, const GaussianShell &s2) {
     int ao12;
     int am1 = s1.am();
@@ -65,6 +65,9 @@ class MultipolePotentialInt : public OneBodyAOInt {
                           int max_k = 0, int deriv = 0);
     //! Virtual destructor
     ~MultipolePotentialInt() override;
+
+    bool cloneable() const override { return true; }
+    OneBodyAOInt* clone() const override;
 };
 
 }  // namespace psi
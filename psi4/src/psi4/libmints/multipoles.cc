@@ -53,13 +53,21 @@ MultipoleInt::MultipoleInt(std::vector<SphericalTransform> &spherical_transforms
     if (deriv_ == 0) {
         buffer_ = new double[n_mult * maxnao1 * maxnao2];
         set_chunks(n_mult);
+    } else if (deriv_ == 1) {
+        // x, y, z of center 1, then x, y, z of center 2, each holding all components
+        buffer_ = new double[6 * n_mult * maxnao1 * maxnao2];
+        set_chunks(6 * n_mult);
     } else {
-        throw PSIEXCEPTION("Derivatives are NYI for arbitrary-order multipoles");
+        throw PSIEXCEPTION("Second derivatives are NYI for arbitrary-order multipoles");
     }
 }
 
 MultipoleInt::~MultipoleInt() { delete[] buffer_; }
 
+OneBodyAOInt *MultipoleInt::clone() const {
+    return clone_settings(new MultipoleInt(spherical_transforms_, bs1_, bs2_, order_, deriv_));
+}
+
 SharedVector MultipoleInt::nuclear_contribution(std::shared_ptr<Molecule> mol, int order, const Vector3 &origin) {
     int ntot = (order + 1) * (order + 2) * (order + 3) / 6 - 1;
     auto sret = std::make_shared<Vector>(ntot);
@@ -217,3 +225,149 @@ void MultipoleInt::compute_pair(const GaussianShell &s1, const GaussianShell &s2
     delete[] Ypowers;
     delete[] Zpowers;
 }
+
+// The engine only supports segmented basis sets
+void MultipoleInt::compute_pair_deriv1(const GaussianShell &s1, const GaussianShell &s2) {
+    int am1 = s1.am();
+    int am2 = s2.am();
+    int nprim1 = s1.nprimitive();
+    int nprim2 = s2.nprimitive();
+
+    // The number of bf components in each shell pair, and of multipole components
+    int stride = INT_NCART(am1) * INT_NCART(am2);
+    int n_mult = (order_ + 1) * (order_ + 2) * (order_ + 3) / 6 - 1;
+
+    memset(buffer_, 0, nchunk_ * stride * sizeof(double));
+
+    // Moments of the undifferentiated and differentiated {x,y,z} factors
+    std::vector<double> powers(9 * (order_ + 1));
+    double *Xpowers = powers.data();
+    double *Ypowers = Xpowers + (order_ + 1);
+    double *Zpowers = Ypowers + (order_ + 1);
+    double *dXpowers[2] = {Zpowers + (order_ + 1), Zpowers + 4 * (order_ + 1)};
+    double *dYpowers[2] = {dXpowers[0] + (order_ + 1), dXpowers[1] + (order_ + 1)};
+    double *dZpowers[2] = {dYpowers[0] + (order_ + 1), dYpowers[1] + (order_ + 1)};
+    std::vector<double> source(order_ + 1);
+
+    double A[3], B[3];
+    A[0] = s1.center()[0];
+    A[1] = s1.center()[1];
+    A[2] = s1.center()[2];
+    B[0] = s2.center()[0];
+    B[1] = s2.center()[1];
+    B[2] = s2.center()[2];
+
+    // compute intermediates
+    double AB2 = 0.0;
+    AB2 += (A[0] - B[0]) * (A[0] - B[0]);
+    AB2 += (A[1] - B[1]) * (A[1] - B[1]);
+    AB2 += (A[2] - B[2]) * (A[2] - B[2]);
+
+    double ***x = mi_recur_.x();
+    double ***y = mi_recur_.y();
+    double ***z = mi_recur_.z();
+
+    // Expand X_C^l = (X_P + X_PC)^l over the moments m[k] about P, as in compute_pair
+    auto expand = [this](const double *m, double PC, double *out) {
+        out[0] = m[0];
+        for (int l = 1; l <= order_; ++l) {
+            double pc = PC;
+            out[l] = m[l] + pow(PC, l) * m[0];
+            for (int i = 1; i < l; ++i) {
+                out[l] += (double)binomial(l, i) * pc * m[l - i];
+                pc *= PC;
+            }
+        }
+    };
+    // Differentiating a Cartesian Gaussian factor gives 2a (l + 1) - l (l - 1) on the same center
+    auto differentiate = [this, &source](double ***r, int l1, int l2, double a, int center) -> const double * {
+        for (int k = 0; k <= order_; ++k) {
+            if (center == 0) {
+                source[k] = 2.0 * a * r[l1 + 1][l2][k] - (l1 ? l1 * r[l1 - 1][l2][k] : 0.0);
+            } else {
+                source[k] = 2.0 * a * r[l1][l2 + 1][k] - (l2 ? l2 * r[l1][l2 - 1][k] : 0.0);
+            }
+        }
+        return source.data();
+    };
+
+    for (int p1 = 0; p1 < nprim1; ++p1) {
+        double a1 = s1.exp(p1);
+        double c1 = s1.coef(p1);
+        for (int p2 = 0; p2 < nprim2; ++p2) {
+            double a2 = s2.exp(p2);
+            double c2 = s2.coef(p2);
+            double gamma = a1 + a2;
+            double oog = 1.0 / gamma;
+
+            double PA[3], PB[3];
+            double P[3];
+
+            P[0] = (a1 * A[0] + a2 * B[0]) * oog;
+            P[1] = (a1 * A[1] + a2 * B[1]) * oog;
+            P[2] = (a1 * A[2] + a2 * B[2]) * oog;
+            PA[0] = P[0] - A[0];
+            PA[1] = P[1] - A[1];
+            PA[2] = P[2] - A[2];
+            PB[0] = P[0] - B[0];
+            PB[1] = P[1] - B[1];
+            PB[2] = P[2] - B[2];
+            double PCx = (P[0] - origin_[0]);
+            double PCy = (P[1] - origin_[1]);
+            double PCz = (P[2] - origin_[2]);
+
+            double over_pf = exp(-a1 * a2 * AB2 * oog) * sqrt(M_PI * oog) * M_PI * oog * c1 * c2;
+
+            // Do recursion, one extra unit of angular momentum is needed on either center
+            mi_recur_.compute(PA, PB, gamma, am1 + 2, am2 + 2);
+            int bf = 0;
+
+            // Basis function A.M. components on center 1
+            for (int ii = 0; ii <= am1; ii++) {
+                int lx1 = am1 - ii;
+                for (int lz1 = 0; lz1 <= ii; lz1++) {
+                    int ly1 = ii - lz1;
+                    // Basis function A.M. components on center 2
+                    for (int kk = 0; kk <= am2; kk++) {
+                        int lx2 = am2 - kk;
+                        for (int lz2 = 0; lz2 <= kk; lz2++) {
+                            int ly2 = kk - lz2;
+
+                            expand(x[lx1][lx2], PCx, Xpowers);
+                            expand(y[ly1][ly2], PCy, Ypowers);
+                            expand(z[lz1][lz2], PCz, Zpowers);
+                            for (int center = 0; center < 2; ++center) {
+                                double a = (center == 0 ? a1 : a2);
+                                expand(differentiate(x, lx1, lx2, a, center), PCx, dXpowers[center]);
+                                expand(differentiate(y, ly1, ly2, a, center), PCy, dYpowers[center]);
+                                expand(differentiate(z, lz1, lz2, a, center), PCz, dZpowers[center]);
+                            }
+
+                            // Loop over the multipole components
+                            int chunk = 0;
+                            for (int l = 1; l <= order_; ++l) {
+                                for (int jj = 0; jj <= l; jj++) {
+                                    int lx = l - jj;
+                                    for (int lz = 0; lz <= jj; lz++) {
+                                        int ly = jj - lz;
+                                        for (int center = 0; center < 2; ++center) {
+                                            double *buf = buffer_ + (3 * center * n_mult + chunk) * stride + bf;
+                                            buf[0 * n_mult * stride] -=
+                                                dXpowers[center][lx] * Ypowers[ly] * Zpowers[lz] * over_pf;
+                                            buf[1 * n_mult * stride] -=
+                                                Xpowers[lx] * dYpowers[center][ly] * Zpowers[lz] * over_pf;
+                                            buf[2 * n_mult * stride] -=
+                                                Xpowers[lx] * Ypowers[ly] * dZpowers[center][lz] * over_pf;
+                                        }
+                                        ++chunk;
+                                    }
+                                }
+                            }
+                            bf++;
+                        }
+                    }  // End loop over shell 2 A.M. components
+                }
+            }  // End loop over shell 1 A.M. components
+        }      // End loop over shell 2 primitives
+    }          // End loop over shell 1 primitives
+}
@@ -51,7 +51,7 @@ class MultipoleInt : public OneBodyAOInt {
     void compute_pair(const GaussianShell &, const GaussianShell &) override;
 
     //! Computes the multipole derivative between two gaussian shells.
-    void compute_pair_deriv1(const GaussianShell &, const GaussianShell &) override { throw PSIEXCEPTION("NYI"); }
+    void compute_pair_deriv1(const GaussianShell &, const GaussianShell &) override;
 
     //! The order of multipole moment to compute
     int order_;
@@ -63,8 +63,11 @@ class MultipoleInt : public OneBodyAOInt {
     //! Virtual destructor
     ~MultipoleInt() override;
 
+    bool cloneable() const override { return true; }
+    OneBodyAOInt* clone() const override;
+
     //! Does the method provide first derivatives?
-    bool has_deriv1() override { return false; }
+    bool has_deriv1() override { return true; }
 
     /// Returns the nuclear contribution to the multipole moments, with angular momentum up to order
     static SharedVector nuclear_contribution(std::shared_ptr<Molecule> mol, int order, const Vector3 &origin);
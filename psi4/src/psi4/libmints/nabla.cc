@@ -60,6 +60,10 @@ NablaInt::NablaInt(std::vector<SphericalTransform>& spherical_transforms, std::s
 
 NablaInt::~NablaInt() { delete[] buffer_; }
 
+OneBodyAOInt *NablaInt::clone() const {
+    return clone_settings(new NablaInt(spherical_transforms_, bs1_, bs2_, deriv_));
+}
+
 // The engine only supports segmented basis sets
 void NablaInt::compute_pair(const GaussianShell& s1, const GaussianShell& s2) {
     int ao12;
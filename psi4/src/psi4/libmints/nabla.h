@@ -63,6 +63,9 @@ class NablaInt : public OneBodyAOInt {
     //! Virtual destructor
     ~NablaInt() override;
 
+    bool cloneable() const override { return true; }
+    OneBodyAOInt* clone() const override;
+
     //! Does the method provide first derivatives?
     bool has_deriv1() override { return true; }
 };
@@ -48,6 +48,7 @@
 #include "psi4/libmints/pointgrp.h"
 #include "psi4/libmints/electricfield.h"
 #include "psi4/libmints/electrostatic.h"
+#include "psi4/libmints/gridesp.h"
 #include "psi4/libmints/petitelist.h"
 #include "psi4/libmints/multipoles.h"
 #include "psi4/libmints/dipole.h"
@@ -1012,49 +1013,19 @@ ESPPropCalc::~ESPPropCalc() {}
 
 void OEProp::compute_esp_over_grid() { epc_.compute_esp_over_grid(true); }
 
-void ESPPropCalc::compute_esp_over_grid(bool print_output) {
-    std::shared_ptr<Molecule> mol = basisset_->molecule();
-
-    std::shared_ptr<ElectrostaticInt> epot(dynamic_cast<ElectrostaticInt*>(integral_->electrostatic()));
-
-    if (print_output) {
-        outfile->Printf("\n Electrostatic potential computed on the grid and written to grid_esp.dat\n");
-    }
-
-    SharedMatrix Dtot = wfn_->matrix_subset_helper(Da_so_, Ca_so_, "AO", "D");
-    if (same_dens_) {
-        Dtot->scale(2.0);
-    } else {
-        Dtot->add(wfn_->matrix_subset_helper(Db_so_, Cb_so_, "AO", "D beta"));
-    }
+SharedMatrix ESPPropCalc::read_grid(const std::string& filename) const {
+    std::vector<Vector3> points;
+    GridIterator griditer(filename);
+    for (griditer.first(); !griditer.last(); griditer.next()) points.push_back(griditer.gridpoints());
 
-    int nbf = basisset_->nbf();
-    auto ints = std::make_shared<Matrix>("Ex integrals", nbf, nbf);
-
-    Vvals_.clear();
-    FILE* gridout = fopen("grid_esp.dat", "w");
-    if (!gridout) throw PSIEXCEPTION("Unable to write to grid_esp.dat");
-    GridIterator griditer("grid.dat");
-    for (griditer.first(); !griditer.last(); griditer.next()) {
-        Vector3 origin(griditer.gridpoints());
-        if (mol->units() == Molecule::Angstrom) origin /= pc_bohr2angstroms;
-        ints->zero();
-        epot->compute(ints, origin);
-        double Velec = Dtot->vector_dot(ints);
-        double Vnuc = 0.0;
-        int natom = mol->natom();
-        for (int i = 0; i < natom; i++) {
-            Vector3 dR = origin - mol->xyz(i);
-            double r = dR.norm();
-            if (r > 1.0E-8) Vnuc += mol->Z(i) / r;
-        }
-        Vvals_.push_back(Velec + Vnuc);
-        fprintf(gridout, "%16.10f\n", Velec + Vnuc);
+    auto grid = std::make_shared<Matrix>("Grid", points.size(), 3);
+    for (size_t i = 0; i < points.size(); i++) {
+        for (int k = 0; k < 3; k++) grid->set(i, k, points[i][k]);
     }
-    fclose(gridout);
+    return grid;
 }
 
-SharedVector ESPPropCalc::compute_esp_over_grid_in_memory(SharedMatrix input_grid) const {
+SharedMatrix ESPPropCalc::compute_esp_and_field(SharedMatrix input_grid, bool field) const {
     // We only want a plain matrix to work with here:
     if (input_grid->nirrep() != 1) {
         throw PSIEXCEPTION("ESPPropCalc only allows \"plain\" input matrices with, i.e. nirrep == 1.");
@@ -1063,12 +1034,7 @@ SharedVector ESPPropCalc::compute_esp_over_grid_in_memory(SharedMatrix input_gri
         throw PSIEXCEPTION("ESPPropCalc only allows \"plain\" input matrices with a dimension of N (rows) x 3 (cols)");
     }
 
-    int number_of_grid_points = input_grid->rowdim();
-    SharedVector output = std::make_shared<Vector>(number_of_grid_points);
-
     std::shared_ptr<Molecule> mol = basisset_->molecule();
-    std::shared_ptr<ElectrostaticInt> epot(dynamic_cast<ElectrostaticInt*>(integral_->electrostatic()));
-
     SharedMatrix Dtot = wfn_->matrix_subset_helper(Da_so_, Ca_so_, "AO", "D");
     if (same_dens_) {
         Dtot->scale(2.0);
@@ -1076,55 +1042,69 @@ SharedVector ESPPropCalc::compute_esp_over_grid_in_memory(SharedMatrix input_gri
         Dtot->add(wfn_->matrix_subset_helper(Db_so_, Cb_so_, "AO", "D beta"));
     }
 
-    int const nbf = basisset_->nbf();
+    auto grid = input_grid->clone();
+    if (mol->units() == Molecule::Angstrom) grid->scale(1.0 / pc_bohr2angstroms);
 
-    bool convert = mol->units() == Molecule::Angstrom;
+    // Electronic part, from the density contracted once into Hermite coefficients
+    GridESP esp(basisset_, Dtot);
+    SharedMatrix result = esp.compute(grid, field);
+    double** Rp = result->pointer();
+    double** Gp = grid->pointer();
 
-    for (int i = 0; i < number_of_grid_points; ++i) {
-        Vector3 origin(input_grid->get(i, 0), input_grid->get(i, 1), input_grid->get(i, 2));
-        if (convert) origin /= pc_bohr2angstroms;
-        auto ints = std::make_shared<Matrix>(nbf, nbf);
-        ints->zero();
-        epot->compute(ints, origin);
-        double Velec = Dtot->vector_dot(ints);
-        double Vnuc = 0.0;
-        int natom = mol->natom();
+    // Nuclear part
+    int natom = mol->natom();
+    for (int i = 0; i < grid->rowdim(); ++i) {
         for (int iat = 0; iat < natom; iat++) {
-            Vector3 dR = origin - mol->xyz(iat);
+            Vector3 dR = Vector3(Gp[i]) - mol->xyz(iat);
             double r = dR.norm();
-            if (r > 1.0E-8) Vnuc += mol->Z(iat) / r;
+            // This allows us to compute the potential and field at the nuclei correctly
+            if (r < 1.0E-8) continue;
+            Rp[i][0] += mol->Z(iat) / r;
+            if (field) {
+                for (int k = 0; k < 3; k++) Rp[i][k + 1] += mol->Z(iat) * dR[k] / (r * r * r);
+            }
         }
-        double Vtot = Velec + Vnuc;
-        (*output)[i] = Vtot;
     }
+    return result;
+}
+
+void ESPPropCalc::compute_esp_over_grid(bool print_output) {
+    if (print_output) {
+        outfile->Printf("\n Electrostatic potential computed on the grid and written to grid_esp.dat\n");
+    }
+
+    SharedMatrix esp = compute_esp_and_field(read_grid("grid.dat"), false);
+
+    Vvals_.clear();
+    FILE* gridout = fopen("grid_esp.dat", "w");
+    if (!gridout) throw PSIEXCEPTION("Unable to write to grid_esp.dat");
+    for (int i = 0; i < esp->rowdim(); i++) {
+        Vvals_.push_back(esp->get(i, 0));
+        fprintf(gridout, "%16.10f\n", esp->get(i, 0));
+    }
+    fclose(gridout);
+}
+
+SharedVector ESPPropCalc::compute_esp_over_grid_in_memory(SharedMatrix input_grid) const {
+    SharedMatrix esp = compute_esp_and_field(input_grid, false);
+    auto output = std::make_shared<Vector>(esp->rowdim());
+    for (int i = 0; i < esp->rowdim(); ++i) (*output)[i] = esp->get(i, 0);
     return output;
 }
 
+SharedMatrix ESPPropCalc::compute_esp_and_field_over_grid_in_memory(SharedMatrix input_grid) const {
+    return compute_esp_and_field(input_grid, true);
+}
+
 void OEProp::compute_field_over_grid() { epc_.compute_field_over_grid(true); }
 
 void ESPPropCalc::compute_field_over_grid(bool print_output) {
-    std::shared_ptr<Molecule> mol = basisset_->molecule();
-
-    std::shared_ptr<ElectrostaticInt> epot(dynamic_cast<ElectrostaticInt*>(integral_->electrostatic()));
-
     if (print_output) {
         outfile->Printf("\n Field computed on the grid and written to grid_field.dat\n");
     }
 
-    SharedMatrix Dtot = wfn_->matrix_subset_helper(Da_so_, Ca_so_, "AO", "D");
-    if (same_dens_) {
-        Dtot->scale(2.0);
-    } else {
-        Dtot->add(wfn_->matrix_subset_helper(Db_so_, Cb_so_, "AO", "D beta"));
-    }
-
-    std::shared_ptr<ElectricFieldInt> field_ints(dynamic_cast<ElectricFieldInt*>(wfn_->integral()->electric_field()));
-
-    int nbf = basisset_->nbf();
-    std::vector<SharedMatrix> intmats;
-    intmats.push_back(std::make_shared<Matrix>("Ex integrals", nbf, nbf));
-    intmats.push_back(std::make_shared<Matrix>("Ey integrals", nbf, nbf));
-    intmats.push_back(std::make_shared<Matrix>("Ez integrals", nbf, nbf));
+    SharedMatrix esp = compute_esp_and_field(read_grid("grid.dat"), true);
+    double** Ep = esp->pointer();
 
     Exvals_.clear();
     Eyvals_.clear();
@@ -1132,21 +1112,11 @@ void ESPPropCalc::compute_field_over_grid(bool print_output) {
 
     FILE* gridout = fopen("grid_field.dat", "w");
     if (!gridout) throw PSIEXCEPTION("Unable to write to grid_field.dat");
-    GridIterator griditer("grid.dat");
-    for (griditer.first(); !griditer.last(); griditer.next()) {
-        Vector3 origin(griditer.gridpoints());
-        if (mol->units() == Molecule::Angstrom) origin /= pc_bohr2angstroms;
-        field_ints->set_origin(origin);
-        for (int m = 0; m < 3; ++m) intmats[m]->zero();
-        field_ints->compute(intmats);
-        double Ex = Dtot->vector_dot(intmats[0]);
-        double Ey = Dtot->vector_dot(intmats[1]);
-        double Ez = Dtot->vector_dot(intmats[2]);
-        Vector3 nuc = field_ints->nuclear_contribution(origin, mol);
-        Exvals_.push_back(Ex + nuc[0]);
-        Eyvals_.push_back(Ey + nuc[1]);
-        Ezvals_.push_back(Ez + nuc[2]);
-        fprintf(gridout, "%16.10f %16.10f %16.10f\n", Ex + nuc[0], Ey + nuc[1], Ez + nuc[2]);
+    for (int i = 0; i < esp->rowdim(); i++) {
+        Exvals_.push_back(Ep[i][1]);
+        Eyvals_.push_back(Ep[i][2]);
+        Ezvals_.push_back(Ep[i][3]);
+        fprintf(gridout, "%16.10f %16.10f %16.10f\n", Ep[i][1], Ep[i][2], Ep[i][3]);
     }
     fclose(gridout);
 }
@@ -357,6 +357,11 @@ class ESPPropCalc : public Prop {
     std::vector<double> Eyvals_;
     std::vector<double> Ezvals_;
 
+    /// Read an N x 3 grid of points from a file, one point per line
+    SharedMatrix read_grid(const std::string& filename) const;
+    /// Total potential (column 0) and, if requested, field (columns 1-3) at each row of input_grid
+    SharedMatrix compute_esp_and_field(SharedMatrix input_grid, bool field) const;
+
    public:
     /// Constructor
     ESPPropCalc(std::shared_ptr<Wavefunction> wfn);
@@ -378,6 +383,8 @@ class ESPPropCalc : public Prop {
     void compute_field_over_grid(bool print_output = false);
     /// Compute electrostatic potential at grid points based on input grid, OpenMP version. input_grid is Nx3
     SharedVector compute_esp_over_grid_in_memory(SharedMatrix input_grid) const;
+    /// Compute electrostatic potential (column 0) and field (columns 1-3) at grid points, input_grid is Nx3
+    SharedMatrix compute_esp_and_field_over_grid_in_memory(SharedMatrix input_grid) const;
 };
 
 /**
@@ -31,8 +31,12 @@
 #include "psi4/libmints/basisset.h"
 #include "psi4/libmints/matrix.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
 
 #include <stdexcept>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace psi {
 
@@ -109,6 +113,21 @@ OneBodyAOInt *OneBodyAOInt::clone() const {
     throw FeatureNotImplemented("libmints", "OneBodyInt::clone()", __FILE__, __LINE__);
 }
 
+OneBodyAOInt *OneBodyAOInt::clone_settings(OneBodyAOInt *clone) const {
+    clone->origin_ = origin_;
+    clone->force_cartesian_ = force_cartesian_;
+    clone->pairs_ = pairs_;
+    return clone;
+}
+
+int OneBodyAOInt::compute_nthread() const {
+    int nthread = 1;
+#ifdef _OPENMP
+    if (cloneable() && !omp_in_parallel()) nthread = Process::environment.get_n_threads();
+#endif
+    return nthread;
+}
+
 void OneBodyAOInt::normalize_am(const GaussianShell & /*s1*/, const GaussianShell & /*s2*/, int /*nchunk*/) {
     // ACS removed this; the normalize function just returns 1.0
     //    // Integrals are done. Normalize for angular momentum
@@ -238,45 +257,11 @@ void OneBodyAOInt::compute_shell_deriv1(int sh1, int sh2) {
 }
 
 void OneBodyAOInt::compute(SharedMatrix &result) {
-    // Do not worry about zeroing out result
-    int ns1 = bs1_->nshell();
-    int ns2 = bs2_->nshell();
-
-    int i_offset = 0;
-    double *location;
-
-    // Leave as this full double for loop. We could be computing nonsymmetric integrals
-    for (int i = 0; i < ns1; ++i) {
-        int ni = force_cartesian_ ? bs1_->shell(i).ncartesian() : bs1_->shell(i).nfunction();
-        int j_offset = 0;
-        for (int j = 0; j < ns2; ++j) {
-            int nj = force_cartesian_ ? bs2_->shell(j).ncartesian() : bs2_->shell(j).nfunction();
-
-            // Compute the shell (automatically transforms to pure am in needed)
-            compute_shell(i, j);
-
-            // For each integral that we got put in its contribution
-            location = buffer_;
-            for (int p = 0; p < ni; ++p) {
-                for (int q = 0; q < nj; ++q) {
-                    result->add(0, i_offset + p, j_offset + q, *location);
-                    location++;
-                }
-            }
-
-            j_offset += nj;
-        }
-        i_offset += ni;
-    }
+    std::vector<SharedMatrix> results(1, result);
+    compute_chunks(results, 1);
 }
 
 void OneBodyAOInt::compute(std::vector<SharedMatrix> &result) {
-    // Do not worry about zeroing out result
-    int ns1 = bs1_->nshell();
-    int ns2 = bs2_->nshell();
-    int i_offset = 0;
-    double *location = 0;
-
     // Check the length of result, must be chunk
     // There not an easy way of checking the size now.
     if (result.size() != (size_t)nchunk_) {
@@ -292,28 +277,64 @@ void OneBodyAOInt::compute(std::vector<SharedMatrix> &result) {
         }
     }
 
+    compute_chunks(result, nchunk_);
+}
+
+void OneBodyAOInt::compute_chunks(std::vector<SharedMatrix> &result, int nchunk) {
+    // Do not worry about zeroing out result
+    int ns1 = bs1_->nshell();
+    int ns2 = bs2_->nshell();
+
+    std::vector<int> i_offsets(ns1 + 1, 0);
+    for (int i = 0; i < ns1; ++i) {
+        const GaussianShell &shell = bs1_->shell(i);
+        i_offsets[i + 1] = i_offsets[i] + (force_cartesian_ ? shell.ncartesian() : shell.nfunction());
+    }
+    std::vector<int> j_offsets(ns2 + 1, 0);
+    for (int j = 0; j < ns2; ++j) {
+        const GaussianShell &shell = bs2_->shell(j);
+        j_offsets[j + 1] = j_offsets[j] + (force_cartesian_ ? shell.ncartesian() : shell.nfunction());
+    }
+
+    // One engine per thread, this object serves thread 0
+    int nthread = compute_nthread();
+    std::vector<std::shared_ptr<OneBodyAOInt>> clones;
+    std::vector<OneBodyAOInt *> engines(1, this);
+    for (int thread = 1; thread < nthread; ++thread) {
+        clones.push_back(std::shared_ptr<OneBodyAOInt>(clone()));
+        engines.push_back(clones.back().get());
+    }
+
+    // Leave as this full double loop. We could be computing nonsymmetric integrals.
+    // Each shell row writes its own block of rows, so the threads never overlap.
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
     for (int i = 0; i < ns1; ++i) {
-        int ni = force_cartesian_ ? bs1_->shell(i).ncartesian() : bs1_->shell(i).nfunction();
-        int j_offset = 0;
+        int rank = 0;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        OneBodyAOInt *engine = engines[rank];
+        int i_offset = i_offsets[i];
+        int ni = i_offsets[i + 1] - i_offset;
         for (int j = 0; j < ns2; ++j) {
-            int nj = force_cartesian_ ? bs2_->shell(j).ncartesian() : bs2_->shell(j).nfunction();
+            int j_offset = j_offsets[j];
+            int nj = j_offsets[j + 1] - j_offset;
 
-            // Compute the shell
-            compute_shell(i, j);
+            // Compute the shell (automatically transforms to pure am in needed)
+            engine->compute_shell(i, j);
 
             // For each integral that we got put in its contribution
-            location = buffer_;
-            for (int r = 0; r < nchunk_; ++r) {
+            const double *location = engine->buffer();
+            for (int r = 0; r < nchunk; ++r) {
+                double **resultp = result[r]->pointer();
                 for (int p = 0; p < ni; ++p) {
                     for (int q = 0; q < nj; ++q) {
-                        result[r]->add(0, i_offset + p, j_offset + q, *location);
+                        resultp[i_offset + p][j_offset + q] += *location;
                         location++;
                     }
                 }
             }
-            j_offset += nj;
         }
-        i_offset += ni;
     }
 }
 
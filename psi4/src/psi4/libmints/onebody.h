@@ -47,6 +47,7 @@ namespace psi {
 class BasisSet;
 class GaussianShell;
 class SphericalTransform;
+class ShellPairCache;
 
 /*! \ingroup MINTS
  *  \class OneBodyInt
@@ -75,6 +76,9 @@ class PSI_API OneBodyAOInt {
 
     int buffer_size_;
 
+    /// Cached primitive pair data of (bs1_, bs2_), if the engine was given one
+    std::shared_ptr<ShellPairCache> pairs_;
+
     OneBodyAOInt(std::vector<SphericalTransform>&, std::shared_ptr<BasisSet> bs1, std::shared_ptr<BasisSet> bs2,
                  int deriv = 0);
 
@@ -88,6 +92,12 @@ class PSI_API OneBodyAOInt {
     /// Normalize Cartesian functions based on angular momentum
     void normalize_am(const GaussianShell&, const GaussianShell&, int nchunk = 1);
 
+    /// Compute all shell pairs into the first nchunk matrices of result, threaded over shell rows
+    void compute_chunks(std::vector<SharedMatrix>& result, int nchunk);
+
+    /// Copy the origin and Cartesian forcing of this object into a new clone, returns the clone
+    OneBodyAOInt* clone_settings(OneBodyAOInt* clone) const;
+
    public:
     virtual ~OneBodyAOInt();
 
@@ -104,6 +114,9 @@ class PSI_API OneBodyAOInt {
     /// Sets whether we're forcing this object to always generate Cartesian integrals
     void set_force_cartesian(bool t_f) { force_cartesian_ = t_f; }
 
+    /// Hands the engine precomputed primitive pair data of (basis1, basis2); engines that can use it will
+    void set_shell_pairs(std::shared_ptr<ShellPairCache> pairs) { pairs_ = pairs; }
+
     /// Buffer where the integrals are placed.
     const double* buffer() const;
 
@@ -111,7 +124,8 @@ class PSI_API OneBodyAOInt {
     void compute_shell(int, int);
 
     /*! @{
-     * Computes all integrals and stores them in result
+     * Computes all integrals and stores them in result, threaded over
+     * shell pairs with one clone per thread (see compute_nthread)
      * @param result Shared matrix object that will hold the results.
      */
     void compute(SharedMatrix& result);
@@ -146,6 +160,10 @@ class PSI_API OneBodyAOInt {
     /// Returns a clone of this object. By default throws an exception.
     virtual OneBodyAOInt* clone() const;
 
+    /// Number of threads compute() spreads the shell pairs over: the process
+    /// thread count if cloneable and not already in a parallel region, else 1
+    int compute_nthread() const;
+
     /// Returns the origin (useful for properties)
     Vector3 origin() const { return origin_; }
 
@@ -1453,6 +1453,22 @@ void ObaraSaikaTwoCenterVIRecursion::calculate_f(double *F, int n, double t) {
 }
 
 void ObaraSaikaTwoCenterVIRecursion::compute(double PA[3], double PB[3], double PC[3], double zeta, int am1, int am2) {
+    int mmax = max_am1_ + max_am2_;
+
+    // U from A21
+    double u = zeta * (PC[0] * PC[0] + PC[1] * PC[1] + PC[2] * PC[2]);
+    auto *F = new double[mmax + 1];
+
+    // Form Fm(U) from A20
+    calculate_f(F, mmax, u);
+
+    compute_given_f(PA, PB, PC, zeta, am1, am2, F, 1);
+
+    delete[] F;
+}
+
+void ObaraSaikaTwoCenterVIRecursion::compute_given_f(double PA[3], double PB[3], double PC[3], double zeta, int am1,
+                                                     int am2, const double *F, size_t stride) {
     int a, b, m;
     int azm = 1;
     int aym = am1 + 1;
@@ -1467,19 +1483,13 @@ void ObaraSaikaTwoCenterVIRecursion::compute(double PA[3], double PB[3], double
 
     // Prefactor from A20
     double tmp = sqrt(zeta) * M_2_SQRTPI;
-    // U from A21
-    double u = zeta * (PC[0] * PC[0] + PC[1] * PC[1] + PC[2] * PC[2]);
-    auto *F = new double[mmax + 1];
-
-    // Form Fm(U) from A20
-    calculate_f(F, mmax, u);
 
     // Think we're having problems with values being left over.
     // zero_box(vi_, size_, size_, mmax + 1);
 
     // Perform recursion in m for (a|A(0)|s) using A20
     for (m = 0; m <= mmax; ++m) {
-        vi_[0][0][m] = tmp * F[m];
+        vi_[0][0][m] = tmp * F[m * stride];
     }
 
     // Perform recursion in b with a=0
@@ -1610,8 +1620,6 @@ void ObaraSaikaTwoCenterVIRecursion::compute(double PA[3], double PB[3], double
             }
         }
     }
-
-    delete[] F;
 }
 
 void ObaraSaikaTwoCenterVIRecursion::compute_erf(double PA[3], double PB[3], double PC[3], double zeta, int am1,
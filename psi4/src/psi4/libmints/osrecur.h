@@ -137,8 +137,14 @@ class ObaraSaikaTwoCenterVIRecursion {
     virtual double ***vyz() const { return nullptr; }
     virtual double ***vzz() const { return nullptr; }
 
+    /// Highest Boys function order the recursion needs, F_m(U) for 0 <= m <= max_m()
+    int max_m() const { return max_am1_ + max_am2_; }
+
     /// Computes the potential integral 3D matrix using the data provided.
     virtual void compute(double PA[3], double PB[3], double PC[3], double zeta, int am1, int am2);
+    /// Computes the potential integral 3D matrix (vi only) from precomputed F_m(U), read as F[m * stride]
+    void compute_given_f(double PA[3], double PB[3], double PC[3], double zeta, int am1, int am2, const double *F,
+                         size_t stride);
     /// Computes the Ewald potential integral with modified zeta -> zetam 3D matrix using the data provided.
     virtual void compute_erf(double PA[3], double PB[3], double PC[3], double zeta, int am1, int am2, double zetam);
 };
@@ -68,6 +68,10 @@ OverlapInt::OverlapInt(std::vector<SphericalTransform> &st, std::shared_ptr<Basi
 
 OverlapInt::~OverlapInt() { delete[] buffer_; }
 
+OneBodyAOInt *OverlapInt::clone() const {
+    return clone_settings(new OverlapInt(spherical_transforms_, bs1_, bs2_, deriv_));
+}
+
 // The engine only supports segmented basis sets
 void OverlapInt::compute_pair(const GaussianShell &s1, const GaussianShell &s2) {
     int ao12;
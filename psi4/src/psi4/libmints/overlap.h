@@ -58,6 +58,9 @@ class OverlapInt : public OneBodyAOInt {
     OverlapInt(std::vector<SphericalTransform>&, std::shared_ptr<BasisSet>, std::shared_ptr<BasisSet>, int deriv = 0);
     ~OverlapInt() override;
 
+    bool cloneable() const override { return true; }
+    OneBodyAOInt* clone() const override;
+
     /// Does the method provide first derivatives?
     bool has_deriv1() override { return true; }
     /// Does the method provide second derivatives?
@@ -29,6 +29,7 @@
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/libmints/cdsalclist.h"
 #include "psi4/libmints/potential.h"
+#include "psi4/libmints/fjt.h"
 #include "psi4/libmints/integral.h"
 #include "psi4/libmints/basisset.h"
 #include "psi4/libmints/matrix.h"
@@ -56,6 +57,8 @@ PotentialInt::PotentialInt(std::vector<SphericalTransform> &st, std::shared_ptr<
         potential_recur_ = new ObaraSaikaTwoCenterVIDeriv2Recursion(bs1->max_am() + 3, bs2->max_am() + 3);
     else
         throw PSIEXCEPTION("PotentialInt: deriv > 2 is not supported.");
+    // The +1 is needed for the Taylor interpolation of the highest order, as in ERI
+    fjt_ = new Taylor_Fjt(potential_recur_->max_m() + 1, 1.0e-15);
 
     const int maxam1 = bs1_->max_am();
     const int maxam2 = bs2_->max_am();
@@ -93,6 +96,13 @@ PotentialInt::PotentialInt(std::vector<SphericalTransform> &st, std::shared_ptr<
 PotentialInt::~PotentialInt() {
     delete[] buffer_;
     delete potential_recur_;
+    delete fjt_;
+}
+
+OneBodyAOInt *PotentialInt::clone() const {
+    auto *clone = new PotentialInt(spherical_transforms_, bs1_, bs2_, deriv_);
+    clone->set_charge_field(Zxyz_);
+    return clone_settings(clone);
 }
 
 // The engine only supports segmented basis sets
@@ -100,15 +110,6 @@ void PotentialInt::compute_pair(const GaussianShell &s1, const GaussianShell &s2
     int ao12;
     int am1 = s1.am();
     int am2 = s2.am();
-    int nprim1 = s1.nprimitive();
-    int nprim2 = s2.nprimitive();
-    double A[3], B[3];
-    A[0] = s1.center()[0];
-    A[1] = s1.center()[1];
-    A[2] = s1.center()[2];
-    B[0] = s2.center()[0];
-    B[1] = s2.center()[1];
-    B[2] = s2.center()[2];
 
     int izm = 1;
     int iym = am1 + 1;
@@ -117,12 +118,6 @@ void PotentialInt::compute_pair(const GaussianShell &s1, const GaussianShell &s2
     int jym = am2 + 1;
     int jxm = jym * jym;
 
-    // compute intermediates
-    double AB2 = 0.0;
-    AB2 += (A[0] - B[0]) * (A[0] - B[0]);
-    AB2 += (A[1] - B[1]) * (A[1] - B[1]);
-    AB2 += (A[2] - B[2]) * (A[2] - B[2]);
-
     memset(buffer_, 0, s1.ncartesian() * s2.ncartesian() * sizeof(double));
 
     double ***vi = potential_recur_->vi();
@@ -130,67 +125,83 @@ void PotentialInt::compute_pair(const GaussianShell &s1, const GaussianShell &s2
     double **Zxyzp = Zxyz_->pointer();
     int ncharge = Zxyz_->rowspi()[0];
 
-    for (int p1 = 0; p1 < nprim1; ++p1) {
-        double a1 = s1.exp(p1);
-        double c1 = s1.coef(p1);
-        for (int p2 = 0; p2 < nprim2; ++p2) {
-            double a2 = s2.exp(p2);
-            double c2 = s2.coef(p2);
-            double gamma = a1 + a2;
-            double oog = 1.0 / gamma;
+    const int mmax = potential_recur_->max_m();
+    if (boys_T_.size() < (size_t)ncharge) {
+        boys_T_.resize(ncharge);
+        boys_F_.resize((mmax + 1) * (size_t)ncharge);
+    }
 
-            double PA[3], PB[3];
-            double P[3];
+    // Primitive pairs, from the shared cache when one was set
+    int npair;
+    bool swapped = false;
+    const ShellPairCache::PrimitivePair *pairs;
+    if (pairs_) {
+        pairs = pairs_->pairs(bs1_, bs2_, bs1_->function_to_shell(s1.function_index()),
+                              bs2_->function_to_shell(s2.function_index()), npair, swapped);
+    } else {
+        pair_scratch_.clear();
+        npair = ShellPairCache::append_pairs(s1, s2, 0.0, pair_scratch_);
+        pairs = pair_scratch_.data();
+    }
 
-            P[0] = (a1 * A[0] + a2 * B[0]) * oog;
-            P[1] = (a1 * A[1] + a2 * B[1]) * oog;
-            P[2] = (a1 * A[2] + a2 * B[2]) * oog;
-            PA[0] = P[0] - A[0];
-            PA[1] = P[1] - A[1];
-            PA[2] = P[2] - A[2];
-            PB[0] = P[0] - B[0];
-            PB[1] = P[1] - B[1];
-            PB[2] = P[2] - B[2];
+    for (int p = 0; p < npair; ++p) {
+        const ShellPairCache::PrimitivePair &pair = pairs[p];
+        double gamma = pair.gamma;
 
-            double over_pf = exp(-a1 * a2 * AB2 * oog) * sqrt(M_PI * oog) * M_PI * oog * c1 * c2;
+        double PA[3], PB[3];
+        const double *P = pair.P;
+        for (int x = 0; x < 3; ++x) {
+            PA[x] = swapped ? pair.PB[x] : pair.PA[x];
+            PB[x] = swapped ? pair.PA[x] : pair.PB[x];
+        }
 
-            // Loop over atoms of basis set 1 (only works if bs1_ and bs2_ are on the same
-            // molecule)
-            for (int atom = 0; atom < ncharge; ++atom) {
-                double PC[3];
+        double over_pf = pair.K;
 
-                double Z = Zxyzp[atom][0];
+        // F_m(U) for all charges at once, U = gamma |PC|^2 (A21)
+        for (int atom = 0; atom < ncharge; ++atom) {
+            const double PCx = P[0] - Zxyzp[atom][1];
+            const double PCy = P[1] - Zxyzp[atom][2];
+            const double PCz = P[2] - Zxyzp[atom][3];
+            boys_T_[atom] = gamma * (PCx * PCx + PCy * PCy + PCz * PCz);
+        }
+        fjt_->values(mmax, boys_T_.data(), ncharge, boys_F_.data());
 
-                PC[0] = P[0] - Zxyzp[atom][1];
-                PC[1] = P[1] - Zxyzp[atom][2];
-                PC[2] = P[2] - Zxyzp[atom][3];
+        // Loop over atoms of basis set 1 (only works if bs1_ and bs2_ are on the same
+        // molecule)
+        for (int atom = 0; atom < ncharge; ++atom) {
+            double PC[3];
 
-                // Do recursion
-                potential_recur_->compute(PA, PB, PC, gamma, am1, am2);
+            double Z = Zxyzp[atom][0];
 
-                ao12 = 0;
-                for (int ii = 0; ii <= am1; ii++) {
-                    int l1 = am1 - ii;
-                    for (int jj = 0; jj <= ii; jj++) {
-                        int m1 = ii - jj;
-                        int n1 = jj;
-                        /*--- create all am components of sj ---*/
-                        for (int kk = 0; kk <= am2; kk++) {
-                            int l2 = am2 - kk;
-                            for (int ll = 0; ll <= kk; ll++) {
-                                int m2 = kk - ll;
-                                int n2 = ll;
+            PC[0] = P[0] - Zxyzp[atom][1];
+            PC[1] = P[1] - Zxyzp[atom][2];
+            PC[2] = P[2] - Zxyzp[atom][3];
 
-                                // Compute location in the recursion
-                                int iind = l1 * ixm + m1 * iym + n1 * izm;
-                                int jind = l2 * jxm + m2 * jym + n2 * jzm;
+            // Do recursion
+            potential_recur_->compute_given_f(PA, PB, PC, gamma, am1, am2, boys_F_.data() + atom, ncharge);
 
-                                buffer_[ao12++] += -vi[iind][jind][0] * over_pf * Z;
+            ao12 = 0;
+            for (int ii = 0; ii <= am1; ii++) {
+                int l1 = am1 - ii;
+                for (int jj = 0; jj <= ii; jj++) {
+                    int m1 = ii - jj;
+                    int n1 = jj;
+                    /*--- create all am components of sj ---*/
+                    for (int kk = 0; kk <= am2; kk++) {
+                        int l2 = am2 - kk;
+                        for (int ll = 0; ll <= kk; ll++) {
+                            int m2 = kk - ll;
+                            int n2 = ll;
 
-                                //                                outfile->Printf( "ao12=%d, vi[%d][%d][0] = %20.14f,
-                                //                                over_pf = %20.14f, Z = %f\n", ao12-1, iind, jind,
-                                //                                vi[iind][jind][0], over_pf, Z);
-                            }
+                            // Compute location in the recursion
+                            int iind = l1 * ixm + m1 * iym + n1 * izm;
+                            int jind = l2 * jxm + m2 * jym + n2 * jzm;
+
+                            buffer_[ao12++] += -vi[iind][jind][0] * over_pf * Z;
+
+                            //                                outfile->Printf( "ao12=%d, vi[%d][%d][0] = %20.14f,
+                            //                                over_pf = %20.14f, Z = %f\n", ao12-1, iind, jind,
+                            //                                vi[iind][jind][0], over_pf, Z);
                         }
                     }
                 }
@@ -34,6 +34,7 @@
 #include "psi4/libmints/onebody.h"
 #include "psi4/libmints/sointegral_onebody.h"
 #include "psi4/libmints/osrecur.h"
+#include "psi4/libmints/shellpaircache.h"
 
 namespace psi {
 class BasisSet;
@@ -41,6 +42,7 @@ class GaussianShell;
 class IntegralFactory;
 class SphericalTransform;
 class CdSalcList;
+class Fjt;
 
 /*! \ingroup MINTS
  *  \class PotentialInt
@@ -62,11 +64,23 @@ class PotentialInt : public OneBodyAOInt {
     /// Matrix of coordinates/charges of partial charges
     SharedMatrix Zxyz_;
 
+    /// Primitive pairs of the current shell pair when no shared cache was set
+    std::vector<ShellPairCache::PrimitivePair> pair_scratch_;
+
+    /// Boys function engine, F_m(U) of every charge of a primitive pair is evaluated in one batched call
+    Fjt* fjt_;
+    /// U and F_m(U) (as F[m * ncharge + charge]) of the current primitive pair
+    std::vector<double> boys_T_;
+    std::vector<double> boys_F_;
+
    public:
     /// Constructor. Assumes nuclear centers/charges as the potential
     PotentialInt(std::vector<SphericalTransform>&, std::shared_ptr<BasisSet>, std::shared_ptr<BasisSet>, int deriv = 0);
     ~PotentialInt() override;
 
+    bool cloneable() const override { return true; }
+    OneBodyAOInt* clone() const override;
+
     /// Computes the first derivatives and stores them in result
     void compute_deriv1(std::vector<SharedMatrix>& result) override;
 
@@ -39,4 +39,10 @@ PCMPotentialInt::PCMPotentialInt(std::vector<SphericalTransform>& trans, std::sh
     force_cartesian_ = true;
 }
 
+OneBodyAOInt* PCMPotentialInt::clone() const {
+    auto* clone = new PCMPotentialInt(spherical_transforms_, bs1_, bs2_, deriv_);
+    clone->set_charge_field(Zxyz_);
+    return clone_settings(clone);
+}
+
 }  // namespace psi
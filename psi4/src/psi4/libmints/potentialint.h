@@ -57,6 +57,8 @@ class PCMPotentialInt : public PotentialInt {
    public:
     PCMPotentialInt(std::vector<SphericalTransform> &, std::shared_ptr<BasisSet>, std::shared_ptr<BasisSet>,
                     int deriv = 0);
+    /// Clones must stay PCMPotentialInt, PotentialInt::clone would return the base class
+    OneBodyAOInt *clone() const override;
     /// Drives the loops over all shell pairs, to compute integrals
     template <typename PCMPotentialIntFunctor>
     void compute(PCMPotentialIntFunctor &functor);
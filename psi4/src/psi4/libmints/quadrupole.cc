@@ -54,6 +54,10 @@ QuadrupoleInt::QuadrupoleInt(std::vector<SphericalTransform> &st, std::shared_pt
 
 QuadrupoleInt::~QuadrupoleInt() { delete[] buffer_; }
 
+OneBodyAOInt *QuadrupoleInt::clone() const {
+    return clone_settings(new QuadrupoleInt(spherical_transforms_, bs1_, bs2_));
+}
+
 SharedVector QuadrupoleInt::nuclear_contribution(std::shared_ptr<Molecule> mol, const Vector3 &origin) {
     auto sret = std::make_shared<Vector>(6);
     double *ret = sret->pointer();
@@ -77,6 +77,12 @@ RelPotentialInt::~RelPotentialInt() {
     delete potential_recur_;
 }
 
+OneBodyAOInt *RelPotentialInt::clone() const {
+    auto *clone = new RelPotentialInt(spherical_transforms_, bs1_, bs2_, deriv_);
+    clone->set_charge_field(Zxyz_);
+    return clone_settings(clone);
+}
+
 /* Prakash
    changing compute_pair to do <p mu |1/r-C | p nu >
 */
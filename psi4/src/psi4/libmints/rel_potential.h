@@ -70,6 +70,9 @@ class RelPotentialInt : public OneBodyAOInt {
                     int deriv = 0);
     ~RelPotentialInt() override;
 
+    bool cloneable() const override { return true; }
+    OneBodyAOInt* clone() const override;
+
     /// Computes the first derivatives and stores them in result
     void compute_deriv1(std::vector<SharedMatrix>& result) override;
 
@@ -0,0 +1,154 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2019 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "psi4/libmints/shellpaircache.h"
+#include "psi4/libmints/basisset.h"
+#include "psi4/libmints/gshell.h"
+#include "psi4/libmints/vector3.h"
+#include "psi4/libpsi4util/exception.h"
+#include "psi4/libpsi4util/process.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace psi {
+
+ShellPairCache::ShellPairCache(std::shared_ptr<BasisSet> bs1, std::shared_ptr<BasisSet> bs2, double threshold)
+    : bs1_(bs1), bs2_(bs2), symmetric_(bs1 == bs2), threshold_(threshold), nunscreened_(0) {
+    const int nshell1 = bs1_->nshell();
+    const int nshell2 = bs2_->nshell();
+
+    // Each row P of shell pairs is built independently, then the rows are concatenated
+    std::vector<std::vector<PrimitivePair>> rows(nshell1);
+    std::vector<std::vector<size_t>> row_sizes(nshell1);
+    std::vector<size_t> row_unscreened(nshell1, 0);
+
+#pragma omp parallel for schedule(dynamic) num_threads(Process::environment.get_n_threads())
+    for (int P = 0; P < nshell1; P++) {
+        const GaussianShell &s1 = bs1_->shell(P);
+        const int nQ = symmetric_ ? P + 1 : nshell2;
+        std::vector<PrimitivePair> &row = rows[P];
+        row_sizes[P].resize(nQ);
+        for (int Q = 0; Q < nQ; Q++) {
+            row_unscreened[P] += (size_t)s1.nprimitive() * bs2_->shell(Q).nprimitive();
+            row_sizes[P][Q] = append_pairs(s1, bs2_->shell(Q), threshold_, row);
+        }
+    }
+
+    size_t npair = 0;
+    for (int P = 0; P < nshell1; P++) {
+        npair += rows[P].size();
+        nunscreened_ += row_unscreened[P];
+    }
+    pairs_.reserve(npair);
+    offsets_.reserve(symmetric_ ? (size_t)nshell1 * (nshell1 + 1) / 2 + 1 : (size_t)nshell1 * nshell2 + 1);
+    for (int P = 0; P < nshell1; P++) {
+        for (size_t n : row_sizes[P]) {
+            offsets_.push_back(pairs_.size());
+            pairs_.resize(pairs_.size() + n);
+        }
+        std::copy(rows[P].begin(), rows[P].end(), pairs_.end() - rows[P].size());
+        std::vector<PrimitivePair>().swap(rows[P]);
+    }
+    offsets_.push_back(pairs_.size());
+}
+
+int ShellPairCache::append_pairs(const GaussianShell &s1, const GaussianShell &s2, double threshold,
+                                 std::vector<PrimitivePair> &pairs) {
+    const Vector3 A = s1.center();
+    const Vector3 B = s2.center();
+    const Vector3 AB = A - B;
+    const double AB2 = AB.dot(AB);
+
+    size_t start = pairs.size();
+    for (int p1 = 0; p1 < s1.nprimitive(); p1++) {
+        const double a1 = s1.exp(p1);
+        const double c1 = s1.coef(p1);
+        for (int p2 = 0; p2 < s2.nprimitive(); p2++) {
+            const double a2 = s2.exp(p2);
+            const double c2 = s2.coef(p2);
+            const double gamma = a1 + a2;
+            const double oog = 1.0 / gamma;
+
+            PrimitivePair pair;
+            pair.ai = a1;
+            pair.aj = a2;
+            pair.gamma = gamma;
+            for (int x = 0; x < 3; x++) {
+                pair.P[x] = (a1 * A[x] + a2 * B[x]) * oog;
+                pair.PA[x] = pair.P[x] - A[x];
+                pair.PB[x] = pair.P[x] - B[x];
+            }
+            pair.K = std::pow(M_PI * oog, 1.5) * std::exp(-a1 * a2 * AB2 * oog) * c1 * c2;
+            pair.bound = std::fabs(pair.K) * std::pow(gamma, 0.25);
+            pairs.push_back(pair);
+        }
+    }
+
+    // Largest first, then drop the negligible ones but keep at least one pair. The potential prefactor
+    // 2 sqrt(gamma / pi) |K| exceeds the ERI bound for tight pairs, so both are checked.
+    std::sort(pairs.begin() + start, pairs.end(),
+              [](const PrimitivePair &a, const PrimitivePair &b) { return a.bound > b.bound; });
+    auto negligible = [threshold](const PrimitivePair &pair) {
+        return pair.bound < threshold && M_2_SQRTPI * std::sqrt(pair.gamma) * std::fabs(pair.K) < threshold;
+    };
+    pairs.erase(std::remove_if(pairs.begin() + start + 1, pairs.end(), negligible), pairs.end());
+    return pairs.size() - start;
+}
+
+size_t ShellPairCache::index(int P, int Q) const {
+    return symmetric_ ? (size_t)P * (P + 1) / 2 + Q : (size_t)P * bs2_->nshell() + Q;
+}
+
+bool ShellPairCache::covers(const std::shared_ptr<BasisSet> &bsP, const std::shared_ptr<BasisSet> &bsQ) const {
+    return (bsP == bs1_ && bsQ == bs2_) || (bsP == bs2_ && bsQ == bs1_);
+}
+
+const ShellPairCache::PrimitivePair *ShellPairCache::pairs(const std::shared_ptr<BasisSet> &bsP,
+                                                         const std::shared_ptr<BasisSet> &bsQ, int P, int Q,
+                                                         int &npair, bool &swapped) const {
+    if (bsP == bs1_ && bsQ == bs2_) {
+        swapped = symmetric_ && P < Q;
+    } else if (bsP == bs2_ && bsQ == bs1_) {
+        swapped = true;
+    } else {
+        throw PSIEXCEPTION("ShellPairCache: the requested basis sets are not covered by this object.");
+    }
+    if (swapped) std::swap(P, Q);
+
+    size_t pq = index(P, Q);
+    npair = offsets_[pq + 1] - offsets_[pq];
+    return pairs_.data() + offsets_[pq];
+}
+
+}  // namespace psi
@@ -0,0 +1,127 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2019 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _psi_src_lib_libmints_shellpaircache_h_
+#define _psi_src_lib_libmints_shellpaircache_h_
+
+#include <memory>
+#include <vector>
+#include "psi4/pragma.h"
+
+namespace psi {
+
+class BasisSet;
+class GaussianShell;
+
+/*! \ingroup MINTS
+ *  \class ShellPairCache
+ *  \brief Primitive pair quantities of every shell pair of two basis sets.
+ *
+ *  The Gaussian product data (exponents, product center, distances to both centers and the contracted
+ *  overlap prefactor) only depend on the two shells, so they are computed once per pair of basis sets and
+ *  shared by every integral object built from the same IntegralFactory. Within each shell pair, primitive
+ *  pairs are sorted by decreasing bound and those whose bound is below the threshold are dropped, always
+ *  keeping the largest one. When both basis sets are the same object, only the pairs P >= Q are stored.
+ */
+class PSI_API ShellPairCache {
+   public:
+    /// One primitive pair of a shell pair
+    struct PrimitivePair {
+        /// Exponents of the primitives on the first and second shell
+        double ai, aj;
+        /// Total exponent ai + aj
+        double gamma;
+        /// Gaussian product center
+        double P[3];
+        /// P - A and P - B
+        double PA[3], PB[3];
+        /// Contracted overlap prefactor (pi / gamma)^3/2 exp(-ai aj |AB|^2 / gamma) ci cj
+        double K;
+        /**
+         * |K| gamma^1/4. Since rho = zeta eta / (zeta + eta) <= sqrt(zeta eta) / 2, the prefactor 2 sqrt(rho / pi) K_ab K_cd
+         * of a primitive ERI quartet is at most sqrt(2 / pi) bound_ab bound_cd
+         */
+        double bound;
+    };
+
+   protected:
+    /// Basis sets of the first and second shell
+    std::shared_ptr<BasisSet> bs1_, bs2_;
+    /// Are the two basis sets the same object?
+    bool symmetric_;
+    /// Primitive pairs whose bound is below this are dropped
+    double threshold_;
+    /// Retained primitive pairs of all shell pairs, contiguous per shell pair
+    std::vector<PrimitivePair> pairs_;
+    /// Offset of each shell pair in pairs_, with one extra entry at the end
+    std::vector<size_t> offsets_;
+    /// Number of primitive pairs before screening
+    size_t nunscreened_;
+
+    size_t index(int P, int Q) const;
+
+   public:
+    /**
+     * @param bs1       basis set of the first shell
+     * @param bs2       basis set of the second shell
+     * @param threshold primitive pairs whose bound is below this are dropped
+     */
+    ShellPairCache(std::shared_ptr<BasisSet> bs1, std::shared_ptr<BasisSet> bs2, double threshold = 1.0E-15);
+
+    std::shared_ptr<BasisSet> basis1() const { return bs1_; }
+    std::shared_ptr<BasisSet> basis2() const { return bs2_; }
+    double threshold() const { return threshold_; }
+
+    /// Number of primitive pairs kept over all shell pairs
+    size_t nprimitive_pair() const { return pairs_.size(); }
+    /// Number of primitive pairs over all shell pairs before screening
+    size_t nprimitive_pair_unscreened() const { return nunscreened_; }
+
+    /**
+     * Appends the primitive pairs of (s1, s2) to pairs, largest bound first, dropping those below threshold
+     * except the largest. A pair is dropped only if both its ERI bound and its nuclear attraction prefactor
+     * 2 sqrt(gamma / pi) |K| are below threshold. Returns the number appended.
+     */
+    static int append_pairs(const GaussianShell& s1, const GaussianShell& s2, double threshold,
+                            std::vector<PrimitivePair>& pairs);
+
+    /// Does this hold the shell pairs of (bsP, bsQ), in either order?
+    bool covers(const std::shared_ptr<BasisSet>& bsP, const std::shared_ptr<BasisSet>& bsQ) const;
+
+    /**
+     * The retained primitive pairs of shell P of bsP and shell Q of bsQ, largest first.
+     * @param npair   number of primitive pairs returned
+     * @param swapped set if the pairs are stored as (Q, P), so that ai, aj and PA, PB refer to Q and P
+     */
+    const PrimitivePair* pairs(const std::shared_ptr<BasisSet>& bsP, const std::shared_ptr<BasisSet>& bsQ, int P,
+                               int Q, int& npair, bool& swapped) const;
+};
+
+}  // namespace psi
+
+#endif
@@ -30,6 +30,7 @@
 #include "psi4/psi4-dec.h"
 #include "psi4/libmints/sieve.h"
 #include "psi4/libmints/basisset.h"
+#include "psi4/libmints/matrix.h"
 #include "psi4/libmints/twobody.h"
 #include "psi4/libmints/integral.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
@@ -389,5 +390,30 @@ bool ERISieve::shell_significant_csam(int M, int N, int R, int S) {
     return std::abs(mnrs_2) >= sieve2_;
 }
 
+void ERISieve::set_density(const std::vector<SharedMatrix> &D) {
+    shell_pair_density_values_.resize(nshell_ * nshell_);
+    std::fill(shell_pair_density_values_.begin(), shell_pair_density_values_.end(), 0.0);
+
+    for (size_t ind = 0; ind < D.size(); ind++) {
+        double **Dp = D[ind]->pointer();
+        for (int M = 0; M < nshell_; M++) {
+            int nM = primary_->shell(M).nfunction();
+            int oM = primary_->shell(M).function_index();
+            for (int N = 0; N <= M; N++) {
+                int nN = primary_->shell(N).nfunction();
+                int oN = primary_->shell(N).function_index();
+                double max_val = shell_pair_density_values_[M * nshell_ + N];
+                for (int m = 0; m < nM; m++) {
+                    for (int n = 0; n < nN; n++) {
+                        max_val = std::max(max_val, std::abs(Dp[m + oM][n + oN]));
+                        max_val = std::max(max_val, std::abs(Dp[n + oN][m + oM]));
+                    }
+                }
+                shell_pair_density_values_[M * nshell_ + N] = shell_pair_density_values_[N * nshell_ + M] = max_val;
+            }
+        }
+    }
+}
+
 double ERISieve::shell_pair_value(int m, int n) const { return shell_pair_values_[m * nshell_ + n]; }
 }  // namespace psi
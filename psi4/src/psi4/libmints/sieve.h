@@ -31,10 +31,12 @@
 
 // need this for erfc^{-1} in the QQR sieve
 //#include <cfloat>
+#include <algorithm>
 #include <vector>
 #include <memory>
 //#include <utility>
 #include "psi4/pragma.h"
+#include "psi4/libmints/typedefs.h"
 #include "psi4/libmints/vector3.h"
 
 namespace psi {
@@ -72,6 +74,12 @@ class BasisSet;
  *     if (sieve->shell_ceiling2(M,N,R,S) * D_RS * D_RS >= sieve_cutoff * sieve_cutoff)
  *         eri->compute(M,N,R,S);
  *
+ *     // Density-weighted sieving: tabulate max |D_MN| over all densities
+ *     // once per Fock build, then test (MN|RS) separately for J and K
+ *     sieve->set_density(D);
+ *     if (sieve->shell_significant_density_J(M,N,R,S)) { ... J_MN, J_RS ... }
+ *     if (sieve->shell_significant_density_K(M,N,R,S)) { ... K_MR, K_MS, K_NR, K_NS ... }
+ *
  *     // Index the significant MN shell pairs (triangular M,N)
  *     const std::vector<std::pair<int,int> >& MN = sieve->shell_pairs();
  *     for (long int index = 0L; index < MN.size(); ++index) {
@@ -170,6 +178,12 @@ class PSI_API ERISieve {
     /// Compute csam sieve integrals (only done once)
     void csam_integrals();
 
+    ///////////////////////////////////////
+    // density-weighted sieving
+
+    /// max |D_MN| over all densities set by set_density, symmetrized (nshell * nshell)
+    std::vector<double> shell_pair_density_values_;
+
     ///////////////////////////////////////
 
     /// Set initial indexing
@@ -225,6 +239,34 @@ class PSI_API ERISieve {
     // Implements the CSAM sieve
     bool shell_significant_csam(int M, int N, int R, int S);
 
+    /**
+     * Tabulate max |D_MN| for each shell pair over a set of AO densities.
+     * Must be called before the density-weighted checks below, and again
+     * whenever the densities change.
+     * @param D AO (C1) densities, nbf x nbf, need not be symmetric
+     */
+    void set_density(const std::vector<SharedMatrix>& D);
+    /// Has a density table been set?
+    bool has_density() const { return !shell_pair_density_values_.empty(); }
+    /// max |D_MN| over the last set of densities
+    inline double shell_pair_density_value(int M, int N) const {
+        return shell_pair_density_values_[M * nshell_ + N];
+    }
+
+    /// Is (MN|RS) significant for J_MN += (MN|RS) D_RS and J_RS += (MN|RS) D_MN?
+    inline bool shell_significant_density_J(int M, int N, int R, int S) {
+        double D = std::max(shell_pair_density_values_[M * nshell_ + N], shell_pair_density_values_[R * nshell_ + S]);
+        return shell_pair_values_[N * nshell_ + M] * shell_pair_values_[R * nshell_ + S] * D * D >= sieve2_;
+    }
+
+    /// Is (MN|RS) significant for K_MR += (MN|RS) D_NS (and the other three exchange-type terms)?
+    inline bool shell_significant_density_K(int M, int N, int R, int S) {
+        double D = std::max(
+            std::max(shell_pair_density_values_[M * nshell_ + R], shell_pair_density_values_[M * nshell_ + S]),
+            std::max(shell_pair_density_values_[N * nshell_ + R], shell_pair_density_values_[N * nshell_ + S]));
+        return shell_pair_values_[N * nshell_ + M] * shell_pair_values_[R * nshell_ + S] * D * D >= sieve2_;
+    }
+
     /// Is the integral (mn|rs) significant according to sieve? (no restriction on mnrs order)
     inline bool function_significant(int m, int n, int r, int s) {
         return function_pair_values_[m * nbf_ + n] * function_pair_values_[r * nbf_ + s] >= sieve2_;
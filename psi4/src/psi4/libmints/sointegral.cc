@@ -44,6 +44,9 @@ PRAGMA_WARNING_PUSH
 PRAGMA_WARNING_IGNORE_DEPRECATED_DECLARATIONS
 #include <memory>
 PRAGMA_WARNING_POP
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace psi {
 
@@ -78,14 +81,30 @@ std::shared_ptr<SOBasisSet> OneBodySOInt::basis2() const { return b2_; }
 
 std::shared_ptr<OneBodyAOInt> OneBodySOInt::ob() const { return ob_; }
 
+std::vector<std::shared_ptr<OneBodyAOInt>> OneBodySOInt::thread_engines() const {
+    std::vector<std::shared_ptr<OneBodyAOInt>> engines(1, ob_);
+    int nthread = ob_->compute_nthread();
+    for (int thread = 1; thread < nthread; ++thread) {
+        engines.push_back(std::shared_ptr<OneBodyAOInt>(ob_->clone()));
+    }
+    return engines;
+}
+
 void OneBodySOInt::compute(SharedMatrix result) {
     // Do not worry about zeroing out result
     int ns1 = b1_->nshell();
     int ns2 = b2_->nshell();
-    const double *aobuf = ob_->buffer();
+    std::vector<std::shared_ptr<OneBodyAOInt>> engines = thread_engines();
 
-    // Loop over the unique AO shells.
+    // Loop over the unique AO shells. Each SO shell row writes its own rows, so the threads never overlap.
+#pragma omp parallel for schedule(dynamic) num_threads(engines.size())
     for (int ish = 0; ish < ns1; ++ish) {
+        int rank = 0;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        OneBodyAOInt *engine = engines[rank].get();
+        const double *aobuf = engine->buffer();
         for (int jsh = 0; jsh < ns2; ++jsh) {
             const SOTransform &t1 = b1_->sotrans(ish);
             const SOTransform &t2 = b2_->sotrans(jsh);
@@ -98,7 +117,7 @@ void OneBodySOInt::compute(SharedMatrix result) {
                 const SOTransformShell &s1 = t1.aoshell[i];
                 for (int j = 0; j < t2.naoshell; ++j) {
                     const SOTransformShell &s2 = t2.aoshell[j];
-                    ob_->compute_shell(s1.aoshell, s2.aoshell);
+                    engine->compute_shell(s1.aoshell, s2.aoshell);
 
                     for (int itr = 0; itr < s1.nfunc; ++itr) {
                         const SOTransformFunction &ifunc = s1.func[itr];
@@ -131,10 +150,17 @@ void OneBodySOInt::compute(std::vector<SharedMatrix> results) {
     int nchunk = ob_->nchunk();
     int ns1 = b1_->nshell();
     int ns2 = b2_->nshell();
-    const double *aobuf = ob_->buffer();
+    std::vector<std::shared_ptr<OneBodyAOInt>> engines = thread_engines();
 
-    // Loop over the unique AO shells.
+    // Loop over the unique AO shells. Each SO shell row writes its own rows, so the threads never overlap.
+#pragma omp parallel for schedule(dynamic) num_threads(engines.size())
     for (int ish = 0; ish < ns1; ++ish) {
+        int rank = 0;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        OneBodyAOInt *engine = engines[rank].get();
+        const double *aobuf = engine->buffer();
         for (int jsh = 0; jsh < ns2; ++jsh) {
             const SOTransform &t1 = b1_->sotrans(ish);
             const SOTransform &t2 = b2_->sotrans(jsh);
@@ -150,7 +176,7 @@ void OneBodySOInt::compute(std::vector<SharedMatrix> results) {
                 for (int j = 0; j < t2.naoshell; ++j) {
                     const SOTransformShell &s2 = t2.aoshell[j];
 
-                    ob_->compute_shell(s1.aoshell, s2.aoshell);
+                    engine->compute_shell(s1.aoshell, s2.aoshell);
 
                     for (int itr = 0; itr < s1.nfunc; ++itr) {
                         const SOTransformFunction &ifunc = s1.func[itr];
@@ -48,6 +48,9 @@ class PSI_API OneBodySOInt {
 
     void common_init();
 
+    /// ob_ followed by one clone per additional thread, see OneBodyAOInt::compute_nthread
+    std::vector<std::shared_ptr<OneBodyAOInt>> thread_engines() const;
+
    public:
     OneBodySOInt(const std::shared_ptr<OneBodyAOInt>&, const std::shared_ptr<IntegralFactory>&);
     OneBodySOInt(const std::shared_ptr<OneBodyAOInt>&, const IntegralFactory*);
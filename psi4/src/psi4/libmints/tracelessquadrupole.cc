@@ -54,6 +54,10 @@ TracelessQuadrupoleInt::TracelessQuadrupoleInt(std::vector<SphericalTransform>&
 
 TracelessQuadrupoleInt::~TracelessQuadrupoleInt() { delete[] buffer_; }
 
+OneBodyAOInt *TracelessQuadrupoleInt::clone() const {
+    return clone_settings(new TracelessQuadrupoleInt(spherical_transforms_, bs1_, bs2_));
+}
+
 void TracelessQuadrupoleInt::compute_pair(const GaussianShell& s1, const GaussianShell& s2) {
     int ao12;
     int am1 = s1.am();
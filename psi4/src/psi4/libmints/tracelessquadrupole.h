@@ -58,6 +58,9 @@ class TracelessQuadrupoleInt : public OneBodyAOInt {
    public:
     TracelessQuadrupoleInt(std::vector<SphericalTransform>&, std::shared_ptr<BasisSet>, std::shared_ptr<BasisSet>);
     ~TracelessQuadrupoleInt() override;
+
+    bool cloneable() const override { return true; }
+    OneBodyAOInt* clone() const override;
 };
 
 }  // namespace psi
@@ -44,6 +44,7 @@
 extern "C" {
 extern void F_DGBMV(char*, int*, int*, int*, int*, double*, double*, int*, double*, int*, double*, double*, int*);
 extern void F_DGEMM(char*, char*, int*, int*, int*, double*, double*, int*, double*, int*, double*, double*, int*);
+extern void F_SGEMM(char*, char*, int*, int*, int*, float*, float*, int*, float*, int*, float*, float*, int*);
 extern void F_DGEMV(char*, int*, int*, double*, double*, int*, double*, int*, double*, double*, int*);
 extern void F_DGER(int*, int*, double*, double*, int*, double*, int*, double*, int*);
 extern void F_DSBMV(char*, int*, int*, double*, double*, int*, double*, int*, double*, double*, int*);
@@ -327,6 +328,16 @@ PSI_API void C_DGEMM(char transa, char transb, int m, int n, int k, double alpha
     ::F_DGEMM(&transb, &transa, &n, &m, &k, &alpha, b, &ldb, a, &lda, &beta, c, &ldc);
 }
 
+/**
+ *  SGEMM is the single precision analogue of C_DGEMM above, with the same
+ *  row-major argument conventions.
+ **/
+PSI_API void C_SGEMM(char transa, char transb, int m, int n, int k, float alpha, float* a, int lda, float* b, int ldb,
+                     float beta, float* c, int ldc) {
+    if (m == 0 || n == 0 || k == 0) return;
+    ::F_SGEMM(&transb, &transa, &n, &m, &k, &alpha, b, &ldb, a, &lda, &beta, c, &ldc);
+}
+
 /**
  *  Purpose
  *  =======
@@ -150,6 +150,10 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
     /*- Integral package to use. If compiled with ERD or Simint support, change this option to use them; LibInt is used
        otherwise. -*/
     options.add_str("INTEGRAL_PACKAGE", "LIBINT", "ERD LIBINT SIMINT");
+    /*- Primitive pairs, and primitive quartets in the libint ERIs, whose bound on the integral prefactor is below
+       this are neglected. The bound includes the sqrt(rho) factor of the quartet prefactor and, for derivative
+       integrals, a factor 2 alpha per derivative. !expert -*/
+    options.add_double("INTS_PRIMITIVE_TOLERANCE", 1.0E-15);
     
 #ifdef USING_BrianQC
     /*- Whether to enable using the BrianQC GPU module -*/
@@ -168,6 +172,14 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
     /*- Assume external fields are arranged so that they have symmetry. It is up to the user to know what to do here.
        The code does NOT help you out in any way! !expert -*/
     options.add_bool("EXTERNAL_POTENTIAL_SYMMETRY", false);
+    /*- Opening-angle criterion for lumping distant external point charges into multipole expansions about
+       the centers of shell-pair boxes. A cell of charges is expanded when (box radius + cell radius) / distance
+       is below this value; nearer charges are integrated exactly. The default of zero integrates all
+       charges exactly. -*/
+    options.add_double("EXTERNAL_POTENTIAL_THETA", 0.0);
+    /*- Order of the Taylor expansion of the far-field external potential used when
+       |globals__external_potential_theta| is nonzero. !expert -*/
+    options.add_int("EXTERNAL_POTENTIAL_MULTIPOLE_ORDER", 4);
     /*- Text to be passed directly into CFOUR input files. May contain
     molecule, options, percent blocks, etc. Access through ``cfour {...}``
     block. -*/
@@ -179,7 +191,7 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
     /*- What algorithm to use for the SCF computation. See Table :ref:`SCF
     Convergence & Algorithm <table:conv_scf>` for default algorithm for
     different calculation types. -*/
-    options.add_str("SCF_TYPE", "PK", "DIRECT DF MEM_DF DISK_DF PK OUT_OF_CORE CD GTFOCK");
+    options.add_str("SCF_TYPE", "PK", "DIRECT DF MEM_DF DISK_DF PK OUT_OF_CORE CD GTFOCK COSX DF_J");
     /*- Algorithm to use for MP2 computation.
     See :ref:`Cross-module Redundancies <table:managedmethods>` for details. -*/
     options.add_str("MP2_TYPE", "DF", "DF CONV CD");
@@ -956,10 +968,13 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         default is conservative, but there isn't much to be gained from
         loosening it, especially for higher-order SAPT. -*/
         options.add_double("INTS_TOLERANCE", 1.0E-12);
-        /*- Do use Combined Schwarz Approximation Maximum (CSAM) screening on
-        two-electron integrals. This is a slightly tighter bound than that of
-        default Schwarz screening. -*/
-        options.add_str("SCREENING", "SCHWARZ" "SCHWARZ CSAM");
+        /*- Screening applied to two-electron integrals. ``CSAM`` uses the
+        Combined Schwarz Approximation Maximum bound, which is a slightly
+        tighter bound than that of default Schwarz screening. ``DENSITY``
+        additionally weights the Schwarz bound of each shell quartet by the
+        largest density element it is contracted with (|globals__scf_type|
+        ``DIRECT`` only). -*/
+        options.add_str("SCREENING", "SCHWARZ", "SCHWARZ CSAM DENSITY");
         /*- Memory safety -*/
         options.add_double("SAPT_MEM_SAFETY", 0.9);
         /*- Do force SAPT2 and higher to die if it thinks there isn't enough
@@ -1279,6 +1294,64 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
             orbitals before switching to the use of exact integrals in
             a |scf__scf_type| ``DIRECT`` calculation -*/
         options.add_bool("DF_SCF_GUESS", true);
+        /*- Do build the Fock matrix incrementally from the change in the
+            density between iterations in a |scf__scf_type| ``DIRECT``
+            calculation? A |scf__scf_type| ``DF_J`` calculation always updates
+            its fitted density incrementally unless this is explicitly turned off. -*/
+        options.add_bool("INCFOCK", false);
+        /*- Maximum number of consecutive incremental Fock builds before a
+            full rebuild is done. See |scf__incfock|. -*/
+        options.add_int("INCFOCK_FULL_FOCK_EVERY", 10);
+        /*- Ratio RMS(D_n - D_{n-1}) / RMS(D_n) above which a full Fock
+            build is done instead of an incremental one. See |scf__incfock|. -*/
+        options.add_double("INCFOCK_FULL_FOCK_THRESHOLD", 0.1);
+        /*- Number of radial points for the seminumerical exchange grid in a
+            |scf__scf_type| ``COSX`` calculation. -*/
+        options.add_int("COSX_RADIAL_POINTS", 35);
+        /*- Number of spherical points (A :ref:`Lebedev Points <table:lebedevorder>`
+            number) for the seminumerical exchange grid in a |scf__scf_type|
+            ``COSX`` calculation. -*/
+        options.add_int("COSX_SPHERICAL_POINTS", 110);
+        /*- Do apply the overlap fitting to the seminumerical exchange in a
+            |scf__scf_type| ``COSX`` calculation? Removes most of the grid
+            error at the cost of one extra pass over the grid. !expert -*/
+        options.add_bool("COSX_OVERLAP_FITTING", true);
+        /*- Do build the Coulomb matrix with the continuous fast multipole
+            method in a |scf__scf_type| ``DIRECT`` calculation?
+            Well-separated charge distributions interact through multipoles,
+            the rest through exact ERIs. Not available for the density-fitted
+            SCF types. -*/
+        options.add_bool("CFMM", false);
+        /*- Order of the Cartesian multipole expansions in CFMM. See |scf__cfmm|. -*/
+        options.add_int("CFMM_ORDER", 10);
+        /*- Number of levels of the CFMM octree. 0 picks a depth giving leaf
+            boxes of about 4 bohr. See |scf__cfmm|. -*/
+        options.add_int("CFMM_LEVELS", 0);
+        /*- Do contract the |scf__scf_type| ``MEM_DF`` exchange over atom-block
+            tiles, skipping tiles whose per-orbital norm bound falls below
+            |scf__ints_tolerance|? Only pays off when the occupied orbitals
+            are spatially confined, e.g. for well-separated fragments. -*/
+        options.add_bool("DF_BLOCK_SPARSE_K", false);
+        /*- Do localize the occupied orbitals before each exchange build in a
+            |scf__scf_type| ``MEM_DF`` calculation, restricting each orbital's
+            half-transformed integrals to its atomic domain? -*/
+        options.add_bool("DF_LOCAL_K", false);
+        /*- Localization method for |scf__df_local_k|. -*/
+        options.add_str("DF_LOCAL_K_TYPE", "BOYS", "BOYS PIPEK_MEZEY");
+        /*- An atom enters a localized orbital's domain if the orbital's squared
+            coefficients on that atom sum to more than the square of this
+            tolerance. See |scf__df_local_k|. -*/
+        options.add_double("DF_LOCAL_K_TOLERANCE", 1.0E-5);
+        /*- Do store the fitted integrals and build J and K in single precision
+            for the early iterations of a |scf__scf_type| ``MEM_DF``
+            calculation? The integrals are rebuilt in double precision once the
+            orbital gradient drops below |scf__df_mixed_precision_convergence|,
+            and the SCF always finishes with double precision iterations. Cannot
+            be combined with |scf__df_local_k| or |scf__df_block_sparse_k|. -*/
+        options.add_bool("DF_MIXED_PRECISION", false);
+        /*- Orbital gradient at which |scf__df_mixed_precision| switches to
+            double precision. -*/
+        options.add_double("DF_MIXED_PRECISION_CONVERGENCE", 1.0E-4);
         /*- Keep JK object for later use? -*/
         options.add_bool("SAVE_JK", false);
         /*- Memory safety factor for allocating JK -*/
@@ -1539,6 +1612,27 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_double("DFT_BS_RADIUS_ALPHA", 1.0);
         /*- DFT basis cutoff. -*/
         options.add_double("DFT_BASIS_TOLERANCE", 1.0E-12);
+        /*- Per-block screening of the RKS potential build. Basis functions whose values and gradients stay
+        below this on every point of a block are dropped from that block's density and potential. A
+        non-positive value turns the screening off. !expert -*/
+        options.add_double("DFT_BLOCK_SCREENING_TOLERANCE", 0.0);
+        /*- Do spill the DFT collocation blocks that do not fit in memory to scratch disk, rather than
+        recomputing them every iteration? -*/
+        options.add_bool("DFT_COLLOCATION_DISK", false);
+        /*- Precision in which spilled DFT collocation blocks are stored. SINGLE halves the disk traffic at
+        the cost of roughly 1e-7 relative error in the basis values. !expert -*/
+        options.add_str("DFT_COLLOCATION_DISK_PRECISION", "DOUBLE", "DOUBLE SINGLE");
+        /*- Number of response densities (e.g., Davidson trial vectors, or alpha/beta pairs for UKS) contracted
+        together on each DFT block when building the XC kernel contribution. Larger batches give wider GEMMs,
+        but each thread keeps (2 max_functions + max_points) max_functions doubles of scratch per density in
+        the batch (twice that for UKS), which is not part of the SCF memory estimate. !expert -*/
+        options.add_int("DFT_VX_BATCH_SIZE", 4);
+        /*- Gather the small DFT blocks into batches of up to this many points, so that the functional is evaluated
+        once per batch rather than once per block in the RKS potential build. Each thread keeps one copy of
+        the point values and functional outputs sized for a batch; the collocation of a batched block is computed
+        twice, once for its point values and once for its integration. Zero evaluates every block separately.
+        !expert -*/
+        options.add_int("DFT_XC_BATCH_POINTS", 0);
         /*- grid weight cutoff. Disable with -1.0. !expert -*/
         options.add_double("DFT_WEIGHTS_TOLERANCE", 1.0E-15);
         /*- density cutoff for LibXC. A negative value turns the feature off and LibXC defaults are used. !expert -*/
@@ -1560,6 +1654,12 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_double("DFT_BLOCK_MAX_RADIUS", 3.0);
         /*- The blocking scheme for DFT. !expert -*/
         options.add_str("DFT_BLOCK_SCHEME", "OCTREE", "NAIVE OCTREE");
+        /*- Do keep the DFT grid and its blocking in a file keyed by the geometry, basis set, and grid options,
+        so that later calculations on the same system read it instead of building it again? -*/
+        options.add_bool("DFT_GRID_CACHE", false);
+        /*- Directory for the DFT grid cache files. Defaults to the scratch directory. The files are
+        never removed automatically, clear them with ``core.DFTGrid.clear_cache()``. -*/
+        options.add_str_i("DFT_GRID_CACHE_DIR", "");
         /*- Parameters defining the dispersion correction. See Table
         :ref:`-D Functionals <table:dft_disp>` for default values and Table
         :ref:`Dispersion Corrections <table:dashd>` for the order in which
@@ -1581,6 +1681,14 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_double("DFT_VV10_C", 0.0);
         /*- post-scf VV10 correction -*/
         options.add_bool("DFT_VV10_POSTSCF", false);
+        /*- Do screen the VV10 nonlocal kernel spatially? The VV10 grid is binned into cells; distant cells are
+        replaced by a single lumped point and very distant cells are neglected. -*/
+        options.add_bool("DFT_VV10_SCREENING", false);
+        /*- Distance [bohr] beyond which a VV10 cell is lumped into a single point if |DFT_VV10_SCREENING| is
+        on. The cell edge is one quarter of this radius. !expert -*/
+        options.add_double("DFT_VV10_LUMP_RADIUS", 10.0);
+        /*- Distance [bohr] beyond which a VV10 cell is neglected if |DFT_VV10_SCREENING| is on. !expert -*/
+        options.add_double("DFT_VV10_CUTOFF_RADIUS", 50.0);
         /*- The convergence on the orbital localization procedure -*/
         options.add_double("LOCAL_CONVERGENCE", 1E-12);
         /*- The maxiter on the orbital localization procedure -*/
@@ -0,0 +1,31 @@
+#! compare the batched Boys function F_j(T) against the scalar one, in particular around the switch to the
+#! asymptotic formula
+
+import psi4
+import pytest
+import numpy as np
+from .utils import *
+
+
+@pytest.mark.quick
+@pytest.mark.parametrize("J", [0, 1, 2, 4, 8, 12, 16])
+def test_boys_batched_vs_scalar(J):
+    # ERI and PotentialInt size the table one order above the highest J they request
+    fjt = psi4.core.TaylorFjt(16 + 1, 1.0e-15)
+
+    # Just below and above T_crit for every order up to J, where the batched values switch from interpolation
+    # plus downward recursion to the asymptotic formula, and a sweep over the interpolated range
+    T = [0.0]
+    for j in range(J + 1):
+        Tc = fjt.T_crit(j)
+        T.extend(Tc * (1.0 + k * 1.0e-6) for k in range(-20, 21))
+    T.extend(np.linspace(1.0e-8, 1.5 * fjt.T_crit(J), 500))
+    T = np.array(T)
+
+    batched = np.array(fjt.batch_values(J, T.tolist())).reshape(J + 1, len(T))
+    scalar = np.array([fjt.values(J, t) for t in T]).T
+
+    assert np.allclose(batched, scalar, rtol=1.0e-13, atol=0.0)
+
+    # F_j(0) = 1 / (2j + 1)
+    assert np.allclose(batched[:, 0], 1.0 / (2.0 * np.arange(J + 1) + 1.0), rtol=1.0e-14, atol=0.0)
@@ -0,0 +1,45 @@
+#! compare seminumerical (COSX) exchange against exact (PK) exchange on the same density
+
+import psi4
+import pytest
+import numpy as np
+from .utils import *
+
+
+@pytest.mark.quick
+def test_cosxjk_exact_k():
+    mol = psi4.geometry("""
+    0 1
+    O
+    H 1 1.00
+    H 1 1.00 2 103.1
+    symmetry c1
+    """)
+
+    psi4.set_options({"BASIS": "cc-pVDZ", "DF_BASIS_SCF": "cc-pVDZ-jkfit", "SCF_TYPE": "PK"})
+    e, wfn = psi4.energy("scf", return_wfn=True)
+    Cocc = wfn.Ca_subset("SO", "OCC")
+    primary = wfn.basisset()
+    aux = psi4.core.BasisSet.build(mol, "ORBITAL", "cc-pVDZ-jkfit")
+
+    def build_K(scf_type, options={}):
+        psi4.set_options({"SCF_TYPE": scf_type})
+        psi4.set_options(options)
+        jk = psi4.core.JK.build_JK(primary, aux)
+        jk.set_do_J(False)
+        jk.initialize()
+        jk.C_left_add(Cocc)
+        jk.compute()
+        K = np.asarray(jk.K()[0]).copy()
+        jk.finalize()
+        return K
+
+    K_exact = build_K("PK")
+    K_cosx = build_K("COSX", {"COSX_RADIAL_POINTS": 75, "COSX_SPHERICAL_POINTS": 302, "INTS_TOLERANCE": 1.0e-12})
+    K_unscreened = build_K("COSX", {"INTS_TOLERANCE": 0.0})
+    D = np.asarray(wfn.Da())
+
+    # The block screening only drops F_gl below the cutoff, so on the same grid it must match the unscreened K
+    assert compare_arrays(K_unscreened, K_cosx, 9, "screened vs unscreened COSX K")
+    assert compare_arrays(K_exact, K_cosx, 3, "COSX K vs exact K")
+    assert compare_values(np.vdot(D, K_exact), np.vdot(D, K_cosx), 4, "COSX exchange energy vs exact")
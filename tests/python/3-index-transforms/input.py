@@ -3,6 +3,7 @@
 import psi4
 import numpy as np
 from collections import OrderedDict
+from itertools import product
 
 psi4.set_output_file("output.dat", False)
 
@@ -79,7 +80,7 @@ for method in methods:
         if(form != 'pqQ' and method == 'DIRECT_iaQ'): continue
         for AO_core in [False, True]:
             for MO_core in [False, True]:
-                for hold_met in [False, True]:
+                for hold_met, pipeline in product([False, True], repeat=2):
                             
                     # get object
                     dfh = psi4.core.DFHelper(primary, aux)
@@ -88,10 +89,14 @@ for method in methods:
                     dfh.set_method(method)
                     memory = mem_bump if hold_met else 0
                     memory += 10*mem if AO_core else mem
+                    # pipelined runs double buffer the AO and MO blocks
+                    memory += (memory - mem_bump if hold_met else memory) if pipeline else 0
                     dfh.set_memory(memory)
                     dfh.set_AO_core(AO_core)
                     dfh.set_MO_core(MO_core)
                     dfh.hold_met(hold_met)
+                    dfh.set_pipeline_transform(pipeline)
+                    dfh.set_mmap_io(pipeline)
 
                     # build
                     dfh.initialize()
@@ -123,6 +128,7 @@ for method in methods:
 
                     test_string = 'Alg: ' + method + ' + ' + form + ' core (AOs, MOs, met): [' 
                     test_string += str(AO_core) + ', ' + str(MO_core) + ', ' + str(hold_met) +  ']' 
+                    test_string += ' pipelined' if pipeline else ''
 
                     print(test_string)
                     # am i right?
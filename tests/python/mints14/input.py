@@ -71,3 +71,20 @@ reference_esps = [ 4.62483342e+01,  1.54804313e-01,  4.13685593e-02,  1.99074762
 psi4.compare_arrays(esps_1threads, esps_4threads, 3, "Reference value for ESP calculation, 1 thread vs. 4 threads.")
 psi4.compare_arrays(esps_1threads, reference_esps, 3, "Reference value for ESP calculation, 1 thread vs. reference calculation.")
 
+
+# The field is returned together with the ESP; check it against finite differences of the ESP,
+# on points shifted off the nuclei
+esp_field = np.array(myepc.compute_esp_and_field_over_grid_in_memory(psi4_matrix))
+psi4.compare_arrays(esps_4threads, esp_field[:, 0], 8, "ESP from the combined ESP and field evaluation.")
+
+shifted = points + np.array([0.37, -0.21, 0.13])
+step = 1.0e-4
+fd_field = np.zeros((len(shifted), 3))
+for xyz in range(3):
+    displacement = np.zeros(3)
+    displacement[xyz] = step
+    plus = np.array(myepc.compute_esp_over_grid_in_memory(p4c.Matrix.from_array(shifted + displacement)))
+    minus = np.array(myepc.compute_esp_over_grid_in_memory(p4c.Matrix.from_array(shifted - displacement)))
+    fd_field[:, xyz] = -(plus - minus) / (2.0 * step / psi4.constants.bohr2angstroms)
+an_field = np.array(myepc.compute_esp_and_field_over_grid_in_memory(p4c.Matrix.from_array(shifted)))[:, 1:]
+psi4.compare_arrays(fd_field, an_field, 5, "Electric field vs. finite differences of the ESP.")
@@ -0,0 +1,78 @@
+#! Check the shared shell pair cache used by the ERI and potential engines. Every ordering of the
+#! basis sets and shells in a quartet reaches the cached primitive pairs through a different lookup
+#! (direct, swapped, bra or ket cache), so all permutations of a given tensor must agree, and the
+#! cached ERIs, first derivative ERIs and potential must match the engines without the cache.
+
+import psi4
+import numpy as np
+
+psi4.set_output_file("output.dat", False)
+
+h2o = psi4.geometry("""
+O
+H 1 0.96
+H 1 0.96 2 104.5
+symmetry c1
+""")
+
+primary = psi4.core.BasisSet.build(h2o, "ORBITAL", "cc-pVDZ")
+aux = psi4.core.BasisSet.build(h2o, "ORBITAL", "cc-pVDZ-jkfit")
+zero = psi4.core.BasisSet.zero_ao_basis_set()
+mints = psi4.core.MintsHelper(primary)
+
+nbf = primary.nbf()
+naux = aux.nbf()
+
+# Four-center integrals over the primary basis: the eight-fold permutational symmetry
+I = np.array(mints.ao_eri()).reshape(nbf, nbf, nbf, nbf)
+psi4.compare_arrays(I, I.transpose(1, 0, 2, 3), 12, "(mn|ls) = (nm|ls)")
+psi4.compare_arrays(I, I.transpose(0, 1, 3, 2), 12, "(mn|ls) = (mn|sl)")
+psi4.compare_arrays(I, I.transpose(2, 3, 0, 1), 12, "(mn|ls) = (ls|mn)")
+
+# Three-center integrals with the zero basis on either center of either side
+Qmn = np.array(mints.ao_eri(aux, zero, primary, primary)).reshape(naux, nbf, nbf)
+psi4.compare_arrays(Qmn, Qmn.transpose(0, 2, 1), 12, "(Q|mn) = (Q|nm)")
+Q0 = np.array(mints.ao_eri(zero, aux, primary, primary)).reshape(naux, nbf, nbf)
+psi4.compare_arrays(Qmn, Q0, 12, "(Q0|mn) = (0Q|mn)")
+mnQ = np.array(mints.ao_eri(primary, primary, aux, zero)).reshape(nbf, nbf, naux)
+psi4.compare_arrays(Qmn, mnQ.transpose(2, 0, 1), 12, "(Q0|mn) = (mn|Q0)")
+mn0Q = np.array(mints.ao_eri(primary, primary, zero, aux)).reshape(nbf, nbf, naux)
+psi4.compare_arrays(Qmn, mn0Q.transpose(2, 0, 1), 12, "(Q0|mn) = (mn|0Q)")
+
+# Two-center metric
+PQ = np.array(mints.ao_eri(zero, aux, zero, aux)).reshape(naux, naux)
+psi4.compare_arrays(PQ, PQ.T, 12, "(P|Q) = (Q|P)")
+QP = np.array(mints.ao_eri(aux, zero, aux, zero)).reshape(naux, naux)
+psi4.compare_arrays(PQ, QP, 12, "(0P|0Q) = (P0|Q0)")
+
+# Four-center integrals over two different basis sets
+mQls = np.array(mints.ao_eri(primary, aux, primary, primary)).reshape(nbf, naux, nbf, nbf)
+Qmls = np.array(mints.ao_eri(aux, primary, primary, primary)).reshape(naux, nbf, nbf, nbf)
+psi4.compare_arrays(mQls, Qmls.transpose(1, 0, 2, 3), 12, "(mQ|ls) = (Qm|ls)")
+lsmQ = np.array(mints.ao_eri(primary, primary, primary, aux)).reshape(nbf, nbf, nbf, naux)
+psi4.compare_arrays(mQls, lsmQ.transpose(2, 3, 0, 1), 12, "(mQ|ls) = (ls|mQ)")
+
+# Zero basis on the bra, with the ket cache shared with the primary four-center integrals
+m0ls = np.array(mints.ao_eri(primary, zero, primary, primary)).reshape(nbf, nbf, nbf)
+psi4.compare_arrays(m0ls, m0ls.transpose(0, 2, 1), 12, "(m0|ls) = (m0|sl)")
+
+# The cached, screened primitive pairs must reproduce the engines that build their own pair data
+ref = psi4.core.MintsHelper(primary)
+ref.set_use_shell_pairs(False)
+psi4.compare_arrays(np.array(ref.ao_eri()).reshape(nbf, nbf, nbf, nbf), I, 12, "(mn|ls) matches the uncached engine")
+psi4.compare_arrays(np.array(ref.ao_eri(aux, zero, primary, primary)).reshape(naux, nbf, nbf), Qmn, 12,
+                    "(Q|mn) matches the uncached engine")
+psi4.compare_arrays(np.array(ref.ao_eri(primary, aux, primary, primary)).reshape(nbf, naux, nbf, nbf), mQls, 12,
+                    "(mQ|ls) matches the uncached engine")
+
+# Nuclear attraction from the cached pairs
+V = np.array(mints.ao_potential())
+psi4.compare_arrays(V, V.T, 12, "V = V^T")
+psi4.compare_arrays(np.array(ref.ao_potential()), V, 12, "V matches the uncached engine")
+
+# First derivative ERIs, whose primitive screening includes the derivative factors
+for atom in range(h2o.natom()):
+    cached = mints.ao_tei_deriv1(atom)
+    uncached = ref.ao_tei_deriv1(atom)
+    for xyz, (dI, dI_ref) in enumerate(zip(cached, uncached)):
+        psi4.compare_arrays(np.array(dI_ref), np.array(dI), 11, "d(mn|ls)/dR[%d,%d] matches the uncached engine" % (atom, xyz))